@@ -491,3 +491,249 @@ void AUD_DecodeVorbis(Stream& inStream, Stream& outStream, PcmFormat format)
     LogDebug("Decoded Vorbis: %d bytes -> %d bytes", inStream.GetSize(), outStream.GetSize());
 }
 
+
+struct VorbisDecoder
+{
+    const uint8_t* mData = nullptr;
+    uint32_t mSize = 0;
+    uint32_t mPos = 0;
+    uint32_t mAudioStart = 0;       // Offset of the first audio page, after the three headers
+    PcmFormat mFormat;
+
+    ogg_sync_state mSyncState;
+    ogg_stream_state mStreamState;
+    vorbis_info mInfo;
+    vorbis_comment mComment;
+    vorbis_dsp_state mDspState;
+    vorbis_block mBlock;
+
+    bool mOpen = false;
+    bool mEndOfPages = false;
+};
+
+static uint32_t FeedVorbisDecoder(VorbisDecoder* decoder)
+{
+    uint32_t bytes = glm::min<uint32_t>(4096, decoder->mSize - decoder->mPos);
+    char* buffer = ogg_sync_buffer(&decoder->mSyncState, 4096);
+    memcpy(buffer, decoder->mData + decoder->mPos, bytes);
+    ogg_sync_wrote(&decoder->mSyncState, bytes);
+    decoder->mPos += bytes;
+    return bytes;
+}
+
+static bool OpenVorbisDecoder(VorbisDecoder* decoder)
+{
+    ogg_page og;
+    ogg_packet op;
+
+    decoder->mPos = 0;
+    decoder->mEndOfPages = false;
+    ogg_sync_init(&decoder->mSyncState);
+
+    // Find the first page, which holds the initial Vorbis header.
+    while (ogg_sync_pageout(&decoder->mSyncState, &og) != 1)
+    {
+        if (FeedVorbisDecoder(decoder) == 0)
+        {
+            LogError("Input does not appear to be an Ogg bitstream.");
+            ogg_sync_clear(&decoder->mSyncState);
+            return false;
+        }
+    }
+
+    ogg_stream_init(&decoder->mStreamState, ogg_page_serialno(&og));
+    vorbis_info_init(&decoder->mInfo);
+    vorbis_comment_init(&decoder->mComment);
+
+    bool valid = ogg_stream_pagein(&decoder->mStreamState, &og) >= 0 &&
+        ogg_stream_packetout(&decoder->mStreamState, &op) == 1 &&
+        vorbis_synthesis_headerin(&decoder->mInfo, &decoder->mComment, &op) >= 0;
+
+    // The comment and codebook headers follow and may span multiple pages.
+    int32_t numHeaders = 1;
+    while (valid && numHeaders < 3)
+    {
+        int result = ogg_stream_packetout(&decoder->mStreamState, &op);
+
+        if (result == 1)
+        {
+            valid = vorbis_synthesis_headerin(&decoder->mInfo, &decoder->mComment, &op) >= 0;
+            numHeaders++;
+        }
+        else if (result < 0)
+        {
+            valid = false;
+        }
+        else if (ogg_sync_pageout(&decoder->mSyncState, &og) == 1)
+        {
+            ogg_stream_pagein(&decoder->mStreamState, &og);
+        }
+        else if (FeedVorbisDecoder(decoder) == 0)
+        {
+            valid = false;
+        }
+    }
+
+    valid = valid &&
+        decoder->mInfo.channels == (int)decoder->mFormat.mNumChannels &&
+        vorbis_synthesis_init(&decoder->mDspState, &decoder->mInfo) == 0;
+
+    if (!valid)
+    {
+        LogError("Failed to read Vorbis headers for streaming.");
+        ogg_stream_clear(&decoder->mStreamState);
+        vorbis_comment_clear(&decoder->mComment);
+        vorbis_info_clear(&decoder->mInfo);
+        ogg_sync_clear(&decoder->mSyncState);
+        return false;
+    }
+
+    // The last header ends its page, so any bytes the sync state hasn't returned yet are audio.
+    decoder->mAudioStart = decoder->mPos - uint32_t(decoder->mSyncState.fill - decoder->mSyncState.returned);
+
+    vorbis_block_init(&decoder->mDspState, &decoder->mBlock);
+    decoder->mOpen = true;
+    return true;
+}
+
+static void CloseVorbisDecoder(VorbisDecoder* decoder)
+{
+    if (decoder->mOpen)
+    {
+        vorbis_block_clear(&decoder->mBlock);
+        vorbis_dsp_clear(&decoder->mDspState);
+        ogg_stream_clear(&decoder->mStreamState);
+        vorbis_comment_clear(&decoder->mComment);
+        vorbis_info_clear(&decoder->mInfo);
+        ogg_sync_clear(&decoder->mSyncState);
+        decoder->mOpen = false;
+    }
+}
+
+VorbisDecoder* AUD_CreateVorbisDecoder(const uint8_t* data, uint32_t size, PcmFormat format)
+{
+    VorbisDecoder* decoder = new VorbisDecoder();
+    decoder->mData = data;
+    decoder->mSize = size;
+    decoder->mFormat = format;
+
+    if (!OpenVorbisDecoder(decoder))
+    {
+        delete decoder;
+        decoder = nullptr;
+    }
+
+    return decoder;
+}
+
+void AUD_DestroyVorbisDecoder(VorbisDecoder* decoder)
+{
+    if (decoder != nullptr)
+    {
+        CloseVorbisDecoder(decoder);
+        delete decoder;
+    }
+}
+
+void AUD_ResetVorbisDecoder(VorbisDecoder* decoder)
+{
+    if (!decoder->mOpen)
+    {
+        return;
+    }
+
+    // Rewind to the first audio page. The reset functions keep their buffers, so this doesn't allocate.
+    ogg_sync_reset(&decoder->mSyncState);
+    ogg_stream_reset(&decoder->mStreamState);
+    vorbis_synthesis_restart(&decoder->mDspState);
+    decoder->mPos = decoder->mAudioStart;
+    decoder->mEndOfPages = false;
+}
+
+uint32_t AUD_ReadVorbisDecoder(VorbisDecoder* decoder, uint8_t* dst, uint32_t maxBytes)
+{
+    if (!decoder->mOpen)
+    {
+        return 0;
+    }
+
+    const uint32_t numChannels = decoder->mFormat.mNumChannels;
+    const uint32_t bytesPerSample = decoder->mFormat.mBytesPerSample;
+    const uint32_t maxFrames = maxBytes / (numChannels * bytesPerSample);
+    uint32_t numFrames = 0;
+
+    while (numFrames < maxFrames)
+    {
+        // Drain any decoded samples first, then packets, then pages, then feed more input.
+        float** pcm = nullptr;
+        int32_t samples = vorbis_synthesis_pcmout(&decoder->mDspState, &pcm);
+
+        if (samples > 0)
+        {
+            uint32_t count = glm::min(uint32_t(samples), maxFrames - numFrames);
+
+            for (uint32_t c = 0; c < numChannels; ++c)
+            {
+                const float* mono = pcm[c];
+                uint8_t* out = dst + (numFrames * numChannels + c) * bytesPerSample;
+
+                for (uint32_t j = 0; j < count; ++j)
+                {
+                    int32_t val = glm::clamp((int32_t)floor(mono[j] * 32767.f + .5f), -32768, 32767);
+
+                    if (bytesPerSample == 1)
+                    {
+                        *out = (uint8_t)((val + 32768) >> 8);
+                    }
+                    else
+                    {
+                        int16_t val16 = (int16_t)val;
+#if PLATFORM_DOLPHIN
+                        Swap16(val16);
+#endif
+                        memcpy(out, &val16, sizeof(int16_t));
+                    }
+
+                    out += numChannels * bytesPerSample;
+                }
+            }
+
+            vorbis_synthesis_read(&decoder->mDspState, count);
+            numFrames += count;
+            continue;
+        }
+
+        ogg_packet op;
+        int result = ogg_stream_packetout(&decoder->mStreamState, &op);
+
+        if (result != 0)
+        {
+            if (result > 0 && vorbis_synthesis(&decoder->mBlock, &op) == 0)
+            {
+                vorbis_synthesis_blockin(&decoder->mDspState, &decoder->mBlock);
+            }
+
+            continue;
+        }
+
+        if (decoder->mEndOfPages)
+        {
+            break;
+        }
+
+        ogg_page og;
+        result = ogg_sync_pageout(&decoder->mSyncState, &og);
+
+        if (result > 0)
+        {
+            ogg_stream_pagein(&decoder->mStreamState, &og);
+            decoder->mEndOfPages = (ogg_page_eos(&og) != 0);
+        }
+        else if (result == 0 && FeedVorbisDecoder(decoder) == 0)
+        {
+            decoder->mEndOfPages = true;
+        }
+    }
+
+    return numFrames * numChannels * bytesPerSample;
+}
@@ -38,3 +38,12 @@ void AUD_ProcessWaveBuffer(SoundWave* soundWave);
 // Platform Independent
 void AUD_EncodeVorbis(Stream& inStream, Stream& outStream, PcmFormat format);
 void AUD_DecodeVorbis(Stream& inStream, Stream& outStream, PcmFormat format);
+
+// Incremental Vorbis decoding for streamed sound waves. The decoder reads directly from data,
+// which must outlive it. AUD_ReadVorbisDecoder returns the number of bytes written, 0 at the end of the stream.
+// AUD_ResetVorbisDecoder rewinds to the first audio packet without reparsing the headers or allocating.
+struct VorbisDecoder;
+VorbisDecoder* AUD_CreateVorbisDecoder(const uint8_t* data, uint32_t size, PcmFormat format);
+void AUD_DestroyVorbisDecoder(VorbisDecoder* decoder);
+void AUD_ResetVorbisDecoder(VorbisDecoder* decoder);
+uint32_t AUD_ReadVorbisDecoder(VorbisDecoder* decoder, uint8_t* dst, uint32_t maxBytes);
@@ -10,4 +10,12 @@
 #define AUDIO_MAX_VOICES 8
 #elif PLATFORM_3DS
 #define AUDIO_MAX_VOICES 8
-#endif
\ No newline at end of file
+#endif
+
+// Platforms that can play compressed sound waves by decoding them incrementally.
+// Elsewhere, streamed sound waves are fully decoded at load time.
+#if PLATFORM_LINUX
+#define AUDIO_STREAMING_SUPPORTED 1
+#else
+#define AUDIO_STREAMING_SUPPORTED 0
+#endif
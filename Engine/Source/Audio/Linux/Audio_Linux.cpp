@@ -7,13 +7,31 @@
 #include "Assets/SoundWave.h"
 #include "Log.h"
 #include "Maths.h"
+#include "Profiler.h"
 
 #include <alsa/asoundlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include <atomic>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define AUDIO_MIX_SSE 1
+#else
+#define AUDIO_MIX_SSE 0
+#endif
+
+#define AUDIO_MIX_RATE 44100
+#define AUDIO_COMMAND_QUEUE_SIZE 256
+#define AUDIO_MIX_WAIT_MS 20
+#define AUDIO_STREAM_BUFFER_FRAMES 8192
 
 snd_pcm_t* sSoundDevice = nullptr;
 snd_pcm_uframes_t sPlaybackFrames = 0;
 uint32_t sMixBufferLen = 0;
 int16_t* sMixBuffer = nullptr;
+float* sMixAccumBuffer = nullptr;
 
 struct SoundVoice
 {
@@ -24,14 +42,675 @@ struct SoundVoice
     uint8_t* mSrcBuffer = nullptr;
     uint32_t mSrcBufferLen = 0;
     uint32_t mSrcFrames = 0;
-    float mCurFrame = 0;
+    double mCurFrame = 0;
     uint32_t mNumChannels = 2;
     uint32_t mBytesPerSample = 2;
+    uint32_t mFormatIndex = 0;
+    uint32_t mSerial = 0;
     bool mLoop = false;
     bool mActive = false;
+
+    // Streamed voices decode into sStreamBuffers[voice] and mix from [mStreamStart, mStreamEnd).
+    VorbisDecoder* mDecoder = nullptr;
+    uint32_t mStreamStart = 0;
+    uint32_t mStreamEnd = 0;
+    bool mStreamEnded = false;
+};
+
+enum class AudioCommandType : uint8_t
+{
+    Play,
+    Stop,
+    SetVolume,
+    SetPitch
 };
 
+struct AudioCommand
+{
+    AudioCommandType mType = AudioCommandType::Stop;
+    uint32_t mVoiceIndex = 0;
+    SoundVoice mVoice;
+};
+
+// Voices are owned by the mixer thread once it is running. The game thread only
+// talks to it through the single-producer / single-consumer command queue.
 static SoundVoice sVoices[AUDIO_MAX_VOICES];
+static uint8_t* sStreamBuffers[AUDIO_MAX_VOICES] = {};
+static AudioCommand sCommands[AUDIO_COMMAND_QUEUE_SIZE];
+static std::atomic<uint32_t> sCommandWrite { 0 };
+static std::atomic<uint32_t> sCommandRead { 0 };
+
+// Game thread view of each voice. A voice is playing until the mixer reports that
+// the serial it was started with has reached the end of its buffer.
+static bool sVoicePlaying[AUDIO_MAX_VOICES] = {};
+static uint32_t sVoiceSerial[AUDIO_MAX_VOICES] = {};
+static const uint8_t* sVoiceBuffers[AUDIO_MAX_VOICES] = {};
+static std::atomic<uint32_t> sVoiceFinishedSerial[AUDIO_MAX_VOICES];
+static uint32_t sNextSerial = 1;
+
+// Decoders are created and destroyed on the game thread so the mixer never allocates or frees.
+// A decoder replaced by a Play / Stop command is retired until the mixer has read that command.
+struct RetiredDecoder
+{
+    VorbisDecoder* mDecoder = nullptr;
+    uint32_t mCommandIndex = 0;
+};
+
+static VorbisDecoder* sVoiceDecoders[AUDIO_MAX_VOICES] = {};
+static std::vector<RetiredDecoder> sRetiredDecoders;
+
+// Commands that didn't fit in the queue. They are moved into it in order as the mixer catches up.
+static std::vector<AudioCommand> sOverflowCommands;
+
+static ThreadObject* sMixThread = nullptr;
+static std::atomic<bool> sMixRunning { false };
+static std::atomic<uint32_t> sMixEpoch { 0 };
+static std::atomic<uint64_t> sMixTime { 0 };
+static std::atomic<uint64_t> sMixFrames { 0 };
+
+typedef void(*MixUnitStepFP)(const SoundVoice& voice, float* dst, uint32_t numFrames, uint32_t srcFrame);
+typedef void(*MixResampledFP)(const SoundVoice& voice, float* dst, uint32_t numFrames, double srcFrame, double srcStep);
+
+template<typename T>
+static inline float ReadSample(const T* src, uint32_t index);
+
+template<>
+inline float ReadSample<uint8_t>(const uint8_t* src, uint32_t index)
+{
+    // Convert from uint8_t to the int16_t range
+    return float(src[index]) * 256.0f - 32767.0f;
+}
+
+template<>
+inline float ReadSample<int16_t>(const int16_t* src, uint32_t index)
+{
+    return float(src[index]);
+}
+
+template<typename T, uint32_t C>
+static void MixUnitStep(const SoundVoice& voice, float* dst, uint32_t numFrames, uint32_t srcFrame)
+{
+    const T* src = ((const T*)voice.mSrcBuffer) + srcFrame * C;
+    const float volL = voice.mVolumeL;
+    const float volR = voice.mVolumeR;
+
+    for (uint32_t i = 0; i < numFrames; ++i)
+    {
+        float sampleL = ReadSample<T>(src, i * C);
+        float sampleR = (C == 2) ? ReadSample<T>(src, i * C + 1) : sampleL;
+        dst[i * 2 + 0] += sampleL * volL;
+        dst[i * 2 + 1] += sampleR * volR;
+    }
+}
+
+#if AUDIO_MIX_SSE
+template<>
+void MixUnitStep<int16_t, 2>(const SoundVoice& voice, float* dst, uint32_t numFrames, uint32_t srcFrame)
+{
+    const int16_t* src = ((const int16_t*)voice.mSrcBuffer) + srcFrame * 2;
+    const __m128 vol = _mm_setr_ps(voice.mVolumeL, voice.mVolumeR, voice.mVolumeL, voice.mVolumeR);
+    uint32_t i = 0;
+
+    // 4 stereo frames per iteration
+    for (; i + 4 <= numFrames; i += 4)
+    {
+        __m128i samples = _mm_loadu_si128((const __m128i*)(src + i * 2));
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+        __m128 dstLo = _mm_loadu_ps(dst + i * 2);
+        __m128 dstHi = _mm_loadu_ps(dst + i * 2 + 4);
+        _mm_storeu_ps(dst + i * 2, _mm_add_ps(dstLo, _mm_mul_ps(_mm_cvtepi32_ps(lo), vol)));
+        _mm_storeu_ps(dst + i * 2 + 4, _mm_add_ps(dstHi, _mm_mul_ps(_mm_cvtepi32_ps(hi), vol)));
+    }
+
+    for (; i < numFrames; ++i)
+    {
+        dst[i * 2 + 0] += float(src[i * 2 + 0]) * voice.mVolumeL;
+        dst[i * 2 + 1] += float(src[i * 2 + 1]) * voice.mVolumeR;
+    }
+}
+
+template<>
+void MixUnitStep<int16_t, 1>(const SoundVoice& voice, float* dst, uint32_t numFrames, uint32_t srcFrame)
+{
+    const int16_t* src = ((const int16_t*)voice.mSrcBuffer) + srcFrame;
+    const __m128 vol = _mm_setr_ps(voice.mVolumeL, voice.mVolumeR, voice.mVolumeL, voice.mVolumeR);
+    uint32_t i = 0;
+
+    // 4 mono frames per iteration, each duplicated into left and right
+    for (; i + 4 <= numFrames; i += 4)
+    {
+        __m128i samples = _mm_loadl_epi64((const __m128i*)(src + i));
+        __m128 mono = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16));
+        __m128 dstLo = _mm_loadu_ps(dst + i * 2);
+        __m128 dstHi = _mm_loadu_ps(dst + i * 2 + 4);
+        _mm_storeu_ps(dst + i * 2, _mm_add_ps(dstLo, _mm_mul_ps(_mm_unpacklo_ps(mono, mono), vol)));
+        _mm_storeu_ps(dst + i * 2 + 4, _mm_add_ps(dstHi, _mm_mul_ps(_mm_unpackhi_ps(mono, mono), vol)));
+    }
+
+    for (; i < numFrames; ++i)
+    {
+        float sample = float(src[i]);
+        dst[i * 2 + 0] += sample * voice.mVolumeL;
+        dst[i * 2 + 1] += sample * voice.mVolumeR;
+    }
+}
+#endif
+
+// Caller guarantees that frame (srcFrame + i * srcStep) + 1 is in bounds for every i.
+template<typename T, uint32_t C>
+static void MixResampled(const SoundVoice& voice, float* dst, uint32_t numFrames, double srcFrame, double srcStep)
+{
+    const T* src = (const T*)voice.mSrcBuffer;
+    const float volL = voice.mVolumeL;
+    const float volR = voice.mVolumeR;
+
+    for (uint32_t i = 0; i < numFrames; ++i)
+    {
+        double frame = srcFrame + i * srcStep;
+        uint32_t index = uint32_t(frame);
+        float alpha = float(frame - index);
+
+        float l0 = ReadSample<T>(src, index * C);
+        float l1 = ReadSample<T>(src, (index + 1) * C);
+        float r0 = (C == 2) ? ReadSample<T>(src, index * C + 1) : l0;
+        float r1 = (C == 2) ? ReadSample<T>(src, (index + 1) * C + 1) : l1;
+
+        dst[i * 2 + 0] += (l0 + (l1 - l0) * alpha) * volL;
+        dst[i * 2 + 1] += (r0 + (r1 - r0) * alpha) * volR;
+    }
+}
+
+// Indexed by SoundVoice::mFormatIndex
+static const MixUnitStepFP sMixUnitStepFuncs[4] =
+{
+    MixUnitStep<uint8_t, 1>,
+    MixUnitStep<uint8_t, 2>,
+    MixUnitStep<int16_t, 1>,
+    MixUnitStep<int16_t, 2>
+};
+
+static const MixResampledFP sMixResampledFuncs[4] =
+{
+    MixResampled<uint8_t, 1>,
+    MixResampled<uint8_t, 2>,
+    MixResampled<int16_t, 1>,
+    MixResampled<int16_t, 2>
+};
+
+static void ReadFrame(const SoundVoice& voice, uint32_t frame, float& outL, float& outR)
+{
+    outL = 0.0f;
+    outR = 0.0f;
+
+    if (frame >= voice.mSrcFrames)
+    {
+        return;
+    }
+
+    if (voice.mBytesPerSample == 1)
+    {
+        const uint8_t* src = voice.mSrcBuffer;
+        outL = ReadSample<uint8_t>(src, frame * voice.mNumChannels);
+        outR = (voice.mNumChannels == 2) ? ReadSample<uint8_t>(src, frame * 2 + 1) : outL;
+    }
+    else
+    {
+        const int16_t* src = (const int16_t*)voice.mSrcBuffer;
+        outL = ReadSample<int16_t>(src, frame * voice.mNumChannels);
+        outR = (voice.mNumChannels == 2) ? ReadSample<int16_t>(src, frame * 2 + 1) : outL;
+    }
+}
+
+// Mixes the last frame of the source, which interpolates towards the first frame when looping.
+static void MixEdgeFrame(const SoundVoice& voice, float* dst, double srcFrame)
+{
+    uint32_t index0 = uint32_t(srcFrame);
+    uint32_t index1 = index0 + 1;
+    float alpha = float(srcFrame - index0);
+
+    if (voice.mLoop && index1 >= voice.mSrcFrames)
+    {
+        index1 -= voice.mSrcFrames;
+    }
+
+    float l0, r0, l1, r1;
+    ReadFrame(voice, index0, l0, r0);
+    ReadFrame(voice, index1, l1, r1);
+
+    dst[0] += (l0 + (l1 - l0) * alpha) * voice.mVolumeL;
+    dst[1] += (r0 + (r1 - r0) * alpha) * voice.mVolumeR;
+}
+
+// Number of consecutive dst frames (up to maxFrames) whose interpolation pair stays below limitFrame.
+static uint32_t GetSafeFrameCount(double srcFrame, double srcStep, double limitFrame, uint32_t maxFrames)
+{
+    if (srcFrame >= limitFrame)
+    {
+        return 0;
+    }
+
+    if (srcStep <= 0.0)
+    {
+        return maxFrames;
+    }
+
+    double count = ceil((limitFrame - srcFrame) / srcStep);
+    uint32_t numFrames = (count >= double(maxFrames)) ? maxFrames : uint32_t(count);
+
+    while (numFrames > 0 && srcFrame + (numFrames - 1) * srcStep >= limitFrame)
+    {
+        --numFrames;
+    }
+
+    return numFrames;
+}
+
+// Mixes frames from voice.mSrcBuffer starting at voice.mCurFrame and advances mCurFrame.
+static void MixSource(SoundVoice& voice, float* dst, uint32_t frames)
+{
+    OCT_ASSERT(voice.mSrcFrames > 0);
+
+    // The src voice may move at a faster or slower pace based on the pitch value,
+    // so we walk it with a fractional step and interpolate between frames.
+    const double srcStep = glm::max(double(voice.mPitch), 0.0) * (voice.mSampleRate / double(AUDIO_MIX_RATE));
+    const double srcFrames = double(voice.mSrcFrames);
+    const double lastFrame = srcFrames - 1.0;
+    const bool unitStep = (srcStep == 1.0);
+
+    double srcFrame = voice.mCurFrame;
+    uint32_t dstFrame = 0;
+
+    while (dstFrame < frames)
+    {
+        if (srcFrame >= srcFrames)
+        {
+            if (!voice.mLoop)
+            {
+                break;
+            }
+
+            srcFrame = fmod(srcFrame, srcFrames);
+        }
+
+        uint32_t numFrames = GetSafeFrameCount(srcFrame, srcStep, lastFrame, frames - dstFrame);
+
+        if (numFrames > 0)
+        {
+            if (unitStep && srcFrame == floor(srcFrame))
+            {
+                sMixUnitStepFuncs[voice.mFormatIndex](voice, dst + dstFrame * 2, numFrames, uint32_t(srcFrame));
+            }
+            else
+            {
+                sMixResampledFuncs[voice.mFormatIndex](voice, dst + dstFrame * 2, numFrames, srcFrame, srcStep);
+            }
+
+            srcFrame += numFrames * srcStep;
+            dstFrame += numFrames;
+        }
+        else
+        {
+            MixEdgeFrame(voice, dst + dstFrame * 2, srcFrame);
+            srcFrame += srcStep;
+            dstFrame++;
+        }
+    }
+
+    voice.mCurFrame = srcFrame;
+}
+
+// Tops up the voice's decode buffer so it holds at least numFrames frames, unless the stream has ended.
+static void FillStreamBuffer(uint32_t voiceIndex, uint32_t numFrames)
+{
+    SoundVoice& voice = sVoices[voiceIndex];
+    uint8_t* buffer = sStreamBuffers[voiceIndex];
+    const uint32_t frameBytes = voice.mBytesPerSample * voice.mNumChannels;
+    const uint32_t neededBytes = numFrames * frameBytes;
+
+    if (voice.mStreamEnd - voice.mStreamStart >= neededBytes || voice.mStreamEnded)
+    {
+        return;
+    }
+
+    memmove(buffer, buffer + voice.mStreamStart, voice.mStreamEnd - voice.mStreamStart);
+    voice.mStreamEnd -= voice.mStreamStart;
+    voice.mStreamStart = 0;
+
+    bool rewound = false;
+
+    while (voice.mStreamEnd < neededBytes && !voice.mStreamEnded)
+    {
+        uint32_t bytes = AUD_ReadVorbisDecoder(voice.mDecoder, buffer + voice.mStreamEnd, neededBytes - voice.mStreamEnd);
+        voice.mStreamEnd += bytes;
+
+        if (bytes > 0)
+        {
+            rewound = false;
+        }
+        else if (voice.mLoop && !rewound)
+        {
+            AUD_ResetVorbisDecoder(voice.mDecoder);
+            rewound = true;
+        }
+        else
+        {
+            voice.mStreamEnded = true;
+        }
+    }
+}
+
+static void MixStreamVoice(uint32_t voiceIndex, float* dst, uint32_t frames)
+{
+    SoundVoice& voice = sVoices[voiceIndex];
+    const uint32_t frameBytes = voice.mBytesPerSample * voice.mNumChannels;
+    const double srcStep = glm::max(double(voice.mPitch), 0.0) * (voice.mSampleRate / double(AUDIO_MIX_RATE));
+
+    // mCurFrame only holds the fractional position into the first buffered frame.
+    // One extra frame is needed to interpolate the last output frame.
+    double neededFrames = ceil(voice.mCurFrame + frames * srcStep) + 1.0;
+    FillStreamBuffer(voiceIndex, uint32_t(glm::min(neededFrames, double(AUDIO_STREAM_BUFFER_FRAMES))));
+
+    SoundVoice source = voice;
+    source.mSrcBuffer = sStreamBuffers[voiceIndex] + voice.mStreamStart;
+    source.mSrcFrames = (voice.mStreamEnd - voice.mStreamStart) / frameBytes;
+    source.mLoop = false;
+
+    if (source.mSrcFrames > 0)
+    {
+        MixSource(source, dst, frames);
+
+        uint32_t consumedFrames = uint32_t(glm::min(floor(source.mCurFrame), double(source.mSrcFrames)));
+        double remainder = source.mCurFrame - consumedFrames;
+
+        voice.mStreamStart += consumedFrames * frameBytes;
+        voice.mCurFrame = (remainder < 1.0) ? remainder : 0.0;
+    }
+
+    if (voice.mStreamEnded && voice.mStreamStart >= voice.mStreamEnd)
+    {
+        // The game thread destroys the decoder once it sees the finished serial.
+        voice.mDecoder = nullptr;
+        voice.mActive = false;
+        sVoiceFinishedSerial[voiceIndex].store(voice.mSerial, std::memory_order_release);
+    }
+}
+
+static void MixVoice(uint32_t voiceIndex, float* dst, uint32_t frames)
+{
+    SoundVoice& voice = sVoices[voiceIndex];
+
+    if (voice.mDecoder != nullptr)
+    {
+        MixStreamVoice(voiceIndex, dst, frames);
+        return;
+    }
+
+    MixSource(voice, dst, frames);
+
+    if (!voice.mLoop && voice.mCurFrame >= double(voice.mSrcFrames))
+    {
+        voice.mActive = false;
+        sVoiceFinishedSerial[voiceIndex].store(voice.mSerial, std::memory_order_release);
+    }
+}
+
+static void ConvertMixBuffer(const float* src, int16_t* dst, uint32_t numSamples)
+{
+    uint32_t i = 0;
+
+#if AUDIO_MIX_SSE
+    // Pack with signed saturation, which also clamps to the int16 range.
+    for (; i + 8 <= numSamples; i += 8)
+    {
+        __m128i lo = _mm_cvtps_epi32(_mm_loadu_ps(src + i));
+        __m128i hi = _mm_cvtps_epi32(_mm_loadu_ps(src + i + 4));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packs_epi32(lo, hi));
+    }
+#endif
+
+    for (; i < numSamples; ++i)
+    {
+        dst[i] = (int16_t)glm::clamp(int32_t(src[i]), -32768, 32767);
+    }
+}
+
+static void MixFrames(uint32_t frames)
+{
+    memset(sMixAccumBuffer, 0, frames * 2 * sizeof(float));
+
+    for (uint32_t i = 0; i < AUDIO_MAX_VOICES; ++i)
+    {
+        if (sVoices[i].mActive)
+        {
+            MixVoice(i, sMixAccumBuffer, frames);
+        }
+    }
+
+    ConvertMixBuffer(sMixAccumBuffer, sMixBuffer, frames * 2);
+}
+
+static void ApplyCommand(const AudioCommand& cmd)
+{
+    SoundVoice& voice = sVoices[cmd.mVoiceIndex];
+
+    switch (cmd.mType)
+    {
+    case AudioCommandType::Play:
+        voice = cmd.mVoice;
+        break;
+    case AudioCommandType::Stop:
+        voice.mDecoder = nullptr;
+        voice.mActive = false;
+        voice.mSrcBuffer = nullptr;
+        break;
+    case AudioCommandType::SetVolume:
+        voice.mVolumeL = cmd.mVoice.mVolumeL;
+        voice.mVolumeR = cmd.mVoice.mVolumeR;
+        break;
+    case AudioCommandType::SetPitch:
+        voice.mPitch = cmd.mVoice.mPitch;
+        break;
+    }
+}
+
+static void ProcessCommands()
+{
+    uint32_t read = sCommandRead.load(std::memory_order_relaxed);
+    uint32_t write = sCommandWrite.load(std::memory_order_acquire);
+
+    while (read != write)
+    {
+        ApplyCommand(sCommands[read % AUDIO_COMMAND_QUEUE_SIZE]);
+        ++read;
+    }
+
+    sCommandRead.store(read, std::memory_order_release);
+}
+
+static bool TryPushCommand(const AudioCommand& cmd)
+{
+    uint32_t write = sCommandWrite.load(std::memory_order_relaxed);
+
+    if (write - sCommandRead.load(std::memory_order_acquire) >= AUDIO_COMMAND_QUEUE_SIZE)
+    {
+        return false;
+    }
+
+    sCommands[write % AUDIO_COMMAND_QUEUE_SIZE] = cmd;
+    sCommandWrite.store(write + 1, std::memory_order_release);
+    return true;
+}
+
+static void FlushOverflowCommands()
+{
+    uint32_t numPushed = 0;
+
+    while (numPushed < sOverflowCommands.size() &&
+        TryPushCommand(sOverflowCommands[numPushed]))
+    {
+        ++numPushed;
+    }
+
+    sOverflowCommands.erase(sOverflowCommands.begin(), sOverflowCommands.begin() + numPushed);
+}
+
+static void PushCommand(const AudioCommand& cmd)
+{
+    if (!sMixRunning.load(std::memory_order_acquire))
+    {
+        ApplyCommand(cmd);
+        return;
+    }
+
+    FlushOverflowCommands();
+
+    if (sOverflowCommands.empty() && TryPushCommand(cmd))
+    {
+        return;
+    }
+
+    // The queue is full. Rather than waiting on the mixer, hold the command until the next flush.
+    // Volume and pitch changes only need their latest value, so they replace an identical pending one.
+    AudioCommand* last = sOverflowCommands.empty() ? nullptr : &sOverflowCommands.back();
+
+    if (last != nullptr &&
+        last->mType == cmd.mType &&
+        last->mVoiceIndex == cmd.mVoiceIndex &&
+        (cmd.mType == AudioCommandType::SetVolume || cmd.mType == AudioCommandType::SetPitch))
+    {
+        *last = cmd;
+    }
+    else
+    {
+        sOverflowCommands.push_back(cmd);
+    }
+}
+
+// Index that the next pushed command will have in the command queue.
+static uint32_t GetNextCommandIndex()
+{
+    return sCommandWrite.load(std::memory_order_relaxed) + uint32_t(sOverflowCommands.size());
+}
+
+// Call before pushing a command that replaces the voice's decoder.
+static void RetireVoiceDecoder(uint32_t voiceIndex)
+{
+    VorbisDecoder* decoder = sVoiceDecoders[voiceIndex];
+    sVoiceDecoders[voiceIndex] = nullptr;
+
+    if (decoder == nullptr)
+    {
+        return;
+    }
+
+    if (!sMixRunning.load(std::memory_order_acquire))
+    {
+        AUD_DestroyVorbisDecoder(decoder);
+        return;
+    }
+
+    RetiredDecoder retired;
+    retired.mDecoder = decoder;
+    retired.mCommandIndex = GetNextCommandIndex();
+    sRetiredDecoders.push_back(retired);
+}
+
+static void DestroyFinishedDecoders()
+{
+    for (uint32_t i = 0; i < AUDIO_MAX_VOICES; ++i)
+    {
+        if (sVoiceDecoders[i] != nullptr &&
+            sVoiceFinishedSerial[i].load(std::memory_order_acquire) == sVoiceSerial[i])
+        {
+            AUD_DestroyVorbisDecoder(sVoiceDecoders[i]);
+            sVoiceDecoders[i] = nullptr;
+        }
+    }
+}
+
+static void DestroyRetiredDecoders()
+{
+    uint32_t read = sCommandRead.load(std::memory_order_acquire);
+
+    for (int32_t i = int32_t(sRetiredDecoders.size()) - 1; i >= 0; --i)
+    {
+        // Indices wrap, so compare the distance rather than the values.
+        if (read - sRetiredDecoders[i].mCommandIndex - 1 < 0x80000000u)
+        {
+            AUD_DestroyVorbisDecoder(sRetiredDecoders[i].mDecoder);
+            sRetiredDecoders.erase(sRetiredDecoders.begin() + i);
+        }
+    }
+}
+
+// Blocks until the mixer has started a new pass, after which it has seen every command queued so far.
+static void SyncMixer()
+{
+    if (!sMixRunning.load(std::memory_order_acquire))
+    {
+        return;
+    }
+
+    while (!sOverflowCommands.empty())
+    {
+        FlushOverflowCommands();
+        SYS_Sleep(1);
+    }
+
+    uint32_t epoch = sMixEpoch.load(std::memory_order_acquire);
+
+    while (sMixRunning.load(std::memory_order_acquire) &&
+        sMixEpoch.load(std::memory_order_acquire) == epoch)
+    {
+        SYS_Sleep(1);
+    }
+}
+
+static ThreadFuncRet MixThreadFunc(void* in)
+{
+    // Try to run the mixer with real-time priority so that it isn't starved by the game threads.
+    // This usually requires rtkit or CAP_SYS_NICE, so failing here is expected and harmless.
+    sched_param schedParam = {};
+    schedParam.sched_priority = sched_get_priority_min(SCHED_FIFO);
+    pthread_setschedparam(pthread_self(), SCHED_FIFO, &schedParam);
+
+    while (sMixRunning.load(std::memory_order_acquire))
+    {
+        ProcessCommands();
+
+        snd_pcm_wait(sSoundDevice, AUDIO_MIX_WAIT_MS);
+
+        int32_t frames = (int32_t) snd_pcm_avail(sSoundDevice);
+        frames = glm::min(int32_t(sMixBufferLen) / 4, frames);
+
+        if (frames > 0)
+        {
+            uint64_t startTime = SYS_GetTimeMicroseconds();
+            MixFrames(uint32_t(frames));
+            sMixTime.fetch_add(SYS_GetTimeMicroseconds() - startTime, std::memory_order_relaxed);
+            sMixFrames.fetch_add(uint64_t(frames), std::memory_order_relaxed);
+        }
+
+        snd_pcm_sframes_t framesWritten = 0;
+        // We've generated the frames we need for this pass, so now we just need to send it to the audio driver.
+        if (frames < 0 ||
+            (frames > 0 && (framesWritten = snd_pcm_writei(sSoundDevice, sMixBuffer, frames)) == -EPIPE))
+        {
+            //LogWarning("Audio buffer underrun.");
+            snd_pcm_prepare(sSoundDevice);
+        }
+        else if (framesWritten < 0)
+        {
+            LogError("Can't write to PCM device. %s", snd_strerror(framesWritten));
+            snd_pcm_recover(sSoundDevice, (int) framesWritten, 1);
+        }
+
+        sMixEpoch.fetch_add(1, std::memory_order_release);
+    }
+
+    THREAD_RETURN();
+}
 
 void AUD_Initialize()
 {
@@ -64,7 +743,7 @@ void AUD_Initialize()
     }
 
     // Create enough buffer room for a 30 fps update rate.
-    sPlaybackFrames = snd_pcm_uframes_t((1 / 15.0f) * 44100);
+    sPlaybackFrames = snd_pcm_uframes_t((1 / 15.0f) * AUDIO_MIX_RATE);
 
     err = snd_pcm_hw_params_set_rate_resample(sSoundDevice, hw_params, 1);
     err = snd_pcm_hw_params_set_access(sSoundDevice, hw_params, SND_PCM_ACCESS_RW_INTERLEAVED);
@@ -72,7 +751,7 @@ void AUD_Initialize()
     err = snd_pcm_hw_params_set_channels(sSoundDevice, hw_params, 2);
     err = snd_pcm_hw_params_set_buffer_size(sSoundDevice, hw_params, sPlaybackFrames);
 
-    unsigned int playbackRate = 44100;
+    unsigned int playbackRate = AUDIO_MIX_RATE;
     err = snd_pcm_hw_params_set_rate_near(sSoundDevice, hw_params, &playbackRate, 0);
 
     err = snd_pcm_hw_params(sSoundDevice, hw_params);
@@ -93,156 +772,80 @@ void AUD_Initialize()
     sMixBufferLen = sPlaybackFrames * 4; // ( 2 samples (L/R) * 2 bytes per sample)
     sMixBuffer = new int16_t[sMixBufferLen / 2];
     memset(sMixBuffer, 0, sMixBufferLen);
+    sMixAccumBuffer = (float*)SYS_AlignedMalloc(sPlaybackFrames * 2 * sizeof(float), 16);
+
+    for (uint32_t i = 0; i < AUDIO_MAX_VOICES; ++i)
+    {
+        // Enough for 2 channel, 16 bit streams.
+        sStreamBuffers[i] = (uint8_t*)SYS_AlignedMalloc(AUDIO_STREAM_BUFFER_FRAMES * 4, 16);
+    }
+
     snd_pcm_writei(sSoundDevice, sMixBuffer, sPlaybackFrames);
     //snd_pcm_start(sSoundDevice);
 
     LogDebug("PCM name: '%s'", snd_pcm_name(sSoundDevice));
     LogDebug("PCM state: %s", snd_pcm_state_name(snd_pcm_state(sSoundDevice)));
+
+    // Mix on a dedicated thread so that main thread hitches don't cause underruns.
+    sMixRunning = true;
+    sMixThread = SYS_CreateThread(MixThreadFunc, nullptr);
 }
 
 void AUD_Shutdown()
 {
+    if (sMixThread != nullptr)
+    {
+        sMixRunning = false;
+        SYS_JoinThread(sMixThread);
+        SYS_DestroyThread(sMixThread);
+        sMixThread = nullptr;
+    }
+
     delete [] sMixBuffer;
     sMixBuffer = nullptr;
 
-    if (sSoundDevice != nullptr)
+    SYS_AlignedFree(sMixAccumBuffer);
+    sMixAccumBuffer = nullptr;
+
+    // Every decoder is either still assigned to a voice or retired.
+    sOverflowCommands.clear();
+
+    for (uint32_t i = 0; i < sRetiredDecoders.size(); ++i)
     {
-        snd_pcm_close(sSoundDevice);
+        AUD_DestroyVorbisDecoder(sRetiredDecoders[i].mDecoder);
     }
-}
 
-void AUD_Update()
-{   
-    int32_t frames = (int32_t) snd_pcm_avail(sSoundDevice);
-    frames = glm::min(int32_t(sMixBufferLen) / 4, frames);
-
-    //LogDebug("Frames to mix: %d", frames);
-    //LogDebug("PCM state: %s", snd_pcm_state_name(snd_pcm_state(sSoundDevice)));
+    sRetiredDecoders.clear();
 
-    if (frames > 0)
+    for (uint32_t i = 0; i < AUDIO_MAX_VOICES; ++i)
     {
-        // We need to mix an audio buffer
-        //OCT_ASSERT(frames * 4  <= int32_t(sMixBufferLen));
-        memset(sMixBuffer, 0, frames * 4);
+        AUD_DestroyVorbisDecoder(sVoiceDecoders[i]);
+        sVoiceDecoders[i] = nullptr;
+        sVoices[i].mDecoder = nullptr;
 
-        for (uint32_t i = 0; i < AUDIO_MAX_VOICES; ++i)
-        {
-            if (sVoices[i].mActive)
-            {
-                SoundVoice& voice = sVoices[i];
-                OCT_ASSERT(voice.mSrcFrames > 0);
-
-                // If the voice is active, that means we need to mix *frames* number of frames
-                // into the mix buffer. The src voice may move at a faster or slower pace based on the 
-                // pitch value, so we will need to interpolate between frames.
-
-                // TODO: Handle pitch
-                float srcDeltaFrame = 1 * voice.mPitch * (voice.mSampleRate / 44100.0f);
-
-                for (int32_t dstFrame = 0; dstFrame < frames; ++dstFrame)
-                {
-                    float srcFrameFloat = voice.mCurFrame + (dstFrame * srcDeltaFrame);
-
-                    int32_t srcFrames[2] = { int32_t(srcFrameFloat), int32_t(srcFrameFloat) + 1 };
-                    float frameInterpAlpha = fmod(srcFrameFloat, 1.0f);
-
-                    int16_t srcSampleL[2] = { 0, 0 };
-                    int16_t srcSampleR[2] = { 0, 0 };
-
-                    if (voice.mLoop)
-                    {
-                        if (srcFrames[0] >= int32_t(voice.mSrcFrames))
-                            srcFrames[0] = srcFrames[0] % voice.mSrcFrames;
-                        if (srcFrames[1] >= int32_t(voice.mSrcFrames))
-                            srcFrames[1] = srcFrames[1] % voice.mSrcFrames;
-                    }
-
-                    // Interpolate between the two src frames
-                    for (int32_t f = 0; f < 2; ++f)
-                    {
-                        int32_t frameIndex = srcFrames[f];
-
-                        if (frameIndex >= int32_t(voice.mSrcFrames))
-                        {
-                            srcSampleL[f] = 0;
-                            srcSampleR[f] = 0;
-                        }
-                        else if (voice.mNumChannels == 1)
-                        {
-                            // Use same src sample for left and right dst samples
-
-                            if (voice.mBytesPerSample == 1)
-                            {
-                                // uint8 samples
-                                // Convert from uint8_t to int16_t
-                                srcSampleL[f] = *((uint8_t*) (voice.mSrcBuffer + (frameIndex * 1 * 1)));
-                                srcSampleL[f] = srcSampleL[f] * 256 - 32767;
-                                srcSampleR[f] = srcSampleL[f];   
-                            }
-                            else
-                            {
-                                // int16 samples
-                                srcSampleL[f] = *((int16_t*) (voice.mSrcBuffer + (frameIndex * 1 * 2)));
-                                srcSampleR[f] = srcSampleL[f];
-                            }
-                        }
-                        else
-                        {
-                            if (voice.mBytesPerSample == 1)
-                            {
-                                // uint8 samples
-                                srcSampleL[f] = *((uint8_t*) (voice.mSrcBuffer + (frameIndex * 2 * 1)));
-                                srcSampleR[f] = *((uint8_t*) (voice.mSrcBuffer + (frameIndex * 2 * 1 + 1)));
-                                srcSampleL[f] = srcSampleL[f] * 256 - 32767;
-                                srcSampleR[f] = srcSampleR[f] * 256 - 32767;
-                            }
-                            else
-                            {
-                                // int16 samples
-                                srcSampleL[f] = *((int16_t*) (voice.mSrcBuffer + (frameIndex * 2 * 2)));
-                                srcSampleR[f] = *((int16_t*) (voice.mSrcBuffer + (frameIndex * 2 * 2 + 2)));
-                            }
-                        }
-                    }
-
-                    // We have four samples now, so now we need to linearly interpolate between the left and right channels
-                    // to get a final 2 samples that we will accumulate into the mix buffer.
-                    int32_t finalSampleL = (int32_t)glm::mix(srcSampleL[0], srcSampleL[1], frameInterpAlpha);
-                    int32_t finalSampleR = (int32_t)glm::mix(srcSampleR[0], srcSampleR[1], frameInterpAlpha);
-                    finalSampleL = int32_t(finalSampleL * voice.mVolumeL);
-                    finalSampleR = int32_t(finalSampleR * voice.mVolumeR);
-                    finalSampleL = glm::clamp(finalSampleL + (int32_t)sMixBuffer[dstFrame * 2 + 0], -32768, 32767);
-                    finalSampleR = glm::clamp(finalSampleR + (int32_t)sMixBuffer[dstFrame * 2 + 1], -32768, 32767);
-                    sMixBuffer[dstFrame * 2 + 0] = (int16_t)finalSampleL;
-                    sMixBuffer[dstFrame * 2 + 1] = (int16_t)finalSampleR;
-                }
-
-                // We've finished getting all of the samples for this voice. Increase the current sample value
-                // to keep track of where to pick up next frame. If the sound is looping we need to mod the frame value
-                // otherwise let the curFrame exceed the *voice.mSrcFrames* count so we can determine that it is finished playing.
-
-                voice.mCurFrame += (frames * srcDeltaFrame);
-
-                if (voice.mLoop)
-                {
-                    voice.mCurFrame = fmod(voice.mCurFrame, (float) voice.mSrcFrames);
-                }
-            }
-        }
+        SYS_AlignedFree(sStreamBuffers[i]);
+        sStreamBuffers[i] = nullptr;
     }
 
-    snd_pcm_sframes_t framesWritten = 0;
-    // We've generated the frames we need for this update, so now we just need to sent it to the audio driver.
-    if (frames < 0 ||
-        (frames > 0 && (framesWritten = snd_pcm_writei(sSoundDevice, sMixBuffer, frames)) == -EPIPE))
+    if (sSoundDevice != nullptr)
     {
-        //LogWarning("Audio buffer underrun.");
-        snd_pcm_prepare(sSoundDevice);
-    } 
-    else if (framesWritten < 0)
+        snd_pcm_close(sSoundDevice);
+    }
+}
+
+void AUD_Update()
+{
+    FlushOverflowCommands();
+    DestroyFinishedDecoders();
+    DestroyRetiredDecoders();
+
+    // Mixing happens on the mixer thread. Just report how expensive it has been.
+    uint64_t mixTime = sMixTime.exchange(0, std::memory_order_relaxed);
+    uint64_t mixFrames = sMixFrames.exchange(0, std::memory_order_relaxed);
+
+    if (mixFrames > 0)
     {
-        LogError("Can't write to PCM device. %s", snd_strerror(framesWritten));
-        return;
+        GetProfiler()->SetCounterStat("Audio Mix ns/frame", (mixTime * 1000.0f) / float(mixFrames));
     }
 }
 
@@ -255,48 +858,101 @@ void AUD_Play(
     float startTime,
     bool spatial)
 {
-    OCT_ASSERT(!sVoices[voiceIndex].mActive);
-
-    sVoices[voiceIndex].mActive = true;
-    sVoices[voiceIndex].mBytesPerSample = soundWave->GetBitsPerSample() / 8;
-    sVoices[voiceIndex].mCurFrame = 0.0f;
-    sVoices[voiceIndex].mLoop = loop;
-    sVoices[voiceIndex].mNumChannels = soundWave->GetNumChannels();
-    sVoices[voiceIndex].mPitch = pitch;
-    sVoices[voiceIndex].mSampleRate = soundWave->GetSampleRate();
-    sVoices[voiceIndex].mSrcBuffer = soundWave->GetWaveData();
-    sVoices[voiceIndex].mSrcBufferLen = soundWave->GetWaveDataSize();
-    sVoices[voiceIndex].mVolumeL = spatial ? 0.0f : volume;
-    sVoices[voiceIndex].mVolumeR = spatial ? 0.0f : volume;
-    
-    int32_t bytesPerFrame = sVoices[voiceIndex].mBytesPerSample * sVoices[voiceIndex].mNumChannels;
-    sVoices[voiceIndex].mSrcFrames = sVoices[voiceIndex].mSrcBufferLen / bytesPerFrame;
-
-    OCT_ASSERT(sVoices[voiceIndex].mSrcBufferLen % bytesPerFrame == 0);
+    OCT_ASSERT(!sVoicePlaying[voiceIndex]);
+
+    AudioCommand cmd;
+    cmd.mType = AudioCommandType::Play;
+    cmd.mVoiceIndex = voiceIndex;
+
+    SoundVoice& voice = cmd.mVoice;
+    voice.mActive = true;
+    voice.mBytesPerSample = soundWave->GetBitsPerSample() / 8;
+    voice.mCurFrame = 0.0;
+    voice.mLoop = loop;
+    voice.mNumChannels = soundWave->GetNumChannels();
+    voice.mPitch = pitch;
+    voice.mSampleRate = soundWave->GetSampleRate();
+    voice.mVolumeL = spatial ? 0.0f : volume;
+    voice.mVolumeR = spatial ? 0.0f : volume;
+    voice.mFormatIndex = (voice.mBytesPerSample == 2 ? 2 : 0) + (voice.mNumChannels == 2 ? 1 : 0);
+    voice.mSerial = sNextSerial++;
+
+    int32_t bytesPerFrame = voice.mBytesPerSample * voice.mNumChannels;
     OCT_ASSERT(bytesPerFrame > 0 &&
            bytesPerFrame <= 4);
+
+    bool playable = false;
+
+    RetireVoiceDecoder(voiceIndex);
+
+    if (soundWave->IsStreaming())
+    {
+        // Header parsing allocates, so do it here rather than on the mixer thread.
+        // The mixer thread reads from the decoder but it is still destroyed here.
+        PcmFormat format;
+        format.mNumChannels = voice.mNumChannels;
+        format.mBytesPerSample = voice.mBytesPerSample;
+        format.mSampleRate = voice.mSampleRate;
+        voice.mDecoder = AUD_CreateVorbisDecoder(soundWave->GetCompressedData(), soundWave->GetCompressedSize(), format);
+
+        playable = (voice.mDecoder != nullptr);
+        sVoiceDecoders[voiceIndex] = voice.mDecoder;
+        sVoiceBuffers[voiceIndex] = soundWave->GetCompressedData();
+    }
+    else
+    {
+        voice.mSrcBuffer = soundWave->GetWaveData();
+        voice.mSrcBufferLen = soundWave->GetWaveDataSize();
+        voice.mSrcFrames = voice.mSrcBufferLen / bytesPerFrame;
+        OCT_ASSERT(voice.mSrcBufferLen % bytesPerFrame == 0);
+
+        playable = (voice.mSrcFrames > 0);
+        sVoiceBuffers[voiceIndex] = voice.mSrcBuffer;
+    }
+
+    sVoicePlaying[voiceIndex] = playable;
+    sVoiceSerial[voiceIndex] = voice.mSerial;
+
+    if (playable)
+    {
+        PushCommand(cmd);
+    }
 }
 
 void AUD_Stop(uint32_t voiceIndex)
 {
-    sVoices[voiceIndex].mActive = false;
+    sVoicePlaying[voiceIndex] = false;
+    RetireVoiceDecoder(voiceIndex);
+
+    AudioCommand cmd;
+    cmd.mType = AudioCommandType::Stop;
+    cmd.mVoiceIndex = voiceIndex;
+    PushCommand(cmd);
 }
 
 bool AUD_IsPlaying(uint32_t voiceIndex)
 {
-    return sVoices[voiceIndex].mActive &&
-           sVoices[voiceIndex].mCurFrame < sVoices[voiceIndex].mSrcFrames;
+    return sVoicePlaying[voiceIndex] &&
+           sVoiceFinishedSerial[voiceIndex].load(std::memory_order_acquire) != sVoiceSerial[voiceIndex];
 }
 
 void AUD_SetVolume(uint32_t voiceIndex, float leftVolume, float rightVolume)
 {
-    sVoices[voiceIndex].mVolumeL = leftVolume;
-    sVoices[voiceIndex].mVolumeR = rightVolume;
+    AudioCommand cmd;
+    cmd.mType = AudioCommandType::SetVolume;
+    cmd.mVoiceIndex = voiceIndex;
+    cmd.mVoice.mVolumeL = leftVolume;
+    cmd.mVoice.mVolumeR = rightVolume;
+    PushCommand(cmd);
 }
 
 void AUD_SetPitch(uint32_t voiceIndex, float pitch)
 {
-    sVoices[voiceIndex].mPitch = pitch;
+    AudioCommand cmd;
+    cmd.mType = AudioCommandType::SetPitch;
+    cmd.mVoiceIndex = voiceIndex;
+    cmd.mVoice.mPitch = pitch;
+    PushCommand(cmd);
 }
 
 uint8_t* AUD_AllocWaveBuffer(uint32_t size)
@@ -306,6 +962,23 @@ uint8_t* AUD_AllocWaveBuffer(uint32_t size)
 
 void AUD_FreeWaveBuffer(void* buffer)
 {
+    // The mixer may still be reading a buffer that was recently stopped.
+    bool inUse = false;
+
+    for (uint32_t i = 0; i < AUDIO_MAX_VOICES; ++i)
+    {
+        if (sVoiceBuffers[i] == buffer)
+        {
+            sVoiceBuffers[i] = nullptr;
+            inUse = true;
+        }
+    }
+
+    if (inUse)
+    {
+        SyncMixer();
+    }
+
     SYS_AlignedFree(buffer);
 }
 
@@ -32,6 +32,7 @@
 #include "Assets/Font.h"
 #include "AssetDir.h"
 #include "EmbeddedFile.h"
+#include "AssetArchive.h"
 #include "Utilities.h"
 #include "EditorUtils.h"
 #include "EditorImgui.h"
@@ -162,6 +163,8 @@ void ActionManager::BuildData(Platform platform, bool embedded)
     bool useRomfs = (platform == Platform::N3DS) && embedded;
 
     std::vector<std::pair<AssetStub*, std::string> > embeddedAssets;
+    std::vector<AssetArchive::BuildEntry> archiveEntries;
+    bool buildArchive = !embedded && (platform == Platform::Windows || platform == Platform::Linux);
 
     if (projectDir == "")
     {
@@ -242,6 +245,18 @@ void ActionManager::BuildData(Platform platform, bool embedded)
                 embeddedAssets.push_back({ stub, packFile });
             }
 
+            if (buildArchive)
+            {
+                AssetArchive::BuildEntry archiveEntry;
+                archiveEntry.mName = stub->mAsset->GetName();
+                archiveEntry.mPath = packFile;
+                archiveEntry.mArchivedPath = packFile.substr(packagedDir.length());
+                archiveEntry.mType = stub->mType;
+                archiveEntry.mUuid = stub->mAsset->GetUuid();
+                archiveEntry.mEngine = engine;
+                archiveEntries.push_back(archiveEntry);
+            }
+
             if (!alreadyLoaded)
             {
                 AssetManager::Get()->UnloadAsset(*stub);
@@ -303,6 +318,17 @@ void ActionManager::BuildData(Platform platform, bool embedded)
         registryFile = nullptr;
     }
 
+    // (5) On desktop, also pack the cooked .oct files into a single archive that the engine maps at startup.
+    // The loose files and registry are kept as a fallback.
+    if (buildArchive)
+    {
+        std::string archivePath = packagedDir + ASSET_ARCHIVE_FILENAME;
+        if (!AssetArchive::Build(archivePath.c_str(), archiveEntries))
+        {
+            LogError("Failed to build asset archive %s", archivePath.c_str());
+        }
+    }
+
     // Create a Generated folder inside the project folder if it doesn't exist
     if (!DoesDirExist((projectDir + "Generated").c_str()))
     {
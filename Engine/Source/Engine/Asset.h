@@ -32,7 +32,10 @@ class AssetDir;
 #define ASSET_VERSION_SCENE_SUBSCENE_INSTANCE_COLORS 11
 #define ASSET_VERSION_UUID_SUPPORT 12
 #define ASSET_VERSION_UUID_WITH_NAME_FALLBACK 13
-#define ASSET_VERSION_CURRENT 13
+#define ASSET_VERSION_SOUND_WAVE_STREAM 14
+#define ASSET_VERSION_SKELETAL_MESH_COMPRESSED_ANIM 15
+#define ASSET_VERSION_PARTICLE_POOL_PREWARM 16
+#define ASSET_VERSION_CURRENT 16
 // ----------------------------------------------------
 
 #define DECLARE_ASSET(Base, Parent) DECLARE_FACTORY(Base, Asset); DECLARE_OBJECT(Base, Parent);
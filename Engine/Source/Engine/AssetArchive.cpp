@@ -0,0 +1,289 @@
+#include "AssetArchive.h"
+#include "Stream.h"
+#include "Utilities.h"
+#include "Log.h"
+#include "Assertion.h"
+
+#include "System/System.h"
+
+#include <algorithm>
+
+AssetArchive::~AssetArchive()
+{
+    Close();
+}
+
+bool AssetArchive::Open(const char* path)
+{
+    Close();
+
+#if ENDIAN_SWAP
+    // Archives are stored little endian and read in place.
+    LogError("Asset archives are not supported on this platform");
+    return false;
+#else
+    mData = SYS_MapFile(path, mSize);
+
+    if (mData == nullptr)
+    {
+        return false;
+    }
+
+    bool valid = (mSize >= sizeof(AssetArchiveHeader));
+    const AssetArchiveHeader* header = (const AssetArchiveHeader*)mData;
+
+    if (valid)
+    {
+        uint64_t entriesEnd = sizeof(AssetArchiveHeader) + uint64_t(header->mNumEntries) * sizeof(AssetArchiveEntry);
+        uint64_t uuidIndexEnd = uint64_t(header->mUuidIndexOffset) + uint64_t(header->mNumEntries) * sizeof(uint32_t);
+
+        valid = header->mMagic == ASSET_ARCHIVE_MAGIC &&
+            header->mVersion == ASSET_ARCHIVE_VERSION &&
+            entriesEnd <= header->mUuidIndexOffset &&
+            uuidIndexEnd <= header->mStringsOffset &&
+            header->mStringsOffset <= mSize;
+    }
+
+    if (valid)
+    {
+        mNumEntries = header->mNumEntries;
+        mEntries = (const AssetArchiveEntry*)(mData + sizeof(AssetArchiveHeader));
+        mUuidIndex = (const uint32_t*)(mData + header->mUuidIndexOffset);
+        mStrings = mData + header->mStringsOffset;
+
+        mFiles.resize(mNumEntries);
+
+        for (uint32_t i = 0; i < mNumEntries && valid; ++i)
+        {
+            const AssetArchiveEntry& entry = mEntries[i];
+
+            valid = (header->mStringsOffset + uint64_t(entry.mNameOffset) < mSize) &&
+                (header->mStringsOffset + uint64_t(entry.mPathOffset) < mSize) &&
+                (uint64_t(entry.mDataOffset) + entry.mDataSize <= mSize) &&
+                (mUuidIndex[i] < mNumEntries);
+
+            mFiles[i].mName = mStrings + entry.mNameOffset;
+            mFiles[i].mData = mData + entry.mDataOffset;
+            mFiles[i].mSize = entry.mDataSize;
+            mFiles[i].mEngine = (entry.mFlags & ASSET_ARCHIVE_FLAG_ENGINE) != 0;
+        }
+    }
+
+    if (!valid)
+    {
+        LogError("Invalid asset archive: %s", path);
+        Close();
+        return false;
+    }
+
+    LogDebug("Opened asset archive %s with %d assets", path, mNumEntries);
+    return true;
+#endif
+}
+
+void AssetArchive::Close()
+{
+    if (mData != nullptr)
+    {
+        SYS_UnmapFile(mData, mSize);
+    }
+
+    mData = nullptr;
+    mSize = 0;
+    mEntries = nullptr;
+    mUuidIndex = nullptr;
+    mStrings = nullptr;
+    mNumEntries = 0;
+    mFiles.clear();
+}
+
+bool AssetArchive::IsOpen() const
+{
+    return mData != nullptr;
+}
+
+uint32_t AssetArchive::GetNumEntries() const
+{
+    return mNumEntries;
+}
+
+const AssetArchiveEntry& AssetArchive::GetEntry(uint32_t index) const
+{
+    OCT_ASSERT(index < mNumEntries);
+    return mEntries[index];
+}
+
+const char* AssetArchive::GetEntryName(const AssetArchiveEntry& entry) const
+{
+    return mStrings + entry.mNameOffset;
+}
+
+const char* AssetArchive::GetEntryPath(const AssetArchiveEntry& entry) const
+{
+    return mStrings + entry.mPathOffset;
+}
+
+EmbeddedFile* AssetArchive::GetFile(uint32_t index)
+{
+    OCT_ASSERT(index < mNumEntries);
+    return &mFiles[index];
+}
+
+const AssetArchiveEntry* AssetArchive::FindEntry(const char* name) const
+{
+    uint32_t hash = OctHashString(name);
+
+    // Entries are sorted by name hash. Walk the (rare) hash collisions after the lower bound.
+    const AssetArchiveEntry* end = mEntries + mNumEntries;
+    const AssetArchiveEntry* it = std::lower_bound(mEntries, end, hash,
+        [](const AssetArchiveEntry& entry, uint32_t value) { return entry.mNameHash < value; });
+
+    for (; it != end && it->mNameHash == hash; ++it)
+    {
+        if (strcmp(GetEntryName(*it), name) == 0)
+        {
+            return it;
+        }
+    }
+
+    return nullptr;
+}
+
+const AssetArchiveEntry* AssetArchive::FindEntryByUuid(uint64_t uuid) const
+{
+    const uint32_t* end = mUuidIndex + mNumEntries;
+    const uint32_t* it = std::lower_bound(mUuidIndex, end, uuid,
+        [this](uint32_t index, uint64_t value) { return mEntries[index].mUuid < value; });
+
+    if (it != end && mEntries[*it].mUuid == uuid)
+    {
+        return &mEntries[*it];
+    }
+
+    return nullptr;
+}
+
+#if EDITOR
+bool AssetArchive::Build(const char* path, const std::vector<BuildEntry>& entries)
+{
+    uint32_t numEntries = (uint32_t)entries.size();
+
+    std::vector<uint32_t> nameHashes(numEntries);
+    std::vector<uint32_t> order(numEntries);
+
+    for (uint32_t i = 0; i < numEntries; ++i)
+    {
+        nameHashes[i] = OctHashString(entries[i].mName.c_str());
+        order[i] = i;
+    }
+
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+    {
+        if (nameHashes[a] != nameHashes[b])
+        {
+            return nameHashes[a] < nameHashes[b];
+        }
+
+        return entries[a].mName < entries[b].mName;
+    });
+
+    // Entry indices (in sorted order) sorted by uuid.
+    std::vector<uint32_t> uuidIndex(numEntries);
+    for (uint32_t i = 0; i < numEntries; ++i)
+    {
+        uuidIndex[i] = i;
+    }
+
+    std::sort(uuidIndex.begin(), uuidIndex.end(), [&](uint32_t a, uint32_t b)
+    {
+        return entries[order[a]].mUuid < entries[order[b]].mUuid;
+    });
+
+    std::vector<uint32_t> nameOffsets(numEntries);
+    std::vector<uint32_t> pathOffsets(numEntries);
+    std::string strings;
+
+    for (uint32_t i = 0; i < numEntries; ++i)
+    {
+        nameOffsets[i] = (uint32_t)strings.size();
+        strings += entries[order[i]].mName;
+        strings.push_back('\0');
+
+        pathOffsets[i] = (uint32_t)strings.size();
+        strings += entries[order[i]].mArchivedPath;
+        strings.push_back('\0');
+    }
+
+    uint32_t uuidIndexOffset = sizeof(AssetArchiveHeader) + numEntries * sizeof(AssetArchiveEntry);
+    uint32_t stringsOffset = uuidIndexOffset + numEntries * sizeof(uint32_t);
+    uint32_t dataOffset = stringsOffset + (uint32_t)strings.size();
+
+    // Append the data first so that the entry table can be filled in with the final offsets.
+    Stream dataStream;
+    std::vector<uint32_t> dataOffsets(numEntries);
+    std::vector<uint32_t> dataSizes(numEntries);
+
+    for (uint32_t i = 0; i < numEntries; ++i)
+    {
+        const BuildEntry& entry = entries[order[i]];
+
+        while ((dataOffset + dataStream.GetPos()) % ASSET_ARCHIVE_DATA_ALIGNMENT != 0)
+        {
+            dataStream.WriteUint8(0);
+        }
+
+        Stream fileStream;
+        if (!fileStream.ReadFile(entry.mPath.c_str(), false))
+        {
+            LogError("Failed to add %s to asset archive", entry.mPath.c_str());
+            return false;
+        }
+
+        dataOffsets[i] = dataOffset + dataStream.GetPos();
+        dataSizes[i] = fileStream.GetSize();
+        dataStream.WriteBytes((const uint8_t*)fileStream.GetData(), fileStream.GetSize());
+    }
+
+    Stream stream;
+    stream.WriteUint32(ASSET_ARCHIVE_MAGIC);
+    stream.WriteUint32(ASSET_ARCHIVE_VERSION);
+    stream.WriteUint32(numEntries);
+    stream.WriteUint32(uuidIndexOffset);
+    stream.WriteUint32(stringsOffset);
+    stream.WriteUint32(0);
+    stream.WriteUint32(0);
+    stream.WriteUint32(0);
+
+    for (uint32_t i = 0; i < numEntries; ++i)
+    {
+        const BuildEntry& entry = entries[order[i]];
+        stream.WriteUint64(entry.mUuid);
+        stream.WriteUint32(nameHashes[order[i]]);
+        stream.WriteUint32(nameOffsets[i]);
+        stream.WriteUint32(dataOffsets[i]);
+        stream.WriteUint32(dataSizes[i]);
+        stream.WriteUint32(entry.mType);
+        stream.WriteUint32(entry.mEngine ? ASSET_ARCHIVE_FLAG_ENGINE : 0);
+        stream.WriteUint32(pathOffsets[i]);
+        stream.WriteUint32(0);
+    }
+
+    for (uint32_t i = 0; i < numEntries; ++i)
+    {
+        stream.WriteUint32(uuidIndex[i]);
+    }
+
+    stream.WriteBytes((const uint8_t*)strings.data(), (uint32_t)strings.size());
+    OCT_ASSERT(stream.GetPos() == dataOffset);
+    stream.WriteBytes((const uint8_t*)dataStream.GetData(), dataStream.GetSize());
+
+    bool success = stream.WriteFile(path);
+
+    if (success)
+    {
+        LogDebug("Built asset archive %s with %d assets", path, numEntries);
+    }
+
+    return success;
+}
+#endif
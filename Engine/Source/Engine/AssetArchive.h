@@ -0,0 +1,87 @@
+#pragma once
+
+#include "EngineTypes.h"
+#include "EmbeddedFile.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#define ASSET_ARCHIVE_MAGIC 0x4B41504F // "OPAK"
+#define ASSET_ARCHIVE_VERSION 2
+#define ASSET_ARCHIVE_FILENAME "Assets.octpak"
+#define ASSET_ARCHIVE_DATA_ALIGNMENT 16
+
+// Layout: header, entries sorted by name hash, uuid index (entry indices sorted by uuid),
+// null-terminated name and path strings, then each cooked .oct file aligned to ASSET_ARCHIVE_DATA_ALIGNMENT.
+// Values are stored little endian. Archives are only built for desktop platforms.
+struct AssetArchiveHeader
+{
+    uint32_t mMagic;
+    uint32_t mVersion;
+    uint32_t mNumEntries;
+    uint32_t mUuidIndexOffset;
+    uint32_t mStringsOffset;
+    uint32_t mReserved[3];
+};
+
+struct AssetArchiveEntry
+{
+    uint64_t mUuid;
+    uint32_t mNameHash;
+    uint32_t mNameOffset;
+    uint32_t mDataOffset;
+    uint32_t mDataSize;
+    TypeId mType;
+    uint32_t mFlags;
+    uint32_t mPathOffset;   // Packaged file path relative to the archive, e.g. "MyGame/Assets/Models/SM_Plane.oct"
+    uint32_t mReserved;
+};
+
+#define ASSET_ARCHIVE_FLAG_ENGINE 0x1
+
+class AssetArchive
+{
+public:
+
+    ~AssetArchive();
+
+    bool Open(const char* path);
+    void Close();
+    bool IsOpen() const;
+
+    uint32_t GetNumEntries() const;
+    const AssetArchiveEntry& GetEntry(uint32_t index) const;
+    const char* GetEntryName(const AssetArchiveEntry& entry) const;
+    const char* GetEntryPath(const AssetArchiveEntry& entry) const;
+
+    // Files pointing into the mapped archive, one per entry, usable wherever an EmbeddedFile is.
+    EmbeddedFile* GetFile(uint32_t index);
+
+    const AssetArchiveEntry* FindEntry(const char* name) const;
+    const AssetArchiveEntry* FindEntryByUuid(uint64_t uuid) const;
+
+#if EDITOR
+    struct BuildEntry
+    {
+        std::string mName;
+        std::string mPath;
+        std::string mArchivedPath;
+        TypeId mType = INVALID_TYPE_ID;
+        uint64_t mUuid = 0;
+        bool mEngine = false;
+    };
+
+    static bool Build(const char* path, const std::vector<BuildEntry>& entries);
+#endif
+
+protected:
+
+    const char* mData = nullptr;
+    uint32_t mSize = 0;
+    const AssetArchiveEntry* mEntries = nullptr;
+    const uint32_t* mUuidIndex = nullptr;
+    const char* mStrings = nullptr;
+    uint32_t mNumEntries = 0;
+    std::vector<EmbeddedFile> mFiles;
+};
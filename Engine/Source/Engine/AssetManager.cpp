@@ -7,6 +7,7 @@
 #include "Constants.h"
 #include "Utilities.h"
 #include "EmbeddedFile.h"
+#include "AssetArchive.h"
 #include "Renderer.h"
 
 #include "Assets/Scene.h"
@@ -22,9 +23,11 @@
 #include "Assets/Font.h"
 
 #include "System/System.h"
+#include "Profiler.h"
 
 #include <string>
 #include <functional>
+#include <algorithm>
 
 #if EDITOR
 #include "Editor/EditorState.h"
@@ -49,9 +52,14 @@ void UnloadAsset(const std::string& name)
     AssetManager::Get()->UnloadAsset(name);
 }
 
-void AsyncLoadAsset(const std::string& name, AssetRef* targetRef)
+void AsyncLoadAsset(const std::string& name, AssetRef* targetRef, int32_t priority)
 {
-    AssetManager::Get()->AsyncLoadAsset(name, targetRef);
+    AssetManager::Get()->AsyncLoadAsset(name, targetRef, priority);
+}
+
+bool CancelAsyncLoad(const std::string& name)
+{
+    return AssetManager::Get()->CancelAsyncLoad(name);
 }
 
 AssetStub* FetchAssetStub(const std::string& name)
@@ -70,9 +78,9 @@ Asset* LoadAssetByUuid(uint64_t uuid)
     return AssetManager::Get()->LoadAssetByUuid(uuid);
 }
 
-void AsyncLoadAssetByUuid(uint64_t uuid, AssetRef* targetRef)
+void AsyncLoadAssetByUuid(uint64_t uuid, AssetRef* targetRef, int32_t priority)
 {
-    AssetManager::Get()->AsyncLoadAssetByUuid(uuid, targetRef);
+    AssetManager::Get()->AsyncLoadAssetByUuid(uuid, targetRef, priority);
 }
 
 AssetStub* FetchAssetStubByUuid(uint64_t uuid)
@@ -112,13 +120,46 @@ AssetManager::~AssetManager()
     Purge(true);
 
     SYS_LockMutex(mMutex);
-    // Flag that we are destructing so that the async load thread can exit.
+    // Flag that we are destructing so that the async load threads can exit.
     mDestructing = true;
     SYS_UnlockMutex(mMutex);
 
-    SYS_JoinThread(mAsyncLoadThread);
-    SYS_DestroyThread(mAsyncLoadThread);
-    mAsyncLoadThread = nullptr;
+    // Wake every loader thread so it can see the destructing flag.
+    SYS_PostSemaphore(mLoadSemaphore, (uint32_t)mAsyncLoadThreads.size());
+
+    for (uint32_t i = 0; i < mAsyncLoadThreads.size(); ++i)
+    {
+        SYS_JoinThread(mAsyncLoadThreads[i]);
+        SYS_DestroyThread(mAsyncLoadThreads[i]);
+    }
+
+    mAsyncLoadThreads.clear();
+
+    for (uint32_t i = 0; i < mBeginLoadQueue.size(); ++i)
+    {
+        delete mBeginLoadQueue[i];
+    }
+
+    for (uint32_t i = 0; i < mEndLoadQueue.size(); ++i)
+    {
+        delete mEndLoadQueue[i]->mAsset;
+        delete mEndLoadQueue[i];
+    }
+
+    mBeginLoadQueue.clear();
+    mEndLoadQueue.clear();
+    mPendingLoads.clear();
+
+    // Unmap archives last since assets and pending loads read directly from them.
+    for (uint32_t i = 0; i < mArchives.size(); ++i)
+    {
+        delete mArchives[i];
+    }
+
+    mArchives.clear();
+
+    SYS_DestroySemaphore(mLoadSemaphore);
+    mLoadSemaphore = nullptr;
 
     SYS_DestroyMutex(mMutex);
     mMutex = nullptr;
@@ -129,7 +170,15 @@ void AssetManager::Initialize()
     mRootDirectory = new AssetDir("Root", "", nullptr);
 
     mMutex = SYS_CreateMutex();
-    mAsyncLoadThread = SYS_CreateThread(AsyncLoadThreadFunc, this);
+    mLoadSemaphore = SYS_CreateSemaphore(0);
+    mAsyncLoadBudget = glm::max(GetEngineConfig()->mAsyncLoadBudget, 0.0f);
+
+    int32_t numThreads = glm::max(GetEngineConfig()->mAsyncLoadThreads, 1);
+
+    for (int32_t i = 0; i < numThreads; ++i)
+    {
+        mAsyncLoadThreads.push_back(SYS_CreateThread(AsyncLoadThreadFunc, this));
+    }
 }
 
 void AssetManager::Update(float deltaTime)
@@ -137,6 +186,24 @@ void AssetManager::Update(float deltaTime)
     UpdateEndLoadQueue();
 }
 
+// Get path relative to project/engine Assets folder
+// e.g., "ProjectName/Assets/Models/SM_Plane.oct" -> "Models/SM_Plane"
+static std::string GetAssetRelativePath(const std::string& dirPath, const std::string& name)
+{
+    std::string relativePath;
+    size_t assetsPos = dirPath.find("/Assets/");
+    if (assetsPos != std::string::npos)
+    {
+        relativePath = dirPath.substr(assetsPos + 8) + name;  // +8 to skip "/Assets/"
+    }
+    else
+    {
+        relativePath = name;
+    }
+
+    return relativePath;
+}
+
 AssetStub* AssetManager::RegisterAsset(const std::string& filename, TypeId type, AssetDir* directory, EmbeddedFile* embeddedAsset, bool engineAsset, uint64_t uuid)
 {
     std::string fixedFilename = filename;
@@ -154,18 +221,7 @@ AssetStub* AssetManager::RegisterAsset(const std::string& filename, TypeId type,
     std::string relativePath = "";
     if (directory != nullptr)
     {
-        // Get path relative to project/engine Assets folder
-        // e.g., "ProjectName/Assets/Models/SM_Plane.oct" -> "Models/SM_Plane"
-        std::string dirPath = directory->mPath;
-        size_t assetsPos = dirPath.find("/Assets/");
-        if (assetsPos != std::string::npos)
-        {
-            relativePath = dirPath.substr(assetsPos + 8) + name;  // +8 to skip "/Assets/"
-        }
-        else
-        {
-            relativePath = name;
-        }
+        relativePath = GetAssetRelativePath(directory->mPath, name);
     }
 
     // Check for existing asset with same path (rediscovery)
@@ -488,6 +544,44 @@ void AssetManager::DiscoverEmbeddedAssets(EmbeddedFile* assets, uint32_t numAsse
     }
 }
 
+bool AssetManager::MountArchive(const char* path)
+{
+    SCOPED_STAT("MountArchive");
+
+    AssetArchive* archive = new AssetArchive();
+
+    if (!archive->Open(path))
+    {
+        delete archive;
+        return false;
+    }
+
+    // The index already holds each asset's type and uuid, so no asset headers need to be read.
+    for (uint32_t i = 0; i < archive->GetNumEntries(); ++i)
+    {
+        const AssetArchiveEntry& entry = archive->GetEntry(i);
+        EmbeddedFile* file = archive->GetFile(i);
+
+        if (GetAssetStub(file->mName) == nullptr)
+        {
+            AssetStub* stub = RegisterAsset(file->mName, entry.mType, nullptr, file, file->mEngine, entry.mUuid);
+            const char* archivedPath = archive->GetEntryPath(entry);
+
+            // Archived stubs have no AssetDir, so set the packaged path and the path lookup key here.
+            if (archivedPath[0] != '\0')
+            {
+                stub->mPath = archivedPath;
+
+                std::string relativePath = GetAssetRelativePath(Asset::GetDirectoryFromPath(stub->mPath), Asset::GetNameFromPath(stub->mPath));
+                mAssetPathMap.insert(std::pair<std::string, AssetStub*>(relativePath, stub));
+            }
+        }
+    }
+
+    mArchives.push_back(archive);
+    return true;
+}
+
 void AssetManager::Purge(bool purgeEngineAssets)
 {
     // Destroy all assets in the map and empty the map.
@@ -949,7 +1043,7 @@ Asset* AssetManager::LoadAssetByUuid(uint64_t uuid)
     return nullptr;
 }
 
-void AssetManager::AsyncLoadAssetByUuid(uint64_t uuid, AssetRef* targetRef)
+void AssetManager::AsyncLoadAssetByUuid(uint64_t uuid, AssetRef* targetRef, int32_t priority)
 {
     SCOPED_LOCK(mMutex);
 
@@ -990,7 +1084,7 @@ void AssetManager::AsyncLoadAssetByUuid(uint64_t uuid, AssetRef* targetRef)
         return;
     }
 
-    AsyncLoadAsset(name, targetRef);
+    AsyncLoadAsset(name, targetRef, priority);
 }
 
 // Path-based lookup methods (e.g., "Assets/Models/SM_Plane" or "Models/SM_Plane")
@@ -1018,7 +1112,7 @@ Asset* AssetManager::LoadAssetByPath(const std::string& path)
     return nullptr;
 }
 
-void AssetManager::AsyncLoadAsset(const std::string& name, AssetRef* targetRef)
+void AssetManager::AsyncLoadAsset(const std::string& name, AssetRef* targetRef, int32_t priority)
 {
     SCOPED_LOCK(mMutex);
     // (1) Check to see if an asset stub exists at all, if not, then log an error and return.
@@ -1046,48 +1140,143 @@ void AssetManager::AsyncLoadAsset(const std::string& name, AssetRef* targetRef)
         return;
     }
 
-    // (3) Check to see if an AsyncLoadRequest is already in flight (in begin/end queues) and if so, add this ref to the list.
-    for (uint32_t i = 0; i < mBeginLoadQueue.size(); ++i)
+    // (3) Check to see if an AsyncLoadRequest is already pending (queued, loading, or waiting to finish)
+    // and if so, add this ref to the list.
+    auto pendingIt = mPendingLoads.find(name);
+    if (pendingIt != mPendingLoads.end())
     {
-        if (mBeginLoadQueue[i]->mName == name)
-        {
-            if (targetRef != nullptr)
-            {
-                targetRef->SetLoadRequest(mBeginLoadQueue[i]);
-            }
+        AsyncLoadRequest* request = pendingIt->second;
+        request->mCancelled = false;
 
-            return;
+        if (targetRef != nullptr)
+        {
+            targetRef->SetLoadRequest(request);
         }
-    }
 
-    for (uint32_t i = 0; i < mEndLoadQueue.size(); ++i)
-    {
-        if (mEndLoadQueue[i]->mName == name)
+        // Move the request forward if it hasn't started and was requested with a higher priority.
+        if (priority > request->mPriority)
         {
-            if (targetRef != nullptr)
+            auto queueIt = std::find(mBeginLoadQueue.begin(), mBeginLoadQueue.end(), request);
+            request->mPriority = priority;
+
+            if (queueIt != mBeginLoadQueue.end())
             {
-                targetRef->SetLoadRequest(mEndLoadQueue[i]);
+                mBeginLoadQueue.erase(queueIt);
+                EnqueueBeginLoad(request);
             }
-
-            return;
         }
+
+        return;
     }
-    
-    // (4) Otherwise, malloc and enqueue a new AsyncLoadRequest to the BeginLoadQueue
-    AsyncLoadRequest* newRequest = new AsyncLoadRequest();
-    mBeginLoadQueue.push_back(newRequest);
 
-    // (5) Set the data on the request, including the targetRef.
+    // (4) Otherwise, malloc a new AsyncLoadRequest and set its data.
+    AsyncLoadRequest* newRequest = new AsyncLoadRequest();
     newRequest->mName = name;
     newRequest->mPath = stub->mPath;
     newRequest->mType = stub->mType;
     newRequest->mEmbeddedData = stub->mEmbeddedData;
+    newRequest->mPriority = priority;
+    newRequest->mRequestTime = SYS_GetTimeMicroseconds();
+    mPendingLoads.insert({ name, newRequest });
 
     if (targetRef != nullptr)
     {
-        // (6) Set the request pointer on the AssetRef.
+        // (5) Set the request pointer on the AssetRef.
         targetRef->SetLoadRequest(newRequest);
     }
+
+    // (6) Enqueue it on the BeginLoadQueue and wake a loader thread.
+    EnqueueBeginLoad(newRequest);
+    SYS_PostSemaphore(mLoadSemaphore);
+}
+
+bool AssetManager::CancelAsyncLoad(const std::string& name)
+{
+    SCOPED_LOCK(mMutex);
+
+    auto pendingIt = mPendingLoads.find(name);
+    if (pendingIt == mPendingLoads.end())
+    {
+        return false;
+    }
+
+    AsyncLoadRequest* request = pendingIt->second;
+    AssetStub* stub = GetAssetStub(name);
+
+    // Assets that are being loaded hold refs on their dependencies' requests, so a load that
+    // another pending load depends on can't be cancelled without stalling the dependent load.
+    for (auto& pending : mPendingLoads)
+    {
+        std::vector<AssetStub*>& deps = pending.second->mDependentAssets;
+        if (pending.second != request &&
+            std::find(deps.begin(), deps.end(), stub) != deps.end())
+        {
+            LogWarning("Cannot cancel async load for %s, %s depends on it", name.c_str(), pending.first.c_str());
+            return false;
+        }
+    }
+
+    // The request is dropped by the loader thread if it hasn't started yet, otherwise
+    // it is discarded once it reaches the end load queue. Requesting the asset again
+    // before then clears mCancelled.
+    request->mCancelled = true;
+    DetachAsyncLoadRefs(request);
+
+    return true;
+}
+
+void AssetManager::AddAsyncLoadDependency(AsyncLoadRequest* request, AssetStub* dependency)
+{
+    // Registered before the dependency's load is requested so that CancelAsyncLoad() always sees it.
+    SCOPED_LOCK(mMutex);
+
+    std::vector<AssetStub*>& deps = request->mDependentAssets;
+    if (std::find(deps.begin(), deps.end(), dependency) == deps.end())
+    {
+        deps.push_back(dependency);
+    }
+}
+
+void AssetManager::SetAsyncLoadBudget(float budgetMs)
+{
+    mAsyncLoadBudget = glm::max(budgetMs, 0.0f);
+}
+
+float AssetManager::GetAsyncLoadBudget() const
+{
+    return mAsyncLoadBudget;
+}
+
+uint32_t AssetManager::GetNumPendingAsyncLoads()
+{
+    SCOPED_LOCK(mMutex);
+    return (uint32_t)mPendingLoads.size();
+}
+
+void AssetManager::EnqueueBeginLoad(AsyncLoadRequest* request)
+{
+    // Keep the queue sorted by priority (highest first), FIFO among equal priorities.
+    auto it = mBeginLoadQueue.end();
+    while (it != mBeginLoadQueue.begin() &&
+           (*(it - 1))->mPriority < request->mPriority)
+    {
+        --it;
+    }
+
+    mBeginLoadQueue.insert(it, request);
+}
+
+void AssetManager::DetachAsyncLoadRefs(AsyncLoadRequest* request)
+{
+    SCOPED_LOCK(GetAssetRefMutex());
+
+    // SetLoadRequest() removes the ref from mTargetRefs, so iterate backwards.
+    for (int32_t i = int32_t(request->mTargetRefs.size()) - 1; i >= 0; --i)
+    {
+        request->mTargetRefs[i]->SetLoadRequest(nullptr);
+    }
+
+    request->mTargetRefs.clear();
 }
 
 void AssetManager::SaveAsset(const std::string& name)
@@ -1633,25 +1822,36 @@ std::vector<AssetStub*> AssetManager::GatherDirtyAssets()
 ThreadFuncRet AssetManager::AsyncLoadThreadFunc(void* in)
 {
     AssetManager& am = *((AssetManager*)in);
-    bool exit = false;
 
-    while (!exit)
+    while (true)
     {
+        // Sleep until a request is enqueued (or the manager is destructing).
+        SYS_WaitSemaphore(am.mLoadSemaphore);
+
         AsyncLoadRequest* request = nullptr;
 
-        // Pop off the next request from the queue.
-        SYS_LockMutex(am.mMutex);
-        bool exit = am.mDestructing;
-        if (am.mBeginLoadQueue.size() > 0)
         {
-            request = am.mBeginLoadQueue.front();
-            am.mBeginLoadQueue.pop_front();
-        }
-        SYS_UnlockMutex(am.mMutex);
+            // Pop off the highest priority request from the queue.
+            SCOPED_LOCK(am.mMutex);
 
-        if (exit)
-        {
-            break;
+            if (am.mDestructing)
+            {
+                break;
+            }
+
+            if (am.mBeginLoadQueue.size() > 0)
+            {
+                request = am.mBeginLoadQueue.front();
+                am.mBeginLoadQueue.pop_front();
+
+                if (request->mCancelled)
+                {
+                    // Its refs were detached when it was cancelled and nothing depends on it.
+                    am.mPendingLoads.erase(request->mName);
+                    delete request;
+                    request = nullptr;
+                }
+            }
         }
 
         if (request != nullptr)
@@ -1681,11 +1881,6 @@ ThreadFuncRet AssetManager::AsyncLoadThreadFunc(void* in)
                 am.mEndLoadQueue.push_back(request);
             }
         }
-        else
-        {
-            // If nothing to process then sleep, for a bit so we don't was cpu cycles checking.
-            SYS_Sleep(2);
-        }
     }
 
     THREAD_RETURN();
@@ -1695,100 +1890,140 @@ void AssetManager::UpdateEndLoadQueue()
 {
     SCOPED_LOCK(mMutex);
 
-    const uint32_t maxIterations = 3;
-    uint32_t numIterations = 0;
+    // Finish loads until the frame's time budget is spent. Each request is visited
+    // at most once per frame so that requests waiting on dependencies can't spin here.
+    const uint64_t startTime = SYS_GetTimeMicroseconds();
+    const uint64_t budget = uint64_t(mAsyncLoadBudget * 1000.0f);
+    uint32_t numToVisit = (uint32_t)mEndLoadQueue.size();
+    uint32_t numFinished = 0;
+    uint64_t totalLatency = 0;
 
-    bool handled = false;
-
-    do
+    for (uint32_t visit = 0; visit < numToVisit && mEndLoadQueue.size() > 0; ++visit)
     {
-        handled = false;
-        AsyncLoadRequest* loadRequest = (mEndLoadQueue.size() > 0) ? mEndLoadQueue.front() : nullptr;
-
-        if (mEndLoadQueue.size() > 0)
+        if (numFinished > 0 &&
+            SYS_GetTimeMicroseconds() - startTime >= budget)
         {
-            mEndLoadQueue.pop_front();
+            break;
         }
 
-        if (loadRequest != nullptr)
-        {
-            numIterations++;
+        AsyncLoadRequest* loadRequest = mEndLoadQueue.front();
+        mEndLoadQueue.pop_front();
 
-            // Check load dependencies before finish the load
-            bool allDependenciesLoaded = true;
+        if (loadRequest->mCancelled)
+        {
+            // Cancelled after the loader thread picked it up. Throw away the loaded data
+            // rather than registering an asset that nobody is waiting for.
+            LogDebug("Discarding cancelled async load: %s", loadRequest->mName.c_str());
 
-            for (uint32_t i = 0; i < loadRequest->mDependentAssets.size(); ++i)
             {
-                if (loadRequest->mDependentAssets[i]->mAsset == nullptr)
-                {
-                    allDependenciesLoaded = false;
-                    break;
-                }
+                SCOPED_LOCK(GetAssetRefMutex());
+                delete loadRequest->mAsset;
             }
 
-            if (allDependenciesLoaded)
-            {
-                handled = true;
+            mPendingLoads.erase(loadRequest->mName);
+            delete loadRequest;
+            continue;
+        }
 
-                AssetStub* stub = GetAssetStub(loadRequest->mName);
+        // Check load dependencies before finish the load
+        bool allDependenciesLoaded = true;
 
-                // Lock the AssetRefLock while we update asset members
-                SCOPED_LOCK(GetAssetRefMutex());
+        for (uint32_t i = 0; i < loadRequest->mDependentAssets.size(); ++i)
+        {
+            if (loadRequest->mDependentAssets[i]->mAsset == nullptr)
+            {
+                allDependenciesLoaded = false;
+                break;
+            }
+        }
 
-                if (stub == nullptr)
-                {
-                    LogError("Cannot find asset for async load request");
-                }
-                else if (stub->mAsset != nullptr)
-                {
-                    LogWarning("AsyncLoadRequest not finished because the asset has already been loaded");
-                }
-                else
-                {
-                    LogDebug("Finished Async Loading: %s", loadRequest->mName.c_str());
+        if (allDependenciesLoaded)
+        {
+            AssetStub* stub = GetAssetStub(loadRequest->mName);
 
-                    // Finish the load on the main thread and assign the stub's mAsset so that it is officially "Loaded"
-                    OCT_ASSERT(loadRequest->mAsset != nullptr);
-                    loadRequest->mAsset->Create();
-                    stub->mAsset = loadRequest->mAsset;
+            // Lock the AssetRefLock while we update asset members
+            SCOPED_LOCK(GetAssetRefMutex());
 
-                    // Now assign the asset to all of the refs that had requested the load
-                    for (int32_t i = int32_t(loadRequest->mTargetRefs.size()) - 1; i >= 0; --i)
+            if (stub == nullptr)
+            {
+                LogError("Cannot find asset for async load request");
+                DetachAsyncLoadRefs(loadRequest);
+                delete loadRequest->mAsset;
+            }
+            else if (stub->mAsset != nullptr)
+            {
+                LogWarning("AsyncLoadRequest not finished because the asset has already been loaded");
+
+                // The refs waiting on this request still want the asset, so point them at the loaded one.
+                for (int32_t i = int32_t(loadRequest->mTargetRefs.size()) - 1; i >= 0; --i)
+                {
+                    if (loadRequest->mTargetRefs[i] != nullptr)
                     {
-                        if (loadRequest->mTargetRefs[i] != nullptr)
-                        {
-                            // The load request of the target ref should match this load request but...
-                            // We need to make sure we handle the case where an AssetRef is assigned twice to an async load
-                            // before the first one finishes. Might mean Canceling the request if one already exists in AsyncLoadAsset()
-                            OCT_ASSERT(loadRequest->mTargetRefs[i]->GetLoadRequest() == nullptr ||
-                                loadRequest->mTargetRefs[i]->GetLoadRequest() == loadRequest);
-
-                            // This will clear the existing load request (and also remove the entry from loadRequest->mTargetRefs
-                            (*loadRequest->mTargetRefs[i]) = loadRequest->mAsset;
-                        }
+                        (*loadRequest->mTargetRefs[i]) = stub->mAsset;
                     }
                 }
 
-                delete loadRequest;
-                loadRequest = nullptr;
+                DetachAsyncLoadRefs(loadRequest);
+                delete loadRequest->mAsset;
             }
             else
             {
-                // Still waiting on some dependent assets, so push this on the back of the queue
-                // This might happen several times before the dependent assests make their way to the front
-                // of the mEndLoadQueue.
-                LogWarning("Async load for %s is still waiting on dependencies", loadRequest->mName.c_str());
-                mEndLoadQueue.push_back(loadRequest);
-                loadRequest->mRequeueCount++;
-
-                if (loadRequest->mRequeueCount >= ASYNC_REQUEUE_LIMIT)
+                LogDebug("Finished Async Loading: %s", loadRequest->mName.c_str());
+
+                // Finish the load on the main thread and assign the stub's mAsset so that it is officially "Loaded"
+                OCT_ASSERT(loadRequest->mAsset != nullptr);
+                loadRequest->mAsset->Create();
+                stub->mAsset = loadRequest->mAsset;
+
+                // Now assign the asset to all of the refs that had requested the load.
+                for (int32_t i = int32_t(loadRequest->mTargetRefs.size()) - 1; i >= 0; --i)
                 {
-                    LogWarning("Exceeded requeue limit for %s, possible cyclical dependency. Forcing load.", loadRequest->mName.c_str());
-                    LoadAsset(loadRequest->mName);
+                    if (loadRequest->mTargetRefs[i] != nullptr)
+                    {
+                        // The load request of the target ref should match this load request but...
+                        // We need to make sure we handle the case where an AssetRef is assigned twice to an async load
+                        // before the first one finishes. Might mean Canceling the request if one already exists in AsyncLoadAsset()
+                        OCT_ASSERT(loadRequest->mTargetRefs[i]->GetLoadRequest() == nullptr ||
+                            loadRequest->mTargetRefs[i]->GetLoadRequest() == loadRequest);
+
+                        // This will clear the existing load request (and also remove the entry from loadRequest->mTargetRefs
+                        (*loadRequest->mTargetRefs[i]) = loadRequest->mAsset;
+                    }
                 }
             }
+
+            numFinished++;
+            totalLatency += SYS_GetTimeMicroseconds() - loadRequest->mRequestTime;
+
+            mPendingLoads.erase(loadRequest->mName);
+            delete loadRequest;
+            loadRequest = nullptr;
+        }
+        else
+        {
+            // Still waiting on some dependent assets, so push this on the back of the queue
+            // This might happen several times before the dependent assests make their way to the front
+            // of the mEndLoadQueue.
+            LogWarning("Async load for %s is still waiting on dependencies", loadRequest->mName.c_str());
+            mEndLoadQueue.push_back(loadRequest);
+            loadRequest->mRequeueCount++;
+
+            if (loadRequest->mRequeueCount >= ASYNC_REQUEUE_LIMIT)
+            {
+                LogWarning("Exceeded requeue limit for %s, possible cyclical dependency. Forcing load.", loadRequest->mName.c_str());
+                LoadAsset(loadRequest->mName);
+            }
         }
-    } while (handled && numIterations < maxIterations);
+    }
+
+#if PROFILING_ENABLED
+    GetProfiler()->SetCounterStat("Async Load Queue", (float)mPendingLoads.size());
+
+    if (numFinished > 0)
+    {
+        GetProfiler()->SetCounterStat("Async Load Latency", (totalLatency / float(numFinished)) / 1000.0f);
+    }
+#endif
 }
 
 #if EDITOR
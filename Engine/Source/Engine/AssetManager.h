@@ -26,19 +26,23 @@ struct AsyncLoadRequest
     TypeId mType = INVALID_TYPE_ID;
     Asset* mAsset = nullptr;
     int32_t mRequeueCount = 0;
+    int32_t mPriority = 0;          // Higher priority requests are loaded first
+    uint64_t mRequestTime = 0;      // Microseconds, used for load latency stats
+    bool mCancelled = false;        // Dropped by the loader thread or the end load queue instead of finishing
 };
 
 // Name-based lookup (backward compatible)
 Asset* FetchAsset(const std::string& name);
 Asset* LoadAsset(const std::string& name);
 void UnloadAsset(const std::string& name);
-void AsyncLoadAsset(const std::string& name, AssetRef* targetRef = nullptr);
+void AsyncLoadAsset(const std::string& name, AssetRef* targetRef = nullptr, int32_t priority = 0);
+bool CancelAsyncLoad(const std::string& name);
 AssetStub* FetchAssetStub(const std::string& name);
 
 // UUID-based lookup
 Asset* FetchAssetByUuid(uint64_t uuid);
 Asset* LoadAssetByUuid(uint64_t uuid);
-void AsyncLoadAssetByUuid(uint64_t uuid, AssetRef* targetRef = nullptr);
+void AsyncLoadAssetByUuid(uint64_t uuid, AssetRef* targetRef = nullptr, int32_t priority = 0);
 AssetStub* FetchAssetStubByUuid(uint64_t uuid);
 
 template<typename T>
@@ -87,6 +91,7 @@ public:
     void Discover(const char* directoryName, const char* directoryPath);
     void DiscoverAssetRegistry(const char* registryPath);
     void DiscoverEmbeddedAssets(struct EmbeddedFile* assets, uint32_t numAssets);
+    bool MountArchive(const char* path);
     void Purge(bool purgeEngineAssets);
     bool PurgeAsset(const char* name);
     void RefSweep();
@@ -103,13 +108,18 @@ public:
     AssetStub* GetSceneAsset(const std::string& name);
     Asset* LoadAsset(const std::string& name);
     Asset* LoadAsset(AssetStub& stub);
-    void AsyncLoadAsset(const std::string& name, AssetRef* targetRef);
+    void AsyncLoadAsset(const std::string& name, AssetRef* targetRef, int32_t priority = 0);
+    bool CancelAsyncLoad(const std::string& name);
+    void AddAsyncLoadDependency(AsyncLoadRequest* request, AssetStub* dependency);
+    void SetAsyncLoadBudget(float budgetMs);
+    float GetAsyncLoadBudget() const;
+    uint32_t GetNumPendingAsyncLoads();
 
     // UUID-based lookup (primary)
     AssetStub* GetAssetStubByUuid(uint64_t uuid);
     Asset* GetAssetByUuid(uint64_t uuid);
     Asset* LoadAssetByUuid(uint64_t uuid);
-    void AsyncLoadAssetByUuid(uint64_t uuid, AssetRef* targetRef);
+    void AsyncLoadAssetByUuid(uint64_t uuid, AssetRef* targetRef, int32_t priority = 0);
 
     // Path-based lookup (e.g., "Assets/Models/SM_Plane" or "Models/SM_Plane")
     AssetStub* GetAssetStubByPath(const std::string& path);
@@ -153,6 +163,8 @@ protected:
     AssetManager();
 
     void UpdateEndLoadQueue();
+    void EnqueueBeginLoad(AsyncLoadRequest* request);
+    void DetachAsyncLoadRefs(AsyncLoadRequest* request);
 
     std::unordered_map<std::string, AssetStub*> mAssetMap;      // Name-based lookup (first wins)
     std::unordered_map<std::string, AssetStub*> mAssetPathMap;  // Path-based lookup (e.g., "Models/SM_Plane")
@@ -163,8 +175,12 @@ protected:
     bool mDestructing = false;
     std::deque<AsyncLoadRequest*> mBeginLoadQueue;
     std::deque<AsyncLoadRequest*> mEndLoadQueue;
-    ThreadObject* mAsyncLoadThread = {};
+    std::unordered_map<std::string, AsyncLoadRequest*> mPendingLoads;  // Every request not yet finished, by name
+    std::vector<ThreadObject*> mAsyncLoadThreads;
+    std::vector<class AssetArchive*> mArchives;
+    SemaphoreObject* mLoadSemaphore = nullptr;
     MutexObject* mMutex = {};
+    float mAsyncLoadBudget = 4.0f;
 
 #if EDITOR
 public:
@@ -78,6 +78,11 @@ void ParticleSystem::LoadStream(Stream& stream, Platform platform)
 
     mParams.mScaleStart = stream.ReadVec2();
     mParams.mScaleEnd = stream.ReadVec2();
+
+    if (mVersion >= ASSET_VERSION_PARTICLE_POOL_PREWARM)
+    {
+        mPoolPrewarmCount = stream.ReadUint32();
+    }
 }
 
 void ParticleSystem::SaveStream(Stream& stream, Platform platform)
@@ -128,6 +133,8 @@ void ParticleSystem::SaveStream(Stream& stream, Platform platform)
 
     stream.WriteVec2(mParams.mScaleStart);
     stream.WriteVec2(mParams.mScaleEnd);
+
+    stream.WriteUint32(mPoolPrewarmCount);
 }
 
 void ParticleSystem::Create()
@@ -158,6 +165,7 @@ void ParticleSystem::GatherProperties(std::vector<Property>& outProps)
     outProps.push_back(Property(DatumType::Bool, "Radial Velocity", this, &mRadialVelocity, 1, HandlePropChange));
     outProps.push_back(Property(DatumType::Bool, "Radial Spawn", this, &mRadialSpawn, 1, HandlePropChange));
     outProps.push_back(Property(DatumType::Bool, "Locked Ratio", this, &mLockedRatio, 1, HandlePropChange));
+    outProps.push_back(Property(DatumType::Integer, "Pool Prewarm", this, &mPoolPrewarmCount, 1, HandlePropChange));
 
     outProps.push_back(Property(DatumType::Vector, "Bounds Center", this, &mBounds.mCenter, 1, HandlePropChange));
     outProps.push_back(Property(DatumType::Float, "Bounds Radius", this, &mBounds.mRadius, 1, HandlePropChange));
@@ -319,6 +327,16 @@ bool ParticleSystem::IsRatioLocked() const
     return mLockedRatio;
 }
 
+void ParticleSystem::SetPoolPrewarmCount(uint32_t count)
+{
+    mPoolPrewarmCount = count;
+}
+
+uint32_t ParticleSystem::GetPoolPrewarmCount() const
+{
+    return mPoolPrewarmCount;
+}
+
 Bounds ParticleSystem::GetBounds() const
 {
     return mBounds;
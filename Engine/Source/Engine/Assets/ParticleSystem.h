@@ -105,6 +105,9 @@ public:
     void SetLockedRatio(bool lockedRatio);
     bool IsRatioLocked() const;
 
+    void SetPoolPrewarmCount(uint32_t count);
+    uint32_t GetPoolPrewarmCount() const;
+
     Bounds GetBounds() const;
 
     static bool HandlePropChange(Datum* datum, uint32_t index, const void* newValue);
@@ -120,6 +123,7 @@ protected:
     bool mRadialVelocity = false;
     bool mRadialSpawn = false;
     bool mLockedRatio = true;
+    uint32_t mPoolPrewarmCount = 0;
 
     MaterialRef mMaterial = nullptr;
     Bounds mBounds;
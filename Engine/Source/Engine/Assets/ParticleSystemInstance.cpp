@@ -42,6 +42,7 @@ void ParticleSystemInstance::CopyParticleSystem(const ParticleSystem* src)
     mRadialVelocity = src->IsRadialVelocity();
     mRadialSpawn = src->IsRadialSpawn();
     mLockedRatio = src->IsRatioLocked();
+    mPoolPrewarmCount = src->GetPoolPrewarmCount();
 
     mMaterial = src->GetMaterial();
 
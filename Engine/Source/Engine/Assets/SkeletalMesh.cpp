@@ -21,7 +21,110 @@ DEFINE_ASSET(SkeletalMesh);
 
 bool SkeletalMesh::HandlePropChange(Datum* datum, uint32_t index, const void* newValue)
 {
-    return HandleAssetPropChange(datum, index, newValue);
+    Property* prop = static_cast<Property*>(datum);
+    SkeletalMesh* mesh = (SkeletalMesh*)prop->mOwner;
+    bool handled = false;
+
+    if (prop->mName == "Compress Animations")
+    {
+        mesh->mCompressAnimations = *(const bool*)newValue;
+        mesh->CompressAnimations();
+        handled = true;
+    }
+    else if (prop->mName == "Compressed Sample Rate")
+    {
+        mesh->mCompressedSampleRate = *(const float*)newValue;
+        mesh->CompressAnimations();
+        handled = true;
+    }
+
+    HandleAssetPropChange(datum, index, newValue);
+
+    return handled;
+}
+
+template<typename KeyType>
+static glm::vec3 SampleVec3Keys(const std::vector<KeyType>& keys, float time, uint32_t& cursor, glm::vec3 defaultValue)
+{
+    if (keys.size() == 0)
+    {
+        return defaultValue;
+    }
+    else if (keys.size() == 1)
+    {
+        return keys[0].mValue;
+    }
+
+    uint32_t index = FindKeyIndex(keys, time, cursor);
+    float factor = (time - keys[index].mTime) / (keys[index + 1].mTime - keys[index].mTime);
+    factor = glm::clamp(factor, 0.0f, 1.0f);
+    return glm::mix(keys[index].mValue, keys[index + 1].mValue, factor);
+}
+
+static glm::quat SampleRotationKeys(const std::vector<RotationKey>& keys, float time, uint32_t& cursor)
+{
+    if (keys.size() == 0)
+    {
+        return glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    }
+    else if (keys.size() == 1)
+    {
+        return keys[0].mValue;
+    }
+
+    uint32_t index = FindKeyIndex(keys, time, cursor);
+    float factor = (time - keys[index].mTime) / (keys[index + 1].mTime - keys[index].mTime);
+    factor = glm::clamp(factor, 0.0f, 1.0f);
+    return glm::normalize(glm::slerp(keys[index].mValue, keys[index + 1].mValue, factor));
+}
+
+static uint16_t QuantizeUnorm16(float value, float minValue, float step)
+{
+    if (step <= 0.0f)
+    {
+        return 0;
+    }
+
+    return (uint16_t)glm::clamp(glm::round((value - minValue) / step), 0.0f, 65535.0f);
+}
+
+static int16_t QuantizeSnorm16(float value)
+{
+    return (int16_t)glm::clamp(glm::round(value * 32767.0f), -32767.0f, 32767.0f);
+}
+
+void CompressedAnimation::FindFrames(float tickTime, uint32_t& outFrame0, uint32_t& outFrame1, float& outAlpha) const
+{
+    OCT_ASSERT(mNumFrames > 0);
+    float frame = (mFrameTicks > 0.0f) ? (tickTime / mFrameTicks) : 0.0f;
+    frame = glm::clamp(frame, 0.0f, float(mNumFrames - 1));
+
+    outFrame0 = glm::min(uint32_t(frame), mNumFrames - 1);
+    outFrame1 = glm::min(outFrame0 + 1, mNumFrames - 1);
+    outAlpha = frame - float(outFrame0);
+}
+
+void CompressedAnimation::Sample(uint32_t channelIndex, uint32_t frame0, uint32_t frame1, float alpha,
+    glm::vec3& outPosition, glm::quat& outRotation, glm::vec3& outScale) const
+{
+    const uint32_t numChannels = (uint32_t)mRanges.size();
+    const CompressedChannelRange& range = mRanges[channelIndex];
+    const CompressedKey& key0 = mKeys[frame0 * numChannels + channelIndex];
+    const CompressedKey& key1 = mKeys[frame1 * numChannels + channelIndex];
+
+    glm::vec3 pos0 = { key0.mPosition[0], key0.mPosition[1], key0.mPosition[2] };
+    glm::vec3 pos1 = { key1.mPosition[0], key1.mPosition[1], key1.mPosition[2] };
+    outPosition = range.mPositionMin + glm::mix(pos0, pos1, alpha) * range.mPositionStep;
+
+    glm::vec3 scale0 = { key0.mScale[0], key0.mScale[1], key0.mScale[2] };
+    glm::vec3 scale1 = { key1.mScale[0], key1.mScale[1], key1.mScale[2] };
+    outScale = range.mScaleMin + glm::mix(scale0, scale1, alpha) * range.mScaleStep;
+
+    // Neighboring frames were put in the same hemisphere when compressed, so a normalized lerp
+    // takes the short path. The 16 bit scale factor cancels out in the normalize.
+    glm::quat rot0(key0.mRotation[3], key0.mRotation[0], key0.mRotation[1], key0.mRotation[2]);
+    glm::quat rot1(key1.mRotation[3], key1.mRotation[0], key1.mRotation[1], key1.mRotation[2]);
+    outRotation = glm::normalize(rot0 * (1.0f - alpha) + rot1 * alpha);
 }
 
 SkeletalMesh::SkeletalMesh() :
@@ -167,6 +270,12 @@ void SkeletalMesh::LoadStream(Stream& stream, Platform platform)
     mBounds.mCenter = stream.ReadVec3();
     mBounds.mRadius = stream.ReadFloat();
     mBoundsScale = stream.ReadFloat();
+
+    if (mVersion >= ASSET_VERSION_SKELETAL_MESH_COMPRESSED_ANIM)
+    {
+        mCompressAnimations = stream.ReadBool();
+        mCompressedSampleRate = stream.ReadFloat();
+    }
 }
 
 void SkeletalMesh::SaveStream(Stream& stream, Platform platform)
@@ -274,6 +383,9 @@ void SkeletalMesh::SaveStream(Stream& stream, Platform platform)
     stream.WriteVec3(mBounds.mCenter);
     stream.WriteFloat(mBounds.mRadius);
     stream.WriteFloat(mBoundsScale);
+
+    stream.WriteBool(mCompressAnimations);
+    stream.WriteFloat(mCompressedSampleRate);
 #endif
 }
 
@@ -286,6 +398,24 @@ void SkeletalMesh::Create()
     GFX_CreateSkeletalMeshResource(this, mNumVertices, mVertices.data(), mNumIndices, mIndices.data());
 
     InitBindPose();
+
+    CompressAnimations();
+
+#if !EDITOR
+    // Compressed animations don't need their source keys at runtime.
+    for (Animation& animation : mAnimations)
+    {
+        if (animation.IsCompressed())
+        {
+            for (Channel& channel : animation.mChannels)
+            {
+                std::vector<PositionKey>().swap(channel.mPositionKeys);
+                std::vector<RotationKey>().swap(channel.mRotationKeys);
+                std::vector<ScaleKey>().swap(channel.mScaleKeys);
+            }
+        }
+    }
+#endif
 }
 
 void SkeletalMesh::Destroy()
@@ -363,6 +493,8 @@ void SkeletalMesh::GatherProperties(std::vector<Property>& outProps)
     outProps.push_back(Property(DatumType::Asset, "Material", this, &mMaterial, 1, HandlePropChange, int32_t(Material::GetStaticType())));
     outProps.push_back(Property(DatumType::Asset, "Animation Lookup", this, &mAnimationLookupMesh, 1, HandlePropChange, int32_t(SkeletalMesh::GetStaticType())));
     outProps.push_back(Property(DatumType::Float, "Bounds Scale", this, &mBoundsScale, 1, HandlePropChange));
+    outProps.push_back(Property(DatumType::Bool, "Compress Animations", this, &mCompressAnimations, 1, HandlePropChange));
+    outProps.push_back(Property(DatumType::Float, "Compressed Sample Rate", this, &mCompressedSampleRate, 1, HandlePropChange));
 
     // TODO: Do we want default animations?
     //outProps.push_back(Property(DatumType::String, "Default Animation", this, &mDefaultAnimation));
@@ -435,6 +567,11 @@ uint32_t SkeletalMesh::GetNumBones() const
     return uint32_t(mBones.size());
 }
 
+uint32_t SkeletalMesh::GetBoneDepth(int32_t index) const
+{
+    return mBoneDepths[index];
+}
+
 glm::mat4 SkeletalMesh::GetInvRootTransform() const
 {
     return mInvRootTransform;
@@ -563,6 +700,24 @@ void SkeletalMesh::InitBindPose()
         }
     }
 
+    // Number of ancestors of each bone. Used to drop the extremities at low animation LODs.
+    mBoneDepths.clear();
+    mBoneDepths.resize(mBones.size(), 0);
+
+    for (uint32_t i = 0; i < mBones.size(); ++i)
+    {
+        uint32_t depth = 0;
+        int32_t parentIndex = mBones[i].mParentIndex;
+
+        while (parentIndex != -1 && depth < mBones.size())
+        {
+            parentIndex = mBones[parentIndex].mParentIndex;
+            depth++;
+        }
+
+        mBoneDepths[i] = (uint8_t)glm::min<uint32_t>(depth, 255);
+    }
+
 #if 0
     // If there is a bind pose, save it off.
     for (uint32_t i = 0; i < mAnimations.size(); ++i)
@@ -613,6 +768,89 @@ void SkeletalMesh::ComputeBounds()
     mBounds.mRadius = maxDist;
 }
 
+void SkeletalMesh::CompressAnimations()
+{
+    for (Animation& animation : mAnimations)
+    {
+        CompressedAnimation& compressed = animation.mCompressed;
+        compressed = CompressedAnimation();
+
+        if (!mCompressAnimations ||
+            animation.mTicksPerSecond <= 0.0f)
+        {
+            continue;
+        }
+
+        const uint32_t numChannels = (uint32_t)animation.mChannels.size();
+        const float durationSeconds = animation.mDuration / animation.mTicksPerSecond;
+        const float sampleRate = glm::max(mCompressedSampleRate, 1.0f);
+        const uint32_t numFrames = glm::max(uint32_t(ceilf(durationSeconds * sampleRate)) + 1, 2u);
+
+        compressed.mNumFrames = numFrames;
+        compressed.mFrameTicks = animation.mDuration / float(numFrames - 1);
+        compressed.mRanges.resize(numChannels);
+        compressed.mKeys.resize(numFrames * numChannels);
+
+        std::vector<glm::vec3> positions(numFrames);
+        std::vector<glm::quat> rotations(numFrames);
+        std::vector<glm::vec3> scales(numFrames);
+
+        for (uint32_t c = 0; c < numChannels; ++c)
+        {
+            const Channel& channel = animation.mChannels[c];
+            uint32_t positionCursor = 0;
+            uint32_t rotationCursor = 0;
+            uint32_t scaleCursor = 0;
+
+            glm::vec3 posMin = { FLT_MAX, FLT_MAX, FLT_MAX };
+            glm::vec3 posMax = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+            glm::vec3 scaleMin = posMin;
+            glm::vec3 scaleMax = posMax;
+
+            for (uint32_t f = 0; f < numFrames; ++f)
+            {
+                float time = (f == numFrames - 1) ? animation.mDuration : f * compressed.mFrameTicks;
+
+                positions[f] = SampleVec3Keys(channel.mPositionKeys, time, positionCursor, glm::vec3(0.0f));
+                rotations[f] = SampleRotationKeys(channel.mRotationKeys, time, rotationCursor);
+                scales[f] = SampleVec3Keys(channel.mScaleKeys, time, scaleCursor, glm::vec3(1.0f));
+
+                if (f > 0 && glm::dot(rotations[f - 1], rotations[f]) < 0.0f)
+                {
+                    rotations[f] = -rotations[f];
+                }
+
+                posMin = glm::min(posMin, positions[f]);
+                posMax = glm::max(posMax, positions[f]);
+                scaleMin = glm::min(scaleMin, scales[f]);
+                scaleMax = glm::max(scaleMax, scales[f]);
+            }
+
+            CompressedChannelRange& range = compressed.mRanges[c];
+            range.mPositionMin = posMin;
+            range.mPositionStep = (posMax - posMin) / 65535.0f;
+            range.mScaleMin = scaleMin;
+            range.mScaleStep = (scaleMax - scaleMin) / 65535.0f;
+
+            for (uint32_t f = 0; f < numFrames; ++f)
+            {
+                CompressedKey& key = compressed.mKeys[f * numChannels + c];
+
+                for (uint32_t i = 0; i < 3; ++i)
+                {
+                    key.mPosition[i] = QuantizeUnorm16(positions[f][i], range.mPositionMin[i], range.mPositionStep[i]);
+                    key.mScale[i] = QuantizeUnorm16(scales[f][i], range.mScaleMin[i], range.mScaleStep[i]);
+                }
+
+                key.mRotation[0] = QuantizeSnorm16(rotations[f].x);
+                key.mRotation[1] = QuantizeSnorm16(rotations[f].y);
+                key.mRotation[2] = QuantizeSnorm16(rotations[f].z);
+                key.mRotation[3] = QuantizeSnorm16(rotations[f].w);
+            }
+        }
+    }
+}
+
 #if EDITOR
 void SkeletalMesh::Create(const aiScene& scene,
     const aiMesh& meshData,
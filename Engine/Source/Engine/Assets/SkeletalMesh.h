@@ -73,6 +73,77 @@ struct Channel
     std::vector<ScaleKey> mScaleKeys;
 };
 
+// Returns the index of the key that begins the segment containing time, in [0, numKeys - 2].
+// cursor holds the previous result for this track. Playback usually lands on the same or the
+// next segment, so the binary search is only needed after seeks, loops, or large time steps.
+template<typename KeyType>
+uint32_t FindKeyIndex(const std::vector<KeyType>& keys, float time, uint32_t& cursor)
+{
+    OCT_ASSERT(keys.size() > 1);
+    const uint32_t lastSegment = uint32_t(keys.size() - 2);
+
+    for (uint32_t index = cursor; index <= cursor + 1 && index <= lastSegment; ++index)
+    {
+        if ((index == 0 || time >= keys[index].mTime) &&
+            (index == lastSegment || time < keys[index + 1].mTime))
+        {
+            cursor = index;
+            return index;
+        }
+    }
+
+    // First key after time, ignoring the first and last keys so the result stays in range.
+    uint32_t low = 1;
+    uint32_t high = lastSegment + 1;
+
+    while (low < high)
+    {
+        uint32_t mid = (low + high) / 2;
+
+        if (time < keys[mid].mTime)
+        {
+            high = mid;
+        }
+        else
+        {
+            low = mid + 1;
+        }
+    }
+
+    cursor = low - 1;
+    return cursor;
+}
+
+struct CompressedChannelRange
+{
+    glm::vec3 mPositionMin = {};
+    glm::vec3 mPositionStep = {};
+    glm::vec3 mScaleMin = {};
+    glm::vec3 mScaleStep = {};
+};
+
+struct CompressedKey
+{
+    uint16_t mPosition[3];
+    int16_t mRotation[4];
+    uint16_t mScale[3];
+};
+
+// Channels resampled at a uniform rate. Positions and scales are quantized to 16 bits within
+// each channel's range and rotations are stored as 16 bit normalized quaternions.
+// Keys are stored frame by frame so that sampling every channel reads memory in order.
+struct CompressedAnimation
+{
+    uint32_t mNumFrames = 0;
+    float mFrameTicks = 0.0f;
+    std::vector<CompressedChannelRange> mRanges;
+    std::vector<CompressedKey> mKeys;
+
+    void FindFrames(float tickTime, uint32_t& outFrame0, uint32_t& outFrame1, float& outAlpha) const;
+    void Sample(uint32_t channelIndex, uint32_t frame0, uint32_t frame1, float alpha,
+        glm::vec3& outPosition, glm::quat& outRotation, glm::vec3& outScale) const;
+};
+
 struct Animation
 {
     std::string mName;
@@ -80,6 +151,9 @@ struct Animation
     float mTicksPerSecond = 0.0f;
     std::vector<Channel> mChannels;
     std::vector<AnimEventTrack> mEventTracks;
+    CompressedAnimation mCompressed;
+
+    bool IsCompressed() const { return mCompressed.mNumFrames > 0; }
 };
 
 class SkeletalMesh : public Asset
@@ -117,6 +191,7 @@ public:
     const std::vector<Bone>& GetBones() const;
     const Bone& GetBone(int32_t index) const;
     uint32_t GetNumBones() const;
+    uint32_t GetBoneDepth(int32_t index) const;
 
     glm::mat4 GetInvRootTransform() const;
 
@@ -145,6 +220,7 @@ private:
 
     void InitBindPose();
     void ComputeBounds();
+    void CompressAnimations();
 
     MaterialRef mMaterial;
     SkeletalMeshRef mAnimationLookupMesh;
@@ -158,11 +234,15 @@ private:
 
     glm::mat4 mInvRootTransform;
     std::vector<glm::mat4> mBindPoseMatrices;
+    std::vector<uint8_t> mBoneDepths;
     std::vector<IndexType> mIndices;
 
     Bounds mBounds;
     float mBoundsScale = 1.1f;
 
+    bool mCompressAnimations = false;
+    float mCompressedSampleRate = 30.0f;
+
     // Graphics Resource
     SkeletalMeshResource mResource;
 
@@ -6,6 +6,7 @@
 #include "AudioManager.h"
 
 #include "Audio/Audio.h"
+#include "Audio/AudioConstants.h"
 #include "System/System.h"
 
 FORCE_LINK_DEF(SoundWave);
@@ -60,6 +61,11 @@ void SoundWave::LoadStream(Stream& stream, Platform platform)
     mCompress = stream.ReadBool();
     mCompressInternal = stream.ReadBool();
 
+    if (mVersion >= ASSET_VERSION_SOUND_WAVE_STREAM)
+    {
+        mStream = stream.ReadBool();
+    }
+
     // Waveform Format
     mNumChannels = stream.ReadUint32();
     mBitsPerSample = stream.ReadUint32();
@@ -75,6 +81,10 @@ void SoundWave::LoadStream(Stream& stream, Platform platform)
         uint32_t compressedSize = stream.ReadUint32();
         OCT_UNUSED(compressedSize); // Unused in non-editor
 
+#if !EDITOR && AUDIO_STREAMING_SUPPORTED
+        mStreaming = mStream;
+#endif
+
 #if EDITOR
         // In Editor, we want to keep the compressed data around so in case we save the file again,
         // we won't be recompressing the sound a second time (adding more artifacts / distortion).
@@ -83,16 +93,27 @@ void SoundWave::LoadStream(Stream& stream, Platform platform)
         memcpy(mCompressedData, stream.GetData() + stream.GetPos(), compressedSize);
 #endif
 
-        Stream outStream;
-        PcmFormat format;
-        format.mBytesPerSample = (mBitsPerSample / 8);
-        format.mNumChannels = mNumChannels;
-        format.mSampleRate = mSampleRate;
-        AUD_DecodeVorbis(stream, outStream, format);
-
-        mWaveDataSize = outStream.GetSize();
-        mWaveData = AUD_AllocWaveBuffer(mWaveDataSize);
-        memcpy(mWaveData, outStream.GetData(), mWaveDataSize);
+        if (mStreaming)
+        {
+            // Only the compressed bytes stay resident. Allocated as a wave buffer so that
+            // freeing it waits for the mixer to let go of it.
+            mCompressedData = AUD_AllocWaveBuffer(compressedSize);
+            mCompressedSize = compressedSize;
+            stream.ReadBytes(mCompressedData, compressedSize);
+        }
+        else
+        {
+            Stream outStream;
+            PcmFormat format;
+            format.mBytesPerSample = (mBitsPerSample / 8);
+            format.mNumChannels = mNumChannels;
+            format.mSampleRate = mSampleRate;
+            AUD_DecodeVorbis(stream, outStream, format);
+
+            mWaveDataSize = outStream.GetSize();
+            mWaveData = AUD_AllocWaveBuffer(mWaveDataSize);
+            memcpy(mWaveData, outStream.GetData(), mWaveDataSize);
+        }
     }
     else
     {
@@ -118,6 +139,7 @@ void SoundWave::SaveStream(Stream& stream, Platform platform)
     stream.WriteInt8(mAudioClass);
     stream.WriteBool(mCompress);
     stream.WriteBool(mCompressInternal);
+    stream.WriteBool(mStream);
 
     uint32_t numChannels = mNumChannels;
     uint32_t bitsPerSample = mBitsPerSample;
@@ -305,11 +327,22 @@ void SoundWave::Destroy()
 
     if (mCompressedData != nullptr)
     {
+        if (mStreaming)
+        {
+            AudioManager::StopSounds(this);
+            AUD_FreeWaveBuffer(mCompressedData);
+        }
+        else
+        {
 #if !EDITOR
-        // We should only have compressed data in EDITOR.
-        OCT_ASSERT(0);
+            // Outside of streaming, we should only have compressed data in EDITOR.
+            OCT_ASSERT(0);
 #endif
-        delete mCompressedData;
+            delete mCompressedData;
+        }
+
+        mCompressedData = nullptr;
+        mCompressedSize = 0;
     }
 }
 
@@ -396,6 +429,7 @@ void SoundWave::GatherProperties(std::vector<Property>& outProps)
     outProps.push_back(Property(DatumType::Byte, "Audio Class", this, &mAudioClass, 1, HandlePropChange));
     outProps.push_back(Property(DatumType::Bool, "Compress", this, &mCompress, 1, HandlePropChange));
     outProps.push_back(Property(DatumType::Bool, "Compress Internal", this, &mCompressInternal, 1, HandlePropChange));
+    outProps.push_back(Property(DatumType::Bool, "Stream", this, &mStream, 1, HandlePropChange));
 }
 
 glm::vec4 SoundWave::GetTypeColor()
@@ -466,6 +500,21 @@ uint32_t SoundWave::GetWaveDataSize() const
     return mWaveDataSize;
 }
 
+bool SoundWave::IsStreaming() const
+{
+    return mStreaming;
+}
+
+const uint8_t* SoundWave::GetCompressedData() const
+{
+    return mCompressedData;
+}
+
+uint32_t SoundWave::GetCompressedSize() const
+{
+    return mCompressedSize;
+}
+
 uint32_t SoundWave::GetNumChannels() const
 {
     return mNumChannels;
@@ -34,6 +34,9 @@ public:
 
     uint8_t* GetWaveData() const;
     uint32_t GetWaveDataSize() const;
+    bool IsStreaming() const;
+    const uint8_t* GetCompressedData() const;
+    uint32_t GetCompressedSize() const;
     uint32_t GetNumChannels() const;
     uint32_t GetBitsPerSample() const;
     uint32_t GetSampleRate() const;
@@ -59,6 +62,10 @@ protected:
     int8_t mAudioClass = 0;
     bool mCompress = false;
     bool mCompressInternal = false;
+    bool mStream = false;
+
+    // Compressed data is kept and decoded by the platform mixer during playback instead of at load.
+    bool mStreaming = false;
 
     // Soundwave Format
     uint32_t mNumChannels = 1;
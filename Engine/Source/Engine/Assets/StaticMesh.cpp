@@ -115,21 +115,21 @@ void StaticMesh::LoadStream(Stream& stream, Platform platform)
     mPureVertexColors.clear();
 #endif
 
+    // Vertices and indices are stored as contiguous arrays of 32-bit values that match
+    // the in-memory vertex layout, so they can be copied in bulk.
     if (mHasVertexColor)
     {
         VertexColor* vertices = GetColorVertices();
+        stream.ReadArray32(vertices, mNumVertices * (sizeof(VertexColor) / sizeof(uint32_t)));
+
+#if EDITOR
+        // Cache these to save later. Should not be affected by color scale config.
+        mPureVertexColors.resize(mNumVertices);
         for (uint32_t i = 0; i < mNumVertices; ++i)
         {
-            vertices[i].mPosition = stream.ReadVec3();
-            vertices[i].mTexcoord0 = stream.ReadVec2();
-            vertices[i].mTexcoord1 = stream.ReadVec2();
-            vertices[i].mNormal = stream.ReadVec3();
-            vertices[i].mColor = stream.ReadUint32();
-#if EDITOR
-            // Cache these to save later. Should not be affected by color scale config.
-            mPureVertexColors.push_back(vertices[i].mColor);
-#endif
+            mPureVertexColors[i] = vertices[i].mColor;
         }
+#endif
 
         // Only allow vertex colors to go beyond 1.0 when painted.
         // For meshes with vertex colors, convert to reduced color space.
@@ -150,19 +150,24 @@ void StaticMesh::LoadStream(Stream& stream, Platform platform)
     else
     {
         Vertex* vertices = GetVertices();
-        for (uint32_t i = 0; i < mNumVertices; ++i)
-        {
-            vertices[i].mPosition = stream.ReadVec3();
-            vertices[i].mTexcoord0 = stream.ReadVec2();
-            vertices[i].mTexcoord1 = stream.ReadVec2();
-            vertices[i].mNormal = stream.ReadVec3();
-        }
+        stream.ReadArray32(vertices, mNumVertices * (sizeof(Vertex) / sizeof(uint32_t)));
     }
 
     ResizeIndexArray(mNumIndices);
-    for (uint32_t i = 0; i < mNumIndices; ++i)
+    if (sizeof(IndexType) == sizeof(uint32_t))
     {
-        mIndices[i] = (IndexType) stream.ReadUint32();
+        stream.ReadArray32(mIndices, mNumIndices);
+    }
+    else
+    {
+        // Indices are always serialized as 32-bit. Narrow them for 16-bit index platforms.
+        std::vector<uint32_t> indices32(mNumIndices);
+        stream.ReadArray32(indices32.data(), mNumIndices);
+
+        for (uint32_t i = 0; i < mNumIndices; ++i)
+        {
+            mIndices[i] = (IndexType)indices32[i];
+        }
     }
 
     // Collision shapes
@@ -256,33 +261,28 @@ void StaticMesh::SaveStream(Stream& stream, Platform platform)
 
     if (mHasVertexColor)
     {
-        VertexColor* vertices = GetColorVertices();
+        // Save pure vertex color, unaffected by color scale config setting.
+        std::vector<VertexColor> vertices(GetColorVertices(), GetColorVertices() + mNumVertices);
         for (uint32_t i = 0; i < mNumVertices; ++i)
         {
-            stream.WriteVec3(vertices[i].mPosition);
-            stream.WriteVec2(vertices[i].mTexcoord0);
-            stream.WriteVec2(vertices[i].mTexcoord1);
-            stream.WriteVec3(vertices[i].mNormal);
-
-            // Save pure vertex color, unaffected by color scale config setting.
-            stream.WriteUint32(mPureVertexColors[i]);
+            vertices[i].mColor = mPureVertexColors[i];
         }
+
+        stream.WriteArray32(vertices.data(), mNumVertices * (sizeof(VertexColor) / sizeof(uint32_t)));
     }
     else
     {
-        Vertex* vertices = GetVertices();
-        for (uint32_t i = 0; i < mNumVertices; ++i)
-        {
-            stream.WriteVec3(vertices[i].mPosition);
-            stream.WriteVec2(vertices[i].mTexcoord0);
-            stream.WriteVec2(vertices[i].mTexcoord1);
-            stream.WriteVec3(vertices[i].mNormal);
-        }
+        stream.WriteArray32(GetVertices(), mNumVertices * (sizeof(Vertex) / sizeof(uint32_t)));
     }
 
-    for (uint32_t i = 0; i < mNumIndices; ++i)
+    if (sizeof(IndexType) == sizeof(uint32_t))
+    {
+        stream.WriteArray32(mIndices, mNumIndices);
+    }
+    else
     {
-        stream.WriteUint32(mIndices[i]);
+        std::vector<uint32_t> indices32(mIndices, mIndices + mNumIndices);
+        stream.WriteArray32(indices32.data(), mNumIndices);
     }
 
     // Collision shapes
@@ -1,6 +1,13 @@
 #include "CameraFrustum.h"
 #include "Maths.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FRUSTUM_CULL_SSE 1
+#else
+#define FRUSTUM_CULL_SSE 0
+#endif
+
 // This camera frustum culling code was taken from:
 // http://www.lighthouse3d.com/tutorials/view-frustum-culling/ 
 // The original algorithm was introduced in Game Programming Gems 5 (radar culling).
@@ -150,3 +157,139 @@ bool CameraFrustum::IsSphereInFrustumOrtho(glm::vec3 center, float radius) const
 
     return true;
 }
+
+void CameraFrustum::GetPlanes(glm::vec4 outPlanes[6]) const
+{
+    glm::vec3 normals[6];
+    float offsets[6];
+
+    // Near / Far
+    normals[0] = mBasisZ;
+    offsets[0] = -mNearDist;
+    normals[1] = -mBasisZ;
+    offsets[1] = mFarDist;
+
+    if (mOrtho)
+    {
+        normals[2] = -mBasisX;
+        normals[3] = mBasisX;
+        normals[4] = -mBasisY;
+        normals[5] = mBasisY;
+        offsets[2] = mNearWidth;
+        offsets[3] = mNearWidth;
+        offsets[4] = mNearHeight;
+        offsets[5] = mNearHeight;
+    }
+    else
+    {
+        // Matches the radar test above: |x| <= z * tan * ratio, |y| <= z * tan
+        float tanX = mTangent * mAspectRatio;
+        float tanY = mTangent;
+        normals[2] = mBasisZ * tanX - mBasisX;
+        normals[3] = mBasisZ * tanX + mBasisX;
+        normals[4] = mBasisZ * tanY - mBasisY;
+        normals[5] = mBasisZ * tanY + mBasisY;
+        offsets[2] = 0.0f;
+        offsets[3] = 0.0f;
+        offsets[4] = 0.0f;
+        offsets[5] = 0.0f;
+    }
+
+    // Planes were built relative to the frustum origin, so shift them into world space.
+    for (uint32_t i = 0; i < 6; ++i)
+    {
+        outPlanes[i] = glm::vec4(normals[i], offsets[i] - glm::dot(normals[i], mPosition));
+    }
+}
+
+void CameraFrustum::AreSpheresInFrustum(
+    const float* centerX,
+    const float* centerY,
+    const float* centerZ,
+    const float* radius,
+    uint32_t count,
+    uint8_t* outVisible) const
+{
+    // Perspective and ortho tests share the same form once the half extents are written as
+    // (az * slope + constant). For ortho the slopes are 0 and the sphere factors are 1.
+    const float slopeY = mOrtho ? 0.0f : mTangent;
+    const float slopeX = mOrtho ? 0.0f : mTangent * mAspectRatio;
+    const float constY = mOrtho ? mNearHeight : 0.0f;
+    const float constX = mOrtho ? mNearWidth : 0.0f;
+    const float sphereFactorY = mOrtho ? 1.0f : mSphereFactorY;
+    const float sphereFactorX = mOrtho ? 1.0f : mSphereFactorX;
+
+    uint32_t i = 0;
+
+#if FRUSTUM_CULL_SSE
+    const __m128 posX = _mm_set1_ps(mPosition.x);
+    const __m128 posY = _mm_set1_ps(mPosition.y);
+    const __m128 posZ = _mm_set1_ps(mPosition.z);
+    const __m128 bxX = _mm_set1_ps(mBasisX.x);
+    const __m128 bxY = _mm_set1_ps(mBasisX.y);
+    const __m128 bxZ = _mm_set1_ps(mBasisX.z);
+    const __m128 byX = _mm_set1_ps(mBasisY.x);
+    const __m128 byY = _mm_set1_ps(mBasisY.y);
+    const __m128 byZ = _mm_set1_ps(mBasisY.z);
+    const __m128 bzX = _mm_set1_ps(mBasisZ.x);
+    const __m128 bzY = _mm_set1_ps(mBasisZ.y);
+    const __m128 bzZ = _mm_set1_ps(mBasisZ.z);
+    const __m128 nearDist = _mm_set1_ps(mNearDist);
+    const __m128 farDist = _mm_set1_ps(mFarDist);
+    const __m128 slopeY4 = _mm_set1_ps(slopeY);
+    const __m128 slopeX4 = _mm_set1_ps(slopeX);
+    const __m128 constY4 = _mm_set1_ps(constY);
+    const __m128 constX4 = _mm_set1_ps(constX);
+    const __m128 sphereFactorY4 = _mm_set1_ps(sphereFactorY);
+    const __m128 sphereFactorX4 = _mm_set1_ps(sphereFactorX);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 vx = _mm_sub_ps(_mm_loadu_ps(centerX + i), posX);
+        __m128 vy = _mm_sub_ps(_mm_loadu_ps(centerY + i), posY);
+        __m128 vz = _mm_sub_ps(_mm_loadu_ps(centerZ + i), posZ);
+        __m128 r = _mm_loadu_ps(radius + i);
+
+        __m128 az = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, bzX), _mm_mul_ps(vy, bzY)), _mm_mul_ps(vz, bzZ));
+        __m128 inside = _mm_and_ps(
+            _mm_cmple_ps(az, _mm_add_ps(farDist, r)),
+            _mm_cmpge_ps(az, _mm_sub_ps(nearDist, r)));
+
+        __m128 ay = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, byX), _mm_mul_ps(vy, byY)), _mm_mul_ps(vz, byZ));
+        __m128 vert = _mm_add_ps(_mm_mul_ps(az, slopeY4), constY4);
+        __m128 limitY = _mm_add_ps(vert, _mm_mul_ps(r, sphereFactorY4));
+        inside = _mm_and_ps(inside, _mm_cmple_ps(_mm_and_ps(ay, absMask), limitY));
+
+        __m128 ax = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, bxX), _mm_mul_ps(vy, bxY)), _mm_mul_ps(vz, bxZ));
+        __m128 hori = _mm_add_ps(_mm_mul_ps(az, slopeX4), constX4);
+        __m128 limitX = _mm_add_ps(hori, _mm_mul_ps(r, sphereFactorX4));
+        inside = _mm_and_ps(inside, _mm_cmple_ps(_mm_and_ps(ax, absMask), limitX));
+
+        int mask = _mm_movemask_ps(inside);
+        outVisible[i + 0] = (mask >> 0) & 1;
+        outVisible[i + 1] = (mask >> 1) & 1;
+        outVisible[i + 2] = (mask >> 2) & 1;
+        outVisible[i + 3] = (mask >> 3) & 1;
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        glm::vec3 v = glm::vec3(centerX[i], centerY[i], centerZ[i]) - mPosition;
+        float r = radius[i];
+
+        float az = glm::dot(v, mBasisZ);
+        bool inside = (az <= mFarDist + r) && (az >= mNearDist - r);
+
+        float ay = glm::dot(v, mBasisY);
+        float vert = az * slopeY + constY;
+        inside = inside && (fabsf(ay) <= vert + r * sphereFactorY);
+
+        float ax = glm::dot(v, mBasisX);
+        float hori = az * slopeX + constX;
+        inside = inside && (fabsf(ax) <= hori + r * sphereFactorX);
+
+        outVisible[i] = inside ? 1 : 0;
+    }
+}
@@ -35,4 +35,18 @@ public:
 
     bool IsPointInFrustumOrtho(glm::vec3 p) const;
     bool IsSphereInFrustumOrtho(glm::vec3 center, float radius) const;
+
+    // Planes are (normal, offset) with dot(normal, p) + offset >= 0 for points inside.
+    // Normals are not normalized.
+    void GetPlanes(glm::vec4 outPlanes[6]) const;
+
+    // Batched version of IsSphereInFrustum / IsSphereInFrustumOrtho over structure-of-arrays
+    // sphere data. outVisible[i] is set to 1 if sphere i intersects the frustum, otherwise 0.
+    void AreSpheresInFrustum(
+        const float* centerX,
+        const float* centerY,
+        const float* centerZ,
+        const float* radius,
+        uint32_t count,
+        uint8_t* outVisible) const;
 };
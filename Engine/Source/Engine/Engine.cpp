@@ -13,6 +13,8 @@
 #include "Constants.h"
 #include "Utilities.h"
 #include "Profiler.h"
+#include "JobSystem.h"
+#include "AssetArchive.h"
 #include "Maths.h"
 #include "ScriptAutoReg.h"
 #include "ScriptFunc.h"
@@ -20,6 +22,7 @@
 #include "Nodes/Widgets/Button.h"
 #include "FileWatcher.h"
 #include "ScriptUtils.h"
+#include "ScriptTickScheduler.h"
 
 #include "System/System.h"
 #include "Graphics/Graphics.h"
@@ -279,6 +282,7 @@ bool Initialize()
     CreateProfiler();
     SCOPED_STAT("Initialize");
 
+    JobSystem::Create();
     Renderer::Create();
     AssetManager::Create();
     NetworkManager::Create();
@@ -306,8 +310,22 @@ bool Initialize()
         SYS_SetWorkingDirectory(sEngineConfig.mWorkingDirectory);
     }
 
+    JobSystem::Get()->Initialize();
     AssetManager::Get()->Initialize();
 
+    bool archiveMounted = false;
+
+#if !EDITOR
+    // Packaged desktop builds ship every cooked asset in one archive. When it mounts,
+    // its index replaces the directory and registry scans below.
+    if (SYS_DoesFileExist(ASSET_ARCHIVE_FILENAME, false))
+    {
+        archiveMounted = AssetManager::Get()->MountArchive(ASSET_ARCHIVE_FILENAME);
+    }
+#endif
+
+    bool discoverAssets = !sEngineConfig.mUseAssetRegistry && !archiveMounted;
+
     if (sEngineConfig.mProjectPath != "")
     {
 #if EDITOR
@@ -318,19 +336,20 @@ bool Initialize()
         sEngineState.mProjectDirectory = path.substr(0, path.find_last_of("/\\") + 1);
 #else
         // Editor uses ActionManager::OpenProject()
-        LoadProject(sEngineConfig.mProjectPath, !sEngineConfig.mUseAssetRegistry);
+        LoadProject(sEngineConfig.mProjectPath, discoverAssets);
 #endif
     }
     else if (sEngineConfig.mProjectName != "")
     {
         std::string projectName = sEngineConfig.mProjectName;
         std::string projectPath = projectName + "/" + projectName + ".octp";
-        LoadProject(projectPath, !sEngineConfig.mUseAssetRegistry);
+        LoadProject(projectPath, discoverAssets);
     }
 
 #if !EDITOR
     if (GetEngineState()->mProjectDirectory != "" &&
-        sEngineConfig.mUseAssetRegistry)
+        sEngineConfig.mUseAssetRegistry &&
+        !archiveMounted)
     {
         AssetManager::Get()->DiscoverAssetRegistry((GetEngineState()->mProjectDirectory + "AssetRegistry.txt").c_str());
     }
@@ -352,7 +371,7 @@ bool Initialize()
     // In editor, it's expected that all engine assets are imported manually...
     // At least for now. This is to prevent breaking the editor when a file format changes.
     // Building Data (Ctrl+B) in editor will regenerate .oct files from the source data.
-    if (!sEngineConfig.mUseAssetRegistry)
+    if (discoverAssets)
     {
         AssetManager::Get()->Discover("Engine", "Engine/Assets/");
     }
@@ -612,6 +631,7 @@ bool Update()
 
     END_FRAME_STAT("Frame");
 
+    JobSystem::Get()->EndFrame();
     GetProfiler()->EndFrame();
 
     if (doFrameStep)
@@ -641,6 +661,7 @@ void Shutdown()
     sWorlds.clear();
 
 #if LUA_ENABLED
+    ScriptTickScheduler::Shutdown();
     lua_close(sEngineState.mLua);
     sEngineState.mLua = nullptr;
 #endif
@@ -652,6 +673,7 @@ void Shutdown()
     NetworkManager::Destroy();
     Renderer::Destroy();
     AssetManager::Destroy();
+    JobSystem::Destroy();
 
     NET_Shutdown();
     if (!IsHeadless())
@@ -1059,6 +1081,14 @@ void WriteEngineConfig(std::string path)
         fprintf(configIni, "LqMaxTextureSize=%d\n", sEngineConfig.mLqMaxTextureSize);
         fprintf(configIni, "LqEnableMipMaps=%d\n", sEngineConfig.mLqEnableMipMaps);
 
+        fprintf(configIni, "AsyncLoadThreads=%d\n", sEngineConfig.mAsyncLoadThreads);
+        fprintf(configIni, "AsyncLoadBudget=%f\n", sEngineConfig.mAsyncLoadBudget);
+
+        fprintf(configIni, "PhysicsRate=%d\n", sEngineConfig.mPhysicsRate);
+        fprintf(configIni, "MaxPhysicsSubsteps=%d\n", sEngineConfig.mMaxPhysicsSubsteps);
+        fprintf(configIni, "ParticlePoolSize=%d\n", sEngineConfig.mParticlePoolSize);
+        fprintf(configIni, "BatchScriptTick=%d\n", sEngineConfig.mBatchScriptTick);
+
         fprintf(configIni, "EditorInterfaceScale=%f\n", sEngineConfig.mEditorInterfaceScale);
         fprintf(configIni, "ScriptHotReload=%d\n", sEngineConfig.mScriptHotReload);
         fprintf(configIni, "ColorScale=%d\n", sEngineConfig.mColorScale);
@@ -1166,6 +1196,20 @@ void ReadEngineConfig(std::string path)
             else if (keyStr == "LqEnableMipMaps")
                 sEngineConfig.mLqEnableMipMaps = strToBool(value);
 
+            else if (keyStr == "AsyncLoadThreads")
+                sEngineConfig.mAsyncLoadThreads = atoi(value);
+            else if (keyStr == "AsyncLoadBudget")
+                sEngineConfig.mAsyncLoadBudget = (float)atof(value);
+
+            else if (keyStr == "PhysicsRate")
+                sEngineConfig.mPhysicsRate = atoi(value);
+            else if (keyStr == "MaxPhysicsSubsteps")
+                sEngineConfig.mMaxPhysicsSubsteps = atoi(value);
+            else if (keyStr == "ParticlePoolSize")
+                sEngineConfig.mParticlePoolSize = atoi(value);
+            else if (keyStr == "BatchScriptTick")
+                sEngineConfig.mBatchScriptTick = strToBool(value);
+
             else if (keyStr == "EditorInterfaceScale")
                 sEngineConfig.mEditorInterfaceScale = (float)atof(value);
             else if (keyStr == "ScriptHotReload")
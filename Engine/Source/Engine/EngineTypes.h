@@ -175,6 +175,7 @@ struct DrawData
     int32_t mSortPriority;
     float mDistance2;
     TypeId mNodeType;
+    const void* mInstanceKey; // Adjacent draws with the same key and material can be merged into one instanced draw.
     bool mDepthless;
 };
 
@@ -220,7 +221,10 @@ struct PrimitivePair
 
     size_t operator()(const PrimitivePair& pairToHash) const
     {
-        size_t hash = (size_t)pairToHash.mPrimitiveA + (size_t)pairToHash.mPrimitiveB;
+        // Order-dependent so that (A, B) and (B, A) don't always land in the same bucket.
+        size_t hashA = std::hash<Primitive3D*>()(pairToHash.mPrimitiveA);
+        size_t hashB = std::hash<Primitive3D*>()(pairToHash.mPrimitiveB);
+        size_t hash = hashA ^ (hashB + 0x9e3779b9 + (hashA << 6) + (hashA >> 2));
         return hash;
     }
 
@@ -279,6 +283,15 @@ struct EngineConfig
     int32_t mLqMaxTextureSize = 0;
     bool mLqEnableMipMaps = true;
 
+    int32_t mAsyncLoadThreads = 1;
+    float mAsyncLoadBudget = 4.0f; // Milliseconds per frame spent finishing async loads
+
+    int32_t mPhysicsRate = 60; // Fixed physics steps per second. 0 steps once per frame with the frame delta.
+    int32_t mMaxPhysicsSubsteps = 4; // Time beyond this many steps in a frame is dropped
+
+    int32_t mParticlePoolSize = 0; // Idle SpawnParticle() nodes kept per ParticleSystem. 0 disables pooling.
+    bool mBatchScriptTick = false; // Run script Tick() functions in one Lua call per script class (see ScriptTickScheduler)
+
     std::string mProjectPath;
     std::string mCurrentFont;
     std::string mWorkingDirectory;
@@ -0,0 +1,354 @@
+#include "JobSystem.h"
+#include "System/System.h"
+#include "Profiler.h"
+#include "Log.h"
+#include "Assertion.h"
+
+#define MAX_PARALLEL_FOR_BATCHES 64
+
+JobSystem* JobSystem::sInstance = nullptr;
+
+struct ParallelForBatch
+{
+    ParallelForFuncFP mFunc = nullptr;
+    void* mArg = nullptr;
+    uint32_t mStart = 0;
+    uint32_t mEnd = 0;
+};
+
+static void RunParallelForBatch(void* arg)
+{
+    ParallelForBatch* batch = (ParallelForBatch*)arg;
+    batch->mFunc(batch->mArg, batch->mStart, batch->mEnd);
+}
+
+void JobSystem::Create()
+{
+    Destroy();
+    sInstance = new JobSystem();
+}
+
+void JobSystem::Destroy()
+{
+    if (sInstance != nullptr)
+    {
+        delete sInstance;
+        sInstance = nullptr;
+    }
+}
+
+JobSystem* JobSystem::Get()
+{
+    return sInstance;
+}
+
+JobSystem::JobSystem()
+{
+
+}
+
+JobSystem::~JobSystem()
+{
+    Shutdown();
+}
+
+void JobSystem::Initialize()
+{
+    // Leave one core for the main thread. Single core platforms run every job inline.
+    uint32_t numProcs = SYS_GetNumProcessors();
+    uint32_t numWorkers = (numProcs > 1) ? (numProcs - 1) : 0;
+    numWorkers = glm::min<uint32_t>(numWorkers, MAX_JOB_WORKERS);
+
+    mQueues.resize(numWorkers + 1);
+    for (uint32_t i = 0; i < mQueues.size(); ++i)
+    {
+        mQueues[i].mMutex = SYS_CreateMutex();
+    }
+
+    mWakeSemaphore = SYS_CreateSemaphore(0);
+    mRunning = true;
+
+    for (uint32_t i = 0; i < numWorkers; ++i)
+    {
+        JobWorker* worker = new JobWorker();
+        worker->mJobSystem = this;
+        worker->mIndex = i + 1;
+        mWorkers.push_back(worker);
+    }
+
+    // Only launch threads after the worker list is complete so that
+    // workers never see a partially constructed array.
+    for (uint32_t i = 0; i < mWorkers.size(); ++i)
+    {
+        mWorkers[i]->mThread = SYS_CreateThread(WorkerThreadFunc, mWorkers[i]);
+    }
+
+    mFrameStartTime = SYS_GetTimeMicroseconds();
+
+    LogDebug("Job system initialized with %d worker(s)", numWorkers);
+}
+
+void JobSystem::Shutdown()
+{
+    if (!mRunning)
+    {
+        return;
+    }
+
+    mRunning = false;
+    SYS_PostSemaphore(mWakeSemaphore, (uint32_t)mWorkers.size());
+
+    for (uint32_t i = 0; i < mWorkers.size(); ++i)
+    {
+        SYS_JoinThread(mWorkers[i]->mThread);
+        SYS_DestroyThread(mWorkers[i]->mThread);
+        delete mWorkers[i];
+    }
+
+    mWorkers.clear();
+
+    // Anything still queued at this point was never waited on. Run it so counters resolve.
+    while (ExecuteNextJob(0, nullptr)) {}
+
+    for (uint32_t i = 0; i < mQueues.size(); ++i)
+    {
+        SYS_DestroyMutex(mQueues[i].mMutex);
+    }
+
+    mQueues.clear();
+
+    SYS_DestroySemaphore(mWakeSemaphore);
+    mWakeSemaphore = nullptr;
+}
+
+void JobSystem::EndFrame()
+{
+    uint64_t curTime = SYS_GetTimeMicroseconds();
+    uint64_t frameTime = curTime - mFrameStartTime;
+    mFrameStartTime = curTime;
+
+    for (uint32_t i = 0; i < mWorkers.size(); ++i)
+    {
+        uint64_t busyTime = mWorkers[i]->mBusyTime.exchange(0);
+        float utilization = (frameTime > 0) ? (100.0f * busyTime / frameTime) : 0.0f;
+
+#if PROFILING_ENABLED
+        GetProfiler()->SetWorkerUtilization(i, glm::min(utilization, 100.0f));
+#endif
+    }
+}
+
+void JobSystem::Kick(JobFuncFP func, void* arg, JobCounter* counter)
+{
+    Job job;
+    job.mFunc = func;
+    job.mArg = arg;
+    Kick(&job, 1, counter);
+}
+
+void JobSystem::Kick(const Job* jobs, uint32_t numJobs, JobCounter* counter)
+{
+    if (counter != nullptr)
+    {
+        counter->mValue.fetch_add((int32_t)numJobs);
+    }
+
+    for (uint32_t i = 0; i < numJobs; ++i)
+    {
+        Job job = jobs[i];
+        job.mCounter = counter;
+        PushJob(job);
+    }
+
+    if (mWorkers.size() > 0)
+    {
+        SYS_PostSemaphore(mWakeSemaphore, glm::min<uint32_t>(numJobs, (uint32_t)mWorkers.size()));
+    }
+}
+
+void JobSystem::Wait(JobCounter* counter)
+{
+    while (!counter->IsDone())
+    {
+        if (!ExecuteNextJob(0, nullptr))
+        {
+            // Remaining jobs are running on other threads.
+            SYS_Sleep(0);
+        }
+    }
+}
+
+void JobSystem::ParallelFor(uint32_t count, uint32_t minBatchSize, ParallelForFuncFP func, void* arg)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    minBatchSize = glm::max<uint32_t>(minBatchSize, 1);
+
+    if (mWorkers.size() == 0 || count <= minBatchSize)
+    {
+        func(arg, 0, count);
+        return;
+    }
+
+    // Oversubscribe a little so that stealing can even out uneven batches.
+    uint32_t numThreads = (uint32_t)mWorkers.size() + 1;
+    uint32_t numBatches = (count + minBatchSize - 1) / minBatchSize;
+    numBatches = glm::min<uint32_t>(numBatches, numThreads * 4);
+    numBatches = glm::min<uint32_t>(numBatches, MAX_PARALLEL_FOR_BATCHES);
+    uint32_t batchSize = (count + numBatches - 1) / numBatches;
+    numBatches = (count + batchSize - 1) / batchSize;
+
+    ParallelForBatch batches[MAX_PARALLEL_FOR_BATCHES];
+    Job jobs[MAX_PARALLEL_FOR_BATCHES];
+
+    for (uint32_t i = 0; i < numBatches; ++i)
+    {
+        batches[i].mFunc = func;
+        batches[i].mArg = arg;
+        batches[i].mStart = i * batchSize;
+        batches[i].mEnd = glm::min(count, (i + 1) * batchSize);
+
+        jobs[i].mFunc = RunParallelForBatch;
+        jobs[i].mArg = &batches[i];
+    }
+
+    // The calling thread takes the first batch itself.
+    JobCounter counter;
+    Kick(jobs + 1, numBatches - 1, &counter);
+    RunParallelForBatch(&batches[0]);
+    Wait(&counter);
+}
+
+uint32_t JobSystem::GetNumWorkers() const
+{
+    return (uint32_t)mWorkers.size();
+}
+
+bool JobSystem::IsMultithreaded() const
+{
+    return mWorkers.size() > 0;
+}
+
+ThreadFuncRet JobSystem::WorkerThreadFunc(void* in)
+{
+    JobWorker* worker = (JobWorker*)in;
+    JobSystem* jobSystem = worker->mJobSystem;
+    uint64_t busyTime = 0;
+
+    while (jobSystem->mRunning)
+    {
+        if (jobSystem->ExecuteNextJob(worker->mIndex, &busyTime))
+        {
+            worker->mBusyTime.fetch_add(busyTime);
+        }
+        else
+        {
+            SYS_WaitSemaphore(jobSystem->mWakeSemaphore);
+        }
+    }
+
+    THREAD_RETURN();
+}
+
+void JobSystem::PushJob(const Job& job)
+{
+    if (mWorkers.size() == 0)
+    {
+        // Nobody else could run it, so run it now.
+        job.mFunc(job.mArg);
+
+        if (job.mCounter != nullptr)
+        {
+            job.mCounter->mValue.fetch_sub(1);
+        }
+
+        return;
+    }
+
+    uint32_t queueIndex = mNextQueue.fetch_add(1) % mQueues.size();
+    JobQueue& queue = mQueues[queueIndex];
+
+    SCOPED_LOCK(queue.mMutex);
+    queue.mJobs.push_back(job);
+}
+
+bool JobSystem::PopJob(uint32_t queueIndex, Job& outJob)
+{
+    // The owner takes the most recently pushed job, which is most likely to be warm in cache.
+    JobQueue& queue = mQueues[queueIndex];
+    SCOPED_LOCK(queue.mMutex);
+
+    if (queue.mJobs.size() <= queue.mHead)
+    {
+        return false;
+    }
+
+    outJob = queue.mJobs.back();
+    queue.mJobs.pop_back();
+
+    if (queue.mJobs.size() == queue.mHead)
+    {
+        queue.mJobs.clear();
+        queue.mHead = 0;
+    }
+
+    return true;
+}
+
+bool JobSystem::StealJob(uint32_t queueIndex, Job& outJob)
+{
+    // Thieves take the oldest job from the front of another queue.
+    uint32_t numQueues = (uint32_t)mQueues.size();
+
+    for (uint32_t i = 1; i < numQueues; ++i)
+    {
+        JobQueue& queue = mQueues[(queueIndex + i) % numQueues];
+        SCOPED_LOCK(queue.mMutex);
+
+        if (queue.mJobs.size() > queue.mHead)
+        {
+            outJob = queue.mJobs[queue.mHead];
+            queue.mHead++;
+
+            if (queue.mJobs.size() == queue.mHead)
+            {
+                queue.mJobs.clear();
+                queue.mHead = 0;
+            }
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool JobSystem::ExecuteNextJob(uint32_t queueIndex, uint64_t* busyTime)
+{
+    Job job;
+
+    if (!PopJob(queueIndex, job) &&
+        !StealJob(queueIndex, job))
+    {
+        return false;
+    }
+
+    uint64_t startTime = (busyTime != nullptr) ? SYS_GetTimeMicroseconds() : 0;
+
+    job.mFunc(job.mArg);
+
+    if (busyTime != nullptr)
+    {
+        *busyTime = SYS_GetTimeMicroseconds() - startTime;
+    }
+
+    if (job.mCounter != nullptr)
+    {
+        job.mCounter->mValue.fetch_sub(1);
+    }
+
+    return true;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "System/SystemTypes.h"
+
+#include <stdint.h>
+#include <atomic>
+#include <vector>
+
+#define MAX_JOB_WORKERS 16
+
+class JobSystem;
+
+typedef void(*JobFuncFP)(void* arg);
+typedef void(*ParallelForFuncFP)(void* arg, uint32_t start, uint32_t end);
+
+// Tracks the number of outstanding jobs in a group. Jobs kicked with a counter
+// increment it and decrement it on completion. Use JobSystem::Wait() to block
+// until it reaches zero.
+struct JobCounter
+{
+    std::atomic<int32_t> mValue { 0 };
+
+    bool IsDone() const { return mValue.load(std::memory_order_acquire) == 0; }
+};
+
+struct Job
+{
+    JobFuncFP mFunc = nullptr;
+    void* mArg = nullptr;
+    JobCounter* mCounter = nullptr;
+};
+
+struct JobQueue
+{
+    std::vector<Job> mJobs;
+    uint32_t mHead = 0;
+    MutexObject* mMutex = nullptr;
+};
+
+struct JobWorker
+{
+    JobSystem* mJobSystem = nullptr;
+    ThreadObject* mThread = nullptr;
+    uint32_t mIndex = 0;
+    std::atomic<uint64_t> mBusyTime { 0 };
+};
+
+class JobSystem
+{
+public:
+
+    static void Create();
+    static void Destroy();
+    static JobSystem* Get();
+
+    void Initialize();
+    void Shutdown();
+    void EndFrame();
+
+    // Queue jobs for execution. If counter is provided, it is incremented by the
+    // number of jobs and decremented as each one finishes.
+    void Kick(JobFuncFP func, void* arg, JobCounter* counter = nullptr);
+    void Kick(const Job* jobs, uint32_t numJobs, JobCounter* counter = nullptr);
+
+    // Blocks until the counter reaches zero. The calling thread executes queued jobs while waiting.
+    void Wait(JobCounter* counter);
+
+    // Splits [0, count) into batches of at least minBatchSize and runs func on each batch.
+    // Returns once every batch has finished. Runs inline when no workers are available.
+    void ParallelFor(uint32_t count, uint32_t minBatchSize, ParallelForFuncFP func, void* arg);
+
+    template<typename Func>
+    void ParallelFor(uint32_t count, uint32_t minBatchSize, const Func& func)
+    {
+        ParallelFor(count, minBatchSize, [](void* arg, uint32_t start, uint32_t end)
+        {
+            (*static_cast<const Func*>(arg))(start, end);
+        }, (void*)&func);
+    }
+
+    uint32_t GetNumWorkers() const;
+    bool IsMultithreaded() const;
+
+private:
+
+    static JobSystem* sInstance;
+    JobSystem();
+    ~JobSystem();
+
+    static ThreadFuncRet WorkerThreadFunc(void* in);
+
+    void PushJob(const Job& job);
+    bool PopJob(uint32_t queueIndex, Job& outJob);
+    bool StealJob(uint32_t queueIndex, Job& outJob);
+    bool ExecuteNextJob(uint32_t queueIndex, uint64_t* busyTime);
+
+    // Queue 0 belongs to the main thread, queue N to worker N.
+    std::vector<JobQueue> mQueues;
+    std::vector<JobWorker*> mWorkers;
+    SemaphoreObject* mWakeSemaphore = nullptr;
+    std::atomic<uint32_t> mNextQueue { 0 };
+    std::atomic<bool> mRunning { false };
+    uint64_t mFrameStartTime = 0;
+};
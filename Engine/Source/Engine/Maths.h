@@ -100,3 +100,46 @@ glm::vec3 Maths::RandRange<glm::vec3>(glm::vec3 min, glm::vec3 max);
 
 template<>
 glm::vec4 Maths::RandRange<glm::vec4>(glm::vec4 min, glm::vec4 max);
+
+// Xorshift generator for hot loops (e.g. particle spawning) that would otherwise
+// go through rand(). Each user keeps its own state, so no global state is touched.
+struct FastRand
+{
+    uint32_t mState = 0x9E3779B9u;
+
+    void Seed(uint32_t seed)
+    {
+        mState = (seed != 0) ? seed : 0x9E3779B9u;
+    }
+
+    uint32_t Next()
+    {
+        uint32_t x = mState;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        mState = x;
+        return x;
+    }
+
+    // Uniform in [0, 1]
+    float NextFloat()
+    {
+        return float(Next() >> 8) * (1.0f / 16777215.0f);
+    }
+
+    float Range(float min, float max)
+    {
+        return min + (max - min) * NextFloat();
+    }
+
+    glm::vec2 Range(glm::vec2 min, glm::vec2 max)
+    {
+        return glm::vec2(Range(min.x, max.x), Range(min.y, max.y));
+    }
+
+    glm::vec3 Range(glm::vec3 min, glm::vec3 max)
+    {
+        return glm::vec3(Range(min.x, max.x), Range(min.y, max.y), Range(min.z, max.z));
+    }
+};
@@ -25,108 +25,26 @@ NetDatum::NetDatum(
 
 bool NetDatum::ShouldReplicate() const
 {
-    // Only replicate if the data has changed
     if (mType == DatumType::Count)
         return false;
 
-    // NetDatum count should never change after init.
-    OCT_ASSERT(mPrevCount == 0 ||
-           mPrevCount == mCount);
-
-    if (mAlwaysReplicate)
-        return true;
-
-    if (mCount != mPrevCount)
-        return true;
-
-    bool equal = true;
-    for (uint32_t i = 0; i < mCount; ++i)
-    {
-        switch (mType)
-        {
-            case DatumType::Integer: equal = (mPrevData.i[i] == mData.i[i]); break;
-            case DatumType::Float: equal = (mPrevData.f[i] == mData.f[i]); break;
-            case DatumType::Bool: equal = (mPrevData.b[i] == mData.b[i]); break;
-            case DatumType::String: equal = (mPrevData.s[i] == mData.s[i]); break;
-            case DatumType::Vector2D: equal = (mPrevData.v2[i] == mData.v2[i]); break;
-            case DatumType::Vector: equal = (mPrevData.v3[i] == mData.v3[i]); break;
-            case DatumType::Color: equal = (mPrevData.v4[i] == mData.v4[i]); break;
-            case DatumType::Asset: equal = (mPrevData.as[i] == mData.as[i]); break;
-            case DatumType::Byte: equal = (mPrevData.by[i] == mData.by[i]); break;
-            case DatumType::Table: equal = false; OCT_ASSERT(0); break; // Table not supported for replication
-            case DatumType::Node: equal = (mPrevData.n[i] == mData.n[i]); break;
-            case DatumType::Short: equal = (mPrevData.sh[i] == mData.sh[i]); break;
-            case DatumType::Function: equal = false; OCT_ASSERT(0); break; // Functions not supported for replication
-
-            case DatumType::Count: break;
-        }
-
-        if (!equal)
-        {
-            break;
-        }
-    }
-
-    return !equal;
+    return mDirty || mAlwaysReplicate;
 }
 
 void NetDatum::PostReplicate()
 {
     OCT_ASSERT(mType != DatumType::Count);
-
-    // NetDatums should never change size (except at initialization)
-    // We could possible get rid off the mPrevCount member, but I'm using it
-    // for sanity checking that the size doesn't change. It could be made Debug only?
-    if (mPrevData.vp == nullptr)
-    {
-        OCT_ASSERT(mPrevCount == 0);
-        mPrevData.vp = calloc(mCount, GetDataTypeSize());
-        for (uint32_t i = 0; i < mCount; ++i)
-        {
-            ConstructData(mPrevData, i);
-        }
-
-        mPrevCount = mCount;
-    }
-
-    // Copy members over
-    for (uint32_t i = 0; i < mCount; ++i)
-    {
-        switch (mType)
-        {
-            case DatumType::Integer: mPrevData.i[i] = mData.i[i]; break;
-            case DatumType::Float: mPrevData.f[i] = mData.f[i]; break;
-            case DatumType::Bool: mPrevData.b[i] = mData.b[i]; break;
-            case DatumType::String: mPrevData.s[i] = mData.s[i]; break;
-            case DatumType::Vector2D: mPrevData.v2[i] = mData.v2[i]; break;
-            case DatumType::Vector: mPrevData.v3[i] = mData.v3[i]; break;
-            case DatumType::Color: mPrevData.v4[i] = mData.v4[i]; break;
-            case DatumType::Asset: mPrevData.as[i] = mData.as[i]; break;
-            case DatumType::Byte: mPrevData.by[i] = mData.by[i]; break;
-            case DatumType::Table: OCT_ASSERT(0); break; // Table not supported for replication
-            case DatumType::Node: mPrevData.n[i] = mData.n[i]; break;
-            case DatumType::Short: mPrevData.sh[i] = mData.sh[i]; break;
-            case DatumType::Function: OCT_ASSERT(0); break; // Function not supported for replication
-
-            case DatumType::Count: break;
-        }
-    }
+    mDirty = false;
 }
 
-void NetDatum::Destroy()
+void NetDatum::MarkDirty()
 {
-    if (mPrevData.vp != nullptr)
-    {
-        for (uint32_t i = 0; i < mPrevCount; ++i)
-        {
-            DestructData(mPrevData, i);
-        }
-
-        free(mPrevData.vp);
-        mPrevData.vp = nullptr;
-    }
+    mDirty = true;
+}
 
-    mPrevCount = 0;
+bool NetDatum::IsDirty() const
+{
+    return mDirty;
 }
 
 
@@ -17,12 +17,16 @@ public:
         bool alwaysReplicate = false);
     bool ShouldReplicate() const;
     void PostReplicate();
-    
+
+    // Changes are tracked on write instead of by comparing against the last replicated value.
+    // Whatever writes to the replicated data must call MarkDirty() (or Node::MarkNetDirty()).
+    void MarkDirty();
+    bool IsDirty() const;
+
 protected:
-    virtual void Destroy() override;
 
-    DatumData mPrevData = {};
-    uint32_t mPrevCount = 0;
+    // New datums start dirty so that their initial value is replicated.
+    bool mDirty = true;
     bool mAlwaysReplicate = false;
 };
 
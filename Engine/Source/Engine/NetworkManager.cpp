@@ -2,6 +2,7 @@
 #include "Engine.h"
 #include "Log.h"
 #include "Nodes/Node.h"
+#include "Nodes/3D/Node3d.h"
 #include "Assets/Scene.h"
 #include "World.h"
 #include "Profiler.h"
@@ -13,6 +14,8 @@
 #include "Network/NetPlatformEpic.h"
 #include "Network/NetPlatformSteam.h"
 
+#include <algorithm>
+
 #ifdef SendMessage
 #undef SendMessage
 #endif
@@ -86,9 +89,8 @@ void UpdateDebugPackets(float deltaTime)
 
 #endif
 
-// Avoid dynamic allocations when appropriate. Reuse static messages.
-static NetMsgReplicate sMsgReplicate;
-static NetMsgReplicateScript sMsgReplicateScript;
+// Outgoing replicate messages are serialized straight from the NetDatums into this buffer.
+static char sReplicateMsgData[OCT_MAX_MSG_BODY_SIZE] = {};
 
 // Reliable messaging
 static float sReliableResendTime = 0.1f;
@@ -763,20 +765,24 @@ void NetworkManager::SendMessage(const NetMsg* netMsg, NetHostProfile* hostProfi
         Stream stream(msgData, OCT_MAX_MSG_BODY_SIZE);
         netMsg->Write(stream);
 
-        bool reliable = netMsg->IsReliable();
-        std::vector<char>& sendBuffer = reliable ? hostProfile->mReliableSendBuffer : hostProfile->mSendBuffer;
+        QueueMessageData(hostProfile, stream.GetData(), stream.GetPos(), netMsg->IsReliable());
+    }
+}
 
-        // If this newly serialized message would cause send buffer to exceed max message size,
-        // then send out the queued messages first.
-        if (sendBuffer.size() + stream.GetPos() > OCT_MAX_MSG_BODY_SIZE)
-        {
-            FlushSendBuffer(hostProfile, reliable);
-        }
+void NetworkManager::QueueMessageData(NetHostProfile* hostProfile, const char* data, uint32_t size, bool reliable)
+{
+    std::vector<char>& sendBuffer = reliable ? hostProfile->mReliableSendBuffer : hostProfile->mSendBuffer;
 
-        uint32_t startByte = (uint32_t)sendBuffer.size();
-        sendBuffer.resize(sendBuffer.size() + stream.GetPos());
-        memcpy(sendBuffer.data() + startByte, stream.GetData(), stream.GetPos());
+    // If this newly serialized message would cause send buffer to exceed max message size,
+    // then send out the queued messages first.
+    if (sendBuffer.size() + size > OCT_MAX_MSG_BODY_SIZE)
+    {
+        FlushSendBuffer(hostProfile, reliable);
     }
+
+    uint32_t startByte = (uint32_t)sendBuffer.size();
+    sendBuffer.resize(sendBuffer.size() + size);
+    memcpy(sendBuffer.data() + startByte, data, size);
 }
 
 void NetworkManager::SendMessageToAllClients(const NetMsg* netMsg)
@@ -791,6 +797,16 @@ void NetworkManager::SendMessageToAllClients(const NetMsg* netMsg)
 void NetworkManager::SendMessageToAllRelevantClients(const NetMsg* netMsg, NetId nodeNetId)
 {
     OCT_ASSERT(IsServer());
+
+    char msgData[OCT_MAX_MSG_BODY_SIZE] = {};
+    Stream stream(msgData, OCT_MAX_MSG_BODY_SIZE);
+    netMsg->Write(stream);
+
+    QueueMessageDataToRelevantClients(nodeNetId, stream.GetData(), stream.GetPos(), netMsg->IsReliable());
+}
+
+void NetworkManager::QueueMessageDataToRelevantClients(NetId nodeNetId, const char* data, uint32_t size, bool reliable)
+{
     for (uint32_t i = 0; i < mClients.size(); ++i)
     {
         bool relevant = true;
@@ -803,7 +819,7 @@ void NetworkManager::SendMessageToAllRelevantClients(const NetMsg* netMsg, NetId
 
         if (relevant)
         {
-            SendMessage(netMsg, &mClients[i]);
+            QueueMessageData(&mClients[i], data, size, reliable);
         }
     }
 }
@@ -1029,6 +1045,7 @@ void NetworkManager::AddNetNode(Node* node, NetId netId)
                 node->SetNetId(netId);
                 mNetNodeMap.insert({ netId, node });
                 mNetNodes.push_back(node);
+                node->MarkNetDirty();
 
                 // The server needs to send Spawn messages for newly added network actors.
                 if (NetIsServer())
@@ -1071,12 +1088,7 @@ void NetworkManager::RemoveNetNode(Node* node)
             {
                 mNetNodes.erase(mNetNodes.begin() + i);
 
-                // Adjust these indices so we don't skip a node when doing replication and relevancy updates
-                if (i < mReplicationIndex && i > 0)
-                {
-                    --mReplicationIndex;
-                }
-
+                // Adjust these indices so we don't skip a node when doing incremental replication and relevancy updates
                 if (i < mIncrementalRepIndex && i > 0)
                 {
                     --mIncrementalRepIndex;
@@ -1091,10 +1103,25 @@ void NetworkManager::RemoveNetNode(Node* node)
             }
         }
 
+        if (node->IsNetDirty())
+        {
+            // Null out the entry instead of erasing it so that mReplicationIndex stays valid.
+            std::replace(mDirtyNetNodes.begin(), mDirtyNetNodes.end(), node, (Node*)nullptr);
+            std::replace(mReplicatingNetNodes.begin(), mReplicatingNetNodes.end(), node, (Node*)nullptr);
+            node->ClearNetDirty();
+        }
+
         node->SetNetId(INVALID_NET_ID);
     }
 }
 
+void NetworkManager::AddDirtyNetNode(Node* node)
+{
+    // Node::MarkNetDirty() makes sure a node is only queued once until it is replicated.
+    OCT_ASSERT(node->IsNetDirty());
+    mDirtyNetNodes.push_back(node);
+}
+
 const std::unordered_map<NetId, Node*>& NetworkManager::GetNetNodeMap() const
 {
     return mNetNodeMap;
@@ -1419,8 +1446,13 @@ void NetworkManager::HandleBroadcast(
     }
 }
 
+// Matches NetMsgReplicate::Write(). The variable count is patched in once the message is complete.
+static const uint32_t RepMsgNumVarsOffset =
+    sizeof(NetMsgType) +
+    sizeof(NetMsgReplicate::mNodeNetId);
+
 static const uint32_t RepMsgHeaderSize = 
-    sizeof(NetMsgReplicate::mNodeNetId) +
+    RepMsgNumVarsOffset +
     sizeof(NetMsgReplicate::mNumVariables);
 
 static const uint32_t MaxDatumNetSerializeSize = 
@@ -1428,30 +1460,30 @@ static const uint32_t MaxDatumNetSerializeSize =
     RepMsgHeaderSize -
     sizeof(uint16_t); // 1 index
 
-void NetworkManager::SendReplicateMsg(NetMsgReplicate& repMsg, uint32_t& numVars, NetHostId hostId)
+void NetworkManager::SendReplicateMsg(Stream& msgStream, uint16_t numVars, NetId nodeNetId, NetHostId hostId, bool reliable)
 {
     OCT_ASSERT(numVars > 0);
 
-    repMsg.mNumVariables = numVars;
+    uint32_t msgSize = msgStream.GetPos();
+    msgStream.SetPos(RepMsgNumVarsOffset);
+    msgStream.WriteUint16(numVars);
+    msgStream.SetPos(msgSize);
 
+    // The message is serialized once and copied into the send buffer of each relevant client.
     if (hostId == INVALID_HOST_ID)
     {
-        SendMessageToAllRelevantClients(&repMsg, repMsg.mNodeNetId);
+        QueueMessageDataToRelevantClients(nodeNetId, msgStream.GetData(), msgSize, reliable);
     }
     else
     {
-        bool relevant = IsNetIdRelevantToHost(repMsg.mNodeNetId, hostId);
+        NetClient* client = FindNetClient(hostId);
+        bool relevant = IsNetIdRelevantToHost(nodeNetId, hostId);
 
-        if (relevant)
+        if (client != nullptr && relevant)
         {
-            SendMessage(&repMsg, hostId);
+            QueueMessageData(client, msgStream.GetData(), msgSize, reliable);
         }
     }
-
-    repMsg.mIndices.clear();
-    repMsg.mData. clear();
-    repMsg.mNumVariables = 0;
-    numVars = 0;
 }
 
 void NetworkManager::SendInvokeMsg(NetMsgInvoke& msg, Node* node, NetFunc* func, uint32_t numParams, const Datum** params)
@@ -1618,6 +1650,7 @@ void NetworkManager::UpdateReplication(float deltaTime)
     // TODO: Handle multiple worlds. Pass world into update replication.
 
     Node* incRepNode = nullptr;
+    uint32_t incRepIndex = mIncrementalRepIndex;
 
     if (IsIncrementalReplicationEnabled())
     {
@@ -1653,31 +1686,57 @@ void NetworkManager::UpdateReplication(float deltaTime)
         }
     }
 
-    // Do the replication
-    uint32_t numNodesReplicated = 0;
+    // Do the replication. Only nodes that were marked dirty since their last replication are visited.
+    // Each replication interval takes the nodes that were marked dirty during the previous one
+    // and spreads them evenly over its duration.
     float remainingDeltaTime = deltaTime;
 
     int32_t loopCount = 0;
 
     while (loopCount < 2 && remainingDeltaTime > 0.0f)
     {
+        if (mReplicationTimer == 0.0f)
+        {
+            OCT_ASSERT(mReplicationIndex == 0);
+            mReplicatingNetNodes.clear();
+            mReplicatingNetNodes.swap(mDirtyNetNodes);
+        }
+
+        float prevRepRatio = (mReplicationInterval > 0.0f) ? (mReplicationTimer / mReplicationInterval) : 0.0f;
+        prevRepRatio = glm::clamp(prevRepRatio, 0.0f, 1.0f);
+
         mReplicationTimer += remainingDeltaTime;
         float repRatio = (mReplicationInterval > 0.0f) ? (mReplicationTimer / mReplicationInterval) : 1.0f;
         repRatio = glm::clamp(repRatio, 0.0f, 1.0f);
 
+        // Forced replication (in case unreliable updates were dropped) only happens when the
+        // incremental node falls in this frame's slice of mNetNodes, same as when every net node was visited.
+        uint32_t numNetNodes = uint32_t(mNetNodes.size());
+        uint32_t netStartIndex = uint32_t(prevRepRatio * numNetNodes + 0.5f);
+        uint32_t netEndIndex = uint32_t(repRatio * numNetNodes + 0.5f);
+
+        if (incRepNode != nullptr &&
+            incRepIndex >= netStartIndex &&
+            incRepIndex < netEndIndex)
+        {
+            ReplicateNode(incRepNode, INVALID_HOST_ID, true, false);
+        }
+
+        uint32_t numRepNodes = uint32_t(mReplicatingNetNodes.size());
         uint32_t startIndex = mReplicationIndex;
-        mReplicationIndex = uint32_t(repRatio * mNetNodes.size() + 0.5f);
-        mReplicationIndex = glm::clamp<uint32_t>(mReplicationIndex, 0u, uint32_t(mNetNodes.size()));
+        mReplicationIndex = uint32_t(repRatio * numRepNodes + 0.5f);
+        mReplicationIndex = glm::clamp<uint32_t>(mReplicationIndex, startIndex, numRepNodes);
 
         for (uint32_t i = startIndex; i < mReplicationIndex; ++i)
         {
-            Node* node = mNetNodes[i];
-            bool forceRep = (node == incRepNode);
-            bool nodeReplicated = ReplicateNode(node, INVALID_HOST_ID, forceRep, false);
+            // Entries of nodes removed from the network are nulled out.
+            Node* node = mReplicatingNetNodes[i];
 
-            if (nodeReplicated)
+            if (node != nullptr)
             {
-                numNodesReplicated++;
+                // Clear first so that changes made from here on queue the node again.
+                node->ClearNetDirty();
+                ReplicateNode(node, INVALID_HOST_ID, false, false);
             }
         }
 
@@ -1698,17 +1757,18 @@ void NetworkManager::UpdateReplication(float deltaTime)
 }
 
 template<typename T>
-bool ReplicateData(std::vector<T>& repData, NetMsgReplicate& msg, NetId hostId, bool force, bool reliable)
+bool ReplicateData(std::vector<T>& repData, NetMsgType msgType, NetId nodeNetId, NetHostId hostId, bool force, bool reliable)
 {
-    // msg.mNetId should already be set by caller.
-    msg.mIndices.clear();
-    msg.mData.clear();
-    msg.mReliable = reliable;
-
     bool replicated = false;
-    uint32_t numVars = 0;
+    uint16_t numVars = 0;
+
+    // Dirty flags are only cleared when all clients are sent the changes.
+    bool postReplicate = (hostId == INVALID_HOST_ID);
 
-    uint32_t msgSerializedSize = RepMsgHeaderSize;
+    Stream stream(sReplicateMsgData, OCT_MAX_MSG_BODY_SIZE);
+    stream.WriteUint8((uint8_t)msgType);
+    stream.WriteUint32(nodeNetId);
+    stream.WriteUint16(0);
 
     for (uint32_t i = 0; i < repData.size(); ++i)
     {
@@ -1725,27 +1785,29 @@ bool ReplicateData(std::vector<T>& repData, NetMsgReplicate& msg, NetId hostId,
                 LogWarning("Replicated variable too large to replicate. Most likely a big string.");
                 continue;
             }
-            else if (msgSerializedSize + datumSerializeSize > OCT_MAX_MSG_BODY_SIZE)
+            else if (stream.GetPos() + sizeof(uint16_t) + datumSerializeSize > OCT_MAX_MSG_BODY_SIZE)
             {
                 // Send what we have until now
-                NetworkManager::Get()->SendReplicateMsg(msg, numVars, hostId);
-                msgSerializedSize = RepMsgHeaderSize;
+                NetworkManager::Get()->SendReplicateMsg(stream, numVars, nodeNetId, hostId, reliable);
+                stream.SetPos(RepMsgHeaderSize);
+                numVars = 0;
                 replicated = true;
             }
 
-            msg.mIndices.push_back((uint16_t)i);
-            msg.mData.push_back(Datum(repData[i]));
-
+            stream.WriteUint16((uint16_t)i);
+            repData[i].WriteStream(stream, true);
             numVars++;
-            msgSerializedSize += datumSerializeSize;
-            repData[i].PostReplicate();
+
+            if (postReplicate)
+            {
+                repData[i].PostReplicate();
+            }
         }
     }
 
     if (numVars > 0)
     {
-        NetworkManager::Get()->SendReplicateMsg(msg, numVars, hostId);
-        msgSerializedSize = RepMsgHeaderSize;
+        NetworkManager::Get()->SendReplicateMsg(stream, numVars, nodeNetId, hostId, reliable);
         replicated = true;
     }
 
@@ -1758,19 +1820,22 @@ bool NetworkManager::ReplicateNode(Node* node, NetId hostId, bool force, bool re
     bool needsForcedRep = node->NeedsForcedReplication();
     force = (force || needsForcedRep);
     reliable = (reliable || needsForcedRep || mEnableReliableReplication);
-    sMsgReplicate.mNodeNetId = node->GetNetId();
+
+    // The replicated rotation is only brought up to date when the transform is.
+    if (node->IsTransformReplicated() && node->IsNode3D())
+    {
+        static_cast<Node3D*>(node)->UpdateTransform(false);
+    }
 
     std::vector<NetDatum>& repData = node->GetReplicatedData();
 
-    nodeReplicated = ReplicateData<NetDatum>(repData, sMsgReplicate, hostId, force, reliable);
+    nodeReplicated = ReplicateData<NetDatum>(repData, NetMsgType::Replicate, node->GetNetId(), hostId, force, reliable);
 
     Script* script = node->GetScript();
     if (script != nullptr && script->IsActive())
     {
-        sMsgReplicateScript.mNodeNetId = node->GetNetId();
-
         std::vector<ScriptNetDatum>& scriptRepData = script->GetReplicatedData();
-        nodeReplicated = ReplicateData<ScriptNetDatum>(scriptRepData, sMsgReplicateScript, hostId, force, reliable);
+        nodeReplicated = ReplicateData<ScriptNetDatum>(scriptRepData, NetMsgType::ReplicateScript, node->GetNetId(), hostId, force, reliable) || nodeReplicated;
     }
 
     node->ClearForcedReplication();
@@ -2120,6 +2185,11 @@ void NetworkManager::ResetToLocalStatus()
         mHostId = AUTHORITY_HOST_ID;
         mServer = NetServer();
         mInOnlineSession = false;
+
+        mDirtyNetNodes.clear();
+        mReplicatingNetNodes.clear();
+        mReplicationIndex = 0;
+        mReplicationTimer = 0.0f;
     }
 }
 
@@ -87,7 +87,7 @@ public:
     int32_t RecvFrom(char* buffer, uint32_t size, NetHost& outHost);
     void SendTo(const NetHost& host, const char* buffer, uint32_t size);
 
-    void SendReplicateMsg(NetMsgReplicate& repMsg, uint32_t& numVars, NetHostId hostId);
+    void SendReplicateMsg(Stream& msgStream, uint16_t numVars, NetId nodeNetId, NetHostId hostId, bool reliable);
     void SendInvokeMsg(NetMsgInvoke& msg, Node* node, NetFunc* func, uint32_t numParams, const Datum** params);
     void SendInvokeMsg(Node* node, NetFunc* func, uint32_t numParams, const Datum** params);
     void SendInvokeScriptMsg(Script* script, ScriptNetFunc* func, uint32_t numParams, const Datum** params);
@@ -125,6 +125,7 @@ public:
 
     void AddNetNode(Node* node, NetId netId);
     void RemoveNetNode(Node* node);
+    void AddDirtyNetNode(Node* node);
     const std::unordered_map<NetId, Node*>& GetNetNodeMap() const;
     Node* GetNetNode(NetId netId);
 
@@ -173,6 +174,8 @@ private:
     void BroadcastSession();
     void FlushSendBuffers(NetHostProfile* hostProfile);
     void FlushSendBuffer(NetHostProfile* hostProfile, bool reliable);
+    void QueueMessageData(NetHostProfile* hostProfile, const char* data, uint32_t size, bool reliable);
+    void QueueMessageDataToRelevantClients(NetId nodeNetId, const char* data, uint32_t size, bool reliable);
     void UpdateReliablePackets(float deltaTime);
     bool UpdateReliablePackets(NetHostProfile* profile, float deltaTime);
     void ResetHostProfile(NetHostProfile* profile);
@@ -187,6 +190,8 @@ private:
     std::vector<NetSession> mSessions;
     std::unordered_map<NetId, Node*> mNetNodeMap;
     std::vector<Node*> mNetNodes;
+    std::vector<Node*> mDirtyNetNodes;
+    std::vector<Node*> mReplicatingNetNodes;
     NetServer mServer;
     uint32_t mBroadcastIp = 0;
     uint32_t mMaxClients = 15;
@@ -218,6 +218,7 @@ void InstancedMesh3D::UpdateInstanceData()
     {
         RecreateCollisionShape();
         CalculateLocalBounds();
+        MarkBoundsDirty();
 
         mInstanceDataDirty = false;
         mInstanceDataUpdatedThisFrame = true;
@@ -175,6 +175,7 @@ void Node3D::AttachToBone(SkeletalMesh3D* parent, int32_t boneIndex, bool keepWo
 void Node3D::MarkTransformDirty()
 {
     mTransformDirty = true;
+    MarkBoundsDirty();
 
     // TODO-NODE: Consider propogating this to children nodes. 
     // It looks like Godot does it this way, and might remove some one-frame-delay bugs.
@@ -194,6 +195,35 @@ bool Node3D::IsTransformDirty() const
     return mTransformDirty;
 }
 
+void Node3D::MarkBoundsDirty()
+{
+    // Transforms are resolved lazily, so a moved parent also invalidates the
+    // bounds of every 3D descendant in the world's primitive tree.
+    if (!mBoundsDirty && mWorld != nullptr)
+    {
+        mBoundsDirty = true;
+        mWorld->AddDirtyBoundsNode(this);
+
+        for (uint32_t i = 0; i < mChildren.size(); ++i)
+        {
+            if (mChildren[i]->IsNode3D())
+            {
+                static_cast<Node3D*>(mChildren[i].Get())->MarkBoundsDirty();
+            }
+        }
+    }
+}
+
+bool Node3D::IsBoundsDirty() const
+{
+    return mBoundsDirty;
+}
+
+void Node3D::ClearBoundsDirty()
+{
+    mBoundsDirty = false;
+}
+
 void Node3D::UpdateTransform(bool updateChildren)
 {
     // First we need to update parent transform if it's dirty.
@@ -376,6 +406,11 @@ const glm::mat4& Node3D::GetTransform()
 
 void Node3D::SetPosition(glm::vec3 position)
 {
+    if (mPosition != position)
+    {
+        MarkNetDirty(&mPosition);
+    }
+
     mPosition = position;
     MarkTransformDirty();
 }
@@ -387,12 +422,25 @@ void Node3D::SetRotation(glm::vec3 rotation)
 
 void Node3D::SetRotation(glm::quat quat)
 {
-    mRotationQuat = glm::normalize(quat);
+    quat = glm::normalize(quat);
+
+    // mRotationEuler is replicated, but it isn't updated until UpdateTransform().
+    if (mRotationQuat != quat)
+    {
+        MarkNetDirty(&mRotationEuler);
+    }
+
+    mRotationQuat = quat;
     MarkTransformDirty();
 }
 
 void Node3D::SetScale(glm::vec3 scale)
 {
+    if (mScale != scale)
+    {
+        MarkNetDirty(&mScale);
+    }
+
     mScale = scale;
     MarkTransformDirty();
 }
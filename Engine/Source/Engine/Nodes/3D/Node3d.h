@@ -35,6 +35,10 @@ public:
     bool IsTransformDirty() const;
     virtual void UpdateTransform(bool updateChildren);
 
+    void MarkBoundsDirty();
+    bool IsBoundsDirty() const;
+    void ClearBoundsDirty();
+
     virtual bool CheckNetRelevance(Node* playerNode) override;
 
     virtual void GatherProxyDraws(std::vector<DebugDraw>& inoutDraws);
@@ -109,4 +113,5 @@ protected:
     bool mInheritTransform = true;
 
     bool mTransformDirty;
+    bool mBoundsDirty = false;
 };
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "Utilities.h"
 #include "Maths.h"
 #include "Profiler.h"
+#include "JobSystem.h"
 #include "Assets/ParticleSystemInstance.h"
 
 #include "Graphics/Graphics.h"
@@ -14,6 +15,17 @@
 #include "EditorState.h"
 #endif
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PARTICLE_SSE 1
+#else
+#define PARTICLE_SSE 0
+#endif
+
+// Systems with at least this many particles split their update and vertex expansion across job workers.
+#define PARTICLE_PARALLEL_THRESHOLD 4096
+#define PARTICLE_PARALLEL_BATCH 1024
+
 FORCE_LINK_DEF(Particle3D);
 DEFINE_NODE(Particle3D, Primitive3D);
 
@@ -29,6 +41,398 @@ const char* sParticleOrientationStrings[] =
 };
 static_assert(int32_t(ParticleOrientation::Count) == 7, "Need to update string conversion table");
 
+uint32_t ParticlePool::GetSize() const
+{
+    return (uint32_t)mLifetime.size();
+}
+
+void ParticlePool::Reserve(uint32_t count)
+{
+    mPositionX.reserve(count);
+    mPositionY.reserve(count);
+    mPositionZ.reserve(count);
+    mVelocityX.reserve(count);
+    mVelocityY.reserve(count);
+    mVelocityZ.reserve(count);
+    mElapsedTime.reserve(count);
+    mLifetime.reserve(count);
+    mSizeX.reserve(count);
+    mSizeY.reserve(count);
+    mRotationSpeed.reserve(count);
+    mRotation.reserve(count);
+}
+
+void ParticlePool::Clear()
+{
+    mPositionX.clear();
+    mPositionY.clear();
+    mPositionZ.clear();
+    mVelocityX.clear();
+    mVelocityY.clear();
+    mVelocityZ.clear();
+    mElapsedTime.clear();
+    mLifetime.clear();
+    mSizeX.clear();
+    mSizeY.clear();
+    mRotationSpeed.clear();
+    mRotation.clear();
+}
+
+void ParticlePool::ShrinkToFit()
+{
+    mPositionX.shrink_to_fit();
+    mPositionY.shrink_to_fit();
+    mPositionZ.shrink_to_fit();
+    mVelocityX.shrink_to_fit();
+    mVelocityY.shrink_to_fit();
+    mVelocityZ.shrink_to_fit();
+    mElapsedTime.shrink_to_fit();
+    mLifetime.shrink_to_fit();
+    mSizeX.shrink_to_fit();
+    mSizeY.shrink_to_fit();
+    mRotationSpeed.shrink_to_fit();
+    mRotation.shrink_to_fit();
+}
+
+void ParticlePool::Add(const Particle& particle)
+{
+    mPositionX.push_back(particle.mPosition.x);
+    mPositionY.push_back(particle.mPosition.y);
+    mPositionZ.push_back(particle.mPosition.z);
+    mVelocityX.push_back(particle.mVelocity.x);
+    mVelocityY.push_back(particle.mVelocity.y);
+    mVelocityZ.push_back(particle.mVelocity.z);
+    mElapsedTime.push_back(particle.mElapsedTime);
+    mLifetime.push_back(particle.mLifetime);
+    mSizeX.push_back(particle.mSize.x);
+    mSizeY.push_back(particle.mSize.y);
+    mRotationSpeed.push_back(particle.mRotationSpeed);
+    mRotation.push_back(particle.mRotation);
+}
+
+template<typename T>
+static inline void SwapRemove(std::vector<T>& vec, uint32_t index)
+{
+    vec[index] = vec.back();
+    vec.pop_back();
+}
+
+void ParticlePool::RemoveSwap(uint32_t index)
+{
+    OCT_ASSERT(index < GetSize());
+    SwapRemove(mPositionX, index);
+    SwapRemove(mPositionY, index);
+    SwapRemove(mPositionZ, index);
+    SwapRemove(mVelocityX, index);
+    SwapRemove(mVelocityY, index);
+    SwapRemove(mVelocityZ, index);
+    SwapRemove(mElapsedTime, index);
+    SwapRemove(mLifetime, index);
+    SwapRemove(mSizeX, index);
+    SwapRemove(mSizeY, index);
+    SwapRemove(mRotationSpeed, index);
+    SwapRemove(mRotation, index);
+}
+
+Particle ParticlePool::Get(uint32_t index) const
+{
+    OCT_ASSERT(index < GetSize());
+    Particle particle;
+    particle.mPosition = glm::vec3(mPositionX[index], mPositionY[index], mPositionZ[index]);
+    particle.mVelocity = glm::vec3(mVelocityX[index], mVelocityY[index], mVelocityZ[index]);
+    particle.mElapsedTime = mElapsedTime[index];
+    particle.mLifetime = mLifetime[index];
+    particle.mSize = glm::vec2(mSizeX[index], mSizeY[index]);
+    particle.mRotationSpeed = mRotationSpeed[index];
+    particle.mRotation = mRotation[index];
+    return particle;
+}
+
+void ParticlePool::Set(uint32_t index, const Particle& particle)
+{
+    OCT_ASSERT(index < GetSize());
+    mPositionX[index] = particle.mPosition.x;
+    mPositionY[index] = particle.mPosition.y;
+    mPositionZ[index] = particle.mPosition.z;
+    mVelocityX[index] = particle.mVelocity.x;
+    mVelocityY[index] = particle.mVelocity.y;
+    mVelocityZ[index] = particle.mVelocity.z;
+    mElapsedTime[index] = particle.mElapsedTime;
+    mLifetime[index] = particle.mLifetime;
+    mSizeX[index] = particle.mSize.x;
+    mSizeY[index] = particle.mSize.y;
+    mRotationSpeed[index] = particle.mRotationSpeed;
+    mRotation[index] = particle.mRotation;
+}
+
+static void UpdateParticleRange(ParticlePool& pool, uint32_t start, uint32_t end, float deltaTime, glm::vec3 accel)
+{
+    float* posX = pool.mPositionX.data();
+    float* posY = pool.mPositionY.data();
+    float* posZ = pool.mPositionZ.data();
+    float* velX = pool.mVelocityX.data();
+    float* velY = pool.mVelocityY.data();
+    float* velZ = pool.mVelocityZ.data();
+    float* elapsed = pool.mElapsedTime.data();
+    float* rot = pool.mRotation.data();
+    const float* rotSpeed = pool.mRotationSpeed.data();
+
+    const glm::vec3 deltaVel = accel * deltaTime;
+    uint32_t i = start;
+
+#if PARTICLE_SSE
+    const __m128 dt4 = _mm_set1_ps(deltaTime);
+    const __m128 dvX = _mm_set1_ps(deltaVel.x);
+    const __m128 dvY = _mm_set1_ps(deltaVel.y);
+    const __m128 dvZ = _mm_set1_ps(deltaVel.z);
+
+    for (; i + 4 <= end; i += 4)
+    {
+        __m128 vx = _mm_add_ps(_mm_loadu_ps(velX + i), dvX);
+        __m128 vy = _mm_add_ps(_mm_loadu_ps(velY + i), dvY);
+        __m128 vz = _mm_add_ps(_mm_loadu_ps(velZ + i), dvZ);
+        _mm_storeu_ps(velX + i, vx);
+        _mm_storeu_ps(velY + i, vy);
+        _mm_storeu_ps(velZ + i, vz);
+
+        _mm_storeu_ps(posX + i, _mm_add_ps(_mm_loadu_ps(posX + i), _mm_mul_ps(vx, dt4)));
+        _mm_storeu_ps(posY + i, _mm_add_ps(_mm_loadu_ps(posY + i), _mm_mul_ps(vy, dt4)));
+        _mm_storeu_ps(posZ + i, _mm_add_ps(_mm_loadu_ps(posZ + i), _mm_mul_ps(vz, dt4)));
+
+        _mm_storeu_ps(elapsed + i, _mm_add_ps(_mm_loadu_ps(elapsed + i), dt4));
+        _mm_storeu_ps(rot + i, _mm_add_ps(_mm_loadu_ps(rot + i), _mm_mul_ps(_mm_loadu_ps(rotSpeed + i), dt4)));
+    }
+#endif
+
+    for (; i < end; ++i)
+    {
+        elapsed[i] += deltaTime;
+        velX[i] += deltaVel.x;
+        velY[i] += deltaVel.y;
+        velZ[i] += deltaVel.z;
+        posX[i] += velX[i] * deltaTime;
+        posY[i] += velY[i] * deltaTime;
+        posZ[i] += velZ[i] * deltaTime;
+        rot[i] += rotSpeed[i] * deltaTime;
+    }
+}
+
+// Per-frame values shared by every particle when building the vertex buffer.
+struct ParticleVertexParams
+{
+    glm::vec2 mScaleStart;
+    glm::vec2 mScaleEnd;
+    glm::vec4 mColorStart;
+    glm::vec4 mColorEnd;
+    float mAlphaEase;
+    float mScaleEase;
+    float mInvAlphaEase2;
+    float mInvScaleEase2;
+    float mInvColorScale;
+
+    // A particle's right axis is mRight * cos(rotation) + mRightPerp * sin(rotation),
+    // which is the same as rotating mRight around the facing axis. Likewise for up.
+    glm::vec3 mRight;
+    glm::vec3 mRightPerp;
+    glm::vec3 mUp;
+    glm::vec3 mUpPerp;
+};
+
+static void ExpandParticleVertices(
+    const ParticlePool& pool,
+    const ParticleVertexParams& vp,
+    VertexParticle* vertices,
+    uint32_t start,
+    uint32_t end)
+{
+    uint32_t i = start;
+
+#if PARTICLE_SSE
+    // Four particles at a time. Everything but sin / cos of rotated particles is computed in
+    // SSE registers, then the results are scattered into the interleaved vertices.
+    const __m128 zero4 = _mm_setzero_ps();
+    const __m128 one4 = _mm_set1_ps(1.0f);
+    const __m128 half4 = _mm_set1_ps(0.5f);
+    const __m128 two4 = _mm_set1_ps(2.0f);
+    const __m128 absMask4 = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    const __m128 colorMax4 = _mm_set1_ps(255.0f);
+    const __m128 colorScale4 = _mm_set1_ps(vp.mInvColorScale * 255.0f);
+    const __m128 invScaleEase4 = _mm_set1_ps(vp.mInvScaleEase2);
+    const __m128 invAlphaEase4 = _mm_set1_ps(vp.mInvAlphaEase2);
+
+    const __m128 scaleStartX4 = _mm_set1_ps(vp.mScaleStart.x);
+    const __m128 scaleStartY4 = _mm_set1_ps(vp.mScaleStart.y);
+    const __m128 scaleEndX4 = _mm_set1_ps(vp.mScaleEnd.x);
+    const __m128 scaleEndY4 = _mm_set1_ps(vp.mScaleEnd.y);
+    const __m128 colorStart4[4] = { _mm_set1_ps(vp.mColorStart.r), _mm_set1_ps(vp.mColorStart.g), _mm_set1_ps(vp.mColorStart.b), _mm_set1_ps(vp.mColorStart.a) };
+    const __m128 colorEnd4[4] = { _mm_set1_ps(vp.mColorEnd.r), _mm_set1_ps(vp.mColorEnd.g), _mm_set1_ps(vp.mColorEnd.b), _mm_set1_ps(vp.mColorEnd.a) };
+
+    const __m128 right4[3] = { _mm_set1_ps(vp.mRight.x), _mm_set1_ps(vp.mRight.y), _mm_set1_ps(vp.mRight.z) };
+    const __m128 rightPerp4[3] = { _mm_set1_ps(vp.mRightPerp.x), _mm_set1_ps(vp.mRightPerp.y), _mm_set1_ps(vp.mRightPerp.z) };
+    const __m128 up4[3] = { _mm_set1_ps(vp.mUp.x), _mm_set1_ps(vp.mUp.y), _mm_set1_ps(vp.mUp.z) };
+    const __m128 upPerp4[3] = { _mm_set1_ps(vp.mUpPerp.x), _mm_set1_ps(vp.mUpPerp.y), _mm_set1_ps(vp.mUpPerp.z) };
+
+    for (; i + 4 <= end; i += 4)
+    {
+        __m128 life = _mm_div_ps(_mm_loadu_ps(&pool.mElapsedTime[i]), _mm_loadu_ps(&pool.mLifetime[i]));
+        __m128 invLife = _mm_sub_ps(one4, life);
+        __m128 easeX = _mm_mul_ps(two4, _mm_and_ps(_mm_sub_ps(life, half4), absMask4));
+
+        __m128 scaleX = _mm_add_ps(_mm_mul_ps(scaleStartX4, invLife), _mm_mul_ps(scaleEndX4, life));
+        __m128 scaleY = _mm_add_ps(_mm_mul_ps(scaleStartY4, invLife), _mm_mul_ps(scaleEndY4, life));
+
+        __m128 color[4];
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            color[c] = _mm_add_ps(_mm_mul_ps(colorStart4[c], invLife), _mm_mul_ps(colorEnd4[c], life));
+        }
+
+        if (vp.mScaleEase > 0.0f)
+        {
+            __m128 scalePower = _mm_mul_ps(invScaleEase4, _mm_sub_ps(one4, easeX));
+            scalePower = _mm_min_ps(_mm_max_ps(scalePower, zero4), one4);
+            scaleX = _mm_mul_ps(scaleX, scalePower);
+            scaleY = _mm_mul_ps(scaleY, scalePower);
+        }
+
+        if (vp.mAlphaEase > 0.0f)
+        {
+            __m128 alphaPower = _mm_mul_ps(invAlphaEase4, _mm_sub_ps(one4, easeX));
+            alphaPower = _mm_min_ps(_mm_max_ps(alphaPower, zero4), one4);
+            color[3] = _mm_mul_ps(color[3], alphaPower);
+        }
+
+        // Truncate to integers like the scalar path and pack as RGBA8.
+        __m128i color32 = _mm_setzero_si128();
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            __m128 channel = _mm_min_ps(_mm_max_ps(_mm_mul_ps(color[c], colorScale4), zero4), colorMax4);
+            color32 = _mm_or_si128(color32, _mm_slli_epi32(_mm_cvttps_epi32(channel), int(c * 8)));
+        }
+
+        __m128 halfX = _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(&pool.mSizeX[i]), scaleX), half4);
+        __m128 halfY = _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(&pool.mSizeY[i]), scaleY), half4);
+
+        alignas(16) float rotCos[4];
+        alignas(16) float rotSin[4];
+        for (uint32_t j = 0; j < 4; ++j)
+        {
+            float rotation = pool.mRotation[i + j];
+            rotCos[j] = (rotation != 0.0f) ? cosf(rotation) : 1.0f;
+            rotSin[j] = (rotation != 0.0f) ? sinf(rotation) : 0.0f;
+        }
+
+        __m128 cos4 = _mm_load_ps(rotCos);
+        __m128 sin4 = _mm_load_ps(rotSin);
+
+        const float* posData[3] = { &pool.mPositionX[i], &pool.mPositionY[i], &pool.mPositionZ[i] };
+
+        // corners[k][c] holds component c of corner k for the four particles.
+        alignas(16) float corners[4][3][4];
+        for (uint32_t c = 0; c < 3; ++c)
+        {
+            __m128 rightOffset = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(right4[c], cos4), _mm_mul_ps(rightPerp4[c], sin4)), halfX);
+            __m128 upOffset = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(up4[c], cos4), _mm_mul_ps(upPerp4[c], sin4)), halfY);
+            __m128 pos = _mm_loadu_ps(posData[c]);
+            __m128 left = _mm_sub_ps(pos, rightOffset);
+            __m128 right = _mm_add_ps(pos, rightOffset);
+
+            _mm_store_ps(corners[0][c], _mm_add_ps(left, upOffset));
+            _mm_store_ps(corners[1][c], _mm_sub_ps(left, upOffset));
+            _mm_store_ps(corners[2][c], _mm_add_ps(right, upOffset));
+            _mm_store_ps(corners[3][c], _mm_sub_ps(right, upOffset));
+        }
+
+        alignas(16) uint32_t colors[4];
+        _mm_store_si128((__m128i*)colors, color32);
+
+        for (uint32_t j = 0; j < 4; ++j)
+        {
+            VertexParticle* verts = &vertices[(i + j) * 4];
+
+            for (uint32_t k = 0; k < 4; ++k)
+            {
+                verts[k].mPosition = glm::vec3(corners[k][0][j], corners[k][1][j], corners[k][2][j]);
+                verts[k].mColor = colors[j];
+            }
+
+            verts[0].mTexcoord = glm::vec2(0.0f, 0.0f);
+            verts[1].mTexcoord = glm::vec2(0.0f, 1.0f);
+            verts[2].mTexcoord = glm::vec2(1.0f, 0.0f);
+            verts[3].mTexcoord = glm::vec2(1.0f, 1.0f);
+        }
+    }
+#endif
+
+    for (; i < end; ++i)
+    {
+        VertexParticle* verts = &vertices[i * 4];
+
+        float life = pool.mElapsedTime[i] / pool.mLifetime[i];
+
+        glm::vec2 scale = glm::mix(vp.mScaleStart, vp.mScaleEnd, life);
+        glm::vec4 color = glm::mix(vp.mColorStart, vp.mColorEnd, life);
+
+        float easeX = 2 * fabs(life - 0.5f);
+
+        if (vp.mScaleEase > 0.0f)
+        {
+            float scalePower = glm::clamp(vp.mInvScaleEase2 * (1.0f - easeX), 0.0f, 1.0f);
+            scale *= scalePower;
+        }
+
+        if (vp.mAlphaEase > 0.0f)
+        {
+            float alphaPower = glm::clamp(vp.mInvAlphaEase2 * (1.0f - easeX), 0.0f, 1.0f);
+            color.a *= alphaPower;
+        }
+
+        glm::vec3 pos = glm::vec3(pool.mPositionX[i], pool.mPositionY[i], pool.mPositionZ[i]);
+        glm::vec2 halfSize = glm::vec2(pool.mSizeX[i], pool.mSizeY[i]) * scale * 0.5f;
+        color = glm::clamp(color * (vp.mInvColorScale * 255.0f), 0.0f, 255.0f);
+        uint32_t color32 =
+            (uint32_t(color.r)) |
+            (uint32_t(color.g) << 8) |
+            (uint32_t(color.b) << 16) |
+            (uint32_t(color.a) << 24);
+
+        glm::vec3 rightAxis = vp.mRight;
+        glm::vec3 upAxis = vp.mUp;
+
+        float rotation = pool.mRotation[i];
+        if (rotation != 0.0f)
+        {
+            float c = cosf(rotation);
+            float s = sinf(rotation);
+            rightAxis = vp.mRight * c + vp.mRightPerp * s;
+            upAxis = vp.mUp * c + vp.mUpPerp * s;
+        }
+
+        glm::vec3 rightOffset = rightAxis * halfSize.x;
+        glm::vec3 upOffset = upAxis * halfSize.y;
+
+        //   0----2
+        //   |  / |
+        //   | /  |
+        //   1----3
+        verts[0].mPosition = pos - rightOffset + upOffset;
+        verts[0].mTexcoord = glm::vec2(0.0f, 0.0f);
+        verts[0].mColor = color32;
+
+        verts[1].mPosition = pos - rightOffset - upOffset;
+        verts[1].mTexcoord = glm::vec2(0.0f, 1.0f);
+        verts[1].mColor = color32;
+
+        verts[2].mPosition = pos + rightOffset + upOffset;
+        verts[2].mTexcoord = glm::vec2(1.0f, 0.0f);
+        verts[2].mColor = color32;
+
+        verts[3].mPosition = pos + rightOffset - upOffset;
+        verts[3].mTexcoord = glm::vec2(1.0f, 1.0f);
+        verts[3].mColor = color32;
+    }
+}
+
 bool Particle3D::HandlePropChange(Datum* datum, uint32_t index, const void* newValue)
 {
     Property* prop = static_cast<Property*>(datum);
@@ -129,6 +533,9 @@ void Particle3D::Create()
     Primitive3D::Create();
     GFX_CreateParticleCompResource(this);
     EnableEmission(true);
+
+    // Seeded from rand() so that Maths::SeedRand() still makes spawning deterministic.
+    mRandom.Seed(uint32_t(rand()) * 2654435761u + 1u);
 }
 
 void Particle3D::Destroy()
@@ -137,8 +544,8 @@ void Particle3D::Destroy()
 
     GFX_DestroyParticleCompResource(this);
 
-    mParticles.clear();
-    mParticles.shrink_to_fit();
+    mParticles.Clear();
+    mParticles.ShrinkToFit();
 
     Primitive3D::Destroy();
 }
@@ -202,7 +609,14 @@ void Particle3D::TickCommon(float deltaTime)
             !IsEmissionEnabled() &&
             GetNumParticles() == 0)
         {
-            Destroy();
+            if (mPooled && GetWorld() != nullptr)
+            {
+                GetWorld()->RecycleParticle(this);
+            }
+            else
+            {
+                Destroy();
+            }
         }
     }
 }
@@ -232,7 +646,7 @@ void Particle3D::Simulate(float deltaTime)
 
 void Particle3D::Reset()
 {
-    mParticles.clear();
+    mParticles.Clear();
     mElapsedTime = 0.0f;
     mLoop = 0;
 }
@@ -273,6 +687,36 @@ bool Particle3D::IsAutoDestroyEnabled() const
     return mAutoDestroy;
 }
 
+void Particle3D::SetPooled(bool pooled)
+{
+    mPooled = pooled;
+}
+
+bool Particle3D::IsPooled() const
+{
+    return mPooled;
+}
+
+void Particle3D::ResetForReuse(Particle3D* defaultParticle)
+{
+    // Restore what SpawnParticle() would give a new node. The GFX resource and array capacity are kept.
+    ParticleSystem* particleSystem = GetParticleSystem();
+
+    // Copying every property from a default node restores the name, tags, flags and transform.
+    Copy(defaultParticle, false);
+    SetParticleSystem(particleSystem);
+
+    mSignalMap.clear();
+    mTickEnabled = true;
+    mPersistent = false;
+    mTransient = false;
+
+    Reset();
+    mEmissionCounter = 0.0f;
+    mVertices.clear();
+    mEnableSimulation = true;
+}
+
 float Particle3D::GetElapsedTime() const
 {
     return mElapsedTime;
@@ -359,7 +803,7 @@ bool Particle3D::IsSimulationEnabled() const
 
 uint32_t Particle3D::GetNumParticles()
 {
-    return (uint32_t)mParticles.size();
+    return mParticles.GetSize();
 }
 
 uint32_t Particle3D::GetNumVertices()
@@ -367,7 +811,25 @@ uint32_t Particle3D::GetNumVertices()
     return (uint32_t)mVertices.size();
 }
 
-std::vector<Particle>& Particle3D::GetParticles()
+Particle Particle3D::GetParticle(int32_t index) const
+{
+    Particle ret;
+    if (index >= 0 && index < int32_t(mParticles.GetSize()))
+    {
+        ret = mParticles.Get(index);
+    }
+    return ret;
+}
+
+void Particle3D::SetParticle(int32_t index, const Particle& particle)
+{
+    if (index >= 0 && index < int32_t(mParticles.GetSize()))
+    {
+        mParticles.Set(index, particle);
+    }
+}
+
+ParticlePool& Particle3D::GetParticlePool()
 {
     return mParticles;
 }
@@ -379,25 +841,26 @@ const std::vector<VertexParticle>& Particle3D::GetVertices()
 
 void Particle3D::SetParticleVelocity(int32_t index, glm::vec3 velocity)
 {
-    if (index == -1)
+    uint32_t start = (index == -1) ? 0 : uint32_t(index);
+    uint32_t end = (index == -1) ? mParticles.GetSize() : uint32_t(index + 1);
+
+    if (index >= -1 && end <= mParticles.GetSize())
     {
-        for (uint32_t i = 0; i < mParticles.size(); ++i)
+        for (uint32_t i = start; i < end; ++i)
         {
-            mParticles[i].mVelocity = velocity;
+            mParticles.mVelocityX[i] = velocity.x;
+            mParticles.mVelocityY[i] = velocity.y;
+            mParticles.mVelocityZ[i] = velocity.z;
         }
     }
-    else if (index >= 0 && index < (int32_t)mParticles.size())
-    {
-        mParticles[index].mVelocity = velocity;
-    }
 }
 
 glm::vec3 Particle3D::GetParticleVelocity(int32_t index)
 {
     glm::vec3 ret = { 0.0f, 0.0f, 0.0f };
-    if (index >= 0 && index < (int32_t)mParticles.size())
+    if (index >= 0 && index < (int32_t)mParticles.GetSize())
     {
-        ret = mParticles[index].mVelocity;
+        ret = glm::vec3(mParticles.mVelocityX[index], mParticles.mVelocityY[index], mParticles.mVelocityZ[index]);
     }
     return ret;
 }
@@ -405,42 +868,46 @@ glm::vec3 Particle3D::GetParticleVelocity(int32_t index)
 
 void Particle3D::SetParticlePosition(int32_t index, glm::vec3 position)
 {
-    if (index == -1)
+    uint32_t start = (index == -1) ? 0 : uint32_t(index);
+    uint32_t end = (index == -1) ? mParticles.GetSize() : uint32_t(index + 1);
+
+    if (index >= -1 && end <= mParticles.GetSize())
     {
-        for (uint32_t i = 0; i < mParticles.size(); ++i)
+        for (uint32_t i = start; i < end; ++i)
         {
-            mParticles[i].mPosition = position;
+            mParticles.mPositionX[i] = position.x;
+            mParticles.mPositionY[i] = position.y;
+            mParticles.mPositionZ[i] = position.z;
         }
     }
-    else if (index >= 0 && index < int32_t(mParticles.size()))
-    {
-        mParticles[index].mPosition = position;
-    }
 }
 
 glm::vec3 Particle3D::GetParticlePosition(int32_t index)
 {
     glm::vec3 ret = { 0.0f, 0.0f, 0.0f };
-    if (index >= 0 && index < int32_t(mParticles.size()))
+    if (index >= 0 && index < int32_t(mParticles.GetSize()))
     {
-        ret = mParticles[index].mPosition;
+        ret = glm::vec3(mParticles.mPositionX[index], mParticles.mPositionY[index], mParticles.mPositionZ[index]);
     }
     return ret;
 }
 
 void Particle3D::SetParticleSpeed(int32_t index, float speed)
 {
-    if (index == -1)
+    uint32_t start = (index == -1) ? 0 : uint32_t(index);
+    uint32_t end = (index == -1) ? mParticles.GetSize() : uint32_t(index + 1);
+
+    if (index >= -1 && end <= mParticles.GetSize())
     {
-        for (uint32_t i = 0; i < mParticles.size(); ++i)
+        for (uint32_t i = start; i < end; ++i)
         {
-            mParticles[i].mVelocity = Maths::SafeNormalize(mParticles[i].mVelocity) * speed;
+            glm::vec3 velocity = GetParticleVelocity(int32_t(i));
+            velocity = Maths::SafeNormalize(velocity) * speed;
+            mParticles.mVelocityX[i] = velocity.x;
+            mParticles.mVelocityY[i] = velocity.y;
+            mParticles.mVelocityZ[i] = velocity.z;
         }
     }
-    else if (index >= 0 && index < int32_t(mParticles.size()))
-    {
-        mParticles[index].mVelocity = Maths::SafeNormalize(mParticles[index].mVelocity) * speed;
-    }
 }
 
 void Particle3D::SetParticleOrientation(ParticleOrientation orientation)
@@ -475,14 +942,12 @@ Bounds Particle3D::GetLocalBounds() const
 
 void Particle3D::KillExpiredParticles(float deltaTime)
 {
-    for (int32_t i = int32_t(mParticles.size()) - 1; i >= 0; --i)
+    // Walk backwards so that the particle swapped into a removed slot has already been checked.
+    for (int32_t i = int32_t(mParticles.GetSize()) - 1; i >= 0; --i)
     {
-        Particle& particle = mParticles[i];
-
-        if (particle.mElapsedTime >= particle.mLifetime)
+        if (mParticles.mElapsedTime[i] >= mParticles.mLifetime[i])
         {
-            // Might be more efficient if we swap instead of erase?
-            mParticles.erase(mParticles.begin() + i);
+            mParticles.RemoveSwap(uint32_t(i));
         }
     }
 }
@@ -494,13 +959,19 @@ void Particle3D::UpdateParticles(float deltaTime)
     if (system != nullptr)
     {
         ParticleParams& params = system->GetParams();
+        glm::vec3 accel = params.mAcceleration;
+        uint32_t numParticles = mParticles.GetSize();
 
-        for (uint32_t i = 0; i < mParticles.size(); ++i)
+        if (numParticles >= PARTICLE_PARALLEL_THRESHOLD)
+        {
+            JobSystem::Get()->ParallelFor(numParticles, PARTICLE_PARALLEL_BATCH, [&](uint32_t start, uint32_t end)
+            {
+                UpdateParticleRange(mParticles, start, end, deltaTime, accel);
+            });
+        }
+        else
         {
-            mParticles[i].mElapsedTime += deltaTime;
-            mParticles[i].mVelocity += (params.mAcceleration * deltaTime);
-            mParticles[i].mPosition += (mParticles[i].mVelocity * deltaTime);
-            mParticles[i].mRotation += (mParticles[i].mRotationSpeed * deltaTime);
+            UpdateParticleRange(mParticles, 0, numParticles, deltaTime, accel);
         }
     }
 }
@@ -555,43 +1026,51 @@ void Particle3D::SpawnNewParticles(float deltaTime)
 
         if (maxParticles > 0)
         {
-            int32_t numParticles = (int32_t)mParticles.size();
+            int32_t numParticles = (int32_t)mParticles.GetSize();
             spawnCount = glm::min(maxParticles - numParticles, spawnCount);
         }
 
+        if (spawnCount > 0)
+        {
+            mParticles.Reserve(mParticles.GetSize() + uint32_t(spawnCount));
+        }
+
         for (int32_t i = 0; i < spawnCount; ++i)
         {
             Particle newParticle;
 
-            newParticle.mLifetime = Maths::RandRange(params.mLifetimeMin, params.mLifetimeMax);
+            newParticle.mLifetime = mRandom.Range(params.mLifetimeMin, params.mLifetimeMax);
             if (system->IsRadialSpawn())
             {
                 // Doing the powf(x,1/3) seems to be important for getting a uniform distribution in sphere.
-                float distUnit = Maths::RandRange(params.mPositionMin.x, params.mPositionMax.x);
+                float distUnit = mRandom.Range(params.mPositionMin.x, params.mPositionMax.x);
                 distUnit = Maths::Map(distUnit, params.mPositionMin.x, params.mPositionMax.x, 0.0f, 1.0f);
                 distUnit = powf(distUnit, 1 / 3.0f);
                 distUnit = Maths::Map(distUnit, 0.0f, 1.0f, params.mPositionMin.x, params.mPositionMax.x);
 
-                float yaw = Maths::RandRange(0.0f, PI * 2.0f);
-                float pitch = Maths::RandRange(-PI/2.0f, PI/2.0f);
-                glm::vec3 newPos = glm::vec3(0.0f, 0.0f, distUnit);
-                newPos = glm::rotate(newPos, pitch, glm::vec3(1.0f, 0.0f, 0.0f));
-                newPos = glm::rotate(newPos, yaw, glm::vec3(0.0f, 1.0f, 0.0f));
-                newParticle.mPosition = newPos;
+                float yaw = mRandom.Range(0.0f, PI * 2.0f);
+                float pitch = mRandom.Range(-PI/2.0f, PI/2.0f);
+
+                // (0, 0, distUnit) pitched around X, then yawed around Y.
+                float cosPitch = cosf(pitch);
+                newParticle.mPosition = distUnit * glm::vec3(
+                    cosPitch * sinf(yaw),
+                    -sinf(pitch),
+                    cosPitch * cosf(yaw));
             }
             else
             {
-                newParticle.mPosition = Maths::RandRange(params.mPositionMin, params.mPositionMax);
+                newParticle.mPosition = mRandom.Range(params.mPositionMin, params.mPositionMax);
             }
-            newParticle.mVelocity = Maths::RandRange(params.mVelocityMin, params.mVelocityMax);
-            newParticle.mSize = Maths::RandRange(params.mSizeMin, params.mSizeMax);
-            newParticle.mRotation = Maths::RandRange(params.mRotationMin, params.mRotationMax);
-            newParticle.mRotationSpeed = Maths::RandRange(params.mRotationSpeedMin, params.mRotationSpeedMax);
+            newParticle.mVelocity = mRandom.Range(params.mVelocityMin, params.mVelocityMax);
+            newParticle.mSize = mRandom.Range(params.mSizeMin, params.mSizeMax);
+            newParticle.mRotation = mRandom.Range(params.mRotationMin, params.mRotationMax);
+            newParticle.mRotationSpeed = mRandom.Range(params.mRotationSpeedMin, params.mRotationSpeedMax);
 
             if (system->IsRatioLocked())
             {
                 float ratioYX = params.mSizeMax.x != 0.0f ? (params.mSizeMax.y / params.mSizeMax.x) : 1.0f;
-                newParticle.mSize.x = Maths::RandRange(params.mSizeMin.x, params.mSizeMax.x);
+                newParticle.mSize.x = mRandom.Range(params.mSizeMin.x, params.mSizeMax.x);
                 newParticle.mSize.y = ratioYX * newParticle.mSize.x;
             }
 
@@ -610,7 +1089,7 @@ void Particle3D::SpawnNewParticles(float deltaTime)
                 newParticle.mVelocity = mTransform * glm::vec4(newParticle.mVelocity, 0.0f);
             }
 
-            mParticles.push_back(newParticle);
+            mParticles.Add(newParticle);
         }
     }
 }
@@ -622,19 +1101,21 @@ void Particle3D::UpdateVertexBuffer()
     if (system == nullptr || mHasUpdatedVerticesThisFrame)
         return;
 
-    uint32_t numParticles = (uint32_t)mParticles.size();
+    uint32_t numParticles = mParticles.GetSize();
     mVertices.resize(numParticles * 4);
 
     const ParticleParams& params = system->GetParams();
 
-    const float alphaEase = params.mAlphaEase;
-    const float scaleEase = params.mScaleEase;
-
-    const float invAlphaEase2 = (alphaEase != 0.0f) ? (0.5f / alphaEase) : 1.0f;
-    const float invScaleEase2 = (scaleEase != 0.0f) ? (0.5f / scaleEase) : 1.0f;
-
-    const float invColorScale = Renderer::Get()->GetColorScaleInverse();
-
+    ParticleVertexParams vp;
+    vp.mScaleStart = params.mScaleStart;
+    vp.mScaleEnd = params.mScaleEnd;
+    vp.mColorStart = params.mColorStart;
+    vp.mColorEnd = params.mColorEnd;
+    vp.mAlphaEase = params.mAlphaEase;
+    vp.mScaleEase = params.mScaleEase;
+    vp.mInvAlphaEase2 = (vp.mAlphaEase != 0.0f) ? (0.5f / vp.mAlphaEase) : 1.0f;
+    vp.mInvScaleEase2 = (vp.mScaleEase != 0.0f) ? (0.5f / vp.mScaleEase) : 1.0f;
+    vp.mInvColorScale = Renderer::Get()->GetColorScaleInverse();
     glm::vec3 right = { 1.0f, 0.0f, 0.0f };
     glm::vec3 up = { 0.0f, 1.0f, 0.0f };
     glm::vec3 forward = { 0.0f, 0.0f, -1.0f };
@@ -690,73 +1171,33 @@ void Particle3D::UpdateVertexBuffer()
         break;
     }
 
-    for (uint32_t i = 0; i < numParticles; ++i)
-    {
-        VertexParticle* verts = &mVertices[i * 4];
-
-        float life = mParticles[i].mElapsedTime / mParticles[i].mLifetime;
-
-        glm::vec2 scale = glm::mix(params.mScaleStart, params.mScaleEnd, life);
-        glm::vec4 color = glm::mix(params.mColorStart, params.mColorEnd, life);
+    // The orientation axes are orthogonal to forward, so rotating them around forward
+    // only needs cross(forward, axis) as the second basis vector.
+    vp.mRight = right;
+    vp.mUp = up;
+    vp.mRightPerp = glm::cross(forward, right);
+    vp.mUpPerp = glm::cross(forward, up);
 
-        float easeX = 2 * fabs(life - 0.5f);
-
-        if (scaleEase > 0.0f)
-        {
-            float scalePower = glm::clamp(invScaleEase2 * (1.0f - easeX), 0.0f, 1.0f);
-            scale = glm::mix(glm::vec2(0.0f, 0.0f), scale, scalePower);
-        }
+    if (mUseLocalSpace && mOrientation == ParticleOrientation::Billboard)
+    {
+        vp.mRight = glm::vec4(vp.mRight, 0.0f) * mTransform;
+        vp.mUp = glm::vec4(vp.mUp, 0.0f) * mTransform;
+        vp.mRightPerp = glm::vec4(vp.mRightPerp, 0.0f) * mTransform;
+        vp.mUpPerp = glm::vec4(vp.mUpPerp, 0.0f) * mTransform;
+    }
 
-        if (alphaEase > 0.0f)
-        {
-            float alphaPower = glm::clamp(invAlphaEase2 * (1.0f - easeX), 0.0f, 1.0f);
-            color.a = glm::mix(0.0f, color.a, alphaPower);
-        }
+    VertexParticle* vertices = mVertices.data();
 
-        glm::vec3 pos = mParticles[i].mPosition;
-        glm::vec2 halfSize = mParticles[i].mSize * scale * 0.5f;
-        color *= invColorScale;
-        uint8_t colors[4] =
-        {
-            uint8_t(glm::clamp(color.r * 255.0f, 0.0f, 255.0f)),
-            uint8_t(glm::clamp(color.g * 255.0f, 0.0f, 255.0f)),
-            uint8_t(glm::clamp(color.b * 255.0f, 0.0f, 255.0f)),
-            uint8_t(glm::clamp(color.a * 255.0f, 0.0f, 255.0f))
-        };
-        uint32_t color32 = 
-            (colors[0]) |
-            (colors[1] << 8) |
-            (colors[2] << 16) |
-            (colors[3] << 24);
-
-        glm::vec3 rightAxis = glm::rotate(right, mParticles[i].mRotation, forward);
-        glm::vec3 upAxis = glm::rotate(up, mParticles[i].mRotation, forward);
-
-        if (mUseLocalSpace && mOrientation == ParticleOrientation::Billboard)
+    if (numParticles >= PARTICLE_PARALLEL_THRESHOLD)
+    {
+        JobSystem::Get()->ParallelFor(numParticles, PARTICLE_PARALLEL_BATCH, [&](uint32_t start, uint32_t end)
         {
-            rightAxis = glm::vec4(rightAxis, 0.0f) * mTransform;
-            upAxis = glm::vec4(upAxis, 0.0f) * mTransform;
-        }
-
-        //   0----2
-        //   |  / |
-        //   | /  |
-        //   1----3
-        verts[0].mPosition = pos - (rightAxis * halfSize.x) + (upAxis * halfSize.y);
-        verts[0].mTexcoord = glm::vec2(0.0f, 0.0f);
-        verts[0].mColor = color32;
-
-        verts[1].mPosition = pos - (rightAxis * halfSize.x) - (upAxis * halfSize.y);
-        verts[1].mTexcoord = glm::vec2(0.0f, 1.0f);
-        verts[1].mColor = color32;
-
-        verts[2].mPosition = pos + (rightAxis * halfSize.x) + (upAxis * halfSize.y);
-        verts[2].mTexcoord = glm::vec2(1.0f, 0.0f);
-        verts[2].mColor = color32;
-
-        verts[3].mPosition = pos + (rightAxis * halfSize.x) - (upAxis * halfSize.y);
-        verts[3].mTexcoord = glm::vec2(1.0f, 1.0f);
-        verts[3].mColor = color32;
+            ExpandParticleVertices(mParticles, vp, vertices, start, end);
+        });
+    }
+    else
+    {
+        ExpandParticleVertices(mParticles, vp, vertices, 0, numParticles);
     }
 
     GFX_UpdateParticleCompVertexBuffer(this, mVertices);
@@ -30,6 +30,36 @@ struct Particle
     float mRotation = 0.0f;
 };
 
+// Particle attributes stored as parallel arrays so that the simulation and vertex
+// expansion loops stream through memory. Removal swaps with the last particle,
+// so particle order is not preserved.
+struct ParticlePool
+{
+    uint32_t GetSize() const;
+    void Reserve(uint32_t count);
+    void Clear();
+    void ShrinkToFit();
+
+    void Add(const Particle& particle);
+    void RemoveSwap(uint32_t index);
+
+    Particle Get(uint32_t index) const;
+    void Set(uint32_t index, const Particle& particle);
+
+    std::vector<float> mPositionX;
+    std::vector<float> mPositionY;
+    std::vector<float> mPositionZ;
+    std::vector<float> mVelocityX;
+    std::vector<float> mVelocityY;
+    std::vector<float> mVelocityZ;
+    std::vector<float> mElapsedTime;
+    std::vector<float> mLifetime;
+    std::vector<float> mSizeX;
+    std::vector<float> mSizeY;
+    std::vector<float> mRotationSpeed;
+    std::vector<float> mRotation;
+};
+
 class Particle3D : public Primitive3D
 {
 public:
@@ -68,6 +98,11 @@ public:
     void EnableAutoDestroy(bool enable);
     bool IsAutoDestroyEnabled() const;
 
+    // Pooled particles are handed back to World::RecycleParticle() instead of being destroyed.
+    void SetPooled(bool pooled);
+    bool IsPooled() const;
+    void ResetForReuse(Particle3D* defaultParticle);
+
     float GetElapsedTime() const;
 
     void SetParticleSystem(ParticleSystem* particleSystem);
@@ -91,7 +126,9 @@ public:
 
     uint32_t GetNumParticles();
     uint32_t GetNumVertices();
-    std::vector<Particle>& GetParticles();
+    Particle GetParticle(int32_t index) const;
+    void SetParticle(int32_t index, const Particle& particle);
+    ParticlePool& GetParticlePool();
     const std::vector<VertexParticle>& GetVertices();
 
     void SetParticleVelocity(int32_t index, glm::vec3 velocity);
@@ -123,7 +160,9 @@ protected:
     bool mEmit = true;
     bool mAutoEmit = true;
     bool mAutoDestroy = false;
-    std::vector<Particle> mParticles;
+    bool mPooled = false;
+    ParticlePool mParticles;
+    FastRand mRandom;
     std::vector<VertexParticle> mVertices;
     float mEmissionCounter = 0.0f;
     uint32_t mLoop = 0;
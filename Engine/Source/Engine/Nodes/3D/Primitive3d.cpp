@@ -17,6 +17,8 @@ DEFINE_OBJECT(Primitive3D);
 
 static btEmptyShape* sEmptyCollisionShape = nullptr;
 
+uint32_t OctaveMotionState::sPhysicsStep = 0;
+
 #define UPDATE_RIGID_BODY_PROPERTY(primVariable, newValue, rigidBodyUpdate)    \
     {                                                                          \
         if (primVariable != newValue)                                          \
@@ -165,6 +167,7 @@ void Primitive3D::Tick(float deltaTime)
     Node3D::Tick(deltaTime);
 
     bool gameTickEnabled = IsGameTickEnabled();
+    mInterpolating = false;
 
     if (gameTickEnabled && mPhysicsEnabled)
     {
@@ -181,6 +184,15 @@ void Primitive3D::Tick(float deltaTime)
             if (mPhysicsEnabled)
             {
                 physTransform = mMotionState->GetTransform();
+
+                // Rendering blends between the last two steps, but gameplay sees the latest simulated pose.
+                World* world = GetWorld();
+                if (world != nullptr)
+                {
+                    glm::mat4 interpTransform = mMotionState->GetInterpolatedTransform(world->GetPhysicsInterpolation(), world->GetPhysicsStep());
+                    mInterpolationOffset = interpTransform * glm::inverse(physTransform);
+                    mInterpolating = true;
+                }
             }
             else
             {
@@ -198,6 +210,20 @@ void Primitive3D::Tick(float deltaTime)
     }
 }
 
+glm::mat4 Primitive3D::GetInterpolationOffset()
+{
+    for (Node* node = this; node != nullptr; node = node->GetParent())
+    {
+        if (node->IsPrimitive3D() &&
+            static_cast<Primitive3D*>(node)->mInterpolating)
+        {
+            return static_cast<Primitive3D*>(node)->mInterpolationOffset;
+        }
+    }
+
+    return glm::mat4(1);
+}
+
 void Primitive3D::GatherProperties(std::vector<Property>& outProps)
 {
     Node3D::GatherProperties(outProps);
@@ -611,7 +637,8 @@ void Primitive3D::SyncRigidBodyTransform()
             if (mPhysicsEnabled)
             {
                 OCT_ASSERT(mMotionState != nullptr);
-                mMotionState->setWorldTransform(worldTransform);
+                mInterpolating = false;
+                mMotionState->Teleport(worldTransform, GetWorld() ? GetWorld()->GetPhysicsStep() : 0);
             }
 
             mRigidBody->setWorldTransform(worldTransform);
@@ -833,6 +860,16 @@ Bounds Primitive3D::GetLocalBounds() const
     return retBounds;
 }
 
+btDbvtNode* Primitive3D::GetTreeLeaf() const
+{
+    return mTreeLeaf;
+}
+
+void Primitive3D::SetTreeLeaf(btDbvtNode* leaf)
+{
+    mTreeLeaf = leaf;
+}
+
 void Primitive3D::GatherProxyDraws(std::vector<DebugDraw>& inoutDraws)
 {
 #if DEBUG_DRAW_ENABLED
@@ -14,30 +14,69 @@
 
 ATTRIBUTE_ALIGNED16(struct) OctaveMotionState : public btMotionState
 {
-    btTransform mInterpolatedTransform;
+    // Bullet writes the transform after every fixed physics step. The previous step's transform
+    // is kept so rendering can blend between the two by the world's leftover step fraction.
+    btTransform mTransform;
+    btTransform mPrevTransform;
+    uint32_t mStep = 0;
     //void* mUserPointer;
 
+    // The physics step currently being simulated, set by World before each stepSimulation().
+    static uint32_t sPhysicsStep;
+
     BT_DECLARE_ALIGNED_ALLOCATOR();
 
     OctaveMotionState(glm::mat4 startTransform = glm::mat4(1))
     {
-        mInterpolatedTransform.setFromOpenGLMatrix(glm::value_ptr(startTransform));
+        mTransform.setFromOpenGLMatrix(glm::value_ptr(startTransform));
+        mPrevTransform = mTransform;
     }
 
     virtual void getWorldTransform(btTransform& transform) const override
     {
-        transform = mInterpolatedTransform;
+        transform = mTransform;
     }
 
     virtual void setWorldTransform(const btTransform& transform) override
     {
-        mInterpolatedTransform = transform;
+        if (mStep != sPhysicsStep)
+        {
+            mPrevTransform = mTransform;
+            mStep = sPhysicsStep;
+        }
+
+        mTransform = transform;
+    }
+
+    // Moves the body without blending from its old location.
+    void Teleport(const btTransform& transform, uint32_t step)
+    {
+        mTransform = transform;
+        mPrevTransform = transform;
+        mStep = step;
     }
 
     glm::mat4 GetTransform() const
     {
         glm::mat4 retMat;
-        mInterpolatedTransform.getOpenGLMatrix(glm::value_ptr(retMat));
+        mTransform.getOpenGLMatrix(glm::value_ptr(retMat));
+        return retMat;
+    }
+
+    glm::mat4 GetInterpolatedTransform(float alpha, uint32_t worldStep) const
+    {
+        // Bodies that weren't moved by the latest step (asleep, or teleported since) are at rest.
+        if (mStep != worldStep)
+        {
+            return GetTransform();
+        }
+
+        btTransform transform;
+        transform.setOrigin(mPrevTransform.getOrigin().lerp(mTransform.getOrigin(), alpha));
+        transform.setRotation(mPrevTransform.getRotation().slerp(mTransform.getRotation(), alpha));
+
+        glm::mat4 retMat;
+        transform.getOpenGLMatrix(glm::value_ptr(retMat));
         return retMat;
     }
 };
@@ -139,12 +178,19 @@ public:
     Bounds GetBounds() const;
     virtual Bounds GetLocalBounds() const;
 
+    btDbvtNode* GetTreeLeaf() const;
+    void SetTreeLeaf(btDbvtNode* leaf);
+
     virtual void GatherProxyDraws(std::vector<DebugDraw>& inoutDraws) override;
 
     static bool HandlePropChange(Datum* datum, uint32_t index, const void* newValue);
 
     glm::vec4 GetCollisionDebugColor();
 
+    // Offset from the latest simulated pose to the pose rendered this frame, which is blended between
+    // the last two physics steps. Taken from this node or its nearest physics driven ancestor.
+    glm::mat4 GetInterpolationOffset();
+
 protected:
 
     static btCollisionShape* GetEmptyCollisionShape();
@@ -156,9 +202,14 @@ protected:
     btRigidBody* mRigidBody = nullptr;
     OctaveMotionState* mMotionState = nullptr;
     btCollisionShape* mCollisionShape = nullptr;
+    btDbvtNode* mTreeLeaf = nullptr;
 
     float mCullDistance = 0.0f;
 
+    // Only applied to rendering. The node's transform always holds the latest simulated pose.
+    glm::mat4 mInterpolationOffset = glm::mat4(1);
+    bool mInterpolating = false;
+
     // Physics Properties
     float mMass = 1.0f;
     float mRestitution = 0.0f;
@@ -9,6 +9,13 @@
 
 #include "Graphics/Graphics.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SKINNING_SSE 1
+#else
+#define SKINNING_SSE 0
+#endif
+
 static const char* sBoneInfluenceModeStrings[] =
 {
     "One Bone",
@@ -24,6 +31,12 @@ static const char* sAnimationUpdateModeStrings[] =
 };
 static_assert(int32_t(AnimationUpdateMode::Count) == 3, "Need to update string conversion table");
 
+// Minimum screen size for LODs 0, 1 and 2. Smaller meshes use the last LOD.
+static const float sAnimationLodScreenSizes[NUM_ANIMATION_LODS - 1] = { 0.25f, 0.1f, 0.04f };
+
+// At the last LOD, only bones this close to the root are evaluated. The rest hold their last local pose.
+#define ANIMATION_LOD_MAX_BONE_DEPTH 4
+
 FORCE_LINK_DEF(SkeletalMesh3D);
 DEFINE_NODE(SkeletalMesh3D, Mesh3D);
 
@@ -60,6 +73,75 @@ bool SkeletalMesh3D::HandlePropChange(Datum* datum, uint32_t index, const void*
     return success;
 }
 
+static void SkinVertices(
+    const VertexSkinned* srcVerts,
+    Vertex* dstVerts,
+    uint32_t numVerts,
+    const glm::mat4* boneMatrices,
+    uint32_t numInfluences)
+{
+    static_assert(MAX_BONE_INFLUENCES == 4, "Need to adjust this code or convert to loop.");
+
+    // Single bone meshes use their bone's matrix as is, so the weight is ignored.
+    const bool weighted = (numInfluences > 1);
+
+    for (uint32_t i = 0; i < numVerts; ++i)
+    {
+        const VertexSkinned& srcVert = srcVerts[i];
+        Vertex& dstVert = dstVerts[i];
+
+#if SKINNING_SSE
+        // Blend the columns of the bone matrices, then transform with the blended columns.
+        __m128 col0 = _mm_setzero_ps();
+        __m128 col1 = _mm_setzero_ps();
+        __m128 col2 = _mm_setzero_ps();
+        __m128 col3 = _mm_setzero_ps();
+
+        for (uint32_t b = 0; b < numInfluences; ++b)
+        {
+            const float* bone = glm::value_ptr(boneMatrices[srcVert.mBoneIndices[b]]);
+            const __m128 weight = _mm_set1_ps(weighted ? srcVert.mBoneWeights[b] : 1.0f);
+
+            col0 = _mm_add_ps(col0, _mm_mul_ps(_mm_loadu_ps(bone + 0), weight));
+            col1 = _mm_add_ps(col1, _mm_mul_ps(_mm_loadu_ps(bone + 4), weight));
+            col2 = _mm_add_ps(col2, _mm_mul_ps(_mm_loadu_ps(bone + 8), weight));
+            col3 = _mm_add_ps(col3, _mm_mul_ps(_mm_loadu_ps(bone + 12), weight));
+        }
+
+        __m128 position = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(col0, _mm_set1_ps(srcVert.mPosition.x)), _mm_mul_ps(col1, _mm_set1_ps(srcVert.mPosition.y))),
+            _mm_add_ps(_mm_mul_ps(col2, _mm_set1_ps(srcVert.mPosition.z)), col3));
+
+        __m128 normal = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(col0, _mm_set1_ps(srcVert.mNormal.x)), _mm_mul_ps(col1, _mm_set1_ps(srcVert.mNormal.y))),
+            _mm_mul_ps(col2, _mm_set1_ps(srcVert.mNormal.z)));
+
+        // Vertex members are packed, so store through a temp instead of writing past each vec3.
+        alignas(16) float result[8];
+        _mm_store_ps(result, position);
+        _mm_store_ps(result + 4, normal);
+
+        dstVert.mPosition = glm::vec3(result[0], result[1], result[2]);
+        dstVert.mNormal = glm::vec3(result[4], result[5], result[6]);
+#else
+        glm::mat4 transform = boneMatrices[srcVert.mBoneIndices[0]];
+
+        if (weighted)
+        {
+            transform *= srcVert.mBoneWeights[0];
+
+            for (uint32_t b = 1; b < numInfluences; ++b)
+            {
+                transform += boneMatrices[srcVert.mBoneIndices[b]] * srcVert.mBoneWeights[b];
+            }
+        }
+
+        dstVert.mPosition = transform * glm::vec4(srcVert.mPosition, 1.0f);
+        dstVert.mNormal = transform * glm::vec4(srcVert.mNormal, 0.0f);
+#endif
+    }
+}
+
 static SkeletalMesh* GetDefaultMesh()
 {
     return LoadAsset<SkeletalMesh>("SK_EighthNote");
@@ -105,6 +187,7 @@ void SkeletalMesh3D::GatherProperties(std::vector<Property>& outProps)
     outProps.push_back(Property(DatumType::Integer, "Bone Influence Mode", this, &mBoneInfluenceMode, 1, nullptr, NULL_DATUM, (int32_t)BoneInfluenceMode::Num, sBoneInfluenceModeStrings));
     outProps.push_back(Property(DatumType::Integer, "Animation Update Mode", this, &mAnimationUpdateMode, 1, nullptr, NULL_DATUM, (int32_t)AnimationUpdateMode::Count, sAnimationUpdateModeStrings));
     outProps.push_back(Property(DatumType::Float, "Bounds Radius Override", this, &mBoundsRadiusOverride));
+    outProps.push_back(Property(DatumType::Bool, "Animation LOD", this, &mAnimationLodEnabled));
 }
 
 void SkeletalMesh3D::Create()
@@ -544,14 +627,14 @@ void SkeletalMesh3D::SetScriptAnimEventHandler(const ScriptFunc& func)
     mAnimEventHandler.mScriptFunc = func;
 }
 
-glm::vec3 SkeletalMesh3D::InterpolateScale(float time, const Channel& channel)
+glm::vec3 SkeletalMesh3D::InterpolateScale(float time, const Channel& channel, uint32_t& cursor)
 {
     if (channel.mScaleKeys.size() == 1)
     {
         return channel.mScaleKeys[0].mValue;
     }
 
-    uint32_t index = FindScaleIndex(time, channel);
+    uint32_t index = FindKeyIndex(channel.mScaleKeys, time, cursor);
     uint32_t nextIndex = index + 1;
     OCT_ASSERT(nextIndex < channel.mScaleKeys.size());
 
@@ -566,14 +649,14 @@ glm::vec3 SkeletalMesh3D::InterpolateScale(float time, const Channel& channel)
     return retScale;
 }
 
-glm::quat SkeletalMesh3D::InterpolateRotation(float time, const Channel& channel)
+glm::quat SkeletalMesh3D::InterpolateRotation(float time, const Channel& channel, uint32_t& cursor)
 {
     if (channel.mRotationKeys.size() == 1)
     {
         return channel.mRotationKeys[0].mValue;
     }
 
-    uint32_t index = FindRotationIndex(time, channel);
+    uint32_t index = FindKeyIndex(channel.mRotationKeys, time, cursor);
     uint32_t nextIndex = index + 1;
     OCT_ASSERT(nextIndex < channel.mRotationKeys.size());
 
@@ -589,14 +672,14 @@ glm::quat SkeletalMesh3D::InterpolateRotation(float time, const Channel& channel
     return retQuat;
 }
 
-glm::vec3 SkeletalMesh3D::InterpolatePosition(float time, const Channel& channel)
+glm::vec3 SkeletalMesh3D::InterpolatePosition(float time, const Channel& channel, uint32_t& cursor)
 {
     if (channel.mPositionKeys.size() == 1)
     {
         return channel.mPositionKeys[0].mValue;
     }
 
-    uint32_t index = FindPositionIndex(time, channel);
+    uint32_t index = FindKeyIndex(channel.mPositionKeys, time, cursor);
     uint32_t nextIndex = index + 1;
     OCT_ASSERT(nextIndex < channel.mPositionKeys.size());
 
@@ -643,51 +726,6 @@ void SkeletalMesh3D::DetectTriggeredAnimEvents(
     }
 }
 
-uint32_t SkeletalMesh3D::FindScaleIndex(float time, const Channel& channel)
-{
-    OCT_ASSERT(channel.mScaleKeys.size() > 0);
-
-    for (uint32_t i = 0; i < channel.mScaleKeys.size() - 1; ++i)
-    {
-        if (time < channel.mScaleKeys[i + 1].mTime)
-        {
-            return i;
-        }
-    }
-
-    return uint32_t(channel.mScaleKeys.size() - 2);
-}
-
-uint32_t SkeletalMesh3D::FindRotationIndex(float time, const Channel& channel)
-{
-    OCT_ASSERT(channel.mRotationKeys.size() > 0);
-
-    for (uint32_t i = 0; i < channel.mRotationKeys.size() - 1; ++i)
-    {
-        if (time < channel.mRotationKeys[i + 1].mTime)
-        {
-            return i;
-        }
-    }
-
-    return uint32_t(channel.mRotationKeys.size() - 2);
-}
-
-uint32_t SkeletalMesh3D::FindPositionIndex(float time, const Channel& channel)
-{
-    OCT_ASSERT(channel.mPositionKeys.size() > 0);
-
-    for (uint32_t i = 0; i < channel.mPositionKeys.size() - 1; ++i)
-    {
-        if (time < channel.mPositionKeys[i + 1].mTime)
-        {
-            return i;
-        }
-    }
-
-    return uint32_t(channel.mPositionKeys.size() - 2);
-}
-
 glm::mat4 SkeletalMesh3D::GetBoneTransform(const std::string& name) const
 {
     int32_t index = FindBoneIndex(name);
@@ -960,7 +998,16 @@ void SkeletalMesh3D::UpdateAnimation(float deltaTime, bool updateBones)
         uint32_t numBones = GetNumBones();
         sDecompTransforms.resize(numBones);
 
-        if (updateBones)
+        // The last animation LOD only evaluates bones near the root, so start from the previous local pose.
+        const bool reduceBones = updateBones && mAnimationLodEnabled &&
+            (mAnimationLod == NUM_ANIMATION_LODS - 1) &&
+            (mLodLocalBoneMatrices.size() == numBones);
+
+        if (reduceBones)
+        {
+            mBoneMatrices = mLodLocalBoneMatrices;
+        }
+        else if (updateBones)
         {
             mesh->CopyBindPose(mBoneMatrices);
         }
@@ -1016,20 +1063,57 @@ void SkeletalMesh3D::UpdateAnimation(float deltaTime, bool updateBones)
 
                         if (updateBones)
                         {
+                            const uint32_t numChannels = (uint32_t)anim->mChannels.size();
+                            std::vector<uint32_t>& keyCursors = mActiveAnimations[i].mKeyCursors;
+
+                            if (keyCursors.size() != numChannels * 3)
+                            {
+                                keyCursors.assign(numChannels * 3, 0);
+                            }
+
+                            // Compressed animations are sampled at a uniform rate, so the frame
+                            // pair is shared by every channel.
+                            const bool compressed = anim->IsCompressed();
+                            uint32_t frame0 = 0;
+                            uint32_t frame1 = 0;
+                            float frameAlpha = 0.0f;
+
+                            if (compressed)
+                            {
+                                anim->mCompressed.FindFrames(tickTime, frame0, frame1, frameAlpha);
+                            }
+
                             // Go through all the channels, and update the relative transform 
                             // for each bone that exists in the animation.
-                            for (uint32_t i = 0; i < anim->mChannels.size(); ++i)
+                            for (uint32_t i = 0; i < numChannels; ++i)
                             {
                                 int32_t boneIndex = anim->mChannels[i].mBoneIndex;
                                 OCT_ASSERT(boneIndex != -1 &&
                                     boneIndex >= 0 &&
                                     boneIndex < (int32_t)mesh->GetBones().size());
 
+                                if (reduceBones && boneIndex != -1 &&
+                                    mesh->GetBoneDepth(boneIndex) > ANIMATION_LOD_MAX_BONE_DEPTH)
+                                {
+                                    continue;
+                                }
+
                                 if (boneIndex != -1)
                                 {
-                                    glm::vec3 scale = InterpolateScale(tickTime, anim->mChannels[i]);
-                                    glm::quat rotation = InterpolateRotation(tickTime, anim->mChannels[i]);
-                                    glm::vec3 position = InterpolatePosition(tickTime, anim->mChannels[i]);
+                                    glm::vec3 scale;
+                                    glm::quat rotation;
+                                    glm::vec3 position;
+
+                                    if (compressed)
+                                    {
+                                        anim->mCompressed.Sample(i, frame0, frame1, frameAlpha, position, rotation, scale);
+                                    }
+                                    else
+                                    {
+                                        scale = InterpolateScale(tickTime, anim->mChannels[i], keyCursors[i * 3 + 2]);
+                                        rotation = InterpolateRotation(tickTime, anim->mChannels[i], keyCursors[i * 3 + 1]);
+                                        position = InterpolatePosition(tickTime, anim->mChannels[i], keyCursors[i * 3 + 0]);
+                                    }
 
                                     if (bonesUpdated)
                                     {
@@ -1112,11 +1196,17 @@ void SkeletalMesh3D::UpdateAnimation(float deltaTime, bool updateBones)
                 }
             }
 
+            if (mAnimationLodEnabled)
+            {
+                mLodLocalBoneMatrices = mBoneMatrices;
+            }
+
             mesh->FinalizeBoneTransforms(mBoneMatrices);
 
             if (GFX_IsCpuSkinningRequired(this))
             {
-                CpuSkinVertices();
+                mCpuSkinningPending = true;
+                mReuseSkinnedVertices = false;
             }
         }
 
@@ -1154,7 +1244,7 @@ void SkeletalMesh3D::UpdateAnimation(float deltaTime, bool updateBones)
         mesh != nullptr &&
         GFX_IsCpuSkinningRequired(this))
     {
-        CpuSkinVertices();
+        mCpuSkinningPending = true;
     }
 
     if (updateBones)
@@ -1165,6 +1255,105 @@ void SkeletalMesh3D::UpdateAnimation(float deltaTime, bool updateBones)
     mHasAnimatedThisFrame = true;
 }
 
+void SkeletalMesh3D::UpdateAnimationLod(float deltaTime, float screenSize)
+{
+    if (mHasAnimatedThisFrame)
+        return;
+
+    const uint32_t numBones = GetNumBones();
+    const uint32_t lod = ComputeAnimationLod(screenSize);
+    const bool cpuSkinned = GFX_IsCpuSkinningRequired(this);
+
+    mLodFramesSinceUpdate++;
+
+    // Re-evaluate right away when the mesh moves to a more detailed LOD.
+    bool evaluate = (lod < mAnimationLod) ||
+        (mLodFramesSinceUpdate >= mLodInterval) ||
+        (mLodNextBoneMatrices.size() != numBones);
+
+    mAnimationLod = lod;
+
+    if (evaluate)
+    {
+        mReuseSkinnedVertices = false;
+        UpdateAnimation(deltaTime, true);
+
+        if (mLodNextBoneMatrices.size() != numBones)
+        {
+            mLodNextBoneMatrices = mBoneMatrices;
+        }
+
+        mLodPrevBoneMatrices.swap(mLodNextBoneMatrices);
+        mLodNextBoneMatrices = mBoneMatrices;
+        mLodFramesSinceUpdate = 0;
+        mLodInterval = 1u << lod;
+    }
+    else
+    {
+        // Advances animation time and fires events without touching the bones.
+        UpdateAnimation(deltaTime, false);
+        UpdateAttachedChildren(deltaTime);
+
+        if (cpuSkinned && mSkinnedVertices.size() > 0)
+        {
+            // Skinning is what's being saved here. The vertex buffers are still
+            // multi-buffered, so the last skinned vertices are uploaded again.
+            mCpuSkinningPending = true;
+            mReuseSkinnedVertices = true;
+        }
+    }
+
+    if (!cpuSkinned)
+    {
+        // Trail the newest pose by one interval so that there is always a pose to blend towards.
+        // The last frame of an interval lands on the newest pose exactly.
+        float alpha = glm::min(float(mLodFramesSinceUpdate + 1) / float(mLodInterval), 1.0f);
+
+        for (uint32_t i = 0; i < numBones; ++i)
+        {
+            mBoneMatrices[i] = mLodPrevBoneMatrices[i] + (mLodNextBoneMatrices[i] - mLodPrevBoneMatrices[i]) * alpha;
+        }
+    }
+}
+
+void SkeletalMesh3D::SetAnimationLodEnabled(bool enable)
+{
+    mAnimationLodEnabled = enable;
+
+    if (!enable)
+    {
+        mAnimationLod = 0;
+        mLodInterval = 1;
+        mLodFramesSinceUpdate = 0;
+        mLodPrevBoneMatrices.clear();
+        mLodNextBoneMatrices.clear();
+        mLodLocalBoneMatrices.clear();
+    }
+}
+
+bool SkeletalMesh3D::IsAnimationLodEnabled() const
+{
+    return mAnimationLodEnabled;
+}
+
+uint32_t SkeletalMesh3D::GetAnimationLod() const
+{
+    return mAnimationLod;
+}
+
+uint32_t SkeletalMesh3D::ComputeAnimationLod(float screenSize) const
+{
+    uint32_t lod = 0;
+
+    while (lod < NUM_ANIMATION_LODS - 1 &&
+        screenSize < sAnimationLodScreenSizes[lod])
+    {
+        lod++;
+    }
+
+    return lod;
+}
+
 void SkeletalMesh3D::UpdateAttachedChildren(float deltaTime)
 {
     bool isAnimating = !mAnimationPaused &&
@@ -1185,49 +1374,48 @@ void SkeletalMesh3D::UpdateAttachedChildren(float deltaTime)
     }
 }
 
+bool SkeletalMesh3D::IsCpuSkinningPending() const
+{
+    return mCpuSkinningPending;
+}
+
 void SkeletalMesh3D::CpuSkinVertices()
 {
     SkeletalMesh* mesh = mSkeletalMesh.Get<SkeletalMesh>();
     if (mesh != nullptr)
     {
-        mSkinnedVertices.resize(mesh->GetNumVertices());
         const std::vector<VertexSkinned>& verts = mesh->GetVertices();
+        uint32_t numVerts = mesh->GetNumVertices();
 
-        if (mBoneInfluenceMode == BoneInfluenceMode::One)
+        if (mReuseSkinnedVertices &&
+            mSkinnedVertices.size() == numVerts)
         {
-            for (uint32_t i = 0; i < mesh->GetNumVertices(); ++i)
-            {
-                const VertexSkinned& srcVert = verts[i];
-                Vertex& dstVert = mSkinnedVertices[i];
-
-                glm::mat4 transform = mBoneMatrices[srcVert.mBoneIndices[0]];
-
-                dstVert.mPosition = transform * glm::vec4(srcVert.mPosition, 1.0f);
-                dstVert.mNormal = transform * glm::vec4(srcVert.mNormal, 0.0f);
-                dstVert.mTexcoord0 = srcVert.mTexcoord0;
-                dstVert.mTexcoord1 = srcVert.mTexcoord1;
-            }
+            return;
         }
-        else
+
+        if (mSkinnedVertices.size() != numVerts)
         {
-            for (uint32_t i = 0; i < mesh->GetNumVertices(); ++i)
+            // Texcoords aren't affected by skinning, so they're only copied when the array is (re)built.
+            mSkinnedVertices.resize(numVerts);
+
+            for (uint32_t i = 0; i < numVerts; ++i)
             {
-                const VertexSkinned& srcVert = verts[i];
-                Vertex& dstVert = mSkinnedVertices[i];
-
-                static_assert(MAX_BONE_INFLUENCES == 4, "Need to adjust this code or convert to loop.");
-                glm::mat4 transform = mBoneMatrices[srcVert.mBoneIndices[0]] * srcVert.mBoneWeights[0];
-                transform += mBoneMatrices[srcVert.mBoneIndices[1]] * srcVert.mBoneWeights[1];
-                transform += mBoneMatrices[srcVert.mBoneIndices[2]] * srcVert.mBoneWeights[2];
-                transform += mBoneMatrices[srcVert.mBoneIndices[3]] * srcVert.mBoneWeights[3];
-
-                dstVert.mPosition = transform * glm::vec4(srcVert.mPosition, 1.0f);
-                dstVert.mNormal = transform * glm::vec4(srcVert.mNormal, 0.0f);
-                dstVert.mTexcoord0 = srcVert.mTexcoord0;
-                dstVert.mTexcoord1 = srcVert.mTexcoord1;
+                mSkinnedVertices[i].mTexcoord0 = verts[i].mTexcoord0;
+                mSkinnedVertices[i].mTexcoord1 = verts[i].mTexcoord1;
             }
         }
 
+        uint32_t numInfluences = (mBoneInfluenceMode == BoneInfluenceMode::One) ? 1 : MAX_BONE_INFLUENCES;
+        SkinVertices(verts.data(), mSkinnedVertices.data(), numVerts, mBoneMatrices.data(), numInfluences);
+    }
+}
+
+void SkeletalMesh3D::UploadSkinnedVertices()
+{
+    if (mSkeletalMesh != nullptr)
+    {
         GFX_UpdateSkeletalMeshCompVertexBuffer(this, mSkinnedVertices);
     }
+
+    mCpuSkinningPending = false;
 }
@@ -20,6 +20,8 @@ enum class AnimationUpdateMode
     Count
 };
 
+#define NUM_ANIMATION_LODS 4
+
 class SkeletalMesh;
 struct AnimEvent;
 struct Channel;
@@ -33,6 +35,9 @@ struct ActiveAnimation
     float mWeight = 0.0f;
     int32_t mSlot = 0;
     bool mLoop = false;
+
+    // Last key index found for each channel's position, rotation and scale track.
+    std::vector<uint32_t> mKeyCursors;
 };
 
 struct QueuedAnimation
@@ -132,6 +137,20 @@ public:
 
     void UpdateAnimation(float deltaTime, bool updateBones);
 
+    // Animation LOD evaluates bones less often as the mesh gets smaller on screen (screenSize is the
+    // fraction of the view height covered by its bounds) and blends between the evaluated poses.
+    // Time, events and attached children still update every frame.
+    void UpdateAnimationLod(float deltaTime, float screenSize);
+    void SetAnimationLodEnabled(bool enable);
+    bool IsAnimationLodEnabled() const;
+    uint32_t GetAnimationLod() const;
+
+    // Animation only requests CPU skinning. The Renderer skins the requesting meshes that survived
+    // culling, running CpuSkinVertices() for several meshes in parallel and then uploading on the main thread.
+    bool IsCpuSkinningPending() const;
+    void CpuSkinVertices();
+    void UploadSkinnedVertices();
+
     virtual Bounds GetLocalBounds() const override;
 
     int32_t FindBoneIndex(const std::string& name) const;
@@ -146,9 +165,9 @@ protected:
 
     void TickCommon(float deltaTime);
 
-    glm::vec3 InterpolateScale(float time, const Channel& channel);
-    glm::quat InterpolateRotation(float time, const Channel& channel);
-    glm::vec3 InterpolatePosition(float time, const Channel& channel);
+    glm::vec3 InterpolateScale(float time, const Channel& channel, uint32_t& cursor);
+    glm::quat InterpolateRotation(float time, const Channel& channel, uint32_t& cursor);
+    glm::vec3 InterpolatePosition(float time, const Channel& channel, uint32_t& cursor);
     void DetectTriggeredAnimEvents(
         const Animation& animation,
         float prevTickTime,
@@ -156,12 +175,8 @@ protected:
         float animationSpeed,
         std::vector<AnimEvent>& outEvents);
 
-    uint32_t FindScaleIndex(float time, const Channel& channel);
-    uint32_t FindRotationIndex(float time, const Channel& channel);
-    uint32_t FindPositionIndex(float time, const Channel& channel);
-
     void UpdateAttachedChildren(float deltaTime);
-    void CpuSkinVertices();
+    uint32_t ComputeAnimationLod(float screenSize) const;
 
     SkeletalMeshRef mSkeletalMesh;
     std::vector<glm::mat4> mBoneMatrices;
@@ -177,6 +192,17 @@ protected:
     bool mRevertToBindPose;
     bool mInheritPose;
     bool mHasAnimatedThisFrame;
+    bool mCpuSkinningPending = false;
+    bool mReuseSkinnedVertices = false;
+
+    // Animation LOD
+    bool mAnimationLodEnabled = false;
+    uint32_t mAnimationLod = 0;
+    uint32_t mLodInterval = 1;
+    uint32_t mLodFramesSinceUpdate = 0;
+    std::vector<glm::mat4> mLodPrevBoneMatrices;
+    std::vector<glm::mat4> mLodNextBoneMatrices;
+    std::vector<glm::mat4> mLodLocalBoneMatrices;
 
     BoneInfluenceMode mBoneInfluenceMode;
     AnimationUpdateMode mAnimationUpdateMode;
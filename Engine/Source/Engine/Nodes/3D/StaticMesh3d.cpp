@@ -152,6 +152,7 @@ void StaticMesh3D::SetStaticMesh(StaticMesh* staticMesh)
         mStaticMesh = staticMesh;
         RecreateCollisionShape();
         ClearInstanceColors();
+        MarkBoundsDirty();
     }
 }
 
@@ -196,6 +197,20 @@ Material* StaticMesh3D::GetMaterial()
     return mat;
 }
 
+DrawData StaticMesh3D::GetDrawData()
+{
+    DrawData data = Mesh3D::GetDrawData();
+
+    // Subclasses render differently, and instance colors are bound per node.
+    if (GetType() == StaticMesh3D::GetStaticType() &&
+        !HasInstanceColors())
+    {
+        data.mInstanceKey = GetStaticMesh();
+    }
+
+    return data;
+}
+
 void StaticMesh3D::Render()
 {
     GFX_DrawStaticMeshComp(this);
@@ -40,6 +40,7 @@ public:
     bool GetBakeLighting() const;
 
     virtual Material* GetMaterial() override;
+    virtual DrawData GetDrawData() override;
     virtual void Render() override;
 
     virtual VertexType GetVertexType() const override;
@@ -438,4 +438,5 @@ void TextMesh3D::UpdateVertexData()
 void TextMesh3D::UpdateBounds()
 {
     mBounds = ComputeBounds(mVertices);
+    MarkBoundsDirty();
 }
@@ -59,6 +59,9 @@
 std::unordered_map<TypeId, NetFuncMap> Node::sTypeNetFuncMap;
 std::unordered_set<NodePtrWeak> Node::sPendingDestroySet;
 
+static const SignalId sOnDestroySignal = InternSignal("OnDestroy");
+static const SignalId sOnStopSignal = InternSignal("OnStop");
+
 NodeId Node::sNextNodeId = NodeId(1);
 
 
@@ -212,10 +215,7 @@ void Node::Destroy()
     if (mDestroyed)
         return;
 
-    if (mSignalMap.size() > 0)
-    {
-        EmitSignal("OnDestroy", { this });
-    }
+    EmitSignal(sOnDestroySignal, this);
 
     // Lock a shared pointer so we don't delete ourselves midway through destruction.
     // If we are destroying a node because the last shared pointer was deleted, then this 
@@ -484,10 +484,7 @@ void Node::Stop()
         mScript->CallFunction("Stop");
     }
 
-    if (mSignalMap.size() > 0)
-    {
-        EmitSignal("OnStop", { this });
-    }
+    EmitSignal(sOnStopSignal, this);
 
     if (mNetId != INVALID_NET_ID)
     {
@@ -737,10 +734,21 @@ NodeId Node::GetNodeId() const
 }
 
 void Node::EmitSignal(const std::string& name, const std::vector<Datum>& args)
+{
+    // A name that was never interned can't have any connections.
+    SignalId id = FindSignal(name.c_str());
+
+    if (id != INVALID_SIGNAL_ID)
+    {
+        EmitSignal(id, SignalArgs(args));
+    }
+}
+
+void Node::EmitSignal(SignalId id, const SignalArgs& args)
 {
     if (mSignalMap.size() > 0)
     {
-        auto it = mSignalMap.find(name);
+        auto it = mSignalMap.find(id);
         if (it != mSignalMap.end())
         {
             it->second.Emit(args);
@@ -748,19 +756,36 @@ void Node::EmitSignal(const std::string& name, const std::vector<Datum>& args)
     }
 }
 
+bool Node::HasSignalConnections(SignalId id) const
+{
+    if (mSignalMap.size() > 0)
+    {
+        auto it = mSignalMap.find(id);
+        return (it != mSignalMap.end()) && it->second.HasConnections();
+    }
+
+    return false;
+}
+
 void Node::ConnectSignal(const std::string& name, Node* listener, SignalHandlerFP func)
 {
-    mSignalMap[name].Connect(listener, func);
+    mSignalMap[InternSignal(name.c_str())].Connect(listener, func);
 }
 
 void Node::ConnectSignal(const std::string& name, Node* listener, const ScriptFunc& func)
 {
-    mSignalMap[name].Connect(listener, func);
+    mSignalMap[InternSignal(name.c_str())].Connect(listener, func);
 }
 
 void Node::DisconnectSignal(const std::string& name, Node* listener)
 {
-    mSignalMap[name].Disconnect(listener);
+    SignalId id = FindSignal(name.c_str());
+    auto it = mSignalMap.find(id);
+
+    if (it != mSignalMap.end())
+    {
+        it->second.Disconnect(listener);
+    }
 }
 
 void Node::RenderShadow()
@@ -1183,6 +1208,7 @@ void Node::SetOwningHost(NetHostId hostId, bool setAsPawn)
     if (mOwningHost != hostId)
     {
         mOwningHost = hostId;
+        MarkNetDirty(&mOwningHost);
 
         if (mScript != nullptr)
         {
@@ -1214,6 +1240,7 @@ bool Node::IsTransformReplicated() const
 void Node::ForceReplication()
 {
     mForceReplicate = true;
+    MarkNetDirty();
 }
 
 void Node::ClearForcedReplication()
@@ -1226,6 +1253,43 @@ bool Node::NeedsForcedReplication()
     return mForceReplicate;
 }
 
+void Node::MarkNetDirty()
+{
+    if (!mNetDirty &&
+        mNetId != INVALID_NET_ID &&
+        NetIsServer())
+    {
+        mNetDirty = true;
+        NetworkManager::Get()->AddDirtyNetNode(this);
+    }
+}
+
+void Node::MarkNetDirty(const void* data)
+{
+    if (mNetId != INVALID_NET_ID)
+    {
+        for (uint32_t i = 0; i < mReplicatedData.size(); ++i)
+        {
+            if (mReplicatedData[i].mData.vp == data)
+            {
+                mReplicatedData[i].MarkDirty();
+                MarkNetDirty();
+                break;
+            }
+        }
+    }
+}
+
+void Node::ClearNetDirty()
+{
+    mNetDirty = false;
+}
+
+bool Node::IsNetDirty() const
+{
+    return mNetDirty;
+}
+
 bool Node::CheckNetRelevance(Node* playerNode)
 {
     // Node3D will override this to check based on position
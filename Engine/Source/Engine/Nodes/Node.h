@@ -119,6 +119,20 @@ public:
     NodeId GetNodeId() const;
 
     void EmitSignal(const std::string& name, const std::vector<Datum>& args);
+    void EmitSignal(SignalId id, const SignalArgs& args);
+    bool HasSignalConnections(SignalId id) const;
+
+    // Argument Datums are built on the stack, and only if something is connected.
+    template<typename... Args>
+    void EmitSignal(SignalId id, const Args&... args)
+    {
+        if (HasSignalConnections(id))
+        {
+            const Datum datums[sizeof...(Args) > 0 ? sizeof...(Args) : 1] = { Datum(args)... };
+            EmitSignal(id, SignalArgs(datums, sizeof...(Args)));
+        }
+    }
+
     void ConnectSignal(const std::string& name, Node* listener, SignalHandlerFP func);
     void ConnectSignal(const std::string& name, Node* listener, const ScriptFunc& func);
     void DisconnectSignal(const std::string& name, Node* listener);
@@ -197,6 +211,13 @@ public:
     void ClearForcedReplication();
     bool NeedsForcedReplication();
 
+    // Queues the node for replication on the server. Code that writes to data gathered in
+    // GatherReplicatedData() must call MarkNetDirty(data) with the address of the changed member.
+    void MarkNetDirty();
+    void MarkNetDirty(const void* data);
+    void ClearNetDirty();
+    bool IsNetDirty() const;
+
     virtual bool CheckNetRelevance(Node* playerNode);
     bool IsAlwaysRelevant() const;
     void SetAlwaysRelevant(bool alwaysRelevant);
@@ -446,7 +467,7 @@ protected:
     NodePtrWeak mSelf;
     std::vector<NodePtr> mChildren;
     std::unordered_map<std::string, Node*> mChildNameMap;
-    std::unordered_map<std::string, Signal> mSignalMap;
+    std::unordered_map<SignalId, Signal> mSignalMap;
     std::string mScriptFile;
     uint32_t mLastTickedFrame = 0;
     bool mActive = true;
@@ -476,6 +497,7 @@ protected:
     bool mReplicate = false;
     bool mReplicateTransform = false;
     bool mForceReplicate = false;
+    bool mNetDirty = false;
     bool mAlwaysRelevant = true;
 
     Script* mScript = nullptr;
@@ -12,6 +12,9 @@
 FORCE_LINK_DEF(Button);
 DEFINE_NODE(Button, Widget);
 
+static const SignalId sStateChangedSignal = InternSignal("StateChanged");
+static const SignalId sActivatedSignal = InternSignal("Activated");
+
 // Button that can be "selected" programmatically
 // Will not become unhovered when mouse is off of it.
 WeakPtr<Button> Button::sSelectedButton;
@@ -356,7 +359,7 @@ void Button::SetState(ButtonState newState)
 
         if (!IsDestroyed())
         {
-            EmitSignal("StateChanged", { this });
+            EmitSignal(sStateChangedSignal, this);
             CallFunction("OnStateChanged", { this });
         }
     }
@@ -571,6 +574,6 @@ Quad* Button::GetQuad()
 
 void Button::Activate()
 {
-    EmitSignal("Activated", { this });
+    EmitSignal(sActivatedSignal, this);
     CallFunction("OnActivated", { this });
 }
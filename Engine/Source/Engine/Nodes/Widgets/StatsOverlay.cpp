@@ -64,6 +64,12 @@ void StatsOverlay::TickCommon(float deltaTime)
     case StatDisplayMode::Network:
         numStats = 2;
         break;
+    case StatDisplayMode::Workers:
+        numStats = (uint32_t)GetProfiler()->GetWorkerStats().size();
+        break;
+    case StatDisplayMode::Counters:
+        numStats = (uint32_t)GetProfiler()->GetCounterStats().size();
+        break;
     default:
         numStats = 0;
         break;
@@ -129,6 +135,25 @@ void StatsOverlay::TickCommon(float deltaTime)
         SetStatText(0, "Upload", netMan->GetUploadRate() / 1024, DEFAULT_STAT_COLOR, statY);
         SetStatText(1, "Download", netMan->GetDownloadRate() / 1024, DEFAULT_STAT_COLOR, statY);
     }
+    else if (mDisplayMode == StatDisplayMode::Workers)
+    {
+        // Percentage of the frame each job worker spent running jobs
+        const std::vector<WorkerStat>& workerStats = GetProfiler()->GetWorkerStats();
+
+        for (uint32_t i = 0; i < workerStats.size(); ++i)
+        {
+            SetStatText(i, workerStats[i].mName, workerStats[i].mSmoothedUtilization, glm::vec4(0.4f, 0.7f, 1.0f, 1.0f), statY);
+        }
+    }
+    else if (mDisplayMode == StatDisplayMode::Counters)
+    {
+        const std::vector<CounterStat>& counterStats = GetProfiler()->GetCounterStats();
+
+        for (uint32_t i = 0; i < counterStats.size(); ++i)
+        {
+            SetStatText(i, counterStats[i].mName, counterStats[i].mSmoothedValue, DEFAULT_STAT_COLOR, statY);
+        }
+    }
     else
     {
         const std::vector<CpuStat>& cpuStats = GetProfiler()->GetCpuFrameStats();
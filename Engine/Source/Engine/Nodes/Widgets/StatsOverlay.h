@@ -14,6 +14,8 @@ enum class StatDisplayMode
     AllStatText,
     Memory,
     Network,
+    Workers,
+    Counters,
 
     Count
 };
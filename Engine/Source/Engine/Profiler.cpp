@@ -38,6 +38,16 @@ void Profiler::EndFrame()
     {
         mGpuStats[i].mSmoothedTime = Maths::Damp(mGpuStats[i].mSmoothedTime, mGpuStats[i].mTime, 0.05f, deltaTime);
     }
+
+    for (uint32_t i = 0; i < mWorkerStats.size(); ++i)
+    {
+        mWorkerStats[i].mSmoothedUtilization = Maths::Damp(mWorkerStats[i].mSmoothedUtilization, mWorkerStats[i].mUtilization, 0.05f, deltaTime);
+    }
+
+    for (uint32_t i = 0; i < mCounterStats.size(); ++i)
+    {
+        mCounterStats[i].mSmoothedValue = Maths::Damp(mCounterStats[i].mSmoothedValue, mCounterStats[i].mValue, 0.05f, deltaTime);
+    }
 #endif
 }
 
@@ -120,6 +130,45 @@ void Profiler::SetGpuStatTime(const char* name, float time)
 #endif
 }
 
+void Profiler::SetWorkerUtilization(uint32_t workerIndex, float utilization)
+{
+    // Utilization is the percentage of the last frame a job worker spent executing jobs.
+#if PROFILING_ENABLED
+    while (mWorkerStats.size() <= workerIndex)
+    {
+        mWorkerStats.push_back(WorkerStat());
+        snprintf(mWorkerStats.back().mName, STAT_NAME_BUFFER_LENGTH, "Worker %u", (uint32_t)mWorkerStats.size());
+    }
+
+    mWorkerStats[workerIndex].mUtilization = utilization;
+#endif
+}
+
+void Profiler::SetCounterStat(const char* name, float value)
+{
+    // Counter stats hold an arbitrary value (queue depths, latencies) that persists until it is set again.
+#if PROFILING_ENABLED
+    CounterStat* counterStat = nullptr;
+    for (uint32_t i = 0; i < mCounterStats.size(); ++i)
+    {
+        if (strncmp(mCounterStats[i].mName, name, STAT_NAME_LENGTH) == 0)
+        {
+            counterStat = &mCounterStats[i];
+            break;
+        }
+    }
+
+    if (counterStat == nullptr)
+    {
+        mCounterStats.push_back(CounterStat());
+        counterStat = &(mCounterStats.back());
+        strncpy(counterStat->mName, name, STAT_NAME_LENGTH);
+    }
+
+    counterStat->mValue = value;
+#endif
+}
+
 CpuStat* Profiler::FindCpuStat(const char* name, bool persistent)
 {
     std::vector<CpuStat>& stats = persistent ? mCpuPersistentStats : mCpuFrameStats;
@@ -154,6 +203,16 @@ const std::vector<GpuStat>& Profiler::GetGpuStats() const
     return mGpuStats;
 }
 
+const std::vector<WorkerStat>& Profiler::GetWorkerStats() const
+{
+    return mWorkerStats;
+}
+
+const std::vector<CounterStat>& Profiler::GetCounterStats() const
+{
+    return mCounterStats;
+}
+
 void Profiler::LogPersistentStats()
 {
     LogDebug("----- Persistent Stats -----");
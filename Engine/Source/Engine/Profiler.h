@@ -26,6 +26,20 @@ struct GpuStat
     float mSmoothedTime = 0.0f;
 };
 
+struct WorkerStat
+{
+    char mName[STAT_NAME_BUFFER_LENGTH] = {};
+    float mUtilization = 0.0f;
+    float mSmoothedUtilization = 0.0f;
+};
+
+struct CounterStat
+{
+    char mName[STAT_NAME_BUFFER_LENGTH] = {};
+    float mValue = 0.0f;
+    float mSmoothedValue = 0.0f;
+};
+
 class Profiler
 {
 public:
@@ -39,12 +53,16 @@ public:
     void BeginGpuStat(const char* name);
     void EndGpuStat(const char* name);
     void SetGpuStatTime(const char* name, float time);
+    void SetWorkerUtilization(uint32_t workerIndex, float utilization);
+    void SetCounterStat(const char* name, float value);
 
     CpuStat* FindCpuStat(const char* name, bool persistent);
     const std::vector<CpuStat>& GetCpuFrameStats() const;
 
     const std::vector<CpuStat>& GetCpuPersistentStats() const;
     const std::vector<GpuStat>& GetGpuStats() const;
+    const std::vector<WorkerStat>& GetWorkerStats() const;
+    const std::vector<CounterStat>& GetCounterStats() const;
 
     void LogPersistentStats();
     void DumpPersistentStats();
@@ -54,6 +72,8 @@ protected:
     std::vector<CpuStat> mCpuFrameStats;
     std::vector<CpuStat> mCpuPersistentStats;
     std::vector<GpuStat> mGpuStats;
+    std::vector<WorkerStat> mWorkerStats;
+    std::vector<CounterStat> mCounterStats;
 };
 
 void CreateProfiler();
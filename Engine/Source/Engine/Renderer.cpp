@@ -3,6 +3,7 @@
 #include "Utilities.h"
 #include "Engine.h"
 #include "Profiler.h"
+#include "JobSystem.h"
 #include "Constants.h"
 #include "Nodes/Widgets/Widget.h"
 #include "Nodes/Widgets/Console.h"
@@ -123,6 +124,8 @@ void Renderer::Initialize()
 #endif
 
     SetColorScale((float)GetEngineConfig()->mColorScale);
+
+    PrewarmPipelines();
 }
 
 void Renderer::GatherProperties(std::vector<Property>& props)
@@ -207,6 +210,36 @@ bool Renderer::IsFrustumCullingEnabled() const
     return mFrustumCulling;
 }
 
+void Renderer::EnableSpatialCulling(bool enable)
+{
+    mSpatialCulling = enable;
+}
+
+bool Renderer::IsSpatialCullingEnabled() const
+{
+    return mSpatialCulling;
+}
+
+void Renderer::EnableAutoInstancing(bool enable)
+{
+    mAutoInstancing = enable;
+}
+
+bool Renderer::IsAutoInstancingEnabled() const
+{
+    return mAutoInstancing;
+}
+
+uint32_t Renderer::PrewarmPipelines()
+{
+    return GFX_PrewarmPipelines();
+}
+
+void Renderer::LogPipelineHitchReport()
+{
+    GFX_LogPipelineHitchReport();
+}
+
 void Renderer::Enable3dRendering(bool enable)
 {
     mEnable3dRendering = enable;
@@ -505,10 +538,91 @@ void Renderer::GatherDrawData(World* world)
 
     Camera3D* camera = world ? world->GetActiveCamera() : nullptr;
 
+    // With spatial culling, primitives come from the world's bounds tree instead of the scene
+    // graph. The main passes gather primitives in the view frustum and the shadow pass gathers
+    // casters in the shadow map's volume. Widgets are gathered from the world's widget roots.
+    bool spatialCulling = mSpatialCulling &&
+        mFrustumCulling &&
+        enable3D &&
+        camera != nullptr &&
+        !onlySelected;
+
     if (world != nullptr)
     {
         glm::vec3 cameraPos = camera ? camera->GetWorldPosition() : glm::vec3(0.0f, 0.0f, 0.0f);
 
+        auto gatherPrimitive = [&](Primitive3D* prim, bool mainPasses, bool shadowPass)
+        {
+            DrawData data = prim->GetDrawData();
+            data.mNodeType = prim->GetType();
+
+            bool simpleShadow = (data.mNodeType == ShadowMesh3D::GetStaticType());
+
+            bool distanceCulled = false;
+            data.mDistance2 = glm::distance2(cameraPos, data.mBounds.mCenter);
+            const float cullDist = prim->GetCullDistance();
+            if (cullDist > 0.0f)
+            {
+                const float cullDist2 = cullDist * cullDist;
+                if (data.mDistance2 > cullDist2)
+                {
+                    distanceCulled = true;
+                }
+            }
+
+            if (data.mNode != nullptr &&
+                !distanceCulled)
+            {
+                if (simpleShadow)
+                {
+                    if (mainPasses)
+                    {
+                        mSimpleShadowDraws.push_back(data);
+                    }
+                }
+                else if (!mainPasses)
+                {
+                    if (shadowPass && prim->ShouldCastShadows())
+                    {
+                        mShadowDraws.push_back(data);
+                    }
+                }
+                else
+                {
+                    switch (data.mBlendMode)
+                    {
+                    case BlendMode::Opaque:
+                    case BlendMode::Masked:
+                        if (prim->ShouldReceiveSimpleShadows())
+                        {
+                            mOpaqueDraws.push_back(data);
+                        }
+                        else
+                        {
+                            mPostShadowOpaqueDraws.push_back(data);
+                        }
+                        break;
+                    case BlendMode::Translucent:
+                    case BlendMode::Additive:
+                        mTranslucentDraws.push_back(data);
+                        break;
+                    default:
+                        break;
+                    }
+
+                    if (shadowPass && prim->ShouldCastShadows())
+                    {
+                        mShadowDraws.push_back(data);
+                    }
+
+                    if (mDebugMode == DEBUG_WIREFRAME)
+                    {
+                        mWireframeDraws.push_back(data);
+                    }
+                }
+            }
+        };
+
         auto gatherDrawData = [&](Node* node) -> bool
         {
             if (!node->IsVisible())
@@ -532,64 +646,9 @@ void Renderer::GatherDrawData(World* world)
                 camera != nullptr &&
                 node->IsPrimitive3D())
             {
-                DrawData data = node->GetDrawData();
-                data.mNodeType = node->GetType();
-
-                Primitive3D* prim = (Primitive3D*)node;
-                bool simpleShadow = (data.mNodeType == ShadowMesh3D::GetStaticType());
-
-                bool distanceCulled = false;
-                data.mDistance2 = glm::distance2(cameraPos, data.mBounds.mCenter);
-                const float cullDist = prim ? prim->GetCullDistance() : 0.0f;
-                if (cullDist > 0.0f)
+                if (!spatialCulling)
                 {
-                    const float cullDist2 = cullDist * cullDist;
-                    if (data.mDistance2 > cullDist2)
-                    {
-                        distanceCulled = true;
-                    }
-                }
-
-                if (data.mNode != nullptr &&
-                    !distanceCulled)
-                {
-                    if (simpleShadow)
-                    {
-                        mSimpleShadowDraws.push_back(data);
-                    }
-                    else
-                    {
-                        switch (data.mBlendMode)
-                        {
-                        case BlendMode::Opaque:
-                        case BlendMode::Masked:
-                            if (prim->ShouldReceiveSimpleShadows())
-                            {
-                                mOpaqueDraws.push_back(data);
-                            }
-                            else
-                            {
-                                mPostShadowOpaqueDraws.push_back(data);
-                            }
-                            break;
-                        case BlendMode::Translucent:
-                        case BlendMode::Additive:
-                            mTranslucentDraws.push_back(data);
-                            break;
-                        default:
-                            break;
-                        }
-
-                        if (prim->ShouldCastShadows())
-                        {
-                            mShadowDraws.push_back(data);
-                        }
-
-                        if (mDebugMode == DEBUG_WIREFRAME)
-                        {
-                            mWireframeDraws.push_back(data);
-                        }
-                    }
+                    gatherPrimitive(static_cast<Primitive3D*>(node), true, true);
                 }
             }
             else if (enable2D && node->IsWidget())
@@ -632,9 +691,90 @@ void Renderer::GatherDrawData(World* world)
 
         if (world != nullptr)
         {
-            if (world->GetRootNode() != nullptr)
+            if (spatialCulling)
             {
-                world->GetRootNode()->Traverse(gatherDrawData);
+                static std::vector<Primitive3D*> sCandidates;
+                sCandidates.clear();
+
+                CameraFrustum frustum;
+                SetupFrustum(camera, frustum);
+
+                world->UpdatePrimitiveTree();
+                world->QueryPrimitiveTree(frustum, sCandidates);
+
+                for (uint32_t i = 0; i < sCandidates.size(); ++i)
+                {
+                    if (sCandidates[i]->IsVisible(true))
+                    {
+                        gatherPrimitive(sCandidates[i], true, false);
+                    }
+                }
+
+                // Shadow casters may be outside of the view, so query the volume covered by the
+                // shadow map (see DirectionalLight3D::GenerateViewProjectionMatrix()).
+                DirectionalLight3D* shadowLight = nullptr;
+                const std::vector<Light3D*>& lights = world->GetLights();
+                for (uint32_t i = 0; i < lights.size(); ++i)
+                {
+                    if (lights[i]->IsDirectionalLight3D() &&
+                        lights[i]->ShouldCastShadows() &&
+                        lights[i]->IsVisible(true))
+                    {
+                        shadowLight = static_cast<DirectionalLight3D*>(lights[i]);
+                        break;
+                    }
+                }
+
+                if (shadowLight != nullptr)
+                {
+                    glm::vec3 direction = shadowLight->GetDirection();
+                    glm::vec3 upVector = fabs(direction.y) > 0.5f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+                    glm::vec3 right = glm::normalize(glm::cross(direction, upVector));
+                    glm::vec3 up = glm::cross(right, direction);
+
+                    CameraFrustum shadowFrustum;
+                    shadowFrustum.SetPosition(cameraPos);
+                    shadowFrustum.SetBasis(direction, up, right);
+                    shadowFrustum.SetOrthographic(SHADOW_RANGE, SHADOW_RANGE, -SHADOW_RANGE_Z, SHADOW_RANGE_Z);
+
+                    sCandidates.clear();
+                    world->QueryPrimitiveTree(shadowFrustum, sCandidates);
+
+                    for (uint32_t i = 0; i < sCandidates.size(); ++i)
+                    {
+                        if (sCandidates[i]->IsVisible(true))
+                        {
+                            gatherPrimitive(sCandidates[i], false, true);
+                        }
+                    }
+                }
+            }
+
+            bool traverseScene = !spatialCulling;
+
+#if DEBUG_DRAW_ENABLED
+            // Proxy and collision draws come from every node, so they still need the whole scene graph.
+            traverseScene = traverseScene || mEnableProxyRendering || mDebugMode == DEBUG_COLLISION;
+#endif
+
+            if (traverseScene)
+            {
+                if (world->GetRootNode() != nullptr)
+                {
+                    world->GetRootNode()->Traverse(gatherDrawData);
+                }
+            }
+            else
+            {
+                const std::vector<Widget*>& widgetRoots = world->GetWidgetRoots();
+                for (uint32_t i = 0; i < widgetRoots.size(); ++i)
+                {
+                    Node* parent = widgetRoots[i]->GetParent();
+                    if (parent == nullptr || parent->IsVisible(true))
+                    {
+                        widgetRoots[i]->Traverse(gatherDrawData);
+                    }
+                }
             }
 
             // Need to render these widgets even if in 3D mode.
@@ -672,6 +812,12 @@ void Renderer::GatherDrawData(World* world)
                 return l.mMaterial < r.mMaterial;
             }
 
+            // Keep draws of the same mesh together so they can be instanced.
+            if (l.mInstanceKey != r.mInstanceKey)
+            {
+                return l.mInstanceKey < r.mInstanceKey;
+            }
+
             // Then sort by distance, render closer objects first to get
             // more early depth testing kills.
             return l.mDistance2 < r.mDistance2;
@@ -925,9 +1071,40 @@ void Renderer::GatherLightData(World* world)
 
 void Renderer::RenderDraws(const std::vector<DrawData>& drawData)
 {
-    for (uint32_t i = 0; i < drawData.size(); ++i)
+    static std::vector<StaticMesh3D*> sInstances;
+
+    uint32_t i = 0;
+    while (i < drawData.size())
     {
-        drawData[i].mNode->Render();
+        // Find the run of adjacent draws that share a mesh and material.
+        uint32_t end = i + 1;
+
+        if (mAutoInstancing && drawData[i].mInstanceKey != nullptr)
+        {
+            while (end < drawData.size() &&
+                drawData[end].mInstanceKey == drawData[i].mInstanceKey &&
+                drawData[end].mMaterial == drawData[i].mMaterial)
+            {
+                ++end;
+            }
+        }
+
+        if (end - i > 1)
+        {
+            sInstances.clear();
+            for (uint32_t j = i; j < end; ++j)
+            {
+                sInstances.push_back(static_cast<StaticMesh3D*>(drawData[j].mNode));
+            }
+
+            GFX_DrawStaticMeshCompInstances(sInstances.data(), (uint32_t)sInstances.size());
+        }
+        else
+        {
+            drawData[i].mNode->Render();
+        }
+
+        i = end;
     }
 }
 
@@ -961,12 +1138,8 @@ void Renderer::RenderDebugDraws(const std::vector<DebugDraw>& draws, PipelineCon
 #endif
 }
 
-void Renderer::FrustumCull(Camera3D* camera)
+void Renderer::SetupFrustum(Camera3D* camera, CameraFrustum& frustum)
 {
-    if (camera == nullptr)
-        return;
-
-    CameraFrustum frustum;
     frustum.SetPosition(camera->GetWorldPosition());
     frustum.SetBasis(
         camera->GetForwardVector(),
@@ -998,6 +1171,29 @@ void Renderer::FrustumCull(Camera3D* camera)
             nearZ,
             farZ);
     }
+}
+
+// Visible meshes whose bones changed this frame and need CPU skinning.
+static std::vector<SkeletalMesh3D*> sCpuSkinQueue;
+
+// Used to estimate the screen size of skeletal meshes for animation LOD.
+static glm::vec3 sLodCameraPosition = { 0.0f, 0.0f, 0.0f };
+static float sLodScreenScale = 1.0f;
+static bool sLodOrtho = false;
+
+void Renderer::FrustumCull(Camera3D* camera)
+{
+    if (camera == nullptr)
+        return;
+
+    CameraFrustum frustum;
+    SetupFrustum(camera, frustum);
+
+    sLodCameraPosition = camera->GetWorldPosition();
+    sLodOrtho = (camera->GetProjectionMode() == ProjectionMode::ORTHOGRAPHIC);
+    sLodScreenScale = sLodOrtho ?
+        (2.0f / glm::max(camera->GetOrthoHeight(), 0.0001f)) :
+        (1.0f / glm::max(tanf(DEGREES_TO_RADIANS * camera->GetFieldOfViewY() * 0.5f), 0.0001f));
 
     int32_t drawsCulled = 0;
     drawsCulled += FrustumCullDraws(frustum, mOpaqueDraws);
@@ -1020,6 +1216,49 @@ void Renderer::FrustumCull(Camera3D* camera)
     drawsCulled += FrustumCullDraws(frustum, mCollisionDraws);
     //LogDebug("DebugDraws culled: %d", drawsCulled);
 #endif
+
+    CpuSkinVisibleMeshes();
+}
+
+void Renderer::CpuSkinVisibleMeshes()
+{
+    if (sCpuSkinQueue.size() == 0)
+        return;
+
+    SCOPED_FRAME_STAT("CPU Skinning");
+
+    // A mesh is queued once for each draw list it appears in.
+    std::sort(sCpuSkinQueue.begin(), sCpuSkinQueue.end());
+    sCpuSkinQueue.erase(std::unique(sCpuSkinQueue.begin(), sCpuSkinQueue.end()), sCpuSkinQueue.end());
+
+    // Each mesh only writes its own skinned vertex array, so meshes can be skinned in parallel.
+    JobSystem::Get()->ParallelFor((uint32_t)sCpuSkinQueue.size(), 1, [&](uint32_t start, uint32_t end)
+    {
+        for (uint32_t i = start; i < end; ++i)
+        {
+            sCpuSkinQueue[i]->CpuSkinVertices();
+        }
+    });
+
+    // Vertex buffer updates go through the graphics layer, which is main thread only.
+    for (uint32_t i = 0; i < sCpuSkinQueue.size(); ++i)
+    {
+        sCpuSkinQueue[i]->UploadSkinnedVertices();
+    }
+
+    sCpuSkinQueue.clear();
+}
+
+static inline float GetScreenSize(const Bounds& bounds)
+{
+    // Fraction of the view height covered by the bounding sphere.
+    if (sLodOrtho)
+    {
+        return bounds.mRadius * sLodScreenScale;
+    }
+
+    float dist = glm::max(glm::distance(bounds.mCenter, sLodCameraPosition), 0.0001f);
+    return (bounds.mRadius * sLodScreenScale) / dist;
 }
 
 static inline void HandleCullResult(DrawData& drawData, bool inFrustum)
@@ -1030,14 +1269,35 @@ static inline void HandleCullResult(DrawData& drawData, bool inFrustum)
 
         if (inFrustum)
         {
-            skNode->UpdateAnimation(GetEngineState()->mGameDeltaTime, true);
+            if (skNode->IsAnimationLodEnabled())
+            {
+                skNode->UpdateAnimationLod(GetEngineState()->mGameDeltaTime, GetScreenSize(drawData.mBounds));
+            }
+            else
+            {
+                skNode->UpdateAnimation(GetEngineState()->mGameDeltaTime, true);
+            }
+
+            // Culled meshes are never skinned, even if their bones were updated.
+            if (skNode->IsCpuSkinningPending())
+            {
+                sCpuSkinQueue.push_back(skNode);
+            }
         }
         else
         {
             AnimationUpdateMode animMode = skNode->GetAnimationUpdateMode();
             if (animMode == AnimationUpdateMode::AlwaysUpdateTimeAndBones)
             {
-                skNode->UpdateAnimation(GetEngineState()->mGameDeltaTime, true);
+                if (skNode->IsAnimationLodEnabled())
+                {
+                    // Off-screen meshes only need bones for attachments and sockets.
+                    skNode->UpdateAnimationLod(GetEngineState()->mGameDeltaTime, 0.0f);
+                }
+                else
+                {
+                    skNode->UpdateAnimation(GetEngineState()->mGameDeltaTime, true);
+                }
             }
             else if (animMode == AnimationUpdateMode::AlwaysUpdateTime)
             {
@@ -1061,48 +1321,91 @@ static inline void HandleCullResult(DrawData& drawData, bool inFrustum)
     }
 }
 
-int32_t Renderer::FrustumCullDraws(const CameraFrustum& frustum, std::vector<DrawData>& drawData)
+struct SphereCullBatch
 {
-    int32_t drawsCulled = 0;
+    std::vector<float> mCenterX;
+    std::vector<float> mCenterY;
+    std::vector<float> mCenterZ;
+    std::vector<float> mRadius;
+    std::vector<uint8_t> mVisible;
 
-    // Some code duplication below, but I'm doing this to make sure the branching on ortho doesn't impact performance so much.
-    if (frustum.mOrtho)
+    void Resize(uint32_t count)
     {
-        for (int32_t i = int32_t(drawData.size()) - 1; i >= 0; --i)
-        {
-            bool inFrustum = frustum.IsSphereInFrustumOrtho(drawData[i].mBounds.mCenter, drawData[i].mBounds.mRadius);
-            HandleCullResult(drawData[i], inFrustum);
+        mCenterX.resize(count);
+        mCenterY.resize(count);
+        mCenterZ.resize(count);
+        mRadius.resize(count);
+        mVisible.resize(count);
+    }
 
-            if (!inFrustum)
-            {
-                drawData.erase(drawData.begin() + i);
-                drawsCulled++;
-            }
-        }
+    void Set(uint32_t index, const Bounds& bounds)
+    {
+        mCenterX[index] = bounds.mCenter.x;
+        mCenterY[index] = bounds.mCenter.y;
+        mCenterZ[index] = bounds.mCenter.z;
+        mRadius[index] = bounds.mRadius;
     }
-    else
+
+    void Cull(const CameraFrustum& frustum, uint32_t count)
     {
-        for (int32_t i = int32_t(drawData.size()) - 1; i >= 0; --i)
+        // Large scenes are split across job workers. Small batches stay on this thread.
+        JobSystem::Get()->ParallelFor(count, 1024, [&](uint32_t start, uint32_t end)
         {
-            bool inFrustum = frustum.IsSphereInFrustum(drawData[i].mBounds.mCenter, drawData[i].mBounds.mRadius);
-            HandleCullResult(drawData[i], inFrustum);
+            frustum.AreSpheresInFrustum(
+                mCenterX.data() + start,
+                mCenterY.data() + start,
+                mCenterZ.data() + start,
+                mRadius.data() + start,
+                end - start,
+                mVisible.data() + start);
+        });
+    }
+};
 
-            if (!inFrustum)
+static SphereCullBatch sCullBatch;
+
+int32_t Renderer::FrustumCullDraws(const CameraFrustum& frustum, std::vector<DrawData>& drawData)
+{
+    uint32_t numDraws = (uint32_t)drawData.size();
+    sCullBatch.Resize(numDraws);
+
+    for (uint32_t i = 0; i < numDraws; ++i)
+    {
+        sCullBatch.Set(i, drawData[i].mBounds);
+    }
+
+    sCullBatch.Cull(frustum, numDraws);
+
+    // Compact in place so the material sort order from GatherDrawData is kept.
+    uint32_t numVisible = 0;
+
+    for (uint32_t i = 0; i < numDraws; ++i)
+    {
+        bool inFrustum = (sCullBatch.mVisible[i] != 0);
+        HandleCullResult(drawData[i], inFrustum);
+
+        if (inFrustum)
+        {
+            if (numVisible != i)
             {
-                drawData.erase(drawData.begin() + i);
-                drawsCulled++;
+                drawData[numVisible] = std::move(drawData[i]);
             }
+
+            numVisible++;
         }
     }
 
-    return drawsCulled;
+    drawData.erase(drawData.begin() + numVisible, drawData.end());
+
+    return int32_t(numDraws - numVisible);
 }
 
 int32_t Renderer::FrustumCullDraws(const CameraFrustum& frustum, std::vector<DebugDraw>& drawData)
 {
-    int32_t drawsCulled = 0;
+    uint32_t numDraws = (uint32_t)drawData.size();
+    sCullBatch.Resize(numDraws);
 
-    for (int32_t i = int32_t(drawData.size()) - 1; i >= 0; --i)
+    for (uint32_t i = 0; i < numDraws; ++i)
     {
         Bounds meshBounds = drawData[i].mMesh->GetBounds();
         Bounds worldBounds;
@@ -1112,25 +1415,29 @@ int32_t Renderer::FrustumCullDraws(const CameraFrustum& frustum, std::vector<Deb
         float maxScale = glm::max(glm::max(absScale.x, absScale.y), absScale.z);
         worldBounds.mRadius = maxScale * meshBounds.mRadius;
 
-        bool cull = false;
+        sCullBatch.Set(i, worldBounds);
+    }
 
-        if (frustum.mOrtho)
-        {
-            cull = !frustum.IsSphereInFrustumOrtho(worldBounds.mCenter, worldBounds.mRadius);
-        }
-        else
-        {
-            cull = !frustum.IsSphereInFrustum(worldBounds.mCenter, worldBounds.mRadius);
-        }
+    sCullBatch.Cull(frustum, numDraws);
+
+    uint32_t numVisible = 0;
 
-        if (cull)
+    for (uint32_t i = 0; i < numDraws; ++i)
+    {
+        if (sCullBatch.mVisible[i] != 0)
         {
-            drawData.erase(drawData.begin() + i);
-            drawsCulled++;
+            if (numVisible != i)
+            {
+                drawData[numVisible] = std::move(drawData[i]);
+            }
+
+            numVisible++;
         }
     }
 
-    return drawsCulled;
+    drawData.erase(drawData.begin() + numVisible, drawData.end());
+
+    return int32_t(numDraws - numVisible);
 }
 
 int32_t Renderer::FrustumCullLights(const CameraFrustum& frustum, std::vector<LightData>& lightData)
@@ -78,6 +78,14 @@ public:
 
     void EnableFrustumCulling(bool enable);
     bool IsFrustumCullingEnabled() const;
+    void EnableSpatialCulling(bool enable);
+    bool IsSpatialCullingEnabled() const;
+    void EnableAutoInstancing(bool enable);
+    bool IsAutoInstancingEnabled() const;
+
+    // Builds the pipelines recorded in previous runs whose shaders are loaded. Returns the number built.
+    uint32_t PrewarmPipelines();
+    void LogPipelineHitchReport();
 
     void Enable3dRendering(bool enable);
     bool Is3dRenderingEnabled() const;
@@ -186,9 +194,11 @@ private:
     void RenderDraws(const std::vector<DrawData>& drawData);
     void RenderDraws(const std::vector<DrawData>& drawData, PipelineConfig pipelineConfig);
     void RenderDebugDraws(const std::vector<DebugDraw>& draws, PipelineConfig pipelineConfig = PipelineConfig::Count);
+    void SetupFrustum(Camera3D* camera, CameraFrustum& frustum);
     void FrustumCull(Camera3D* camera);
     int32_t FrustumCullDraws(const CameraFrustum& frustum, std::vector<DrawData>& drawData);
     int32_t FrustumCullDraws(const CameraFrustum& frustum, std::vector<DebugDraw>& drawData);
+    void CpuSkinVisibleMeshes();
     int32_t FrustumCullLights(const CameraFrustum& frustum, std::vector<LightData>& lightData);
 
     void RenderShadowCasters(World* world);
@@ -224,6 +234,8 @@ private:
     DebugMode mDebugMode = DEBUG_NONE;
     BoundsDebugMode mBoundsDebugMode = BoundsDebugMode::Off;
     bool mFrustumCulling = true;
+    bool mSpatialCulling = false;
+    bool mAutoInstancing = true;
     bool mEnableProxyRendering = false;
     bool mEnable3dRendering = true;
     bool mEnable2dRendering = true;
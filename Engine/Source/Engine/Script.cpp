@@ -5,6 +5,7 @@
 #include "Assets/SkeletalMesh.h"
 #include "Engine.h"
 #include "Log.h"
+#include "ScriptTickScheduler.h"
 
 #include "LuaBindings/LuaUtils.h"
 #include "LuaBindings/Vector_Lua.h"
@@ -19,6 +20,15 @@ DEFINE_OBJECT(Script);
 
 std::unordered_map<std::string, ScriptNetFuncMap> Script::sScriptNetFuncMap;
 
+static const char* sCallbackNames[uint32_t(ScriptCallback::Count)] =
+{
+    "Tick",
+    "EditorTick",
+    "BeginOverlap",
+    "EndOverlap",
+    "OnCollision"
+};
+
 bool Script::HandleScriptPropChange(Datum* datum, uint32_t index, const void* newValue)
 {
     Property* prop = static_cast<Property*>(datum);
@@ -98,7 +108,29 @@ Node* Script::GetOwner()
 
 void Script::Tick(float deltaTime)
 {
-    CallTick(deltaTime);
+    bool tickDue = true;
+
+    if (mTickRate != ScriptTickRate::EveryFrame)
+    {
+        mTickTime += deltaTime;
+        ++mTickFrames;
+
+        tickDue = (mTickRate == ScriptTickRate::EveryNFrames) ?
+            (mTickFrames >= (uint32_t)mTickRateValue) :
+            (mTickTime >= mTickRateValue);
+
+        if (tickDue)
+        {
+            deltaTime = mTickTime;
+            mTickTime = 0.0f;
+            mTickFrames = 0;
+        }
+    }
+
+    if (tickDue)
+    {
+        CallTick(deltaTime);
+    }
 
     if (NetIsServer())
     {
@@ -106,6 +138,32 @@ void Script::Tick(float deltaTime)
     }
 }
 
+void Script::SetTickRate(ScriptTickRate rate, float value)
+{
+    mTickRate = rate;
+    mTickRateValue = glm::max(value, 0.0f);
+    mTickTime = 0.0f;
+
+    // Spread nodes that share a frame interval across frames instead of ticking them all at once.
+    uint32_t frames = (uint32_t)mTickRateValue;
+    mTickFrames = (rate == ScriptTickRate::EveryNFrames && frames > 1) ? (mOwner->GetNodeId() % frames) : 0;
+}
+
+ScriptTickRate Script::GetTickRate() const
+{
+    return mTickRate;
+}
+
+float Script::GetTickRateValue() const
+{
+    return mTickRateValue;
+}
+
+const void* Script::GetTickFunction() const
+{
+    return mTickFunction;
+}
+
 void Script::AppendScriptProperties(std::vector<Property>& outProps)
 {
     for (uint32_t i = 0; i < mScriptProps.size(); ++i)
@@ -837,6 +895,12 @@ void Script::GatherReplicatedData()
 
         // Pop userdata
         lua_pop(L, 1);
+
+        // Newly gathered datums start dirty. Queue them in case the node is already on the network.
+        if (mReplicatedData.size() > 0)
+        {
+            mOwner->MarkNetDirty();
+        }
     }
 #endif
 }
@@ -958,10 +1022,24 @@ void Script::DownloadReplicatedData()
 
         OCT_ASSERT(lua_isuserdata(L, -1));
         int udIdx = lua_gettop(L);
+        bool anyChanged = false;
 
+        // Only values that differ from what was downloaded last time are flagged for replication.
         for (uint32_t i = 0; i < mReplicatedData.size(); ++i)
         {
-            DownloadDatum(L, mReplicatedData[i], udIdx, mReplicatedData[i].mVarName.c_str());
+            bool changed = false;
+            DownloadDatum(L, mReplicatedData[i], udIdx, mReplicatedData[i].mVarName.c_str(), &changed);
+
+            if (changed)
+            {
+                mReplicatedData[i].MarkDirty();
+                anyChanged = true;
+            }
+        }
+
+        if (anyChanged)
+        {
+            mOwner->MarkNetDirty();
         }
 
         // Pop script instance table
@@ -1063,9 +1141,10 @@ void Script::ExecuteNetFunc(uint16_t index, uint32_t numParams, const Datum** pa
 #endif
 }
 
-bool Script::DownloadDatum(lua_State* L, Datum& datum, int udIdx, const char* varName)
+bool Script::DownloadDatum(lua_State* L, Datum& datum, int udIdx, const char* varName, bool* outChanged)
 {
     bool success = true;
+    bool changed = false;
 
 #if LUA_ENABLED
     lua_getfield(L, udIdx, varName);
@@ -1077,42 +1156,49 @@ bool Script::DownloadDatum(lua_State* L, Datum& datum, int udIdx, const char* va
         case DatumType::Integer:
         {
             int32_t value = CHECK_INTEGER(L, -1);
+            changed = (datum.GetInteger() != value);
             datum.SetInteger(value);
             break;
         }
         case DatumType::Float:
         {
             float value = CHECK_NUMBER(L, -1);
+            changed = (datum.GetFloat() != value);
             datum.SetFloat(value);
             break;
         }
         case DatumType::Bool:
         {
             bool value = CHECK_BOOLEAN(L, -1);
+            changed = (datum.GetBool() != value);
             datum.SetBool(value);
             break;
         }
         case DatumType::String:
         {
             const char* value = CHECK_STRING(L, -1);
+            changed = (datum.GetString() != value);
             datum.SetString(value);
             break;
         }
         case DatumType::Vector2D:
         {
             glm::vec2 value = CHECK_VECTOR(L, -1);
+            changed = (datum.GetVector2D() != value);
             datum.SetVector2D(value);
             break;
         }
         case DatumType::Vector:
         {
             glm::vec3 value = CHECK_VECTOR(L, -1);
+            changed = (datum.GetVector() != value);
             datum.SetVector(value);
             break;
         }
         case DatumType::Color:
         {
             glm::vec4 value = CHECK_VECTOR(L, -1);
+            changed = (datum.GetColor() != value);
             datum.SetColor(value);
             break;
         }
@@ -1123,12 +1209,14 @@ bool Script::DownloadDatum(lua_State* L, Datum& datum, int udIdx, const char* va
             {
                 asset = CHECK_ASSET(L, -1);
             }
+            changed = (datum.GetAsset() != asset);
             datum.SetAsset(asset);
             break;
         }
         case DatumType::Byte:
         {
             int32_t value = CHECK_INTEGER(L, -1);
+            changed = (datum.GetByte() != (uint8_t)value);
             datum.SetByte((uint8_t)value);
             break;
         }
@@ -1147,6 +1235,7 @@ bool Script::DownloadDatum(lua_State* L, Datum& datum, int udIdx, const char* va
             {
                 node = CHECK_NODE(L, -1);
             }
+            changed = (datum.GetNode().Get() != node);
             datum.SetNode(ResolveWeakPtr<Node>(node));
             break;
         }
@@ -1154,6 +1243,7 @@ bool Script::DownloadDatum(lua_State* L, Datum& datum, int udIdx, const char* va
         case DatumType::Short:
         {
             int32_t value = CHECK_INTEGER(L, -1);
+            changed = (datum.GetShort() != (int16_t)value);
             datum.SetShort((int16_t)value);
             break;
         }
@@ -1182,6 +1272,11 @@ bool Script::DownloadDatum(lua_State* L, Datum& datum, int udIdx, const char* va
     lua_pop(L, 1);
 #endif
 
+    if (outChanged != nullptr)
+    {
+        *outChanged = changed;
+    }
+
     return success;
 }
 
@@ -1392,36 +1487,22 @@ bool Script::InvokeNetFunc(const char* name, uint32_t numParams, const Datum** p
 void Script::BeginOverlap(Primitive3D* thisNode, Primitive3D* otherNode)
 {
 #if LUA_ENABLED
-    if (mHandleBeginOverlap && IsActive())
+    if (IsActive())
     {
         lua_State* L = GetLua();
 
-        // Grab the ud
-        Node_Lua::Create(L, mOwner);
-
-        OCT_ASSERT(lua_isuserdata(L, -1));
-        int udIdx = lua_gettop(L);
-        lua_getfield(L, udIdx, "BeginOverlap");
-
-        if (lua_isfunction(L, -1))
+        if (PushCallback(L, ScriptCallback::BeginOverlap))
         {
-            lua_pushvalue(L, udIdx);
+            Node_Lua::Create(L, mOwner);
             Node_Lua::Create(L, thisNode);
             Node_Lua::Create(L, otherNode);
 
-            // Instance table at -5
             // Func at -4
             // Instance table (as arg1) at -3
-            // thisComp (as arg2) at -2
-            // othercomp as (arg3) at -1
+            // thisNode (as arg2) at -2
+            // otherNode as (arg3) at -1
             LuaFuncCall(3);
         }
-        else
-        {
-            lua_pop(L, 1); // pop nil function
-        }
-
-        lua_pop(L, 1); // pop instance table
     }
 #endif
 }
@@ -1429,35 +1510,22 @@ void Script::BeginOverlap(Primitive3D* thisNode, Primitive3D* otherNode)
 void Script::EndOverlap(Primitive3D* thisNode, Primitive3D* otherNode)
 {
 #if LUA_ENABLED
-    if (mHandleEndOverlap && IsActive())
+    if (IsActive())
     {
         lua_State* L = GetLua();
 
-        Node_Lua::Create(L, mOwner);
-
-        OCT_ASSERT(lua_isuserdata(L, -1));
-        int udIdx = lua_gettop(L);
-        lua_getfield(L, udIdx, "EndOverlap");
-
-        if (lua_isfunction(L, -1))
+        if (PushCallback(L, ScriptCallback::EndOverlap))
         {
-            lua_pushvalue(L, udIdx);
+            Node_Lua::Create(L, mOwner);
             Node_Lua::Create(L, thisNode);
             Node_Lua::Create(L, otherNode);
 
-            // Instance table at -5
             // Func at -4
             // Instance table (as arg1) at -3
             // thisNode (as arg2) at -2
             // otherNode as (arg3) at -1
             LuaFuncCall(3);
         }
-        else
-        {
-            lua_pop(L, 1); // pop nil function
-        }
-
-        lua_pop(L, 1); // pop instance table
     }
 #endif
 }
@@ -1470,18 +1538,13 @@ void Script::OnCollision(
     btPersistentManifold* manifold)
 {
 #if LUA_ENABLED
-    if (mHandleOnCollision && IsActive())
+    if (IsActive())
     {
         lua_State* L = GetLua();
 
-        Node_Lua::Create(L, mOwner);
-        OCT_ASSERT(lua_isuserdata(L, -1));
-        int udIdx = lua_gettop(L);
-        lua_getfield(L, udIdx, "OnCollision");
-
-        if (lua_isfunction(L, -1))
+        if (PushCallback(L, ScriptCallback::OnCollision))
         {
-            lua_pushvalue(L, udIdx);                                // arg1 - self
+            Node_Lua::Create(L, mOwner);                            // arg1 - self
             Node_Lua::Create(L, thisNode);                          // arg2 - thisNode
             Node_Lua::Create(L, otherNode);                         // arg3 - otherNode
             Vector_Lua::Create(L, glm::vec4(impactPoint, 0.0f));    // arg4 - impactPoint
@@ -1490,12 +1553,6 @@ void Script::OnCollision(
 
             LuaFuncCall(5);
         }
-        else
-        {
-            lua_pop(L, 1); // pop nil function
-        }
-
-        lua_pop(L, 1); // pop instance table
     }
 #endif
 }
@@ -1812,10 +1869,7 @@ void Script::CreateScriptInstance()
             OCT_ASSERT(lua_gettop(L) == classTableIdx);
             lua_setfield(L, uvIdx, OCT_CLASS_TABLE_KEY); // Pops script class metatable
 
-            mTickEnabled = CheckIfFunctionExists("Tick");
-            mHandleBeginOverlap = CheckIfFunctionExists("BeginOverlap");
-            mHandleEndOverlap = CheckIfFunctionExists("EndOverlap");
-            mHandleOnCollision = CheckIfFunctionExists("OnCollision");
+            CacheCallbackRefs();
 
             SetWorld(mOwner->GetWorld());
 
@@ -1907,10 +1961,7 @@ void Script::DestroyScriptInstance()
         mActive = false;
     }
 
-    mTickEnabled = false;
-    mHandleBeginOverlap = false;
-    mHandleEndOverlap = false;
-    mHandleOnCollision = false;
+    ReleaseCallbackRefs();
 #endif
 }
 
@@ -1925,47 +1976,35 @@ void Script::CallTick(float deltaTime)
 {
 #if LUA_ENABLED
 
-#if EDITOR
     if (IsActive())
     {
-        if (IsGameTickEnabled())
-        {
-            CallFunction("Tick", deltaTime);
-        }
-        else
-        {
-            CallFunction("EditorTick", deltaTime);
-        }
-    }
+#if EDITOR
+        ScriptCallback callback = IsGameTickEnabled() ? ScriptCallback::Tick : ScriptCallback::EditorTick;
 #else
-    if (IsActive() && mTickEnabled)
-    {
+        ScriptCallback callback = ScriptCallback::Tick;
+#endif
         lua_State* L = GetLua();
 
-        Node_Lua::Create(L, mOwner);
-        OCT_ASSERT(lua_isuserdata(L, -1));
-
-        lua_getfield(L, -1, "Tick");
+        if (callback == ScriptCallback::Tick && ScriptTickScheduler::IsBatching())
+        {
+            RefreshCallbackRefs();
 
-        if (lua_isfunction(L, -1))
+            if (mTickFunction != nullptr)
+            {
+                ScriptTickScheduler::Enqueue(mOwner, mTickFunction, mCallbackRefs[uint32_t(ScriptCallback::Tick)], mClassName.c_str(), deltaTime);
+            }
+        }
+        else if (PushCallback(L, callback))
         {
-            lua_pushvalue(L, -2);
+            Node_Lua::Create(L, mOwner);
             lua_pushnumber(L, deltaTime);
 
-            // Instance table at -4
             // Func at -3
             // Instance table (as arg0) at -2
             // deltaTime as (arg1) at -1
             LuaFuncCall(2);
         }
-        else
-        {
-            lua_pop(L, 1);
-        }
-
-        lua_pop(L, 1);
     }
-#endif // EDITOR
 
 #endif // LUA_ENABLED
 
@@ -1997,4 +2036,106 @@ bool Script::CheckIfFunctionExists(const char* funcName)
     return exists;
 }
 
+void Script::CacheCallbackRefs()
+{
+#if LUA_ENABLED
+    ReleaseCallbackRefs();
 
+    lua_State* L = GetLua();
+
+    if (IsActive() && L != nullptr)
+    {
+        // Resolve the functions through the instance once so that per-frame callbacks
+        // don't need to go through the userdata's __index chain. Only the functions are
+        // referenced; a ref to the userdata itself would keep the node from being collected.
+        Node_Lua::Create(L, mOwner);
+        OCT_ASSERT(lua_isuserdata(L, -1));
+        int udIdx = lua_gettop(L);
+
+        for (uint32_t i = 0; i < uint32_t(ScriptCallback::Count); ++i)
+        {
+            lua_getfield(L, udIdx, sCallbackNames[i]);
+
+            if (lua_isfunction(L, -1))
+            {
+                if (i == uint32_t(ScriptCallback::Tick))
+                {
+                    mTickFunction = lua_topointer(L, -1);
+                }
+
+                mCallbackRefs[i] = luaL_ref(L, LUA_REGISTRYINDEX);
+            }
+            else
+            {
+                lua_pop(L, 1);
+            }
+        }
+
+        lua_pop(L, 1);
+    }
+
+    mCallbackGeneration = ScriptUtils::GetReloadGeneration();
+    mCallbackRefsDirty = false;
+#endif
+}
+
+void Script::ReleaseCallbackRefs()
+{
+#if LUA_ENABLED
+    lua_State* L = GetLua();
+
+    for (uint32_t i = 0; i < uint32_t(ScriptCallback::Count); ++i)
+    {
+        if (mCallbackRefs[i] != LUA_REFNIL && L != nullptr)
+        {
+            luaL_unref(L, LUA_REGISTRYINDEX, mCallbackRefs[i]);
+        }
+
+        mCallbackRefs[i] = LUA_REFNIL;
+    }
+
+    mTickFunction = nullptr;
+#endif
+}
+
+void Script::RefreshCallbackRefs()
+{
+    // Script files were hot-reloaded or a callback was reassigned on the instance,
+    // so the cached functions may be stale.
+    if (mCallbackRefsDirty ||
+        mCallbackGeneration != ScriptUtils::GetReloadGeneration())
+    {
+        CacheCallbackRefs();
+    }
+}
+
+void Script::OnFieldAssigned(const char* key)
+{
+    for (uint32_t i = 0; i < uint32_t(ScriptCallback::Count); ++i)
+    {
+        if (strcmp(key, sCallbackNames[i]) == 0)
+        {
+            mCallbackRefsDirty = true;
+            break;
+        }
+    }
+}
+
+bool Script::PushCallback(lua_State* L, ScriptCallback callback)
+{
+    bool pushed = false;
+
+#if LUA_ENABLED
+    RefreshCallbackRefs();
+
+    int ref = mCallbackRefs[uint32_t(callback)];
+
+    if (ref != LUA_REFNIL)
+    {
+        lua_rawgeti(L, LUA_REGISTRYINDEX, ref);
+        pushed = true;
+    }
+#endif
+
+    return pushed;
+}
@@ -25,6 +25,27 @@ struct AutoProperty
 
 typedef std::unordered_map<std::string, ScriptNetFunc> ScriptNetFuncMap;
 
+// Script callbacks that are invoked from C++ often enough to keep a registry ref to.
+enum class ScriptCallback : uint8_t
+{
+    Tick,
+    EditorTick,
+    BeginOverlap,
+    EndOverlap,
+    OnCollision,
+
+    Count
+};
+
+enum class ScriptTickRate : uint8_t
+{
+    EveryFrame,
+    EveryNFrames,
+    FixedInterval,
+
+    Count
+};
+
 class Script : public Object
 {
 public:
@@ -38,6 +59,19 @@ public:
 
     virtual void Tick(float deltaTime);
 
+    // Lets scripts that don't need full rate ticking opt out of it. The value is the number of frames
+    // for EveryNFrames and the interval in seconds for FixedInterval. Tick() receives the time elapsed since the last tick.
+    void SetTickRate(ScriptTickRate rate, float value);
+    ScriptTickRate GetTickRate() const;
+    float GetTickRateValue() const;
+
+    // Identity of the cached Tick function, used by ScriptTickScheduler to group instances.
+    const void* GetTickFunction() const;
+
+    // Called by the node userdata's __newindex. Assigning one of the cached callbacks
+    // (e.g. self.Tick = func) marks the callback refs stale so they are re-resolved.
+    void OnFieldAssigned(const char* key);
+
     void AppendScriptProperties(std::vector<Property>& outProps);
 
     void SetFile(const char* filename);
@@ -126,13 +160,18 @@ protected:
     void GatherNetFuncs(std::vector<ScriptNetFunc>& outFuncs);
     void DownloadReplicatedData();
 
-    bool DownloadDatum(lua_State* L, Datum& datum, int udIdx, const char* varName);
+    bool DownloadDatum(lua_State* L, Datum& datum, int udIdx, const char* varName, bool* outChanged = nullptr);
     void UploadDatum(Datum& datum, const char* varName);
 
     void CallTick(float deltaTime);
 
     bool CheckIfFunctionExists(const char* funcName);
 
+    void CacheCallbackRefs();
+    void ReleaseCallbackRefs();
+    void RefreshCallbackRefs();
+    bool PushCallback(lua_State* L, ScriptCallback callback);
+
     static std::unordered_map<std::string, ScriptNetFuncMap> sScriptNetFuncMap;
 
     Node* mOwner = nullptr;
@@ -142,9 +181,17 @@ protected:
     std::vector<ScriptNetDatum> mReplicatedData;
     std::vector<AutoProperty> mAutoProperties;
     bool mActive = false;
-    bool mTickEnabled = false;
-    bool mHandleBeginOverlap = false;
-    bool mHandleEndOverlap = false;
-    bool mHandleOnCollision = false;
+
+    // Registry refs to the class functions resolved when the instance is created.
+    // Re-resolved if scripts have been reloaded since (see ScriptUtils::GetReloadGeneration()).
+    int mCallbackRefs[uint32_t(ScriptCallback::Count)] = { LUA_REFNIL, LUA_REFNIL, LUA_REFNIL, LUA_REFNIL, LUA_REFNIL };
+    uint32_t mCallbackGeneration = 0;
+    bool mCallbackRefsDirty = false;
+    const void* mTickFunction = nullptr;
+
+    ScriptTickRate mTickRate = ScriptTickRate::EveryFrame;
+    float mTickRateValue = 0.0f;
+    float mTickTime = 0.0f;
+    uint32_t mTickFrames = 0;
 };
 
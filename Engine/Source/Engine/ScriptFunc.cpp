@@ -2,6 +2,8 @@
 #include "EngineTypes.h"
 #include "ScriptUtils.h"
 
+#include "LuaBindings/Node_Lua.h"
+
 #define REF_TABLE_NAME "OctaveFunc"
 
 ScriptFunc::ScriptFunc()
@@ -98,6 +100,39 @@ void ScriptFunc::Call(uint32_t numParams, Datum* params) const
     }
 }
 
+void ScriptFunc::CallMethod(Node* self, uint32_t numParams, const Datum* params) const
+{
+    lua_State* L = GetLua();
+    if (L != nullptr && 
+        mRef != LUA_REFNIL)
+    {
+        lua_getfield(L, LUA_REGISTRYINDEX, REF_TABLE_NAME);
+        OCT_ASSERT(lua_istable(L, -1));
+
+        // Push function
+        lua_geti(L, -1, mRef);
+
+        // Push self
+        if (self != nullptr)
+        {
+            Node_Lua::Create(L, self);
+        }
+        else
+        {
+            lua_pushnil(L);
+        }
+
+        // Push params
+        OCT_ASSERT(numParams == 0 || params != nullptr);
+        for (uint32_t i = 0; i < numParams; ++i)
+        {
+            LuaPushDatum(L, params[i]);
+        }
+
+        ScriptUtils::CallLuaFunc(numParams + 1, 0);
+    }
+}
+
 Datum ScriptFunc::CallR(uint32_t numParams, Datum* params) const
 {
     Datum retDatum;
@@ -4,6 +4,7 @@
 #include "Datum.h"
 
 class ScriptComponent;
+class Node;
 
 class ScriptFunc
 {
@@ -22,6 +23,9 @@ public:
     void Call(uint32_t numParams = 0, Datum* params = nullptr) const;
     Datum CallR(uint32_t numParams = 0, Datum* params = nullptr) const;
 
+    // Calls the function with self pushed as the first argument, without building a Datum for it.
+    void CallMethod(Node* self, uint32_t numParams = 0, const Datum* params = nullptr) const;
+
     void Push(lua_State* L) const;
 
     bool IsValid() const;
@@ -0,0 +1,283 @@
+#include "ScriptTickScheduler.h"
+#include "ScriptUtils.h"
+#include "Script.h"
+#include "World.h"
+#include "Engine.h"
+#include "Log.h"
+#include "Assertion.h"
+
+#include "LuaBindings/Node_Lua.h"
+
+std::vector<ScriptTickScheduler::TickGroup> ScriptTickScheduler::sGroups;
+std::unordered_map<const void*, uint32_t> ScriptTickScheduler::sGroupMap;
+int ScriptTickScheduler::sDispatcherRef = LUA_REFNIL;
+uint32_t ScriptTickScheduler::sGeneration = 0;
+uint32_t ScriptTickScheduler::sNumBatchedTicks = 0;
+bool ScriptTickScheduler::sBatching = false;
+bool ScriptTickScheduler::sFlushing = false;
+
+// Called with a group's Tick function and an array of instances. Instances are cleared from the
+// array as they are visited so that the array doesn't keep nodes alive, and so that the flush can
+// resume after an instance whose Tick() raised an error.
+static const char* sDispatcherSource =
+    "return function(func, list, first, n, dt)\n"
+    "    for i = first, n do\n"
+    "        local inst = list[i]\n"
+    "        list[i] = nil\n"
+    "        func(inst, dt)\n"
+    "    end\n"
+    "end\n";
+
+void ScriptTickScheduler::SetEnabled(bool enabled)
+{
+    GetMutableEngineConfig()->mBatchScriptTick = enabled;
+}
+
+bool ScriptTickScheduler::IsEnabled()
+{
+    return GetEngineConfig()->mBatchScriptTick;
+}
+
+void ScriptTickScheduler::BeginBatch()
+{
+    OCT_ASSERT(!sBatching);
+
+    // Drop groups that reference functions from before a hot-reload.
+    if (sGeneration != ScriptUtils::GetReloadGeneration())
+    {
+        ReleaseGroups();
+        sGeneration = ScriptUtils::GetReloadGeneration();
+    }
+
+    sBatching = true;
+    sNumBatchedTicks = 0;
+}
+
+void ScriptTickScheduler::Flush(World* world)
+{
+#if LUA_ENABLED
+    lua_State* L = GetLua();
+
+    // Ticks run during the flush (from nested C++ calls) are not queued, see IsBatching().
+    static std::vector<NodePtrWeak> sFlushNodes;
+    static std::vector<float> sFlushDeltaTimes;
+    sFlushing = true;
+
+    for (uint32_t g = 0; g < sGroups.size(); ++g)
+    {
+        if (sGroups[g].mNodes.size() == 0)
+        {
+            continue;
+        }
+
+        sFlushNodes.swap(sGroups[g].mNodes);
+        sFlushDeltaTimes.swap(sGroups[g].mDeltaTimes);
+
+        char statName[STAT_NAME_BUFFER_LENGTH];
+        memcpy(statName, sGroups[g].mStatName, STAT_NAME_BUFFER_LENGTH);
+        BEGIN_FRAME_STAT(statName);
+
+        lua_rawgeti(L, LUA_REGISTRYINDEX, sGroups[g].mListRef);
+        int listIdx = lua_gettop(L);
+
+        const void* func = sGroups[g].mFunc;
+        int32_t count = 0;
+
+        for (uint32_t i = 0; i < sFlushNodes.size(); ++i)
+        {
+            Node* node = sFlushNodes[i].Get();
+            Script* script = node ? node->GetScript() : nullptr;
+
+            // A node ticked earlier in this pass may have destroyed this one or restarted its script.
+            if (script != nullptr &&
+                !node->IsDestroyed() &&
+                node->GetWorld() == world &&
+                script->IsActive() &&
+                script->GetTickFunction() == func)
+            {
+                Node_Lua::Create(L, node);
+                lua_rawseti(L, listIdx, ++count);
+                sFlushDeltaTimes[count - 1] = sFlushDeltaTimes[i];
+            }
+        }
+
+        // Instances are dispatched in runs that share the same delta time, which is every instance
+        // unless some of them use a reduced tick rate.
+        int32_t first = 1;
+
+        while (first <= count)
+        {
+            float deltaTime = sFlushDeltaTimes[first - 1];
+            int32_t last = first;
+
+            while (last < count && sFlushDeltaTimes[last] == deltaTime)
+            {
+                ++last;
+            }
+
+            if (!PushDispatcher(L))
+            {
+                break;
+            }
+
+            lua_rawgeti(L, LUA_REGISTRYINDEX, sGroups[g].mFuncRef);
+            lua_pushvalue(L, listIdx);
+            lua_pushinteger(L, first);
+            lua_pushinteger(L, last);
+            lua_pushnumber(L, deltaTime);
+
+            if (ScriptUtils::CallLuaFunc(5))
+            {
+                first = last + 1;
+            }
+            else
+            {
+                lua_pop(L, 1); // Pop error message
+
+                // Skip past the instance that raised the error and continue with the rest.
+                while (first <= last && lua_rawgeti(L, listIdx, first) == LUA_TNIL)
+                {
+                    lua_pop(L, 1);
+                    ++first;
+                }
+
+                if (first <= last)
+                {
+                    lua_pop(L, 1);
+                }
+            }
+        }
+
+        // Only left over if the dispatcher could not be created.
+        for (int32_t i = first; i <= count; ++i)
+        {
+            lua_pushnil(L);
+            lua_rawseti(L, listIdx, i);
+        }
+
+        lua_pop(L, 1); // Pop instance list
+        sNumBatchedTicks += count;
+
+        sFlushNodes.clear();
+        sFlushDeltaTimes.clear();
+
+        END_FRAME_STAT(statName);
+    }
+
+    sFlushing = false;
+#endif
+}
+
+void ScriptTickScheduler::EndBatch()
+{
+    OCT_ASSERT(sBatching);
+    sBatching = false;
+
+    if (GetProfiler() != nullptr)
+    {
+        GetProfiler()->SetCounterStat("Batched Script Ticks", (float)sNumBatchedTicks);
+    }
+}
+
+bool ScriptTickScheduler::IsBatching()
+{
+    return sBatching && !sFlushing;
+}
+
+void ScriptTickScheduler::Enqueue(Node* node, const void* funcPtr, int funcRef, const char* className, float deltaTime)
+{
+#if LUA_ENABLED
+    OCT_ASSERT(IsBatching());
+
+    uint32_t groupIndex = 0;
+    auto it = sGroupMap.find(funcPtr);
+
+    if (it != sGroupMap.end())
+    {
+        groupIndex = it->second;
+    }
+    else
+    {
+        lua_State* L = GetLua();
+
+        TickGroup group;
+        group.mFunc = funcPtr;
+
+        // The group holds its own ref so the function (and its address) stays alive as long as the group.
+        lua_rawgeti(L, LUA_REGISTRYINDEX, funcRef);
+        group.mFuncRef = luaL_ref(L, LUA_REGISTRYINDEX);
+
+        // Reused every flush to pass the instances to the dispatcher.
+        lua_newtable(L);
+        group.mListRef = luaL_ref(L, LUA_REGISTRYINDEX);
+
+        snprintf(group.mStatName, STAT_NAME_BUFFER_LENGTH, "Script %s", className);
+
+        groupIndex = (uint32_t)sGroups.size();
+        sGroups.push_back(group);
+        sGroupMap.insert({ funcPtr, groupIndex });
+    }
+
+    TickGroup& group = sGroups[groupIndex];
+    group.mNodes.push_back(node->GetSelfPtr());
+    group.mDeltaTimes.push_back(deltaTime);
+#endif
+}
+
+void ScriptTickScheduler::Shutdown()
+{
+    ReleaseGroups();
+
+#if LUA_ENABLED
+    lua_State* L = GetLua();
+
+    if (sDispatcherRef != LUA_REFNIL && L != nullptr)
+    {
+        luaL_unref(L, LUA_REGISTRYINDEX, sDispatcherRef);
+    }
+#endif
+
+    sDispatcherRef = LUA_REFNIL;
+}
+
+void ScriptTickScheduler::ReleaseGroups()
+{
+#if LUA_ENABLED
+    lua_State* L = GetLua();
+
+    if (L != nullptr)
+    {
+        for (uint32_t i = 0; i < sGroups.size(); ++i)
+        {
+            luaL_unref(L, LUA_REGISTRYINDEX, sGroups[i].mFuncRef);
+            luaL_unref(L, LUA_REGISTRYINDEX, sGroups[i].mListRef);
+        }
+    }
+#endif
+
+    sGroups.clear();
+    sGroupMap.clear();
+}
+
+bool ScriptTickScheduler::PushDispatcher(lua_State* L)
+{
+#if LUA_ENABLED
+    if (sDispatcherRef == LUA_REFNIL)
+    {
+        if (luaL_loadstring(L, sDispatcherSource) != LUA_OK ||
+            lua_pcall(L, 0, 1, 0) != LUA_OK)
+        {
+            LogError("Failed to create script tick dispatcher: %s", lua_tostring(L, -1));
+            lua_pop(L, 1);
+            return false;
+        }
+
+        sDispatcherRef = luaL_ref(L, LUA_REGISTRYINDEX);
+    }
+
+    lua_rawgeti(L, LUA_REGISTRYINDEX, sDispatcherRef);
+    return true;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "EngineTypes.h"
+#include "Profiler.h"
+#include "Nodes/Node.h"
+
+#include <unordered_map>
+#include <vector>
+
+class World;
+
+// Batches script Tick() calls so that all nodes sharing a Tick function (in practice, one
+// script class) are ticked by a single call into a Lua-side dispatcher instead of paying a
+// C -> Lua transition per node. Only used for game ticks while EngineConfig::mBatchScriptTick is set.
+// Batched script ticks run after the native Tick() of every node gathered in the same tick pass.
+class ScriptTickScheduler
+{
+public:
+
+    static void SetEnabled(bool enabled);
+    static bool IsEnabled();
+
+    // World::Update() opens a batch around its tick loop and flushes it after each tick pass.
+    static void BeginBatch();
+    static void Flush(World* world);
+    static void EndBatch();
+    static bool IsBatching();
+
+    // funcRef is a registry ref to the Tick function, funcPtr its lua_topointer() identity.
+    static void Enqueue(Node* node, const void* funcPtr, int funcRef, const char* className, float deltaTime);
+
+    // Releases all Lua references. Must be called before the Lua state is closed.
+    static void Shutdown();
+
+private:
+
+    struct TickGroup
+    {
+        const void* mFunc = nullptr;
+        int mFuncRef = LUA_REFNIL;
+        int mListRef = LUA_REFNIL;
+        char mStatName[STAT_NAME_BUFFER_LENGTH] = {};
+        std::vector<NodePtrWeak> mNodes;
+        std::vector<float> mDeltaTimes;
+    };
+
+    static void ReleaseGroups();
+    static bool PushDispatcher(lua_State* L);
+
+    static std::vector<TickGroup> sGroups;
+    static std::unordered_map<const void*, uint32_t> sGroupMap;
+    static int sDispatcherRef;
+    static uint32_t sGeneration;
+    static uint32_t sNumBatchedTicks;
+    static bool sBatching;
+    static bool sFlushing;
+};
@@ -8,6 +8,7 @@ std::unordered_set<std::string> ScriptUtils::sLoadingLuaFiles;
 EmbeddedFile* ScriptUtils::sEmbeddedScripts = nullptr;
 uint32_t ScriptUtils::sNumEmbeddedScripts = 0;
 uint32_t ScriptUtils::sNumScriptInstances = 0;
+uint32_t ScriptUtils::sReloadGeneration = 0;
 bool ScriptUtils::sBreakOnScriptError = false;
 
 static std::string AppendLuaExtension(const std::string& str)
@@ -38,6 +39,7 @@ bool ScriptUtils::ReloadScriptFile(const std::string& fileName)
     }
 
     bool success = LoadScriptFile(fileName, className);
+    ++sReloadGeneration;
 
     return success;
 }
@@ -131,6 +133,8 @@ void ScriptUtils::ReloadAllScriptFiles()
         LoadScriptFile(fileNames[i], className);
     }
 
+    ++sReloadGeneration;
+
     // This doesn't re-gather the NetFuncs for this script file.
 }
 
@@ -332,6 +336,11 @@ uint32_t ScriptUtils::GetNextScriptInstanceNumber()
     return retNum;
 }
 
+uint32_t ScriptUtils::GetReloadGeneration()
+{
+    return sReloadGeneration;
+}
+
 void ScriptUtils::CallMethod(Node* node, const char* funcName, uint32_t numParams, const Datum** params, Datum* ret)
 {
     lua_State* L = GetLua();
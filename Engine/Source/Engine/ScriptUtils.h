@@ -25,6 +25,9 @@ public:
 
     static uint32_t GetNextScriptInstanceNumber();
 
+    // Incremented whenever script files are reloaded so cached function refs can be refreshed.
+    static uint32_t GetReloadGeneration();
+
     static void CallMethod(Node* node, const char* funcName, uint32_t numParams, const Datum** params, Datum* ret);
     static void SetBreakOnScriptError(bool enableBreak);
 
@@ -49,6 +52,7 @@ private:
     static EmbeddedFile* sEmbeddedScripts;
     static uint32_t sNumEmbeddedScripts;
     static uint32_t sNumScriptInstances;
+    static uint32_t sReloadGeneration;
 
     static bool sBreakOnScriptError;
 };
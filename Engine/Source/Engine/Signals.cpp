@@ -1,8 +1,52 @@
 #include "Signals.h"
 #include "Script.h"
 #include "Nodes/Node.h"
+#include "Assertion.h"
 
-void Signal::Emit(const std::vector<Datum>& args)
+struct SignalRegistry
+{
+    std::unordered_map<std::string, SignalId> mIds;
+    std::vector<std::string> mNames;
+};
+
+static SignalRegistry& GetSignalRegistry()
+{
+    // Function static so that signals can be interned during static initialization.
+    static SignalRegistry sRegistry;
+    return sRegistry;
+}
+
+SignalId InternSignal(const char* name)
+{
+    SignalRegistry& registry = GetSignalRegistry();
+    auto it = registry.mIds.find(name);
+
+    if (it != registry.mIds.end())
+    {
+        return it->second;
+    }
+
+    SignalId id = (SignalId)registry.mNames.size();
+    registry.mNames.push_back(name);
+    registry.mIds.insert({ registry.mNames.back(), id });
+    return id;
+}
+
+SignalId FindSignal(const char* name)
+{
+    SignalRegistry& registry = GetSignalRegistry();
+    auto it = registry.mIds.find(name);
+    return (it != registry.mIds.end()) ? it->second : INVALID_SIGNAL_ID;
+}
+
+const char* GetSignalName(SignalId id)
+{
+    SignalRegistry& registry = GetSignalRegistry();
+    OCT_ASSERT(id < registry.mNames.size());
+    return (id < registry.mNames.size()) ? registry.mNames[id].c_str() : "";
+}
+
+void Signal::Emit(const SignalArgs& args)
 {
     mEmitting = true;
 
@@ -24,16 +68,8 @@ void Signal::Emit(const std::vector<Datum>& args)
 
             if (it->second.mScriptFunc.IsValid())
             {
-                // Call the function as a member function (prepend self)
-                std::vector<Datum> selfArgs;
-                selfArgs.push_back(node);
-
-                if (args.size() > 0)
-                {
-                    selfArgs.insert(selfArgs.end(), args.begin(), args.end());
-                }
-
-                it->second.mScriptFunc.Call((uint32_t)selfArgs.size(), selfArgs.data());
+                // Call the function as a member function (self is pushed ahead of the args)
+                it->second.mScriptFunc.CallMethod(node, args.size(), args.begin());
             }
 
             it++;
@@ -51,6 +87,9 @@ void Signal::Emit(const std::vector<Datum>& args)
     {
         mConnectionMap.insert({ mPendingConnects[i] });
     }
+
+    mPendingDisconnects.clear();
+    mPendingConnects.clear();
 }
 
 void Signal::Connect(Node* node, SignalHandlerFP func)
@@ -110,6 +149,11 @@ void Signal::Disconnect(Node* node)
     }
 }
 
+bool Signal::HasConnections() const
+{
+    return !mConnectionMap.empty() || !mPendingConnects.empty();
+}
+
 void Signal::CleanupDeadConnections()
 {
     if (mEmitting)
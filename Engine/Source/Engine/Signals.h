@@ -8,7 +8,36 @@
 
 class Node;
 
-typedef void (*SignalHandlerFP)(Node*, const std::vector<Datum>&);
+// Signal names are interned to ids the first time they are seen so that emitting
+// and looking up signals doesn't need to hash or copy strings.
+typedef uint32_t SignalId;
+#define INVALID_SIGNAL_ID 0xffffffff
+
+// Emits with up to this many arguments are built in a stack buffer.
+#define MAX_SIGNAL_ARGS 8
+
+SignalId InternSignal(const char* name);
+SignalId FindSignal(const char* name);
+const char* GetSignalName(SignalId id);
+
+// Non-owning view of the arguments passed to an emit.
+struct SignalArgs
+{
+    SignalArgs() {}
+    SignalArgs(const Datum* data, uint32_t count) : mData(data), mCount(count) {}
+    SignalArgs(const std::vector<Datum>& args) : mData(args.data()), mCount((uint32_t)args.size()) {}
+
+    uint32_t size() const { return mCount; }
+    bool empty() const { return mCount == 0; }
+    const Datum& operator[](uint32_t index) const { return mData[index]; }
+    const Datum* begin() const { return mData; }
+    const Datum* end() const { return mData + mCount; }
+
+    const Datum* mData = nullptr;
+    uint32_t mCount = 0;
+};
+
+typedef void (*SignalHandlerFP)(Node*, const SignalArgs&);
 
 struct SignalHandlerFunc
 {
@@ -20,10 +49,11 @@ class Signal
 {
 public:
 
-    void Emit(const std::vector<Datum>& args);
+    void Emit(const SignalArgs& args);
     void Connect(Node* node, SignalHandlerFP func);
     void Connect(Node* node, const ScriptFunc& func);
     void Disconnect(Node* node);
+    bool HasConnections() const;
 
 private:
 
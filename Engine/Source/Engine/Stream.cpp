@@ -225,20 +225,8 @@ void Stream::ReadAsset(AssetRef& asset)
                 AssetStub* stub = AssetManager::Get()->GetAssetStub(assetName);
                 if (stub != nullptr)
                 {
-                    AsyncLoadAsset(assetName, &asset);
-                    bool hasDependency = false;
-                    for (uint32_t i = 0; i < mAsyncRequest->mDependentAssets.size(); ++i)
-                    {
-                        if (mAsyncRequest->mDependentAssets[i] == stub)
-                        {
-                            hasDependency = true;
-                            break;
-                        }
-                    }
-                    if (!hasDependency)
-                    {
-                        mAsyncRequest->mDependentAssets.push_back(stub);
-                    }
+                    AssetManager::Get()->AddAsyncLoadDependency(mAsyncRequest, stub);
+                    AsyncLoadAsset(assetName, &asset, mAsyncRequest->mPriority);
                 }
                 else
                 {
@@ -278,20 +266,8 @@ void Stream::ReadAsset(AssetRef& asset)
                     AssetStub* stub = AssetManager::Get()->GetAssetStub(assetName);
                     if (stub != nullptr)
                     {
-                        AsyncLoadAsset(assetName, &asset);
-                        bool hasDependency = false;
-                        for (uint32_t i = 0; i < mAsyncRequest->mDependentAssets.size(); ++i)
-                        {
-                            if (mAsyncRequest->mDependentAssets[i] == stub)
-                            {
-                                hasDependency = true;
-                                break;
-                            }
-                        }
-                        if (!hasDependency)
-                        {
-                            mAsyncRequest->mDependentAssets.push_back(stub);
-                        }
+                        AssetManager::Get()->AddAsyncLoadDependency(mAsyncRequest, stub);
+                        AsyncLoadAsset(assetName, &asset, mAsyncRequest->mPriority);
                     }
                     else
                     {
@@ -342,26 +318,14 @@ void Stream::ReadAsset(AssetRef& asset)
                     }
                     if (stub != nullptr)
                     {
+                        AssetManager::Get()->AddAsyncLoadDependency(mAsyncRequest, stub);
                         if (!assetName.empty())
                         {
-                            AsyncLoadAsset(assetName, &asset);
+                            AsyncLoadAsset(assetName, &asset, mAsyncRequest->mPriority);
                         }
                         else
                         {
-                            AsyncLoadAssetByUuid(uuid, &asset);
-                        }
-                        bool hasDependency = false;
-                        for (uint32_t i = 0; i < mAsyncRequest->mDependentAssets.size(); ++i)
-                        {
-                            if (mAsyncRequest->mDependentAssets[i] == stub)
-                            {
-                                hasDependency = true;
-                                break;
-                            }
-                        }
-                        if (!hasDependency)
-                        {
-                            mAsyncRequest->mDependentAssets.push_back(stub);
+                            AsyncLoadAssetByUuid(uuid, &asset, mAsyncRequest->mPriority);
                         }
                     }
                     else if (sWarnedUuids.find(uuid) == sWarnedUuids.end())
@@ -514,6 +478,34 @@ void Stream::WriteBytes(const uint8_t* src, uint32_t length)
     }
 }
 
+void Stream::ReadArray32(void* dst, uint32_t count)
+{
+    ReadBytes((uint8_t*)dst, count * sizeof(uint32_t));
+
+#if ENDIAN_SWAP
+    SwapArray32((uint32_t*)dst, count);
+#endif
+}
+
+void Stream::WriteArray32(const void* src, uint32_t count)
+{
+    uint32_t startPos = mPos;
+    WriteBytes((const uint8_t*)src, count * sizeof(uint32_t));
+
+#if ENDIAN_SWAP
+    // mData is not guaranteed to be 4 byte aligned at startPos.
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        uint32_t value;
+        memcpy(&value, &mData[startPos + i * sizeof(uint32_t)], sizeof(uint32_t));
+        Swap32(value);
+        memcpy(&mData[startPos + i * sizeof(uint32_t)], &value, sizeof(uint32_t));
+    }
+#else
+    OCT_UNUSED(startPos);
+#endif
+}
+
 int32_t Stream::ReadInt32()
 {
     int32_t ret = 0;
@@ -51,6 +51,10 @@ public:
 
     uint32_t ReadBytesMax(uint8_t* dst, uint32_t length);
 
+    // Bulk copies count 32-bit values (floats/ints). Stored little endian like the single value functions.
+    void ReadArray32(void* dst, uint32_t count);
+    void WriteArray32(const void* src, uint32_t count);
+
     int32_t ReadInt32();
     uint32_t ReadUint32();
     int64_t ReadInt64();
@@ -33,6 +33,10 @@ struct VertexColor
     uint32_t mColor;
 };
 
+// StaticMesh serializes these structs as flat arrays of 32-bit values, so they must not contain padding.
+static_assert(sizeof(Vertex) == 10 * sizeof(uint32_t), "Vertex must be tightly packed");
+static_assert(sizeof(VertexColor) == 11 * sizeof(uint32_t), "VertexColor must be tightly packed");
+
 struct VertexUI
 {
     glm::vec2 mPosition;
@@ -13,6 +13,9 @@
 #include "Nodes/3D/PointLight3d.h"
 #include "Nodes/3D/Particle3d.h"
 #include "Nodes/3D/Audio3d.h"
+#include "Nodes/3D/SkeletalMesh3d.h"
+#include "CameraFrustum.h"
+#include "ScriptTickScheduler.h"
 
 #if EDITOR
 #include "Editor/EditorState.h"
@@ -29,6 +32,10 @@ using namespace std;
 
 std::unordered_set<NodePtrWeak> World::sNewlyRegisteredNodes;
 
+static const SignalId sOnCollisionSignal = InternSignal("OnCollision");
+static const SignalId sBeginOverlapSignal = InternSignal("BeginOverlap");
+static const SignalId sEndOverlapSignal = InternSignal("EndOverlap");
+
 bool ContactAddedHandler(btManifoldPoint& cp,
     const btCollisionObjectWrapper* colObj0Wrap,
     int partId0,
@@ -84,6 +91,7 @@ World::World() :
 
 void World::Destroy()
 {
+    ClearParticlePool();
     DestroyRootNode();
 
     OCT_ASSERT(mRootNode == nullptr);
@@ -177,6 +185,13 @@ void World::SetRootNode(Node* node)
         }
 
         UpdateRenderSettings();
+
+        if (mRootNode != nullptr && IsPlaying())
+        {
+            // Release the previous scene's idle particles (and their ParticleSystem refs).
+            ClearParticlePool();
+            PrewarmParticlePools();
+        }
     }
 }
 
@@ -439,6 +454,16 @@ btDynamicsWorld* World::GetDynamicsWorld()
     return mDynamicsWorld;
 }
 
+uint32_t World::GetPhysicsStep() const
+{
+    return mPhysicsStep;
+}
+
+float World::GetPhysicsInterpolation() const
+{
+    return mPhysicsInterpolation;
+}
+
 btDbvtBroadphase* World::GetBroadphase()
 {
     return mBroadphase;
@@ -455,11 +480,126 @@ void World::PurgeOverlaps(Primitive3D* prim)
             primB == prim)
         {
             primA->EndOverlap(primA, primB);
+            mCurrentOverlapSet.erase(mCurrentOverlaps[i]);
             mCurrentOverlaps.erase(mCurrentOverlaps.begin() + i);
         }
     }
 }
 
+static bool IsTreePrimitive(Primitive3D* prim)
+{
+    // Skeletal meshes and particles are animated / simulated by the renderer's culling pass
+    // (even when off screen) and their bounds change every frame, so keep them out of the tree.
+    TypeId type = prim->GetType();
+    return (type != SkeletalMesh3D::GetStaticType() &&
+        type != Particle3D::GetStaticType());
+}
+
+void World::AddDirtyBoundsNode(Node3D* node)
+{
+    mDirtyBoundsNodes.insert(node);
+}
+
+void World::UpdatePrimitiveTree()
+{
+    static std::vector<Node3D*> sDirtyNodes;
+
+    // Updating a dirty transform will dirty the node's children, so keep
+    // going until no new nodes get added.
+    while (!mDirtyBoundsNodes.empty())
+    {
+        sDirtyNodes.assign(mDirtyBoundsNodes.begin(), mDirtyBoundsNodes.end());
+        mDirtyBoundsNodes.clear();
+
+        for (uint32_t i = 0; i < sDirtyNodes.size(); ++i)
+        {
+            Node3D* node = sDirtyNodes[i];
+            node->ClearBoundsDirty();
+
+            if (node->IsPrimitive3D())
+            {
+                Primitive3D* prim = static_cast<Primitive3D*>(node);
+                btDbvtNode* leaf = prim->GetTreeLeaf();
+
+                if (leaf != nullptr)
+                {
+                    prim->UpdateTransform(false);
+                    Bounds bounds = prim->GetBounds();
+                    btDbvtVolume volume = btDbvtVolume::FromCR(GlmToBullet(bounds.mCenter), bounds.mRadius);
+
+                    // Leaves are enlarged when reinserted so small movements don't touch the tree.
+                    mPrimitiveTree.update(leaf, volume, bounds.mRadius * 0.25f);
+                }
+            }
+        }
+    }
+
+    mPrimitiveTree.optimizeIncremental(1);
+}
+
+void World::QueryPrimitiveTree(const CameraFrustum& frustum, std::vector<Primitive3D*>& outPrims)
+{
+    struct FrustumCollector : btDbvt::ICollide
+    {
+        std::vector<Primitive3D*>* mPrims = nullptr;
+
+        void Process(const btDbvtNode* leaf) override
+        {
+            mPrims->push_back(reinterpret_cast<Primitive3D*>(leaf->data));
+        }
+    };
+
+    glm::vec4 planes[6];
+    frustum.GetPlanes(planes);
+
+    btVector3 normals[6];
+    btScalar offsets[6];
+    for (uint32_t i = 0; i < 6; ++i)
+    {
+        normals[i] = btVector3(planes[i].x, planes[i].y, planes[i].z);
+        offsets[i] = planes[i].w;
+    }
+
+    FrustumCollector collector;
+    collector.mPrims = &outPrims;
+    btDbvt::collideKDOP(mPrimitiveTree.m_root, normals, offsets, 6, collector);
+
+    outPrims.insert(outPrims.end(), mUntreedPrimitives.begin(), mUntreedPrimitives.end());
+}
+
+uint32_t World::GetNumTreePrimitives() const
+{
+    return mNumTreePrimitives;
+}
+
+const std::vector<Widget*>& World::GetWidgetRoots()
+{
+    // Reparenting or reordering a node re-registers it, so the list only needs
+    // rebuilding after a widget is registered or unregistered.
+    if (mWidgetRootsDirty)
+    {
+        mWidgetRoots.clear();
+
+        if (mRootNode != nullptr)
+        {
+            mRootNode->Traverse([&](Node* node) -> bool
+            {
+                if (node->IsWidget())
+                {
+                    mWidgetRoots.push_back(static_cast<Widget*>(node));
+                    return false;
+                }
+
+                return true;
+            });
+        }
+
+        mWidgetRootsDirty = false;
+    }
+
+    return mWidgetRoots;
+}
+
 void World::RayTest(glm::vec3 start, glm::vec3 end, uint8_t collisionMask, RayTestResult& outResult, uint32_t numIgnoredObjects, btCollisionObject** ignoreObjects, bool ignorePureOverlap)
 {
     outResult.mStart = start;
@@ -621,6 +761,34 @@ void World::RegisterNode(Node* node, bool subRoot)
         }
     }
 
+    if (node->IsPrimitive3D())
+    {
+        Primitive3D* prim = static_cast<Primitive3D*>(node);
+        OCT_ASSERT(prim->GetTreeLeaf() == nullptr);
+
+        if (IsTreePrimitive(prim))
+        {
+            // Real volume is filled in by UpdatePrimitiveTree() since the transform may still be dirty.
+            btDbvtVolume volume = btDbvtVolume::FromCR(btVector3(0.0f, 0.0f, 0.0f), 0.0f);
+            prim->SetTreeLeaf(mPrimitiveTree.insert(volume, prim));
+            mNumTreePrimitives++;
+        }
+        else
+        {
+            mUntreedPrimitives.push_back(prim);
+        }
+    }
+
+    if (node->IsNode3D())
+    {
+        static_cast<Node3D*>(node)->MarkBoundsDirty();
+    }
+
+    if (node->IsWidget())
+    {
+        mWidgetRootsDirty = true;
+    }
+
     if (subRoot)
     {
         sNewlyRegisteredNodes.insert(ResolveWeakPtr(node));
@@ -644,6 +812,36 @@ void World::UnregisterNode(Node* node, bool subRoot)
         mLights.erase(it);
     }
 
+    if (node->IsPrimitive3D())
+    {
+        Primitive3D* prim = static_cast<Primitive3D*>(node);
+
+        if (prim->GetTreeLeaf() != nullptr)
+        {
+            mPrimitiveTree.remove(prim->GetTreeLeaf());
+            prim->SetTreeLeaf(nullptr);
+            mNumTreePrimitives--;
+        }
+        else
+        {
+            auto it = std::find(mUntreedPrimitives.begin(), mUntreedPrimitives.end(), prim);
+            OCT_ASSERT(it != mUntreedPrimitives.end());
+            mUntreedPrimitives.erase(it);
+        }
+    }
+
+    if (node->IsNode3D() &&
+        static_cast<Node3D*>(node)->IsBoundsDirty())
+    {
+        mDirtyBoundsNodes.erase(static_cast<Node3D*>(node));
+        static_cast<Node3D*>(node)->ClearBoundsDirty();
+    }
+
+    if (node->IsWidget())
+    {
+        mWidgetRootsDirty = true;
+    }
+
     if (node == mAudioReceiver)
     {
         SetAudioReceiver(nullptr);
@@ -701,6 +899,55 @@ void World::ExtractPersistingNodes()
         true);
 }
 
+void World::StepPhysics(float deltaTime)
+{
+    const EngineConfig* config = GetEngineConfig();
+
+    if (config->mPhysicsRate <= 0)
+    {
+        // Variable timestep. One step with the frame delta, no interpolation.
+        OctaveMotionState::sPhysicsStep = ++mPhysicsStep;
+        mDynamicsWorld->stepSimulation(deltaTime, 0);
+        mPhysicsInterpolation = 1.0f;
+        return;
+    }
+
+    const float fixedDeltaTime = 1.0f / config->mPhysicsRate;
+    const uint32_t maxSubsteps = (uint32_t)glm::max(config->mMaxPhysicsSubsteps, 1);
+
+    mPhysicsAccumulator += deltaTime;
+    uint32_t numSubsteps = uint32_t(mPhysicsAccumulator / fixedDeltaTime);
+
+    if (numSubsteps > maxSubsteps)
+    {
+        // Drop the time we can't catch up on so that a long frame slows the simulation
+        // down instead of making every following frame run extra steps.
+        mPhysicsAccumulator = fmodf(mPhysicsAccumulator, fixedDeltaTime) + maxSubsteps * fixedDeltaTime;
+        numSubsteps = maxSubsteps;
+    }
+
+    uint64_t startTime = SYS_GetTimeMicroseconds();
+
+    for (uint32_t i = 0; i < numSubsteps; ++i)
+    {
+        // Motion states record which step wrote them so they can blend from the previous step.
+        OctaveMotionState::sPhysicsStep = ++mPhysicsStep;
+        mDynamicsWorld->stepSimulation(fixedDeltaTime, 0);
+        mPhysicsAccumulator -= fixedDeltaTime;
+    }
+
+    mPhysicsAccumulator = glm::max(mPhysicsAccumulator, 0.0f);
+    mPhysicsInterpolation = glm::clamp(mPhysicsAccumulator / fixedDeltaTime, 0.0f, 1.0f);
+
+    if (numSubsteps > 0)
+    {
+        float substepTime = (SYS_GetTimeMicroseconds() - startTime) / (1000.0f * numSubsteps);
+        GetProfiler()->SetCounterStat("Physics Substep (ms)", substepTime);
+    }
+
+    GetProfiler()->SetCounterStat("Physics Substeps", (float)numSubsteps);
+}
+
 void World::Update(float deltaTime)
 {
     bool gameTickEnabled = IsGameTickEnabled();
@@ -729,10 +976,13 @@ void World::Update(float deltaTime)
         }
     }
 
+    GetProfiler()->SetCounterStat("Particle Pool Hits", (float)mParticlePoolHits);
+    GetProfiler()->SetCounterStat("Particle Pool Misses", (float)mParticlePoolMisses);
+
     if (gameTickEnabled)
     {
         SCOPED_FRAME_STAT("Physics");
-        mDynamicsWorld->stepSimulation(deltaTime, 2);
+        StepPhysics(deltaTime);
     }
 
     if (gameTickEnabled)
@@ -743,9 +993,11 @@ void World::Update(float deltaTime)
             mDynamicsWorld->getDispatchInfo(),
             mCollisionDispatcher);
 
-        // Update collisions
-        mPreviousOverlaps = mCurrentOverlaps;
+        // Update collisions. Swap instead of copying so the containers keep their capacity.
+        mPreviousOverlaps.swap(mCurrentOverlaps);
+        mPreviousOverlapSet.swap(mCurrentOverlapSet);
         mCurrentOverlaps.clear();
+        mCurrentOverlapSet.clear();
 
         // Check the number of manifolds each loop iteration, since an overlap/collision callbacks
         // may reduce the number of manifolds if an collision object gets removed from the dynamics world.
@@ -793,13 +1045,14 @@ void World::Update(float deltaTime)
                 prim0->OnCollision(prim0, prim1, avgContactPoint0, avgNormal, manifold);
                 prim1->OnCollision(prim1, prim0, avgContactPoint1, -avgNormal, manifold);
 
-                prim0->EmitSignal("OnCollision", {prim0, prim1, avgContactPoint0, avgNormal});
-                prim1->EmitSignal("OnCollision", {prim1, prim0, avgContactPoint1, -avgNormal});
+                prim0->EmitSignal(sOnCollisionSignal, prim0, prim1, avgContactPoint0, avgNormal);
+                prim1->EmitSignal(sOnCollisionSignal, prim1, prim0, avgContactPoint1, -avgNormal);
             }
 
             if (prim0->AreOverlapsEnabled() && prim1->AreOverlapsEnabled() &&
-                std::find(mCurrentOverlaps.begin(), mCurrentOverlaps.end(), PrimitivePair(prim0, prim1)) == mCurrentOverlaps.end())
+                mCurrentOverlapSet.insert(PrimitivePair(prim0, prim1)).second)
             {
+                mCurrentOverlapSet.insert(PrimitivePair(prim1, prim0));
                 mCurrentOverlaps.push_back({ prim0, prim1 });
                 mCurrentOverlaps.push_back({ prim1, prim0 });
             }
@@ -808,24 +1061,24 @@ void World::Update(float deltaTime)
         // Call Begin Overlaps
         for (auto& pair : mCurrentOverlaps)
         {
-            bool beginOverlap = std::find(mPreviousOverlaps.begin(), mPreviousOverlaps.end(), pair) == mPreviousOverlaps.end();
+            bool beginOverlap = mPreviousOverlapSet.find(pair) == mPreviousOverlapSet.end();
 
             if (beginOverlap)
             {
                 pair.mPrimitiveA->BeginOverlap(pair.mPrimitiveA, pair.mPrimitiveB);
-                pair.mPrimitiveA->EmitSignal("BeginOverlap", {pair.mPrimitiveA, pair.mPrimitiveB});
+                pair.mPrimitiveA->EmitSignal(sBeginOverlapSignal, pair.mPrimitiveA, pair.mPrimitiveB);
             }
         }
 
         // Call End Overlaps
         for (auto& pair : mPreviousOverlaps)
         {
-            bool endOverlap = std::find(mCurrentOverlaps.begin(), mCurrentOverlaps.end(), pair) == mCurrentOverlaps.end();
+            bool endOverlap = mCurrentOverlapSet.find(pair) == mCurrentOverlapSet.end();
 
             if (endOverlap)
             {
                 pair.mPrimitiveA->EndOverlap(pair.mPrimitiveA, pair.mPrimitiveB);
-                pair.mPrimitiveA->EmitSignal("EndOverlap", {pair.mPrimitiveA, pair.mPrimitiveB});
+                pair.mPrimitiveA->EmitSignal(sEndOverlapSignal, pair.mPrimitiveA, pair.mPrimitiveB);
             }
         }
     }
@@ -849,6 +1102,13 @@ void World::Update(float deltaTime)
             int32_t tickIteration = 0;
             uint32_t currentFrame = GetEngineState()->mFrameNumber;
 
+            // Script Tick() calls are queued during each pass and then run in one batch per script class.
+            bool batchScriptTicks = gameTickEnabled && ScriptTickScheduler::IsEnabled();
+            if (batchScriptTicks)
+            {
+                ScriptTickScheduler::BeginBatch();
+            }
+
             // Tick all of the nodes that need to be ticked, and then keep iterating
             // until all newly spawned nodes / added nodes have ticked (and maybe start)
             while (sNodesToTick.size() > 0 && tickIteration < kMaxTickIterations)
@@ -873,6 +1133,11 @@ void World::Update(float deltaTime)
                     }
                 }
 
+                if (batchScriptTicks)
+                {
+                    ScriptTickScheduler::Flush(this);
+                }
+
                 tickIteration++;
                 sNodesToTick.clear();
 
@@ -900,6 +1165,11 @@ void World::Update(float deltaTime)
                     LogWarning("Reached tick iteration limit");
                 }
             }
+
+            if (batchScriptTicks)
+            {
+                ScriptTickScheduler::EndBatch();
+            }
         }
     }
 
@@ -928,6 +1198,8 @@ void World::Update(float deltaTime)
 
             mRootNode->Traverse(update3dTransform);
         }
+
+        UpdatePrimitiveTree();
     }
 }
 
@@ -1106,8 +1378,25 @@ Particle3D* World::SpawnParticle(ParticleSystem* sys, glm::vec3 position)
 
     if (sys != nullptr)
     {
-        ret = SpawnNode<Particle3D>();
-        ret->SetParticleSystem(sys);
+        auto poolIt = mParticlePool.find(sys);
+
+        if (poolIt != mParticlePool.end() && poolIt->second.size() > 0)
+        {
+            NodePtr node = poolIt->second.back();
+            poolIt->second.pop_back();
+
+            PlaceNewlySpawnedNode(node, {});
+            ret = static_cast<Particle3D*>(node.Get());
+            mParticlePoolHits++;
+        }
+        else
+        {
+            ret = SpawnNode<Particle3D>();
+            ret->SetParticleSystem(sys);
+            mParticlePoolMisses++;
+        }
+
+        ret->SetPooled(GetEngineConfig()->mParticlePoolSize > 0);
         ret->SetPosition(position);
         ret->EnableEmission(true);
         ret->EnableAutoDestroy(true);
@@ -1116,6 +1405,113 @@ Particle3D* World::SpawnParticle(ParticleSystem* sys, glm::vec3 position)
     return ret;
 }
 
+void World::RecycleParticle(Particle3D* particle)
+{
+    ParticleSystem* sys = particle->GetParticleSystem();
+    uint32_t poolSize = (uint32_t)glm::max(GetEngineConfig()->mParticlePoolSize, 0);
+
+    // Nodes that picked up children, a script or replication are not plain effects anymore.
+    // Neither are nodes with their own ParticleSystemInstance, which no later spawn could reuse.
+    bool canPool = sys != nullptr &&
+        sys->As<ParticleSystemInstance>() == nullptr &&
+        !particle->IsDestroyed() &&
+        particle->GetNumChildren() == 0 &&
+        particle->GetScript() == nullptr &&
+        !particle->IsReplicated();
+
+    std::vector<NodePtr>* pool = canPool ? &mParticlePool[sys] : nullptr;
+
+    if (pool == nullptr || pool->size() >= poolSize)
+    {
+        particle->Destroy();
+        return;
+    }
+
+    NodePtr node = ResolvePtr(particle);
+
+    if (particle->HasStarted())
+    {
+        particle->Stop();
+    }
+
+    if (mParticleTemplate == nullptr)
+    {
+        mParticleTemplate = Node::Construct(Particle3D::GetStaticType());
+    }
+
+    particle->Detach();
+    particle->ResetForReuse(static_cast<Particle3D*>(mParticleTemplate.Get()));
+    pool->push_back(node);
+}
+
+void World::PrewarmParticlePool(ParticleSystem* sys, uint32_t count)
+{
+    if (sys == nullptr)
+        return;
+
+    uint32_t poolSize = (uint32_t)glm::max(GetEngineConfig()->mParticlePoolSize, 0);
+    count = glm::min(count, poolSize);
+
+    std::vector<NodePtr>& pool = mParticlePool[sys];
+
+    while (pool.size() < count)
+    {
+        NodePtr node = Node::Construct(Particle3D::GetStaticType());
+        Particle3D* particle = static_cast<Particle3D*>(node.Get());
+        particle->SetParticleSystem(sys);
+        pool.push_back(node);
+    }
+}
+
+void World::PrewarmParticlePools()
+{
+    // Prewarm every loaded particle system that asks for it, which covers the ones the new scene references.
+    for (auto& pair : AssetManager::Get()->GetAssetMap())
+    {
+        AssetStub* stub = pair.second;
+
+        if (stub->mAsset != nullptr &&
+            stub->mType == ParticleSystem::GetStaticType())
+        {
+            ParticleSystem* sys = static_cast<ParticleSystem*>(stub->mAsset);
+
+            if (sys->GetPoolPrewarmCount() > 0)
+            {
+                PrewarmParticlePool(sys, sys->GetPoolPrewarmCount());
+            }
+        }
+    }
+}
+
+void World::ClearParticlePool()
+{
+    for (auto& pair : mParticlePool)
+    {
+        for (uint32_t i = 0; i < pair.second.size(); ++i)
+        {
+            pair.second[i]->Destroy();
+        }
+    }
+
+    mParticlePool.clear();
+
+    if (mParticleTemplate != nullptr)
+    {
+        mParticleTemplate->Destroy();
+        mParticleTemplate = nullptr;
+    }
+}
+
+uint32_t World::GetParticlePoolHits() const
+{
+    return mParticlePoolHits;
+}
+
+uint32_t World::GetParticlePoolMisses() const
+{
+    return mParticlePoolMisses;
+}
+
 void World::LoadScene(const char* name, bool instant)
 {
     if (instant)
@@ -1128,6 +1524,9 @@ void World::LoadScene(const char* name, bool instant)
 
             NodePtr newRoot = scene->Instantiate();
             SetRootNode(newRoot.Get());
+
+            // The scene's materials are loaded now, so build their pipelines before the first frame needs them.
+            Renderer::Get()->PrewarmPipelines();
         }
         else
         {
@@ -1150,6 +1549,8 @@ void World::QueueRootScene(const char* name)
     {
         NodePtr sceneNode = scene->Instantiate();
         QueueRootNode(sceneNode.Get());
+
+        Renderer::Get()->PrewarmPipelines();
     }
     else
     {
@@ -19,6 +19,8 @@
 class Node;
 class Audio3D;
 class Particle3D;
+class ParticleSystem;
+class CameraFrustum;
 
 class World
 {
@@ -44,6 +46,15 @@ public:
     Node* SpawnScene(Scene* scene, glm::vec3 position = {});
     Particle3D* SpawnParticle(ParticleSystem* sys, glm::vec3 position);
 
+    // SpawnParticle() reuses finished particle nodes per ParticleSystem, up to EngineConfig::mParticlePoolSize
+    // (off by default). A node handed out by SpawnParticle() may be handed out again once its effect has finished,
+    // so pooling should only be enabled when nothing holds on to spawned particles.
+    void RecycleParticle(Particle3D* particle);
+    void PrewarmParticlePool(ParticleSystem* sys, uint32_t count);
+    void ClearParticlePool();
+    uint32_t GetParticlePoolHits() const;
+    uint32_t GetParticlePoolMisses() const;
+
     template<class NodeClass>
     NodeClass* SpawnNode(glm::vec3 position = {})
     {
@@ -86,9 +97,21 @@ public:
     glm::vec3 GetGravity() const;
 
     btDynamicsWorld* GetDynamicsWorld();
+    uint32_t GetPhysicsStep() const;
+    float GetPhysicsInterpolation() const;
     btDbvtBroadphase* GetBroadphase();
     void PurgeOverlaps(Primitive3D* prim);
 
+    // Spatial index of Primitive3D bounds used by the renderer to skip off-screen nodes.
+    void AddDirtyBoundsNode(Node3D* node);
+    void UpdatePrimitiveTree();
+    void QueryPrimitiveTree(const CameraFrustum& frustum, std::vector<Primitive3D*>& outPrims);
+    uint32_t GetNumTreePrimitives() const;
+
+    // Widgets that have no widget ancestor, in scene graph order. Lets the renderer gather
+    // widgets without walking the whole scene when primitives come from the bounds tree.
+    const std::vector<Widget*>& GetWidgetRoots();
+
     void RayTest(
         glm::vec3 start,
         glm::vec3 end,
@@ -191,7 +214,9 @@ public:
 private:
 
     void UpdateLines(float deltaTime);
+    void StepPhysics(float deltaTime);
     void ExtractPersistingNodes();
+    void PrewarmParticlePools();
 
 private:
 
@@ -220,5 +245,24 @@ private:
     btDiscreteDynamicsWorld* mDefaultDynamicsWorld = nullptr;;
     std::vector<PrimitivePair> mCurrentOverlaps;
     std::vector<PrimitivePair> mPreviousOverlaps;
+    std::unordered_set<PrimitivePair, PrimitivePair> mCurrentOverlapSet;
+    std::unordered_set<PrimitivePair, PrimitivePair> mPreviousOverlapSet;
+    float mPhysicsAccumulator = 0.0f;
+    float mPhysicsInterpolation = 1.0f;
+    uint32_t mPhysicsStep = 0;
+
+    // Particle pool
+    std::unordered_map<ParticleSystem*, std::vector<NodePtr>> mParticlePool;
+    NodePtr mParticleTemplate; // Default Particle3D that recycled nodes copy their properties from
+    uint32_t mParticlePoolHits = 0;
+    uint32_t mParticlePoolMisses = 0;
+
+    // Culling
+    btDbvt mPrimitiveTree;
+    std::unordered_set<Node3D*> mDirtyBoundsNodes;
+    std::vector<Primitive3D*> mUntreedPrimitives;
+    uint32_t mNumTreePrimitives = 0;
+    std::vector<Widget*> mWidgetRoots;
+    bool mWidgetRootsDirty = true;
 
 };
\ No newline at end of file
@@ -460,6 +460,16 @@ void GFX_SetFrameRate(int32_t frameRate)
     C3D_FrameRate(float(frameRate));
 }
 
+uint32_t GFX_PrewarmPipelines()
+{
+    return 0;
+}
+
+void GFX_LogPipelineHitchReport()
+{
+
+}
+
 void GFX_PathTrace()
 {
 
@@ -790,6 +800,14 @@ void GFX_DrawStaticMeshComp(StaticMesh3D* staticMeshComp, StaticMesh* meshOverri
     }
 }
 
+void GFX_DrawStaticMeshCompInstances(StaticMesh3D* const* staticMeshComps, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        GFX_DrawStaticMeshComp(staticMeshComps[i]);
+    }
+}
+
 // SkeletalMeshComp
 void GFX_CreateSkeletalMeshCompResource(SkeletalMesh3D* skeletalMeshComp)
 {
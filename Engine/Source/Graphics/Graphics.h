@@ -57,6 +57,9 @@ uint32_t GFX_GetNumViews();
 
 void GFX_SetFrameRate(int32_t frameRate);
 
+uint32_t GFX_PrewarmPipelines();
+void GFX_LogPipelineHitchReport();
+
 void GFX_PathTrace();
 
 void GFX_BeginLightBake();
@@ -91,6 +94,7 @@ void GFX_CreateStaticMeshCompResource(StaticMesh3D* staticMeshComp);
 void GFX_DestroyStaticMeshCompResource(StaticMesh3D* staticMeshComp);
 void GFX_UpdateStaticMeshCompResourceColors(StaticMesh3D* staticMeshComp);
 void GFX_DrawStaticMeshComp(StaticMesh3D* staticMeshComp, StaticMesh* meshOverride = nullptr);
+void GFX_DrawStaticMeshCompInstances(StaticMesh3D* const* staticMeshComps, uint32_t count);
 
 // SkeletalMeshComp
 void GFX_CreateSkeletalMeshCompResource(SkeletalMesh3D* skeletalMeshComp);
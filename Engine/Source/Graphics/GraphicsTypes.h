@@ -140,6 +140,10 @@ struct MaterialResource
 #if API_VULKAN
     Shader* mVertexShaders[(uint32_t)VertexType::Max] = {};
     Shader* mFragmentShader = nullptr;
+
+    // Built by the first draw using the material each frame and reused by the rest.
+    DescriptorSet mDescriptorSet;
+    uint32_t mDescriptorSetFrame = UINT_MAX;
 #endif
 };
 
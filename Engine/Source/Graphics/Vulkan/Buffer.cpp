@@ -11,7 +11,8 @@ Buffer::Buffer(
     size_t size,
     const char* debugObjectName,
     const void* srcData,
-    bool hostVisible)
+    bool hostVisible,
+    bool transient)
 {
     mType = type;
     mSize = size;
@@ -30,7 +31,7 @@ Buffer::Buffer(
     }
 
     VkMemoryPropertyFlags memoryFlags = mHostVisible ? (VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) : VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
-    CreateBuffer(mSize, usageFlags, memoryFlags, mBuffer, mMemory);
+    CreateBuffer(mSize, usageFlags, memoryFlags, mBuffer, mMemory, transient ? VramAllocType::Transient : VramAllocType::Buffer);
 
     // If srcData was supplied, perform an update
     if (srcData != nullptr)
@@ -86,9 +87,7 @@ void Buffer::Update(const void* srcData, size_t srcSize, size_t dstOffset)
     }
     else
     {
-        Buffer* stagingBuffer = new Buffer(BufferType::Transfer, srcSize, "Staging Buffer", srcData);
-        CopyBuffer(stagingBuffer->Get(), mBuffer, srcSize);
-        GetDestroyQueue()->Destroy(stagingBuffer);
+        GetUploadQueue()->CopyToBuffer(srcData, srcSize, mBuffer, dstOffset);
     }
 }
 
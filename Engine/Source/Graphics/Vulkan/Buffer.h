@@ -28,7 +28,8 @@ public:
         size_t size,
         const char* debugObjectName,
         const void* srcData = nullptr,
-        bool hostVisible = true);
+        bool hostVisible = true,
+        bool transient = false);
 
     void Update(const void* srcData, size_t srcSize, size_t dstOffset = 0);
 
@@ -0,0 +1,186 @@
+#if API_VULKAN
+
+#include "Graphics/Vulkan/CommandRecorder.h"
+
+#include <string.h>
+
+void CommandRecorder::Reset()
+{
+    mCommandBuffer = VK_NULL_HANDLE;
+
+    for (uint32_t p = 0; p < kNumBindPoints; ++p)
+    {
+        mPipelines[p] = VK_NULL_HANDLE;
+
+        for (uint32_t i = 0; i < MAX_BOUND_DESCRIPTOR_SETS; ++i)
+        {
+            mDescriptorSets[p][i] = BoundDescriptorSet();
+        }
+    }
+
+    for (uint32_t i = 0; i < MAX_TRACKED_VERTEX_BUFFERS; ++i)
+    {
+        mVertexBuffers[i] = BoundVertexBuffer();
+    }
+
+    mIndexBuffer = VK_NULL_HANDLE;
+    mIndexOffset = 0;
+    mIndexType = VK_INDEX_TYPE_UINT32;
+}
+
+void CommandRecorder::BindPipeline(VkCommandBuffer cb, VkPipelineBindPoint bindPoint, VkPipeline pipeline)
+{
+    TrackCommandBuffer(cb);
+
+    uint32_t p = (bindPoint == VK_PIPELINE_BIND_POINT_COMPUTE) ? 1 : 0;
+
+    if (mPipelines[p] == pipeline)
+    {
+        mNumBindsSkipped++;
+        return;
+    }
+
+    // Bound descriptor sets are not disturbed by a pipeline change. They are only reused
+    // if the new pipeline's layout matches the one they were bound with (see BindDescriptorSet).
+    vkCmdBindPipeline(cb, bindPoint, pipeline);
+    mPipelines[p] = pipeline;
+    mNumBindsIssued++;
+}
+
+void CommandRecorder::BindDescriptorSet(
+    VkCommandBuffer cb,
+    VkPipelineBindPoint bindPoint,
+    VkPipelineLayout layout,
+    uint32_t index,
+    VkDescriptorSet descriptorSet,
+    uint32_t numDynamicOffsets,
+    const uint32_t* dynamicOffsets)
+{
+    TrackCommandBuffer(cb);
+
+    uint32_t p = (bindPoint == VK_PIPELINE_BIND_POINT_COMPUTE) ? 1 : 0;
+    bool tracked = (index < MAX_BOUND_DESCRIPTOR_SETS && numDynamicOffsets <= MAX_TRACKED_DYNAMIC_OFFSETS);
+
+    if (tracked)
+    {
+        const BoundDescriptorSet& bound = mDescriptorSets[p][index];
+
+        if (bound.mDescriptorSet == descriptorSet &&
+            bound.mLayout == layout &&
+            bound.mNumDynamicOffsets == numDynamicOffsets &&
+            (numDynamicOffsets == 0 || memcmp(bound.mDynamicOffsets, dynamicOffsets, numDynamicOffsets * sizeof(uint32_t)) == 0))
+        {
+            mNumBindsSkipped++;
+            return;
+        }
+    }
+
+    vkCmdBindDescriptorSets(
+        cb,
+        bindPoint,
+        layout,
+        index,
+        1,
+        &descriptorSet,
+        numDynamicOffsets,
+        dynamicOffsets);
+
+    mNumBindsIssued++;
+
+    // Binding with a different layout may disturb the other sets, so stop tracking them.
+    for (uint32_t i = 0; i < MAX_BOUND_DESCRIPTOR_SETS; ++i)
+    {
+        if (i != index && mDescriptorSets[p][i].mLayout != layout)
+        {
+            mDescriptorSets[p][i] = BoundDescriptorSet();
+        }
+    }
+
+    if (tracked)
+    {
+        BoundDescriptorSet& bound = mDescriptorSets[p][index];
+        bound.mDescriptorSet = descriptorSet;
+        bound.mLayout = layout;
+        bound.mNumDynamicOffsets = numDynamicOffsets;
+
+        if (numDynamicOffsets > 0)
+        {
+            memcpy(bound.mDynamicOffsets, dynamicOffsets, numDynamicOffsets * sizeof(uint32_t));
+        }
+    }
+    else if (index < MAX_BOUND_DESCRIPTOR_SETS)
+    {
+        mDescriptorSets[p][index] = BoundDescriptorSet();
+    }
+}
+
+void CommandRecorder::BindVertexBuffer(VkCommandBuffer cb, uint32_t binding, VkBuffer buffer, VkDeviceSize offset)
+{
+    TrackCommandBuffer(cb);
+
+    bool tracked = (binding < MAX_TRACKED_VERTEX_BUFFERS);
+
+    if (tracked &&
+        mVertexBuffers[binding].mBuffer == buffer &&
+        mVertexBuffers[binding].mOffset == offset)
+    {
+        mNumBindsSkipped++;
+        return;
+    }
+
+    vkCmdBindVertexBuffers(cb, binding, 1, &buffer, &offset);
+    mNumBindsIssued++;
+
+    if (tracked)
+    {
+        mVertexBuffers[binding].mBuffer = buffer;
+        mVertexBuffers[binding].mOffset = offset;
+    }
+}
+
+void CommandRecorder::BindIndexBuffer(VkCommandBuffer cb, VkBuffer buffer, VkDeviceSize offset, VkIndexType indexType)
+{
+    TrackCommandBuffer(cb);
+
+    if (mIndexBuffer == buffer &&
+        mIndexOffset == offset &&
+        mIndexType == indexType)
+    {
+        mNumBindsSkipped++;
+        return;
+    }
+
+    vkCmdBindIndexBuffer(cb, buffer, offset, indexType);
+    mNumBindsIssued++;
+
+    mIndexBuffer = buffer;
+    mIndexOffset = offset;
+    mIndexType = indexType;
+}
+
+void CommandRecorder::TrackCommandBuffer(VkCommandBuffer cb)
+{
+    if (cb != mCommandBuffer)
+    {
+        Reset();
+        mCommandBuffer = cb;
+    }
+}
+
+uint32_t CommandRecorder::GetNumBindsIssued() const
+{
+    return mNumBindsIssued;
+}
+
+uint32_t CommandRecorder::GetNumBindsSkipped() const
+{
+    return mNumBindsSkipped;
+}
+
+void CommandRecorder::ResetStats()
+{
+    mNumBindsIssued = 0;
+    mNumBindsSkipped = 0;
+}
+
+#endif
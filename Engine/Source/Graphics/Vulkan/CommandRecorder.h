@@ -0,0 +1,68 @@
+#pragma once
+
+#if API_VULKAN
+
+#include "Graphics/Vulkan/VulkanConstants.h"
+
+#include <stdint.h>
+#include <vulkan/vulkan.h>
+
+// Records binds into a command buffer and drops any that would not change the bound state.
+// Tracking restarts whenever a different command buffer is passed in. Any code that binds state
+// outside of the recorder (e.g. ImGui) or restarts a command buffer must call Reset() afterwards.
+class CommandRecorder
+{
+public:
+
+    void Reset();
+
+    void BindPipeline(VkCommandBuffer cb, VkPipelineBindPoint bindPoint, VkPipeline pipeline);
+    void BindDescriptorSet(
+        VkCommandBuffer cb,
+        VkPipelineBindPoint bindPoint,
+        VkPipelineLayout layout,
+        uint32_t index,
+        VkDescriptorSet descriptorSet,
+        uint32_t numDynamicOffsets,
+        const uint32_t* dynamicOffsets);
+    void BindVertexBuffer(VkCommandBuffer cb, uint32_t binding, VkBuffer buffer, VkDeviceSize offset = 0);
+    void BindIndexBuffer(VkCommandBuffer cb, VkBuffer buffer, VkDeviceSize offset, VkIndexType indexType);
+
+    uint32_t GetNumBindsIssued() const;
+    uint32_t GetNumBindsSkipped() const;
+    void ResetStats();
+
+protected:
+
+    void TrackCommandBuffer(VkCommandBuffer cb);
+
+    struct BoundDescriptorSet
+    {
+        VkDescriptorSet mDescriptorSet = VK_NULL_HANDLE;
+        VkPipelineLayout mLayout = VK_NULL_HANDLE;
+        uint32_t mNumDynamicOffsets = 0;
+        uint32_t mDynamicOffsets[MAX_TRACKED_DYNAMIC_OFFSETS] = {};
+    };
+
+    struct BoundVertexBuffer
+    {
+        VkBuffer mBuffer = VK_NULL_HANDLE;
+        VkDeviceSize mOffset = 0;
+    };
+
+    // Graphics and compute have separate pipeline and descriptor set bind points.
+    static const uint32_t kNumBindPoints = 2;
+
+    VkCommandBuffer mCommandBuffer = VK_NULL_HANDLE;
+    VkPipeline mPipelines[kNumBindPoints] = {};
+    BoundDescriptorSet mDescriptorSets[kNumBindPoints][MAX_BOUND_DESCRIPTOR_SETS];
+    BoundVertexBuffer mVertexBuffers[MAX_TRACKED_VERTEX_BUFFERS];
+    VkBuffer mIndexBuffer = VK_NULL_HANDLE;
+    VkDeviceSize mIndexOffset = 0;
+    VkIndexType mIndexType = VK_INDEX_TYPE_UINT32;
+
+    uint32_t mNumBindsIssued = 0;
+    uint32_t mNumBindsSkipped = 0;
+};
+
+#endif
@@ -78,6 +78,19 @@ DescriptorSet& DescriptorSet::WriteStorageBuffer(int32_t binding, Buffer* storag
     return *this;
 }
 
+DescriptorSet& DescriptorSet::WriteStorageBuffer(int32_t binding, const StorageBlock& block)
+{
+    DescriptorBinding bindInfo;
+    bindInfo.mType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindInfo.mObject = block.mBuffer;
+    bindInfo.mOffset = block.mOffset;
+    bindInfo.mSize = block.mSize;
+    bindInfo.mBinding = binding;
+    mBindings.push_back(bindInfo);
+
+    return *this;
+}
+
 DescriptorSet& DescriptorSet::WriteStorageImage(int32_t binding, Image* storageImage)
 {
     DescriptorBinding bindInfo;
@@ -153,13 +166,12 @@ void DescriptorSet::Bind(VkCommandBuffer cb, uint32_t index)
         }
     }
 
-    vkCmdBindDescriptorSets(
+    GetCommandRecorder()->BindDescriptorSet(
         cb,
         bindPoint,
         pipelineLayout,
         index,
-        1,
-        &mDescriptorSet,
+        mDescriptorSet,
         (uint32_t)dynOffsets.size(),
         dynOffsets.data());
 
@@ -180,125 +192,129 @@ void DescriptorSet::UpdateDescriptors()
 {
     VkDevice device = GetVulkanDevice();
 
-    // TODO: Merge all of the updates for this set into a single vkUpdateDescriptorSets() call.
-    // Might want to store VkDescriptorImageInfo and VkDescriptorBufferInfo on Image and Buffer resources.
-    // And we could possibly just use a static std::vector<> for the VkWriteDescriptorSet structs.
+    // All bindings are written with a single vkUpdateDescriptorSets() call.
+    // Info arrays are sized up front so that the pointers stored in the writes stay valid.
+    static std::vector<VkWriteDescriptorSet> sWrites;
+    static std::vector<VkDescriptorImageInfo> sImageInfos;
+    static std::vector<VkDescriptorBufferInfo> sBufferInfos;
+
+    uint32_t numImageInfos = 0;
+    uint32_t numBufferInfos = 0;
+
+    for (uint32_t i = 0; i < mBindings.size(); ++i)
+    {
+        const DescriptorBinding& binding = mBindings[i];
+
+        if (binding.mType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC ||
+            binding.mType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+        {
+            numBufferInfos++;
+        }
+        else
+        {
+            numImageInfos += (binding.mImageArray.size() > 0) ? (uint32_t)binding.mImageArray.size() : 1;
+        }
+    }
+
+    sWrites.clear();
+    sImageInfos.resize(numImageInfos);
+    sBufferInfos.resize(numBufferInfos);
+
+    uint32_t imageIdx = 0;
+    uint32_t bufferIdx = 0;
+
     for (uint32_t i = 0; i < mBindings.size(); ++i)
     {
         DescriptorBinding& binding = mBindings[i];
-        if (binding.mObject != nullptr || binding.mImageArray.size() > 0)
+        if (binding.mObject == nullptr && binding.mImageArray.size() == 0)
         {
-            if (binding.mType == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER)
-            {
-                if (binding.mImageArray.size() == 0)
-                {
-                    Image* image = reinterpret_cast<Image*>(binding.mObject);
+            continue;
+        }
 
-                    VkDescriptorImageInfo imageInfo = {};
-                    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-                    imageInfo.imageView = image->GetView();
-                    imageInfo.sampler = image->GetSampler();
-
-                    VkWriteDescriptorSet descriptorWrite = {};
-                    descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                    descriptorWrite.dstSet = mDescriptorSet;
-                    descriptorWrite.dstBinding = i;
-                    descriptorWrite.dstArrayElement = 0;
-                    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-                    descriptorWrite.descriptorCount = 1;
-                    descriptorWrite.pImageInfo = &imageInfo;
-
-                    vkUpdateDescriptorSets(device, 1, &descriptorWrite, 0, nullptr);
-                }
-                else
-                {
-                    static std::vector<VkDescriptorImageInfo> sDescImageInfo;
-                    sDescImageInfo.resize(binding.mImageArray.size());
-
-                    if (binding.mImageArray.size() > 0)
-                    {
-                        for (uint32_t i = 0; i < binding.mImageArray.size(); ++i)
-                        {
-                            VkDescriptorImageInfo& imageInfo = sDescImageInfo[i];
-                            imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-                            imageInfo.imageView = binding.mImageArray[i]->GetView();
-                            imageInfo.sampler = binding.mImageArray[i]->GetSampler();
-                        }
-
-                        VkWriteDescriptorSet descriptorWrite = {};
-                        descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                        descriptorWrite.dstSet = mDescriptorSet;
-                        descriptorWrite.dstBinding = i;
-                        descriptorWrite.dstArrayElement = 0;
-                        descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-                        descriptorWrite.descriptorCount = (uint32_t)binding.mImageArray.size();
-                        descriptorWrite.pImageInfo = sDescImageInfo.data();
-
-                        vkUpdateDescriptorSets(device, 1, &descriptorWrite, 0, nullptr);
-                    }
-                }
-            }
-            else if (binding.mType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC)
-            {
-                UniformBuffer* uniformBuffer = reinterpret_cast<UniformBuffer*>(binding.mObject);
-
-                VkDescriptorBufferInfo bufferInfo = {};
-                bufferInfo.buffer = uniformBuffer->Get();
-                bufferInfo.range = binding.mSize;
-                bufferInfo.offset = 0;
-
-                VkWriteDescriptorSet descriptorWrite = {};
-                descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                descriptorWrite.dstSet = mDescriptorSet;
-                descriptorWrite.dstBinding = i;
-                descriptorWrite.dstArrayElement = 0;
-                descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
-                descriptorWrite.descriptorCount = 1;
-                descriptorWrite.pBufferInfo = &bufferInfo;
-
-                vkUpdateDescriptorSets(device, 1, &descriptorWrite, 0, nullptr);
-            }
-            else if (binding.mType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
-            {
-                Buffer* buffer = reinterpret_cast<Buffer*>(binding.mObject);
-
-                VkDescriptorBufferInfo bufferInfo = {};
-                bufferInfo.buffer = buffer->Get();
-                bufferInfo.range = buffer->GetSize();
-                bufferInfo.offset = 0;
-
-                VkWriteDescriptorSet descriptorWrite = {};
-                descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                descriptorWrite.dstSet = mDescriptorSet;
-                descriptorWrite.dstBinding = i;
-                descriptorWrite.dstArrayElement = 0;
-                descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-                descriptorWrite.descriptorCount = 1;
-                descriptorWrite.pBufferInfo = &bufferInfo;
-
-                vkUpdateDescriptorSets(device, 1, &descriptorWrite, 0, nullptr);
-            }
-            else if (binding.mType == VK_DESCRIPTOR_TYPE_STORAGE_IMAGE)
+        VkWriteDescriptorSet descriptorWrite = {};
+        descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrite.dstSet = mDescriptorSet;
+        descriptorWrite.dstBinding = i;
+        descriptorWrite.dstArrayElement = 0;
+        descriptorWrite.descriptorType = binding.mType;
+        descriptorWrite.descriptorCount = 1;
+
+        if (binding.mType == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER)
+        {
+            if (binding.mImageArray.size() == 0)
             {
                 Image* image = reinterpret_cast<Image*>(binding.mObject);
 
-                VkDescriptorImageInfo imageInfo = {};
-                imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+                VkDescriptorImageInfo& imageInfo = sImageInfos[imageIdx];
+                imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
                 imageInfo.imageView = image->GetView();
                 imageInfo.sampler = image->GetSampler();
 
-                VkWriteDescriptorSet descriptorWrite = {};
-                descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                descriptorWrite.dstSet = mDescriptorSet;
-                descriptorWrite.dstBinding = i;
-                descriptorWrite.dstArrayElement = 0;
-                descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
-                descriptorWrite.descriptorCount = 1;
                 descriptorWrite.pImageInfo = &imageInfo;
+                imageIdx++;
+            }
+            else
+            {
+                descriptorWrite.descriptorCount = (uint32_t)binding.mImageArray.size();
+                descriptorWrite.pImageInfo = &sImageInfos[imageIdx];
 
-                vkUpdateDescriptorSets(device, 1, &descriptorWrite, 0, nullptr);
+                for (uint32_t a = 0; a < binding.mImageArray.size(); ++a)
+                {
+                    VkDescriptorImageInfo& imageInfo = sImageInfos[imageIdx];
+                    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                    imageInfo.imageView = binding.mImageArray[a]->GetView();
+                    imageInfo.sampler = binding.mImageArray[a]->GetSampler();
+                    imageIdx++;
+                }
             }
         }
+        else if (binding.mType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC)
+        {
+            UniformBuffer* uniformBuffer = reinterpret_cast<UniformBuffer*>(binding.mObject);
+
+            VkDescriptorBufferInfo& bufferInfo = sBufferInfos[bufferIdx];
+            bufferInfo.buffer = uniformBuffer->Get();
+            bufferInfo.range = binding.mSize;
+            bufferInfo.offset = 0;
+
+            descriptorWrite.pBufferInfo = &bufferInfo;
+            bufferIdx++;
+        }
+        else if (binding.mType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+        {
+            Buffer* buffer = reinterpret_cast<Buffer*>(binding.mObject);
+
+            VkDescriptorBufferInfo& bufferInfo = sBufferInfos[bufferIdx];
+            bufferInfo.buffer = buffer->Get();
+            bufferInfo.range = (binding.mSize > 0) ? binding.mSize : buffer->GetSize();
+            bufferInfo.offset = binding.mOffset;
+
+            descriptorWrite.pBufferInfo = &bufferInfo;
+            bufferIdx++;
+        }
+        else if (binding.mType == VK_DESCRIPTOR_TYPE_STORAGE_IMAGE)
+        {
+            Image* image = reinterpret_cast<Image*>(binding.mObject);
+
+            VkDescriptorImageInfo& imageInfo = sImageInfos[imageIdx];
+            imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+            imageInfo.imageView = image->GetView();
+            imageInfo.sampler = image->GetSampler();
+
+            descriptorWrite.pImageInfo = &imageInfo;
+            imageIdx++;
+        }
+        else
+        {
+            continue;
+        }
+
+        sWrites.push_back(descriptorWrite);
+    }
+
+    if (sWrites.size() > 0)
+    {
+        vkUpdateDescriptorSets(device, (uint32_t)sWrites.size(), sWrites.data(), 0, nullptr);
     }
 }
 
@@ -13,13 +13,14 @@
 class Buffer;
 class UniformBuffer;
 struct UniformBlock;
+struct StorageBlock;
 
 struct DescriptorBinding
 {
     VkDescriptorType mType = VK_DESCRIPTOR_TYPE_MAX_ENUM;
     void* mObject = nullptr;
     uint32_t mOffset = 0;
-    uint32_t mSize = 0; // Only filled for Uniform Blocks
+    uint32_t mSize = 0; // Only filled for Uniform Blocks and Storage Blocks
     uint32_t mCount = 1;
     std::vector<Image*> mImageArray;
 
@@ -38,6 +39,7 @@ public:
     DescriptorSet& WriteUniformBuffer(int32_t binding, UniformBuffer* uniformBuffer);
     DescriptorSet& WriteUniformBuffer(int32_t binding, const UniformBlock& block);
     DescriptorSet& WriteStorageBuffer(int32_t binding, Buffer* storageBuffer);
+    DescriptorSet& WriteStorageBuffer(int32_t binding, const StorageBlock& block);
     DescriptorSet& WriteStorageImage(int32_t binding, Image* storageImage);
 
     DescriptorSet& Build();
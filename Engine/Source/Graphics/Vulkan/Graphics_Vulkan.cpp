@@ -185,6 +185,18 @@ void GFX_SetFrameRate(int32_t frameRate)
 
 }
 
+uint32_t GFX_PrewarmPipelines()
+{
+    if (IsHeadless()) return 0;
+    return gVulkanContext->GetPipelineCache().Prewarm();
+}
+
+void GFX_LogPipelineHitchReport()
+{
+    if (IsHeadless()) return;
+    gVulkanContext->GetPipelineCache().LogHitchReport();
+}
+
 void GFX_PathTrace()
 {
     if (gVulkanContext->IsRayTracingSupported())
@@ -333,6 +345,11 @@ void GFX_DrawStaticMeshComp(StaticMesh3D* staticMeshComp, StaticMesh* meshOverri
     DrawStaticMeshComp(staticMeshComp, meshOverride);
 }
 
+void GFX_DrawStaticMeshCompInstances(StaticMesh3D* const* staticMeshComps, uint32_t count)
+{
+    DrawStaticMeshCompInstances(staticMeshComps, count);
+}
+
 void GFX_CreateSkeletalMeshCompResource(SkeletalMesh3D* skeletalMeshComp)
 {
     if (IsHeadless()) return;
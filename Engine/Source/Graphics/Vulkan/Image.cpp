@@ -80,7 +80,8 @@ Image::Image(ImageDesc imageDesc, SamplerDesc samplerDesc, const char* debugObje
     vkGetImageMemoryRequirements(device, mImage, &memRequirements);
     uint32_t memoryType = FindMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
-    VramAllocator::Alloc(memRequirements.size, memRequirements.alignment, memoryType, mMemory);
+    // Images get their own blocks so they never need bufferImageGranularity padding against buffers.
+    VramAllocator::Alloc(memRequirements.size, memRequirements.alignment, memoryType, mMemory, VramAllocType::Image);
     vkBindImageMemory(device, mImage, mMemory.mDeviceMemory, mMemory.mOffset);
 
     // ImageView
@@ -224,14 +225,14 @@ void Image::Update(const void* srcData)
     if (srcData != nullptr &&
         imageSize > 0)
     {
-        Buffer* stagingBuffer = new Buffer(BufferType::Transfer, imageSize, "Staging Buffer", srcData);
+        UploadQueue* uploadQueue = GetUploadQueue();
+        VkCommandBuffer cb = uploadQueue->GetCommandBuffer();
+        uint32_t texelSize = IsFormatBlockCompressed(mFormat) ? GetFormatBlockSize(mFormat) : GetFormatPixelSize(mFormat);
 
         VkImageLayout savedLayout = mLayout;
-        Transition(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-        CopyBufferToImage(stagingBuffer->Get(), mImage, mWidth, mHeight);
-        Transition(savedLayout != VK_IMAGE_LAYOUT_PREINITIALIZED ? savedLayout : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-
-        GetDestroyQueue()->Destroy(stagingBuffer);
+        Transition(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, cb);
+        uploadQueue->CopyToImage(srcData, imageSize, texelSize, mImage, mWidth, mHeight);
+        Transition(savedLayout != VK_IMAGE_LAYOUT_PREINITIALIZED ? savedLayout : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, cb);
     }
 }
 
@@ -255,7 +256,8 @@ void Image::Transition(VkImageLayout layout, VkCommandBuffer commandBuffer)
 
 void Image::GenerateMips()
 {
-    VkCommandBuffer blitCmd = BeginCommandBuffer();
+    // Recorded with the uploads so that the blits follow the copy from Update().
+    VkCommandBuffer blitCmd = GetUploadQueue()->GetCommandBuffer();
 
     VkImageMemoryBarrier barrier = {};
     barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -363,18 +365,16 @@ void Image::GenerateMips()
             0, nullptr,
             1, &barrier);
     }
-
-    EndCommandBuffer(blitCmd);
 }
 
 void Image::Clear(glm::vec4 color)
 {
     if (mImage != VK_NULL_HANDLE)
     {
-        VkImageLayout originalLayout = mLayout;
-        Transition(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+        VkCommandBuffer cb = GetUploadQueue()->GetCommandBuffer();
 
-        VkCommandBuffer cb = BeginCommandBuffer();
+        VkImageLayout originalLayout = mLayout;
+        Transition(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, cb);
 
         VkClearColorValue clearValue;
         memset(&clearValue, 0, sizeof(VkClearColorValue));
@@ -391,9 +391,8 @@ void Image::Clear(glm::vec4 color)
         subresourceRange.levelCount = mMipLevels;
 
         vkCmdClearColorImage(cb, mImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &clearValue, 1, &subresourceRange);
-        EndCommandBuffer(cb);
 
-        Transition(originalLayout != VK_IMAGE_LAYOUT_UNDEFINED ? originalLayout : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        Transition(originalLayout != VK_IMAGE_LAYOUT_UNDEFINED ? originalLayout : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, cb);
     }
 }
 
@@ -12,7 +12,7 @@ ThreadFuncRet MaterialPipelineCache::BuildThreadFunc(void* arg)
 {
     MaterialPipelineCache* cache = (MaterialPipelineCache*)arg;
 
-    std::vector<MaterialPipelineRequest>& requests = cache->mRequests;
+    std::deque<MaterialPipelineRequest>& requests = cache->mRequests;
     std::vector<MaterialPipelineResult>& results = cache->mResults;
     MutexObject* mutex = cache->mMutex;
 
@@ -29,8 +29,8 @@ ThreadFuncRet MaterialPipelineCache::BuildThreadFunc(void* arg)
         if (cacheEnabled && requests.size() > 0)
         {
             hasRequest = true;
-            id = requests[0].mId;
-            requests.erase(requests.begin());
+            id = requests.front().mId;
+            requests.pop_front();
         }
 
         SYS_UnlockMutex(mutex);
@@ -5,6 +5,7 @@
 #include "VulkanTypes.h"
 #include "Pipeline.h"
 
+#include <deque>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -49,7 +50,7 @@ protected:
 
     MutexObject* mMutex = nullptr;
     //CondObject* mWorkCondition = nullptr;
-    std::vector<MaterialPipelineRequest> mRequests;
+    std::deque<MaterialPipelineRequest> mRequests;
     std::vector<MaterialPipelineResult> mResults;
     VkRenderPass mRenderPass;
     bool mEnabled = false;
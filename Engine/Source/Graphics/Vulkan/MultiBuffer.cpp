@@ -118,4 +118,49 @@ UniformBlock UniformBuffer::AllocBlock(uint32_t blockSize)
     return retBlock;
 }
 
+StorageBuffer::StorageBuffer(size_t size, const char* debugName) :
+    MultiBuffer(BufferType::Storage, size, debugName, nullptr)
+{
+
+}
+
+void StorageBuffer::Reset(uint32_t frameIndex)
+{
+    if (frameIndex < MAX_FRAMES)
+    {
+        mHead[frameIndex] = 0;
+    }
+    else
+    {
+        LogError("Invalid frame index in StorageBuffer::Reset()");
+    }
+}
+
+StorageBlock StorageBuffer::AllocBlock(uint32_t blockSize)
+{
+    StorageBlock retBlock;
+
+    const uint32_t ssboAlignment = (uint32_t) GetVulkanContext()->GetDeviceProperties().limits.minStorageBufferOffsetAlignment;
+
+    uint32_t frameIndex = GetFrameIndex();
+    int32_t head = mHead[frameIndex];
+
+    if (head + blockSize <= GetSize())
+    {
+        retBlock.mOffset = head;
+        retBlock.mSize = blockSize;
+        retBlock.mData = ((uint8_t*)GetBuffer(frameIndex)->GetMappedPointer()) + retBlock.mOffset;
+        retBlock.mBuffer = GetBuffer(frameIndex);
+
+        uint32_t alignedBlockSize = blockSize;
+        alignedBlockSize += ssboAlignment - 1;
+        alignedBlockSize = alignedBlockSize & (~(ssboAlignment - 1));
+
+        mHead[frameIndex] = head + alignedBlockSize;
+    }
+
+    // Callers are expected to fall back when the buffer is exhausted, so don't log here.
+    return retBlock;
+}
+
 #endif
@@ -55,4 +55,27 @@ protected:
     int32_t mHead[MAX_FRAMES] = {};
 };
 
+struct StorageBlock
+{
+    Buffer* mBuffer = nullptr;
+    uint8_t* mData = nullptr;
+    uint32_t mOffset = 0;
+    uint32_t mSize = 0;
+};
+
+// Per-frame linear allocator for storage data that is written once and read by the GPU in the same frame.
+class StorageBuffer : public MultiBuffer
+{
+public:
+    StorageBuffer(size_t size, const char* debugName);
+
+    void Reset(uint32_t frameIndex);
+
+    StorageBlock AllocBlock(uint32_t blockSize);
+
+protected:
+
+    int32_t mHead[MAX_FRAMES] = {};
+};
+
 #endif
\ No newline at end of file
@@ -284,7 +284,7 @@ VkPipeline Pipeline::GetVkPipeline() const
 void Pipeline::Bind(VkCommandBuffer commandBuffer)
 {
     VkPipelineBindPoint bindPoint = mComputePipeline ? VK_PIPELINE_BIND_POINT_COMPUTE : VK_PIPELINE_BIND_POINT_GRAPHICS;
-    vkCmdBindPipeline(commandBuffer, bindPoint, mPipeline);
+    GetCommandRecorder()->BindPipeline(commandBuffer, bindPoint, mPipeline);
 }
 
 VkPipelineLayout Pipeline::GetPipelineLayout()
@@ -4,8 +4,17 @@
 #include "VulkanUtils.h"
 #include "VulkanContext.h"
 #include "VulkanConstants.h"
+#include "JobSystem.h"
+#include "AssetManager.h"
+#include "Assets/Material.h"
+#include "Profiler.h"
+#include "Log.h"
 
 #define PIPELINE_CACHE_SAVE_NAME "PipelineCache.sav"
+#define PIPELINE_MANIFEST_SAVE_NAME "PipelineManifest.sav"
+#define PIPELINE_MANIFEST_VERSION 1
+#define PIPELINE_MANIFEST_MAX_ENTRIES 2048
+#define PIPELINE_HITCH_REPORT_MAX 256
 
 void PipelineCache::Create()
 {
@@ -35,6 +44,8 @@ void PipelineCache::Create()
         LogError("Failed to create pipeline cache");
         OCT_ASSERT(0);
     }
+
+    LoadManifest();
 }
 
 void PipelineCache::Clear()
@@ -85,6 +96,8 @@ void PipelineCache::SaveToFile()
             cacheData = nullptr;
         }
     }
+
+    SaveManifest();
 }
 
 VkPipelineCache PipelineCache::GetPipelineCacheObj()
@@ -103,10 +116,319 @@ Pipeline* PipelineCache::Resolve(const PipelineState& state)
     }
     else
     {
+        uint64_t startTime = SYS_GetTimeMicroseconds();
+
         Pipeline* newPipeline = new Pipeline();
         newPipeline->Create(state, mPipelineCache);
 
         mPipelineMap[state] = newPipeline;
+        mNumCompiled++;
+
+        // Compiling here stalls the frame. Remember the pipeline so that it can be prewarmed next time.
+        RecordManifestEntry(state);
+
+        if (mHitches.size() < PIPELINE_HITCH_REPORT_MAX)
+        {
+            PipelineHitch hitch;
+            GetShaderKey(state.mVertexShader, hitch.mVertexShader);
+            GetShaderKey(state.mFragmentShader, hitch.mFragmentShader);
+            GetShaderKey(state.mComputeShader, hitch.mComputeShader);
+            hitch.mCompileTime = (SYS_GetTimeMicroseconds() - startTime) / 1000.0f;
+            hitch.mFrameNumber = GetFrameNumber();
+            mHitches.push_back(hitch);
+        }
+
         return newPipeline;
     }
 }
+
+uint32_t PipelineCache::Prewarm()
+{
+    SCOPED_STAT("PipelineCache::Prewarm");
+
+    RenderPassCache& renderPassCache = GetVulkanContext()->GetRenderPassCache();
+    std::vector<Pipeline*> pipelines;
+
+    for (uint32_t i = 0; i < mManifest.size(); ++i)
+    {
+        const PipelineManifestEntry& entry = mManifest[i];
+
+        PipelineState state = entry.mState;
+        state.mVertexShader = FindShader(entry.mVertexShader);
+        state.mFragmentShader = FindShader(entry.mFragmentShader);
+        state.mComputeShader = FindShader(entry.mComputeShader);
+
+        // Skip pipelines whose shaders aren't loaded right now.
+        if ((entry.mVertexShader != "" && state.mVertexShader == nullptr) ||
+            (entry.mFragmentShader != "" && state.mFragmentShader == nullptr) ||
+            (entry.mComputeShader != "" && state.mComputeShader == nullptr) ||
+            (state.mVertexShader == nullptr && state.mComputeShader == nullptr))
+        {
+            continue;
+        }
+
+        bool hasRenderPass = (entry.mRenderPass.mDepthFormat != VK_FORMAT_UNDEFINED);
+        for (uint32_t c = 0; c < MAX_RENDER_TARGETS; ++c)
+        {
+            hasRenderPass = hasRenderPass || (entry.mRenderPass.mColorFormats[c] != VK_FORMAT_UNDEFINED);
+        }
+
+        if (hasRenderPass)
+        {
+            state.mRenderPass = renderPassCache.ResolveRenderPass(entry.mRenderPass);
+        }
+        else if (state.mComputeShader == nullptr)
+        {
+            continue;
+        }
+
+        if (mPipelineMap.find(state) == mPipelineMap.end())
+        {
+            // Added to the map now so that duplicates are skipped. Nothing resolves pipelines until the builds finish.
+            Pipeline* pipeline = new Pipeline();
+            pipeline->mState = state;
+            mPipelineMap[state] = pipeline;
+            pipelines.push_back(pipeline);
+        }
+    }
+
+    // The VkPipelineCache is internally synchronized, so pipelines can be created on several threads at once.
+    JobSystem::Get()->ParallelFor((uint32_t)pipelines.size(), 1, [&](uint32_t start, uint32_t end)
+    {
+        for (uint32_t i = start; i < end; ++i)
+        {
+            pipelines[i]->Create(pipelines[i]->mState, mPipelineCache);
+        }
+    });
+
+    if (pipelines.size() > 0)
+    {
+        LogDebug("Prewarmed %d pipelines", (int32_t)pipelines.size());
+    }
+
+    return (uint32_t)pipelines.size();
+}
+
+void PipelineCache::LogHitchReport()
+{
+    LogDebug("---- Pipeline Hitch Report ----");
+    LogDebug("%d pipelines compiled on demand", (int32_t)mHitches.size());
+
+    for (uint32_t i = 0; i < mHitches.size(); ++i)
+    {
+        const PipelineHitch& hitch = mHitches[i];
+
+        if (hitch.mComputeShader != "")
+        {
+            LogDebug("[Frame %u] %.2f ms: %s", hitch.mFrameNumber, hitch.mCompileTime, hitch.mComputeShader.c_str());
+        }
+        else
+        {
+            LogDebug("[Frame %u] %.2f ms: %s + %s", hitch.mFrameNumber, hitch.mCompileTime, hitch.mVertexShader.c_str(), hitch.mFragmentShader.c_str());
+        }
+    }
+}
+
+uint32_t PipelineCache::GetNumCompiled() const
+{
+    return mNumCompiled;
+}
+
+void PipelineCache::ResetStats()
+{
+    mNumCompiled = 0;
+}
+
+bool PipelineCache::GetShaderKey(Shader* shader, std::string& outKey)
+{
+    outKey = (shader != nullptr) ? shader->mName : "";
+
+    // Only shaders that can be found again by name (global shaders and material asset shaders) can be prewarmed.
+    return (shader == nullptr) || (FindShader(outKey) == shader);
+}
+
+Shader* PipelineCache::FindShader(const std::string& key)
+{
+    if (key == "")
+    {
+        return nullptr;
+    }
+
+    // Global shaders are named by file, material shaders "<material>:vert<vertex type>" or "<material>:frag".
+    Shader* shader = GetVulkanContext()->FindGlobalShader(key);
+
+    size_t sep = key.rfind(':');
+
+    if (shader == nullptr &&
+        sep != std::string::npos &&
+        sep > 0)
+    {
+        Asset* asset = FetchAsset(key.substr(0, sep));
+        Material* material = asset ? asset->As<Material>() : nullptr;
+
+        if (material != nullptr &&
+            !material->IsLite())
+        {
+            MaterialResource* resource = material->GetResource();
+            std::string slot = key.substr(sep + 1);
+
+            if (slot == "frag")
+            {
+                shader = resource->mFragmentShader;
+            }
+            else if (slot.compare(0, 4, "vert") == 0)
+            {
+                uint32_t index = (uint32_t)atoi(slot.c_str() + 4);
+
+                if (index < (uint32_t)VertexType::Max)
+                {
+                    shader = resource->mVertexShaders[index];
+                }
+            }
+        }
+    }
+
+    return shader;
+}
+
+void PipelineCache::WriteManifestEntry(Stream& stream, const PipelineManifestEntry& entry)
+{
+    stream.WriteString(entry.mVertexShader);
+    stream.WriteString(entry.mFragmentShader);
+    stream.WriteString(entry.mComputeShader);
+
+    const RenderPassConfig& rp = entry.mRenderPass;
+    for (uint32_t i = 0; i < MAX_RENDER_TARGETS; ++i)
+    {
+        stream.WriteUint32((uint32_t)rp.mColorFormats[i]);
+    }
+    stream.WriteUint32((uint32_t)rp.mDepthFormat);
+    stream.WriteUint32((uint32_t)rp.mLoadOp);
+    stream.WriteUint32((uint32_t)rp.mStoreOp);
+    stream.WriteUint32((uint32_t)rp.mDepthLoadOp);
+    stream.WriteUint32((uint32_t)rp.mDepthStoreOp);
+    stream.WriteUint32((uint32_t)rp.mPreLayout);
+    stream.WriteUint32((uint32_t)rp.mPostLayout);
+
+    // PipelineStates are compared and hashed as raw bytes, so they are stored that way too.
+    stream.WriteBytes((const uint8_t*)&entry.mState, sizeof(PipelineState));
+}
+
+void PipelineCache::ReadManifestEntry(Stream& stream, PipelineManifestEntry& entry)
+{
+    stream.ReadString(entry.mVertexShader);
+    stream.ReadString(entry.mFragmentShader);
+    stream.ReadString(entry.mComputeShader);
+
+    RenderPassConfig& rp = entry.mRenderPass;
+    for (uint32_t i = 0; i < MAX_RENDER_TARGETS; ++i)
+    {
+        rp.mColorFormats[i] = (VkFormat)stream.ReadUint32();
+    }
+    rp.mDepthFormat = (VkFormat)stream.ReadUint32();
+    rp.mLoadOp = (VkAttachmentLoadOp)stream.ReadUint32();
+    rp.mStoreOp = (VkAttachmentStoreOp)stream.ReadUint32();
+    rp.mDepthLoadOp = (VkAttachmentLoadOp)stream.ReadUint32();
+    rp.mDepthStoreOp = (VkAttachmentStoreOp)stream.ReadUint32();
+    rp.mPreLayout = (VkImageLayout)stream.ReadUint32();
+    rp.mPostLayout = (VkImageLayout)stream.ReadUint32();
+
+    stream.ReadBytes((uint8_t*)&entry.mState, sizeof(PipelineState));
+}
+
+void PipelineCache::LoadManifest()
+{
+    Stream stream;
+
+    if (!SYS_DoesSaveExist(PIPELINE_MANIFEST_SAVE_NAME) ||
+        !SYS_ReadSave(PIPELINE_MANIFEST_SAVE_NAME, stream) ||
+        stream.GetSize() < 3 * sizeof(uint32_t))
+    {
+        return;
+    }
+
+    uint32_t version = stream.ReadUint32();
+    uint32_t stateSize = stream.ReadUint32();
+    uint32_t numEntries = stream.ReadUint32();
+
+    if (version != PIPELINE_MANIFEST_VERSION ||
+        stateSize != sizeof(PipelineState))
+    {
+        LogWarning("Discarding out of date pipeline manifest");
+        return;
+    }
+
+    for (uint32_t i = 0; i < numEntries && i < PIPELINE_MANIFEST_MAX_ENTRIES; ++i)
+    {
+        uint32_t start = stream.GetPos();
+
+        PipelineManifestEntry entry;
+        ReadManifestEntry(stream, entry);
+
+        std::string key(stream.GetData() + start, stream.GetPos() - start);
+
+        if (mManifestKeys.insert(key).second)
+        {
+            mManifest.push_back(entry);
+        }
+    }
+}
+
+void PipelineCache::SaveManifest()
+{
+    if (mManifest.size() == 0)
+    {
+        return;
+    }
+
+    Stream stream;
+    stream.WriteUint32(PIPELINE_MANIFEST_VERSION);
+    stream.WriteUint32(sizeof(PipelineState));
+    stream.WriteUint32((uint32_t)mManifest.size());
+
+    for (uint32_t i = 0; i < mManifest.size(); ++i)
+    {
+        WriteManifestEntry(stream, mManifest[i]);
+    }
+
+    SYS_WriteSave(PIPELINE_MANIFEST_SAVE_NAME, stream);
+}
+
+void PipelineCache::RecordManifestEntry(const PipelineState& state)
+{
+    if (mManifest.size() >= PIPELINE_MANIFEST_MAX_ENTRIES)
+    {
+        return;
+    }
+
+    PipelineManifestEntry entry;
+
+    if (!GetShaderKey(state.mVertexShader, entry.mVertexShader) ||
+        !GetShaderKey(state.mFragmentShader, entry.mFragmentShader) ||
+        !GetShaderKey(state.mComputeShader, entry.mComputeShader))
+    {
+        return;
+    }
+
+    if (state.mRenderPass != VK_NULL_HANDLE &&
+        !GetVulkanContext()->GetRenderPassCache().FindRenderPassConfig(state.mRenderPass, entry.mRenderPass))
+    {
+        return;
+    }
+
+    entry.mRenderPass.mDebugName = "";
+    entry.mState = state;
+    entry.mState.mVertexShader = nullptr;
+    entry.mState.mFragmentShader = nullptr;
+    entry.mState.mComputeShader = nullptr;
+    entry.mState.mRenderPass = VK_NULL_HANDLE;
+
+    Stream stream;
+    WriteManifestEntry(stream, entry);
+    std::string key(stream.GetData(), stream.GetSize());
+
+    if (mManifestKeys.insert(key).second)
+    {
+        mManifest.push_back(entry);
+    }
+}
@@ -2,8 +2,36 @@
 
 #include "VulkanTypes.h"
 #include "Pipeline.h"
+#include "RenderPassCache.h"
 
 #include <vulkan/vulkan.h>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+class Stream;
+
+// A pipeline that was used in a previous run, described so that it can be rebuilt before it is needed.
+// Shaders are referenced by key (see PipelineCache::GetShaderKey()) and the render pass by its config.
+struct PipelineManifestEntry
+{
+    std::string mVertexShader;
+    std::string mFragmentShader;
+    std::string mComputeShader;
+    RenderPassConfig mRenderPass;
+
+    // Shader and render pass handles are cleared.
+    PipelineState mState;
+};
+
+struct PipelineHitch
+{
+    std::string mVertexShader;
+    std::string mFragmentShader;
+    std::string mComputeShader;
+    float mCompileTime = 0.0f;
+    uint32_t mFrameNumber = 0;
+};
 
 class PipelineCache
 {
@@ -18,8 +46,32 @@ public:
 
     Pipeline* Resolve(const PipelineState& state);
 
+    // Builds every manifest pipeline whose shaders are currently loaded, in parallel.
+    // Returns the number of pipelines built.
+    uint32_t Prewarm();
+
+    // Logs the pipelines that had to be compiled on demand by Resolve().
+    void LogHitchReport();
+
+    uint32_t GetNumCompiled() const;
+    void ResetStats();
+
 protected:
 
+    static bool GetShaderKey(Shader* shader, std::string& outKey);
+    static Shader* FindShader(const std::string& key);
+    static void WriteManifestEntry(Stream& stream, const PipelineManifestEntry& entry);
+    static void ReadManifestEntry(Stream& stream, PipelineManifestEntry& entry);
+
+    void LoadManifest();
+    void SaveManifest();
+    void RecordManifestEntry(const PipelineState& state);
+
     std::unordered_map<PipelineState, Pipeline*, PipelineStateHasher> mPipelineMap;
     VkPipelineCache mPipelineCache = VK_NULL_HANDLE;
+
+    std::vector<PipelineManifestEntry> mManifest;
+    std::unordered_set<std::string> mManifestKeys;
+    std::vector<PipelineHitch> mHitches;
+    uint32_t mNumCompiled = 0;
 };
@@ -150,6 +150,7 @@ void BlurPass::Render(Image* input, Image* output)
             .Bind(cb, 1);
 
         // Draw 
+        GetVulkanContext()->CountDrawCall();
         vkCmdDraw(cb, 4, 1, 0, 0);
 
         // End render pass
@@ -218,6 +219,7 @@ void BlurPass::Render(Image* input, Image* output)
             .Bind(cb, 1);
 
         // Draw 
+        GetVulkanContext()->CountDrawCall();
         vkCmdDraw(cb, 4, 1, 0, 0);
 
         // End render pass
@@ -266,6 +268,7 @@ void BlurPass::Render(Image* input, Image* output)
             .Bind(cb, 1);
 
         // Draw 
+        GetVulkanContext()->CountDrawCall();
         vkCmdDraw(cb, 4, 1, 0, 0);
 
         // End render pass
@@ -302,6 +305,7 @@ void BlurPass::Render(Image* input, Image* output)
             .Bind(cb, 1);
 
         // Draw 
+        GetVulkanContext()->CountDrawCall();
         vkCmdDraw(cb, 4, 1, 0, 0);
 
         // End render pass
@@ -61,6 +61,7 @@ void TonemapPass::Render(Image* input, Image* output)
         .Bind(cb, 1);
 
     // Draw 
+    GetVulkanContext()->CountDrawCall();
     vkCmdDraw(cb, 4, 1, 0, 0);
 
     // End render pass
@@ -216,6 +216,20 @@ VkFramebuffer RenderPassCache::ResolveFramebuffer(const FramebufferConfig& confi
     return framebuffer;
 }
 
+bool RenderPassCache::FindRenderPassConfig(VkRenderPass renderPass, RenderPassConfig& outConfig)
+{
+    for (auto& pair : mRenderPassMap)
+    {
+        if (pair.second == renderPass)
+        {
+            outConfig = pair.first;
+            return true;
+        }
+    }
+
+    return false;
+}
+
 
 bool RenderPassConfig::operator==(const RenderPassConfig& other) const
 {
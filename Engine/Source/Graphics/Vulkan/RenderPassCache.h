@@ -66,6 +66,9 @@ public:
     VkRenderPass ResolveRenderPass(const RenderPassConfig& config);
     VkFramebuffer ResolveFramebuffer(const FramebufferConfig& config);
 
+    // Finds the config a cached render pass was created from. Returns false if it isn't cached.
+    bool FindRenderPassConfig(VkRenderPass renderPass, RenderPassConfig& outConfig);
+
 protected:
 
     std::unordered_map<RenderPassConfig, VkRenderPass, RenderPassHash> mRenderPassMap;
@@ -0,0 +1,258 @@
+#if API_VULKAN
+
+#include "Graphics/Vulkan/UploadQueue.h"
+#include "Graphics/Vulkan/VulkanUtils.h"
+#include "Graphics/Vulkan/VulkanContext.h"
+#include "Graphics/Vulkan/VulkanConstants.h"
+#include "Graphics/Vulkan/Buffer.h"
+
+#include "Log.h"
+#include "Assertion.h"
+
+#include <string.h>
+
+void UploadQueue::Create()
+{
+    mHeap = new Buffer(BufferType::Transfer, UPLOAD_HEAP_SIZE, "Upload Heap");
+    mHeapData = (uint8_t*)mHeap->Map();
+    mHeapHead = 0;
+    mHeapUsed = 0;
+}
+
+void UploadQueue::Destroy()
+{
+    Flush();
+
+    VkDevice device = GetVulkanDevice();
+
+    while (mInFlightBatches.size() > 0)
+    {
+        vkWaitForFences(device, 1, &mInFlightBatches.front().mFence, VK_TRUE, UINT64_MAX);
+        RetireBatch();
+    }
+
+    for (uint32_t i = 0; i < mFreeFences.size(); ++i)
+    {
+        vkDestroyFence(device, mFreeFences[i], nullptr);
+    }
+
+    mFreeFences.clear();
+
+    if (mHeap != nullptr)
+    {
+        GetDestroyQueue()->Destroy(mHeap);
+        mHeap = nullptr;
+        mHeapData = nullptr;
+    }
+}
+
+VkCommandBuffer UploadQueue::GetCommandBuffer()
+{
+    if (mCommandBuffer == VK_NULL_HANDLE)
+    {
+        VkCommandBufferAllocateInfo allocInfo = {};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandPool = GetVulkanContext()->GetCommandPool();
+        allocInfo.commandBufferCount = 1;
+
+        vkAllocateCommandBuffers(GetVulkanDevice(), &allocInfo, &mCommandBuffer);
+
+        VkCommandBufferBeginInfo beginInfo = {};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        vkBeginCommandBuffer(mCommandBuffer, &beginInfo);
+
+        SetDebugObjectName(VK_OBJECT_TYPE_COMMAND_BUFFER, (uint64_t)mCommandBuffer, "UploadCommandBuffer");
+    }
+
+    return mCommandBuffer;
+}
+
+void UploadQueue::CopyToBuffer(const void* srcData, VkDeviceSize size, VkBuffer dstBuffer, VkDeviceSize dstOffset)
+{
+    VkCommandBuffer cb = GetCommandBuffer();
+
+    VkBufferCopy copyRegion = {};
+    copyRegion.srcOffset = 0;
+    copyRegion.dstOffset = dstOffset;
+    copyRegion.size = size;
+
+    VkBuffer srcBuffer = Stage(srcData, size, 16, copyRegion.srcOffset);
+    vkCmdCopyBuffer(cb, srcBuffer, dstBuffer, 1, &copyRegion);
+}
+
+void UploadQueue::CopyToImage(const void* srcData, VkDeviceSize size, VkDeviceSize texelSize, VkImage image, uint32_t width, uint32_t height)
+{
+    VkCommandBuffer cb = GetCommandBuffer();
+
+    VkBufferImageCopy region = {};
+    region.bufferRowLength = 0;
+    region.bufferImageHeight = 0;
+
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.mipLevel = 0;
+    region.imageSubresource.baseArrayLayer = 0;
+    region.imageSubresource.layerCount = 1;
+
+    region.imageOffset = { 0, 0, 0 };
+    region.imageExtent = { width, height, 1 };
+
+    // The buffer offset must be a multiple of both the texel (or block) size and 4.
+    VkBuffer srcBuffer = Stage(srcData, size, texelSize * 4, region.bufferOffset);
+
+    vkCmdCopyBufferToImage(cb,
+        srcBuffer,
+        image,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        1,
+        &region);
+}
+
+void UploadQueue::Flush()
+{
+    if (mCommandBuffer == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    VkDevice device = GetVulkanDevice();
+
+    // Make the uploads visible to anything submitted after this batch.
+    VkMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+
+    vkCmdPipelineBarrier(mCommandBuffer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0,
+        1, &barrier,
+        0, nullptr,
+        0, nullptr);
+
+    vkEndCommandBuffer(mCommandBuffer);
+
+    UploadBatch batch;
+    batch.mCommandBuffer = mCommandBuffer;
+    batch.mHeapBytes = mPendingHeapBytes;
+
+    if (mFreeFences.size() > 0)
+    {
+        batch.mFence = mFreeFences.back();
+        mFreeFences.pop_back();
+    }
+    else
+    {
+        VkFenceCreateInfo ciFence = {};
+        ciFence.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+        if (vkCreateFence(device, &ciFence, nullptr, &batch.mFence) != VK_SUCCESS)
+        {
+            LogError("Failed to create upload fence");
+            OCT_ASSERT(0);
+        }
+    }
+
+    VkSubmitInfo submitInfo = {};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &batch.mCommandBuffer;
+
+    if (vkQueueSubmit(GetVulkanContext()->GetGraphicsQueue(), 1, &submitInfo, batch.mFence) != VK_SUCCESS)
+    {
+        LogError("Failed to submit upload command buffer");
+        OCT_ASSERT(0);
+    }
+
+    mInFlightBatches.push_back(batch);
+    mCommandBuffer = VK_NULL_HANDLE;
+    mPendingHeapBytes = 0;
+    mNumBatchesSubmitted++;
+}
+
+void UploadQueue::Update()
+{
+    VkDevice device = GetVulkanDevice();
+
+    while (mInFlightBatches.size() > 0 &&
+        vkGetFenceStatus(device, mInFlightBatches.front().mFence) == VK_SUCCESS)
+    {
+        RetireBatch();
+    }
+}
+
+uint32_t UploadQueue::GetNumBatchesSubmitted() const
+{
+    return mNumBatchesSubmitted;
+}
+
+uint64_t UploadQueue::GetNumBytesStaged() const
+{
+    return mNumBytesStaged;
+}
+
+void UploadQueue::ResetStats()
+{
+    mNumBatchesSubmitted = 0;
+    mNumBytesStaged = 0;
+}
+
+VkBuffer UploadQueue::Stage(const void* srcData, VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& outOffset)
+{
+    mNumBytesStaged += size;
+
+    VkDeviceSize offset = (mHeapHead + alignment - 1) / alignment * alignment;
+
+    if (offset + size > UPLOAD_HEAP_SIZE)
+    {
+        offset = 0;
+    }
+
+    // Space taken from the heap, including alignment padding and the skipped end of the heap when wrapping.
+    VkDeviceSize consumed = (offset >= mHeapHead) ? (offset + size - mHeapHead) : (UPLOAD_HEAP_SIZE - mHeapHead + size);
+
+    if (mHeapData != nullptr &&
+        consumed <= UPLOAD_HEAP_SIZE - mHeapUsed)
+    {
+        memcpy(mHeapData + offset, srcData, size);
+        mHeapHead = offset + size;
+        mHeapUsed += consumed;
+        mPendingHeapBytes += consumed;
+
+        outOffset = offset;
+        return mHeap->Get();
+    }
+
+    // The heap is too small or still in use by the GPU. Rather than wait, use a dedicated staging buffer.
+    // The pending batch is always flushed before the frame is submitted, so the destroy queue can free it.
+    Buffer* stagingBuffer = new Buffer(BufferType::Transfer, size, "Staging Buffer", srcData, true, true);
+    VkBuffer srcBuffer = stagingBuffer->Get();
+    GetDestroyQueue()->Destroy(stagingBuffer);
+
+    outOffset = 0;
+    return srcBuffer;
+}
+
+void UploadQueue::RetireBatch()
+{
+    OCT_ASSERT(mInFlightBatches.size() > 0);
+
+    VkDevice device = GetVulkanDevice();
+    UploadBatch& batch = mInFlightBatches.front();
+
+    vkFreeCommandBuffers(device, GetVulkanContext()->GetCommandPool(), 1, &batch.mCommandBuffer);
+    vkResetFences(device, 1, &batch.mFence);
+    mFreeFences.push_back(batch.mFence);
+
+    OCT_ASSERT(mHeapUsed >= batch.mHeapBytes);
+    mHeapUsed -= batch.mHeapBytes;
+    mInFlightBatches.pop_front();
+
+    if (mHeapUsed == 0)
+    {
+        mHeapHead = 0;
+    }
+}
+
+#endif
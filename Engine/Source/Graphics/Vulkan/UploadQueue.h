@@ -0,0 +1,66 @@
+#pragma once
+
+#if API_VULKAN
+
+#include <stdint.h>
+#include <deque>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+class Buffer;
+
+// Gathers resource uploads into one command buffer that is submitted with the frame instead of
+// submitting a command buffer per copy. Source data is staged in a persistently mapped ring
+// buffer, and each submitted batch's space is reclaimed once its fence has signaled.
+// Batches go to the graphics queue so they stay ordered with the frame and with any single-use
+// command buffer, which flushes the pending batch before it is submitted (see EndCommandBuffer).
+class UploadQueue
+{
+public:
+
+    void Create();
+    void Destroy();
+
+    // Returns the command buffer of the batch being recorded, beginning a new batch if needed.
+    VkCommandBuffer GetCommandBuffer();
+
+    void CopyToBuffer(const void* srcData, VkDeviceSize size, VkBuffer dstBuffer, VkDeviceSize dstOffset);
+    void CopyToImage(const void* srcData, VkDeviceSize size, VkDeviceSize texelSize, VkImage image, uint32_t width, uint32_t height);
+
+    // Submits the pending batch, if any.
+    void Flush();
+
+    // Reclaims staging space from batches that have finished executing. Never waits.
+    void Update();
+
+    uint32_t GetNumBatchesSubmitted() const;
+    uint64_t GetNumBytesStaged() const;
+    void ResetStats();
+
+protected:
+
+    VkBuffer Stage(const void* srcData, VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& outOffset);
+    void RetireBatch();
+
+    struct UploadBatch
+    {
+        VkCommandBuffer mCommandBuffer = VK_NULL_HANDLE;
+        VkFence mFence = VK_NULL_HANDLE;
+        VkDeviceSize mHeapBytes = 0;
+    };
+
+    Buffer* mHeap = nullptr;
+    uint8_t* mHeapData = nullptr;
+    VkDeviceSize mHeapHead = 0;
+    VkDeviceSize mHeapUsed = 0;
+
+    VkCommandBuffer mCommandBuffer = VK_NULL_HANDLE;
+    VkDeviceSize mPendingHeapBytes = 0;
+    std::deque<UploadBatch> mInFlightBatches;
+    std::vector<VkFence> mFreeFences;
+
+    uint32_t mNumBatchesSubmitted = 0;
+    uint64_t mNumBytesStaged = 0;
+};
+
+#endif
@@ -9,125 +9,412 @@
 
 #include "Assertion.h"
 
-std::vector<VramMemoryBlock> VramAllocator::sBlocks;
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+std::vector<VramMemoryBlock*> VramAllocator::sBlocks;
 const uint64_t VramAllocator::sDefaultBlockSize = 16777216; // 16 MB Blocks
+const uint64_t VramAllocator::sTransientArenaSize = 8388608; // 8 MB Arenas
 
 uint64_t VramAllocator::sNumAllocations = 0;
 uint64_t VramAllocator::sNumAllocatedBytes = 0;
 
-static int64_t sNumChunksAllocated = 0;
+static uint32_t FindLowestBit(uint64_t mask)
+{
+    OCT_ASSERT(mask != 0);
+#if defined(_MSC_VER)
+    unsigned long index = 0;
+    _BitScanForward64(&index, mask);
+    return (uint32_t)index;
+#else
+    return (uint32_t)__builtin_ctzll(mask);
+#endif
+}
 
-VramMemoryChunk* VramMemoryBlock::AllocateChunk(uint64_t size)
+static uint32_t FindHighestBit(uint64_t mask)
 {
-    VramMemoryChunk* chunk = nullptr;
+    OCT_ASSERT(mask != 0);
+#if defined(_MSC_VER)
+    unsigned long index = 0;
+    _BitScanReverse64(&index, mask);
+    return (uint32_t)index;
+#else
+    return 63 - (uint32_t)__builtin_clzll(mask);
+#endif
+}
+
+static uint64_t AlignUp(uint64_t value, uint64_t alignment)
+{
+    return ((value + alignment - 1) / alignment) * alignment;
+}
 
-    for (int32_t j = 0; j < int32_t(mChunks.size()); ++j)
+int32_t VramMemoryBlock::AllocateChunk(uint64_t size, uint64_t alignment, uint64_t& outOffset, uint64_t& outPaddedSize)
+{
+    size = AlignUp(size, VRAM_MIN_ALIGNMENT);
+    alignment = (alignment > VRAM_MIN_ALIGNMENT) ? alignment : VRAM_MIN_ALIGNMENT;
+
+    // Chunk offsets are already aligned to VRAM_MIN_ALIGNMENT, so that much padding is never needed.
+    int32_t index = FindFreeChunk(size + alignment - VRAM_MIN_ALIGNMENT);
+
+    if (index == -1)
     {
-        if (mChunks[j].mFree &&
-            mChunks[j].mSize >= size)
+        return -1;
+    }
+
+    RemoveFreeChunk(index);
+
+    // Give the alignment padding at the front back to the block.
+    uint64_t padding = AlignUp(mChunks[index].mOffset, alignment) - mChunks[index].mOffset;
+
+    if (padding > 0)
+    {
+        int32_t front = NewChunk();
+        int32_t prev = mChunks[index].mPrevPhysical;
+
+        mChunks[front].mOffset = mChunks[index].mOffset;
+        mChunks[front].mSize = padding;
+        mChunks[front].mPrevPhysical = prev;
+        mChunks[front].mNextPhysical = index;
+
+        if (prev != -1)
         {
-            // We found a chunk that is big enough, now let's split the chunk into two.
-            uint64_t extraSize = mChunks[j].mSize - size;
+            mChunks[prev].mNextPhysical = front;
+        }
 
-            if (extraSize > 0)
-            {
-                mChunks[j].mSize = size;
-                
-                VramMemoryChunk extraChunk;
-                extraChunk.mFree = true;
-                extraChunk.mOffset = mChunks[j].mOffset + mChunks[j].mSize;
-                extraChunk.mSize = extraSize;
-                extraChunk.mID = -1;
-
-                mChunks.insert(mChunks.begin() + j + 1, extraChunk);
-            }
+        mChunks[index].mPrevPhysical = front;
+        mChunks[index].mOffset += padding;
+        mChunks[index].mSize -= padding;
 
-            mChunks[j].mFree = false;
-            mChunks[j].mID = sNumChunksAllocated++;
+        InsertFreeChunk(front);
+    }
 
-            OCT_ASSERT(mChunks[j].mID >= 0); // Did we overflow int64_t?
+    // Split off whatever is left at the back.
+    uint64_t extraSize = mChunks[index].mSize - size;
 
-            // make sure we grab the pointer after inserting the new chunk (as it may reallocate the data).
-            chunk = &mChunks[j];
-            break;
+    if (extraSize > 0)
+    {
+        int32_t back = NewChunk();
+        int32_t next = mChunks[index].mNextPhysical;
+
+        mChunks[back].mOffset = mChunks[index].mOffset + size;
+        mChunks[back].mSize = extraSize;
+        mChunks[back].mPrevPhysical = index;
+        mChunks[back].mNextPhysical = next;
+
+        if (next != -1)
+        {
+            mChunks[next].mPrevPhysical = back;
         }
+
+        mChunks[index].mNextPhysical = back;
+        mChunks[index].mSize = size;
+
+        InsertFreeChunk(back);
     }
 
-    return chunk;
+    mChunks[index].mFree = false;
+    mAvailableMemory -= size;
+    mNumAllocations++;
+
+    outOffset = mChunks[index].mOffset;
+    outPaddedSize = size;
+    return index;
 }
 
-bool VramMemoryBlock::FreeChunk(int64_t id)
+void VramMemoryBlock::FreeChunk(int32_t index)
 {
-    bool bFreed = false;
+    OCT_ASSERT(index >= 0 && index < int32_t(mChunks.size()));
+    OCT_ASSERT(!mChunks[index].mFree);
 
-    for (int32_t j = 0; j < int32_t(mChunks.size()); ++j)
+    mAvailableMemory += mChunks[index].mSize;
+    mNumAllocations--;
+
+    // Merge with the next chunk if it's free
+    int32_t next = mChunks[index].mNextPhysical;
+
+    if (next != -1 &&
+        mChunks[next].mFree)
     {
-        if (mChunks[j].mID == id)
+        RemoveFreeChunk(next);
+
+        mChunks[index].mSize += mChunks[next].mSize;
+        mChunks[index].mNextPhysical = mChunks[next].mNextPhysical;
+
+        if (mChunks[index].mNextPhysical != -1)
         {
-            bFreed = true;
+            mChunks[mChunks[index].mNextPhysical].mPrevPhysical = index;
+        }
 
-            // Mark this chunk as freed
-            mChunks[j].mFree = true;
-            
-            // See if we can merge this chunk
-            // First try merging it with the next chunk in the list
-            if (j < int32_t(mChunks.size()) - 1 &&
-                mChunks[j + 1].mFree)
-            {
-                mChunks[j].mSize += mChunks[j + 1].mSize;
-                mChunks.erase(mChunks.begin() + j + 1);
-            }
+        mUnusedChunks.push_back(next);
+    }
+
+    // Then with the previous chunk
+    int32_t prev = mChunks[index].mPrevPhysical;
 
-            // Now try merging with the previous chunk
-            if (j > 0 &&
-                mChunks[j - 1].mFree)
+    if (prev != -1 &&
+        mChunks[prev].mFree)
+    {
+        RemoveFreeChunk(prev);
+
+        mChunks[prev].mSize += mChunks[index].mSize;
+        mChunks[prev].mNextPhysical = mChunks[index].mNextPhysical;
+
+        if (mChunks[prev].mNextPhysical != -1)
+        {
+            mChunks[mChunks[prev].mNextPhysical].mPrevPhysical = prev;
+        }
+
+        mUnusedChunks.push_back(index);
+        index = prev;
+    }
+
+    InsertFreeChunk(index);
+}
+
+bool VramMemoryBlock::IsEmpty() const
+{
+    return mNumAllocations == 0;
+}
+
+uint64_t VramMemoryBlock::GetLargestFreeChunk() const
+{
+    if (mAllocType == VramAllocType::Transient)
+    {
+        return mSize - mLinearHead;
+    }
+
+    if (mFlBitmap == 0)
+    {
+        return 0;
+    }
+
+    // Only the highest non-empty list needs to be checked.
+    uint32_t fl = FindHighestBit(mFlBitmap);
+    uint32_t sl = FindHighestBit(mSlBitmaps[fl]);
+    uint64_t largest = 0;
+
+    for (int32_t i = mFreeLists[fl][sl]; i != -1; i = mChunks[i].mNextFree)
+    {
+        largest = (mChunks[i].mSize > largest) ? mChunks[i].mSize : largest;
+    }
+
+    return largest;
+}
+
+void VramMemoryBlock::InitChunks()
+{
+    mChunks.clear();
+    mUnusedChunks.clear();
+    mNumFreeChunks = 0;
+    mFlBitmap = 0;
+
+    for (uint32_t fl = 0; fl < VRAM_FL_COUNT; ++fl)
+    {
+        mSlBitmaps[fl] = 0;
+
+        for (uint32_t sl = 0; sl < VRAM_SL_COUNT; ++sl)
+        {
+            mFreeLists[fl][sl] = -1;
+        }
+    }
+
+    int32_t firstChunk = NewChunk();
+    mChunks[firstChunk].mOffset = 0;
+    mChunks[firstChunk].mSize = mSize;
+    InsertFreeChunk(firstChunk);
+}
+
+int32_t VramMemoryBlock::NewChunk()
+{
+    int32_t index = -1;
+
+    if (mUnusedChunks.size() > 0)
+    {
+        index = mUnusedChunks.back();
+        mUnusedChunks.pop_back();
+        mChunks[index] = VramMemoryChunk();
+    }
+    else
+    {
+        index = int32_t(mChunks.size());
+        mChunks.push_back(VramMemoryChunk());
+    }
+
+    return index;
+}
+
+void VramMemoryBlock::InsertFreeChunk(int32_t index)
+{
+    uint32_t fl = 0;
+    uint32_t sl = 0;
+    MapSize(mChunks[index].mSize, fl, sl);
+
+    int32_t head = mFreeLists[fl][sl];
+
+    mChunks[index].mFree = true;
+    mChunks[index].mPrevFree = -1;
+    mChunks[index].mNextFree = head;
+
+    if (head != -1)
+    {
+        mChunks[head].mPrevFree = index;
+    }
+
+    mFreeLists[fl][sl] = index;
+    mFlBitmap |= (1ull << fl);
+    mSlBitmaps[fl] |= (1u << sl);
+    mNumFreeChunks++;
+}
+
+void VramMemoryBlock::RemoveFreeChunk(int32_t index)
+{
+    uint32_t fl = 0;
+    uint32_t sl = 0;
+    MapSize(mChunks[index].mSize, fl, sl);
+
+    int32_t prev = mChunks[index].mPrevFree;
+    int32_t next = mChunks[index].mNextFree;
+
+    if (prev != -1)
+    {
+        mChunks[prev].mNextFree = next;
+    }
+
+    if (next != -1)
+    {
+        mChunks[next].mPrevFree = prev;
+    }
+
+    if (mFreeLists[fl][sl] == index)
+    {
+        mFreeLists[fl][sl] = next;
+
+        if (next == -1)
+        {
+            mSlBitmaps[fl] &= ~(1u << sl);
+
+            if (mSlBitmaps[fl] == 0)
             {
-                mChunks[j - 1].mSize += mChunks[j].mSize;
-                mChunks.erase(mChunks.begin() + j);
+                mFlBitmap &= ~(1ull << fl);
             }
         }
     }
 
-    return bFreed;
+    mChunks[index].mFree = false;
+    mChunks[index].mPrevFree = -1;
+    mChunks[index].mNextFree = -1;
+    mNumFreeChunks--;
 }
 
-void VramAllocator::Alloc(uint64_t size, uint64_t alignment, uint32_t memoryType, VramAllocation& outAllocation)
+int32_t VramMemoryBlock::FindFreeChunk(uint64_t size)
 {
-    VramMemoryBlock* block = nullptr;
-    VramMemoryChunk* chunk = nullptr;
+    uint32_t fl = 0;
+    uint32_t sl = 0;
+
+    // Round the size up to the next list so that any chunk found is large enough.
+    uint64_t searchSize = size + (1ull << (FindHighestBit(size) - VRAM_SL_BITS)) - 1;
+    MapSize(searchSize, fl, sl);
 
-    uint64_t maxAlignSize = size + alignment;
-    for (int32_t i = 0; i < int32_t(sBlocks.size()); ++i)
+    if (fl < VRAM_FL_COUNT)
     {
-        if (sBlocks[i].mMemoryType == memoryType)
+        uint32_t slMap = mSlBitmaps[fl] & (~0u << sl);
+
+        if (slMap == 0)
         {
-            chunk = sBlocks[i].AllocateChunk(maxAlignSize);
+            uint64_t flMap = (fl + 1 < VRAM_FL_COUNT) ? (mFlBitmap & (~0ull << (fl + 1))) : 0;
 
-            if (chunk != nullptr)
+            if (flMap != 0)
             {
-                block = &sBlocks[i];
-                break;
+                fl = FindLowestBit(flMap);
+                slMap = mSlBitmaps[fl];
             }
         }
+
+        if (slMap != 0)
+        {
+            sl = FindLowestBit(slMap);
+            return mFreeLists[fl][sl];
+        }
     }
 
-    if (chunk == nullptr)
+    // Nothing in the larger lists, but the list that the size itself maps to may still have a chunk that fits.
+    MapSize(size, fl, sl);
+
+    for (int32_t i = mFreeLists[fl][sl]; i != -1; i = mChunks[i].mNextFree)
+    {
+        if (mChunks[i].mSize >= size)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+void VramMemoryBlock::MapSize(uint64_t size, uint32_t& outFl, uint32_t& outSl)
+{
+    OCT_ASSERT(size >= VRAM_MIN_ALIGNMENT);
+
+    outFl = FindHighestBit(size);
+    outSl = uint32_t(size >> (outFl - VRAM_SL_BITS)) ^ (1u << VRAM_SL_BITS);
+}
+
+void VramAllocator::Alloc(uint64_t size, uint64_t alignment, uint32_t memoryType, VramAllocation& outAllocation, VramAllocType allocType)
+{
+    bool allocated = false;
+
+    if (allocType == VramAllocType::Transient)
     {
-        uint64_t newBlockSize = maxAlignSize > sDefaultBlockSize ? maxAlignSize : sDefaultBlockSize;
-        block = AllocateBlock(newBlockSize, memoryType);
-        OCT_ASSERT(block);
+        allocated = AllocTransient(size, alignment, memoryType, outAllocation);
 
-        chunk = block->AllocateChunk(maxAlignSize);
+        // If the arena is full, fall back to a regular buffer allocation.
+        allocType = VramAllocType::Buffer;
     }
 
-    OCT_ASSERT(chunk);
+    if (!allocated)
+    {
+        VramMemoryBlock* block = nullptr;
+        int32_t chunk = -1;
+        uint64_t offset = 0;
+        uint64_t paddedSize = 0;
 
-    outAllocation.mDeviceMemory = block->mDeviceMemory;
-    outAllocation.mID = chunk->mID;
-    outAllocation.mOffset = ((chunk->mOffset + alignment - 1) / alignment) * alignment;
-    outAllocation.mSize = size;
-    outAllocation.mType = block->mMemoryType;
-    outAllocation.mPaddedSize = maxAlignSize;
+        for (int32_t i = 0; i < int32_t(sBlocks.size()); ++i)
+        {
+            if (sBlocks[i]->mMemoryType == memoryType &&
+                sBlocks[i]->mAllocType == allocType)
+            {
+                chunk = sBlocks[i]->AllocateChunk(size, alignment, offset, paddedSize);
+
+                if (chunk != -1)
+                {
+                    block = sBlocks[i];
+                    break;
+                }
+            }
+        }
+
+        if (chunk == -1)
+        {
+            // Leave room for the worst case alignment padding.
+            uint64_t minBlockSize = AlignUp(size, VRAM_MIN_ALIGNMENT) + AlignUp(alignment, VRAM_MIN_ALIGNMENT);
+            uint64_t newBlockSize = minBlockSize > sDefaultBlockSize ? minBlockSize : sDefaultBlockSize;
+            block = AllocateBlock(newBlockSize, memoryType, allocType);
+            OCT_ASSERT(block);
+
+            chunk = block->AllocateChunk(size, alignment, offset, paddedSize);
+        }
+
+        OCT_ASSERT(chunk != -1);
+
+        outAllocation.mDeviceMemory = block->mDeviceMemory;
+        outAllocation.mBlock = block;
+        outAllocation.mID = chunk;
+        outAllocation.mOffset = offset;
+        outAllocation.mSize = size;
+        outAllocation.mType = block->mMemoryType;
+        outAllocation.mPaddedSize = paddedSize;
+    }
 
     sNumAllocations++;
     sNumAllocatedBytes += outAllocation.mPaddedSize;
@@ -142,35 +429,54 @@ void VramAllocator::Free(VramAllocation& allocation)
 
     //LogDebug("FREE: NumAllocations = %lld, NumAllocatedBytes = %lld", sNumAllocations, sNumAllocatedBytes);
 
-    bool bFreed = false;
-    for (int32_t i = 0; i < int32_t(sBlocks.size()); ++i)
+    VramMemoryBlock* block = allocation.mBlock;
+    OCT_ASSERT(block != nullptr);
+
+    if (block->mAllocType == VramAllocType::Transient)
     {
-        if (sBlocks[i].mMemoryType == allocation.mType)
-        {
-            bFreed = sBlocks[i].FreeChunk(allocation.mID);
+        // Arenas are only rewound once everything allocated from them is freed.
+        // Transient buffers are destroyed through the destroy queue, so this normally happens
+        // when the arena's frame comes around again.
+        OCT_ASSERT(block->mNumAllocations > 0);
+        block->mNumAllocations--;
 
-            if (bFreed)
-            {
-                // If the block is entirely free, deallocate the memory.
-                if (sBlocks[i].mChunks.size() == 1)
-                {
-                    OCT_ASSERT(sBlocks[i].mChunks[0].mFree);
-                    FreeBlock(sBlocks[i]);
-                }
-                break;
-            }
+        if (block->mNumAllocations == 0)
+        {
+            block->mLinearHead = 0;
+            block->mAvailableMemory = block->mSize;
         }
     }
+    else
+    {
+        block->FreeChunk(int32_t(allocation.mID));
 
-    OCT_ASSERT(bFreed);
+        // If the block is entirely free, deallocate the memory.
+        if (block->IsEmpty())
+        {
+            FreeBlock(block);
+        }
+    }
 
     allocation.mDeviceMemory = VK_NULL_HANDLE;
+    allocation.mBlock = nullptr;
     allocation.mID = -1;
     allocation.mOffset = 0;
     allocation.mSize = 0;
     allocation.mType = 0;
 }
 
+void VramAllocator::Shutdown()
+{
+    for (int32_t i = int32_t(sBlocks.size()) - 1; i >= 0; --i)
+    {
+        if (sBlocks[i]->mAllocType == VramAllocType::Transient)
+        {
+            OCT_ASSERT(sBlocks[i]->IsEmpty());
+            FreeBlock(sBlocks[i]);
+        }
+    }
+}
+
 uint64_t VramAllocator::GetNumBlocksAllocated()
 {
     return static_cast<uint64_t>(sBlocks.size());
@@ -186,15 +492,98 @@ uint64_t VramAllocator::GetNumAllocatedBytes()
     return sNumAllocatedBytes;
 }
 
-VramMemoryBlock* VramAllocator::AllocateBlock(uint64_t newBlockSize, uint32_t memoryType)
+void VramAllocator::GetStats(VramStats& outStats)
 {
-    sBlocks.push_back(VramMemoryBlock());
-    VramMemoryBlock& newBlock = sBlocks.back();
+    outStats = VramStats();
+    outStats.mNumBlocks = GetNumBlocksAllocated();
+    outStats.mNumAllocations = sNumAllocations;
+    outStats.mAllocatedBytes = sNumAllocatedBytes;
 
-    newBlock.mSize = newBlockSize;
-    newBlock.mAvailableMemory = newBlockSize;
-    newBlock.mLargestChunk = newBlockSize;
-    newBlock.mMemoryType = memoryType;
+    for (uint32_t i = 0; i < sBlocks.size(); ++i)
+    {
+        const VramMemoryBlock* block = sBlocks[i];
+        outStats.mReservedBytes += block->mSize;
+
+        // Arena space is rewound every frame, so it isn't counted as fragmented free memory.
+        if (block->mAllocType == VramAllocType::Transient)
+        {
+            outStats.mTransientBytes += block->mSize - block->mAvailableMemory;
+            continue;
+        }
+
+        uint64_t largestChunk = block->GetLargestFreeChunk();
+        outStats.mFreeBytes += block->mAvailableMemory;
+        outStats.mNumFreeChunks += block->mNumFreeChunks;
+        outStats.mLargestFreeChunk = (largestChunk > outStats.mLargestFreeChunk) ? largestChunk : outStats.mLargestFreeChunk;
+    }
+
+    if (outStats.mFreeBytes > 0)
+    {
+        outStats.mFragmentation = 1.0f - (outStats.mLargestFreeChunk / float(outStats.mFreeBytes));
+    }
+}
+
+bool VramAllocator::AllocTransient(uint64_t size, uint64_t alignment, uint32_t memoryType, VramAllocation& outAllocation)
+{
+    uint32_t frameIndex = GetFrameIndex();
+    VramMemoryBlock* arena = nullptr;
+
+    for (uint32_t i = 0; i < sBlocks.size(); ++i)
+    {
+        if (sBlocks[i]->mAllocType == VramAllocType::Transient &&
+            sBlocks[i]->mMemoryType == memoryType &&
+            sBlocks[i]->mFrameIndex == frameIndex)
+        {
+            arena = sBlocks[i];
+            break;
+        }
+    }
+
+    alignment = (alignment > VRAM_MIN_ALIGNMENT) ? alignment : VRAM_MIN_ALIGNMENT;
+    uint64_t alignedSize = AlignUp(size, VRAM_MIN_ALIGNMENT);
+
+    if (arena == nullptr)
+    {
+        if (alignedSize + alignment > sTransientArenaSize)
+        {
+            return false;
+        }
+
+        arena = AllocateBlock(sTransientArenaSize, memoryType, VramAllocType::Transient);
+        arena->mFrameIndex = frameIndex;
+    }
+
+    uint64_t offset = AlignUp(arena->mLinearHead, alignment);
+
+    if (offset + alignedSize > arena->mSize)
+    {
+        return false;
+    }
+
+    outAllocation.mDeviceMemory = arena->mDeviceMemory;
+    outAllocation.mBlock = arena;
+    outAllocation.mID = -1;
+    outAllocation.mOffset = offset;
+    outAllocation.mSize = size;
+    outAllocation.mType = memoryType;
+    outAllocation.mPaddedSize = offset + alignedSize - arena->mLinearHead;
+
+    arena->mAvailableMemory -= outAllocation.mPaddedSize;
+    arena->mLinearHead = offset + alignedSize;
+    arena->mNumAllocations++;
+
+    return true;
+}
+
+VramMemoryBlock* VramAllocator::AllocateBlock(uint64_t newBlockSize, uint32_t memoryType, VramAllocType allocType)
+{
+    VramMemoryBlock* newBlock = new VramMemoryBlock();
+    sBlocks.push_back(newBlock);
+
+    newBlock->mSize = newBlockSize;
+    newBlock->mAvailableMemory = newBlockSize;
+    newBlock->mMemoryType = memoryType;
+    newBlock->mAllocType = allocType;
 
     // Allocate video memory.
     VkMemoryAllocateInfo allocInfo = {};
@@ -202,30 +591,28 @@ VramMemoryBlock* VramAllocator::AllocateBlock(uint64_t newBlockSize, uint32_t me
     allocInfo.allocationSize = newBlockSize;
     allocInfo.memoryTypeIndex = memoryType;
 
-    if (vkAllocateMemory(GetVulkanDevice(), &allocInfo, nullptr, &newBlock.mDeviceMemory) != VK_SUCCESS)
+    if (vkAllocateMemory(GetVulkanDevice(), &allocInfo, nullptr, &newBlock->mDeviceMemory) != VK_SUCCESS)
     {
         LogError("Failed to allocate image memory");
         OCT_ASSERT(0);
     }
 
     // Initialize the starting chunk.
-    VramMemoryChunk firstChunk;
-    firstChunk.mFree = true;
-    firstChunk.mID = -1;
-    firstChunk.mOffset = 0;
-    firstChunk.mSize = newBlockSize;
-    newBlock.mChunks.push_back(firstChunk);
+    if (allocType != VramAllocType::Transient)
+    {
+        newBlock->InitChunks();
+    }
 
-    return &newBlock;
+    return newBlock;
 }
 
-void VramAllocator::FreeBlock(VramMemoryBlock& block)
+void VramAllocator::FreeBlock(VramMemoryBlock* block)
 {
     int32_t index = 0;
 
     for (index = 0; index < int32_t(sBlocks.size()); ++index)
     {
-        if (block.mDeviceMemory == sBlocks[index].mDeviceMemory)
+        if (block == sBlocks[index])
         {
             break;
         }
@@ -233,8 +620,9 @@ void VramAllocator::FreeBlock(VramMemoryBlock& block)
 
     OCT_ASSERT(index < int32_t(sBlocks.size()));
 
-    vkFreeMemory(GetVulkanDevice(), sBlocks[index].mDeviceMemory, nullptr);
+    vkFreeMemory(GetVulkanDevice(), sBlocks[index]->mDeviceMemory, nullptr);
+    delete sBlocks[index];
     sBlocks.erase(sBlocks.begin() + index);
 }
 
-#endif // API_VULKAN
\ No newline at end of file
+#endif // API_VULKAN
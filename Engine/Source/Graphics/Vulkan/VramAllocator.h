@@ -5,9 +5,33 @@
 #include <vulkan/vulkan.h>
 #include <vector>
 
+// Two-level segregated free lists (TLSF). The first level splits sizes by power of two,
+// the second level splits each power of two into VRAM_SL_COUNT linear ranges.
+#define VRAM_FL_COUNT 64
+#define VRAM_SL_BITS 4
+#define VRAM_SL_COUNT (1 << VRAM_SL_BITS)
+
+// Every chunk offset and size is a multiple of this.
+#define VRAM_MIN_ALIGNMENT 256
+
+struct VramMemoryBlock;
+
+enum class VramAllocType
+{
+    Buffer,
+    Image,
+
+    // Short lived buffers (like staging buffers) that are destroyed within a few frames.
+    // These are bump allocated from a linear arena for the current frame.
+    Transient,
+
+    Count
+};
+
 struct VramAllocation
 {
     VkDeviceMemory mDeviceMemory;
+    VramMemoryBlock* mBlock;
     uint32_t mType;
     int64_t mID;
     VkDeviceSize mSize;
@@ -16,6 +40,7 @@ struct VramAllocation
 
     VramAllocation() :
         mDeviceMemory(VK_NULL_HANDLE),
+        mBlock(nullptr),
         mType(0),
         mID(-1),
         mSize(0),
@@ -33,16 +58,26 @@ struct VramAllocation
 
 struct VramMemoryChunk
 {
-    int64_t mID;
     uint64_t mOffset;
     uint64_t mSize;
     bool mFree;
 
+    // Neighbouring chunks in address order.
+    int32_t mPrevPhysical;
+    int32_t mNextPhysical;
+
+    // Neighbouring chunks in the same free list while free.
+    int32_t mPrevFree;
+    int32_t mNextFree;
+
     VramMemoryChunk() :
-        mID(-1),
         mOffset(0),
         mSize(0),
-        mFree(true)
+        mFree(true),
+        mPrevPhysical(-1),
+        mNextPhysical(-1),
+        mPrevFree(-1),
+        mNextFree(-1)
     {
 
     }
@@ -50,49 +85,98 @@ struct VramMemoryChunk
 
 struct VramMemoryBlock
 {
-    VramMemoryChunk* AllocateChunk(uint64_t size);
-    bool FreeChunk(int64_t id);
+    // Returns the index of the allocated chunk, or -1 if the block has no room.
+    int32_t AllocateChunk(uint64_t size, uint64_t alignment, uint64_t& outOffset, uint64_t& outPaddedSize);
+    void FreeChunk(int32_t index);
+
+    bool IsEmpty() const;
+    uint64_t GetLargestFreeChunk() const;
+
+    void InitChunks();
+    int32_t NewChunk();
+    void InsertFreeChunk(int32_t index);
+    void RemoveFreeChunk(int32_t index);
+    int32_t FindFreeChunk(uint64_t size);
+
+    static void MapSize(uint64_t size, uint32_t& outFl, uint32_t& outSl);
 
     VramMemoryBlock() :
         mDeviceMemory(0),
         mSize(0),
         mAvailableMemory(0),
-        mLargestChunk(0),
-        mMemoryType(0)
+        mMemoryType(0),
+        mAllocType(VramAllocType::Buffer),
+        mNumAllocations(0),
+        mNumFreeChunks(0),
+        mFrameIndex(0),
+        mLinearHead(0),
+        mFlBitmap(0)
     {
-        
+
     }
 
     std::vector<VramMemoryChunk> mChunks;
+    std::vector<int32_t> mUnusedChunks;
     VkDeviceMemory mDeviceMemory;
     uint64_t mSize;
     uint64_t mAvailableMemory;
-    uint64_t mLargestChunk;
     uint32_t mMemoryType;
+    VramAllocType mAllocType;
+    uint32_t mNumAllocations;
+    uint32_t mNumFreeChunks;
+
+    // Transient arenas only.
+    uint32_t mFrameIndex;
+    uint64_t mLinearHead;
+
+    uint64_t mFlBitmap;
+    uint32_t mSlBitmaps[VRAM_FL_COUNT] = {};
+    int32_t mFreeLists[VRAM_FL_COUNT][VRAM_SL_COUNT];
+};
+
+struct VramStats
+{
+    uint64_t mNumBlocks = 0;
+    uint64_t mNumAllocations = 0;
+    uint64_t mAllocatedBytes = 0;
+    uint64_t mReservedBytes = 0;
+    uint64_t mFreeBytes = 0;
+    uint64_t mLargestFreeChunk = 0;
+    uint64_t mNumFreeChunks = 0;
+    uint64_t mTransientBytes = 0;
+
+    // 0 when all free memory is in one chunk, approaching 1 as it is split into small chunks.
+    float mFragmentation = 0.0f;
 };
 
 class VramAllocator
 {
 public:
 
-    static void Alloc(uint64_t size, uint64_t alignment, uint32_t memoryType, VramAllocation& outAllocation);
+    static void Alloc(uint64_t size, uint64_t alignment, uint32_t memoryType, VramAllocation& outAllocation, VramAllocType allocType = VramAllocType::Buffer);
     static void Free(VramAllocation& allocation);
 
+    // Frees the transient arenas. Every other allocation must have been freed already.
+    static void Shutdown();
+
     static uint64_t GetNumBlocksAllocated();
     static uint64_t GetNumAllocations();
     static uint64_t GetNumAllocatedBytes();
+    static void GetStats(VramStats& outStats);
 
     static const uint64_t sDefaultBlockSize;
+    static const uint64_t sTransientArenaSize;
 
 private:
 
-    static VramMemoryBlock* AllocateBlock(uint64_t newBlockSize, uint32_t memoryType);
-    static void FreeBlock(VramMemoryBlock& block);
+    static bool AllocTransient(uint64_t size, uint64_t alignment, uint32_t memoryType, VramAllocation& outAllocation);
+    static VramMemoryBlock* AllocateBlock(uint64_t newBlockSize, uint32_t memoryType, VramAllocType allocType);
+    static void FreeBlock(VramMemoryBlock* block);
 
 
-    static std::vector<VramMemoryBlock> sBlocks;
+    static std::vector<VramMemoryBlock*> sBlocks;
     static uint64_t sNumAllocations;
     static uint64_t sNumAllocatedBytes;
 };
 
-#endif
\ No newline at end of file
+#endif
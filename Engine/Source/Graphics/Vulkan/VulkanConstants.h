@@ -8,7 +8,10 @@
 #define MAX_STORAGE_IMAGE_DESCRIPTORS 32
 #define MAX_SAMPLER_DESCRIPTORS 4096
 #define MAX_BOUND_DESCRIPTOR_SETS 4
+#define MAX_TRACKED_VERTEX_BUFFERS 4
+#define MAX_TRACKED_DYNAMIC_OFFSETS 4
 #define MAX_RENDER_TARGETS 8
+#define UPLOAD_HEAP_SIZE (16 * 1024 * 1024)
 
 #define ENGINE_SHADER_DIR "Engine/Shaders/GLSL/bin/"
 
@@ -110,8 +110,10 @@ void VulkanContext::Initialize()
     CreateLogicalDevice();
     CreateSwapchain();
     CreateCommandPool();
+    mUploadQueue.Create();
 
     CreateFrameUniformBuffer();
+    CreateFrameInstanceBuffer();
 
     CreateShadowMapImage();
     CreateSceneColorImage();
@@ -242,8 +244,11 @@ void VulkanContext::Destroy()
     DestroyRenderPasses();
 
     DestroyFrameUniformBuffer();
+    DestroyFrameInstanceBuffer();
 
+    mUploadQueue.Destroy();
     mDestroyQueue.FlushAll();
+    VramAllocator::Shutdown();
 
     DestroyDescriptorPools();
 
@@ -316,6 +321,7 @@ void VulkanContext::BeginFrame()
 
     vkBeginCommandBuffer(cb, &beginInfo);
     SetDebugObjectName(VK_OBJECT_TYPE_COMMAND_BUFFER, (uint64_t)cb, "FrameCommandBuffer");
+    mCommandRecorder.Reset();
 
     ReadTimeQueryResults();
 
@@ -342,6 +348,36 @@ void VulkanContext::EndFrame()
     UpdateGlobalUniformData();
     UpdateGlobalDescriptorSet();
 
+    // Uploads recorded this frame must execute before the frame's commands.
+    mUploadQueue.Flush();
+
+    GetProfiler()->SetCounterStat("Draw Calls", (float)mNumDrawCalls);
+    GetProfiler()->SetCounterStat("Auto Instanced Draws", (float)mNumAutoInstancedDraws);
+    GetProfiler()->SetCounterStat("Auto Instanced Meshes", (float)mNumAutoInstances);
+    GetProfiler()->SetCounterStat("Binds Issued", (float)mCommandRecorder.GetNumBindsIssued());
+    GetProfiler()->SetCounterStat("Binds Skipped", (float)mCommandRecorder.GetNumBindsSkipped());
+    GetProfiler()->SetCounterStat("Upload Batches", (float)mUploadQueue.GetNumBatchesSubmitted());
+    GetProfiler()->SetCounterStat("Uploaded KB", mUploadQueue.GetNumBytesStaged() / 1024.0f);
+    GetProfiler()->SetCounterStat("Pipeline Compiles", (float)mPipelineCache.GetNumCompiled());
+
+    VramStats vramStats;
+    VramAllocator::GetStats(vramStats);
+    GetProfiler()->SetCounterStat("VRAM Blocks", (float)vramStats.mNumBlocks);
+    GetProfiler()->SetCounterStat("VRAM Allocations", (float)vramStats.mNumAllocations);
+    GetProfiler()->SetCounterStat("VRAM Used MB", vramStats.mAllocatedBytes / (1024.0f * 1024.0f));
+    GetProfiler()->SetCounterStat("VRAM Reserved MB", vramStats.mReservedBytes / (1024.0f * 1024.0f));
+    GetProfiler()->SetCounterStat("VRAM Largest Free MB", vramStats.mLargestFreeChunk / (1024.0f * 1024.0f));
+    GetProfiler()->SetCounterStat("VRAM Free Chunks", (float)vramStats.mNumFreeChunks);
+    GetProfiler()->SetCounterStat("VRAM Fragmentation %", vramStats.mFragmentation * 100.0f);
+    GetProfiler()->SetCounterStat("VRAM Transient KB", vramStats.mTransientBytes / 1024.0f);
+
+    mNumDrawCalls = 0;
+    mNumAutoInstancedDraws = 0;
+    mNumAutoInstances = 0;
+    mCommandRecorder.ResetStats();
+    mUploadQueue.ResetStats();
+    mPipelineCache.ResetStats();
+
     VkSubmitInfo submitInfo = {};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
@@ -391,8 +427,12 @@ void VulkanContext::EndFrame()
     // It should be safe if we waited to acquire the swapchain image.
     mDestroyQueue.Flush(nextFrameIndex);
 
+    // Reclaim upload heap space from batches that have finished.
+    mUploadQueue.Update();
+
     // Reset the head offset for our frame uniform buffer.
     mFrameUniformBuffer->Reset(nextFrameIndex);
+    mFrameInstanceBuffer->Reset(nextFrameIndex);
 
     mFrameIndex = nextFrameIndex;
     mFrameNumber++;
@@ -609,6 +649,9 @@ void VulkanContext::EndRenderPass()
         if (draw_data != nullptr)
         {
             ImGui_ImplVulkan_RenderDrawData(draw_data, mCommandBuffers[mFrameIndex]);
+
+            // ImGui binds its own pipeline and buffers.
+            mCommandRecorder.Reset();
         }
     }
 #endif
@@ -637,7 +680,7 @@ void VulkanContext::CommitPipeline()
     mBoundPipeline = mPipelineCache.Resolve(mPipelineState);
     mBoundPipeline->Bind(mCommandBuffers[mFrameIndex]);
 
-    // TODO: Can we avoid always binding the global descriptor set.
+    // Skipped by the command recorder unless the pipeline layout changed.
     BindGlobalDescriptorSet();
 }
 
@@ -682,11 +725,10 @@ void VulkanContext::DrawLines(const std::vector<Line>& lines)
     {
         BindPipelineConfig(PipelineConfig::Line);
 
-        VkDeviceSize offset = 0;
-        VkBuffer lineVertexBuffer = mLineVertexBuffer->Get();
-        vkCmdBindVertexBuffers(cb, 0, 1, &lineVertexBuffer, &offset);
+        mCommandRecorder.BindVertexBuffer(cb, 0, mLineVertexBuffer->Get());
 
         CommitPipeline();
+        CountDrawCall();
         vkCmdDraw(cb, 2 * uint32_t(lines.size()), 1, 0, 0);
     }
 }
@@ -699,14 +741,13 @@ void VulkanContext::DrawFullscreen()
 
     CommitPipeline();
 
+    CountDrawCall();
     vkCmdDraw(cb, 4, 1, 0, 0);
 }
 
 void VulkanContext::BindFullscreenVertexBuffer(VkCommandBuffer cb)
 {
-    VkBuffer vertexBuffers[] = { mFullScreenVertexBuffer->Get() };
-    VkDeviceSize offsets[] = { 0 };
-    vkCmdBindVertexBuffers(cb, 0, 1, vertexBuffers, offsets);
+    mCommandRecorder.BindVertexBuffer(cb, 0, mFullScreenVertexBuffer->Get());
 }
 
 void VulkanContext::DestroySwapchain()
@@ -1421,6 +1462,23 @@ void VulkanContext::DestroyFrameUniformBuffer()
     mFrameUniformBuffer = nullptr;
 }
 
+void VulkanContext::CreateFrameInstanceBuffer()
+{
+    // Holds transforms for StaticMesh3D draws that are merged into instanced draws.
+    mFrameInstanceBuffer = new StorageBuffer(4 * 1024 * 1024, "Frame Instance Buffer");
+
+    for (uint32_t i = 0; i < MAX_FRAMES; ++i)
+    {
+        mFrameInstanceBuffer->GetBuffer(i)->Map();
+    }
+}
+
+void VulkanContext::DestroyFrameInstanceBuffer()
+{
+    GetDestroyQueue()->Destroy(mFrameInstanceBuffer);
+    mFrameInstanceBuffer = nullptr;
+}
+
 void VulkanContext::CreateSceneColorImage()
 {
     VkFormat format;
@@ -2309,11 +2367,37 @@ const VkPhysicalDeviceProperties& VulkanContext::GetDeviceProperties() const
     return mDeviceProperties;
 }
 
+CommandRecorder* VulkanContext::GetCommandRecorder()
+{
+    return &mCommandRecorder;
+}
+
+UploadQueue* VulkanContext::GetUploadQueue()
+{
+    return &mUploadQueue;
+}
+
 UniformBuffer* VulkanContext::GetFrameUniformBuffer()
 {
     return mFrameUniformBuffer;
 }
 
+StorageBuffer* VulkanContext::GetFrameInstanceBuffer()
+{
+    return mFrameInstanceBuffer;
+}
+
+void VulkanContext::CountDrawCall()
+{
+    mNumDrawCalls++;
+}
+
+void VulkanContext::CountAutoInstancedDraw(uint32_t numInstances)
+{
+    mNumAutoInstancedDraws++;
+    mNumAutoInstances += numInstances;
+}
+
 Shader* VulkanContext::GetGlobalShader(const std::string& name)
 {
     Shader* shader = mGlobalShaders[name];
@@ -2327,6 +2411,12 @@ Shader* VulkanContext::GetGlobalShader(const std::string& name)
     return shader;
 }
 
+Shader* VulkanContext::FindGlobalShader(const std::string& name)
+{
+    auto it = mGlobalShaders.find(name);
+    return (it != mGlobalShaders.end()) ? it->second : nullptr;
+}
+
 const PipelineState& VulkanContext::GetPipelineState() const
 {
     return mPipelineState;
@@ -2666,6 +2756,11 @@ PipelineCache& VulkanContext::GetPipelineCache()
     return mPipelineCache;
 }
 
+RenderPassCache& VulkanContext::GetRenderPassCache()
+{
+    return mRenderPassCache;
+}
+
 void VulkanContext::SavePipelineCacheToFile()
 {
     mPipelineCache.SaveToFile();
@@ -2784,6 +2879,7 @@ Node3D* VulkanContext::ProcessHitCheck(World* world, int32_t pixelX, int32_t pix
         // replace the "current" CB with our temp CB
         VkCommandBuffer realCb = mCommandBuffers[mFrameIndex];
         mCommandBuffers[mFrameIndex] = cb;
+        mCommandRecorder.Reset();
 
         glm::uvec4 vp = Renderer::Get()->GetSceneViewport();
         SetViewport(vp.x, vp.y, vp.z, vp.w, false, true);
@@ -22,6 +22,8 @@
 #include "DescriptorLayoutCache.h"
 #include "PipelineCache.h"
 #include "RenderPassCache.h"
+#include "CommandRecorder.h"
+#include "UploadQueue.h"
 #include "PostProcessChain.h"
 
 #if PLATFORM_LINUX
@@ -98,6 +100,7 @@ public:
 
     Pipeline* GetBoundPipeline();
     PipelineCache& GetPipelineCache();
+    RenderPassCache& GetRenderPassCache();
     void SavePipelineCacheToFile();
 
     void SetViewport(int32_t x, int32_t y, int32_t width, int32_t height, bool handlePrerotation, bool useSceneRes);
@@ -146,9 +149,19 @@ public:
 
     const VkPhysicalDeviceProperties& GetDeviceProperties() const;
     UniformBuffer* GetFrameUniformBuffer();
+    StorageBuffer* GetFrameInstanceBuffer();
+    CommandRecorder* GetCommandRecorder();
+    UploadQueue* GetUploadQueue();
+
+    // Draw statistics, reported as counter stats at the end of each frame.
+    void CountDrawCall();
+    void CountAutoInstancedDraw(uint32_t numInstances);
 
     Shader* GetGlobalShader(const std::string& name);
 
+    // Returns nullptr if there is no global shader with that name.
+    Shader* FindGlobalShader(const std::string& name);
+
     // Pipeline State
     const PipelineState& GetPipelineState() const;
     void SetPipelineState(const PipelineState& state);
@@ -193,6 +206,8 @@ private:
     void CreateLogicalDevice();
     void CreateFrameUniformBuffer();
     void DestroyFrameUniformBuffer();
+    void CreateFrameInstanceBuffer();
+    void DestroyFrameInstanceBuffer();
     void CreateRenderPasses();
     void DestroyRenderPasses();
     void CreateCommandPool();
@@ -262,6 +277,7 @@ private:
 
     // RenderPasses
     RenderPassCache mRenderPassCache;
+    CommandRecorder mCommandRecorder;
     VkRenderPass mImguiRenderPass = VK_NULL_HANDLE;
 
     // Images
@@ -286,14 +302,23 @@ private:
     DescriptorSet mDebugDescriptorSet;
     DescriptorSet mPostProcessDescriptorSet;
     UniformBuffer* mFrameUniformBuffer = nullptr;
+    StorageBuffer* mFrameInstanceBuffer = nullptr;
     GlobalUniformData mGlobalUniformData;
 
     // Destroy Queue
     DestroyQueue mDestroyQueue;
 
+    // Upload Queue
+    UploadQueue mUploadQueue;
+
     // Ray Tracer
     RayTracer mRayTracer;
 
+    // Draw Stats
+    uint32_t mNumDrawCalls = 0;
+    uint32_t mNumAutoInstancedDraws = 0;
+    uint32_t mNumAutoInstances = 0;
+
     // Debug
     bool mValidate;
     VkDebugUtilsMessengerEXT mDebugMessenger = VK_NULL_HANDLE;
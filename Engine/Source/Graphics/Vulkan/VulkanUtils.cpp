@@ -99,7 +99,8 @@ void CreateBuffer(
     VkBufferUsageFlags usage,
     VkMemoryPropertyFlags properties,
     VkBuffer& buffer,
-    VramAllocation& bufferMemory)
+    VramAllocation& bufferMemory,
+    VramAllocType allocType)
 {
     VkDevice device = GetVulkanDevice();
 
@@ -120,7 +121,7 @@ void CreateBuffer(
     vkGetBufferMemoryRequirements(device, buffer, &memRequirements);
     uint32_t memoryType = FindMemoryType(memRequirements.memoryTypeBits, properties);
 
-    VramAllocator::Alloc(memRequirements.size, memRequirements.alignment, memoryType, bufferMemory);
+    VramAllocator::Alloc(memRequirements.size, memRequirements.alignment, memoryType, bufferMemory, allocType);
 
     vkBindBufferMemory(device, buffer, bufferMemory.mDeviceMemory, bufferMemory.mOffset);
 }
@@ -276,45 +277,6 @@ void TransitionImageLayout(
     }
 }
 
-void CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size)
-{
-    VkCommandBuffer commandBuffer = BeginCommandBuffer();
-
-    VkBufferCopy copyRegion = {};
-    copyRegion.size = size;
-    vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
-
-    EndCommandBuffer(commandBuffer);
-}
-
-void CopyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height)
-{
-    VkCommandBuffer commandBuffer = BeginCommandBuffer();
-
-    VkBufferImageCopy region = {};
-    region.bufferOffset = 0;
-    region.bufferRowLength = 0;
-    region.bufferImageHeight = 0;
-
-    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    region.imageSubresource.mipLevel = 0;
-    region.imageSubresource.baseArrayLayer = 0;
-    region.imageSubresource.layerCount = 1;
-
-    region.imageOffset = { 0, 0, 0 };
-    region.imageExtent = { width, height, 1 };
-
-    vkCmdCopyBufferToImage(commandBuffer,
-        buffer,
-        image,
-        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-        1,
-        &region);
-
-
-    EndCommandBuffer(commandBuffer);
-}
-
 uint32_t GetFrameIndex()
 {
     return GetVulkanContext()->GetFrameIndex();
@@ -330,6 +292,16 @@ DestroyQueue* GetDestroyQueue()
     return GetVulkanContext()->GetDestroyQueue();
 }
 
+CommandRecorder* GetCommandRecorder()
+{
+    return GetVulkanContext()->GetCommandRecorder();
+}
+
+UploadQueue* GetUploadQueue()
+{
+    return GetVulkanContext()->GetUploadQueue();
+}
+
 VkDevice GetVulkanDevice()
 {
     return GetVulkanContext()->GetDevice();
@@ -342,6 +314,8 @@ VkCommandBuffer GetCommandBuffer()
 
 void DeviceWaitIdle()
 {
+    // Callers waiting on the device expect pending uploads to have executed too.
+    GetUploadQueue()->Flush();
     vkDeviceWaitIdle(GetVulkanDevice());
 }
 
@@ -376,6 +350,9 @@ void EndCommandBuffer(VkCommandBuffer commandBuffer)
 
     vkEndCommandBuffer(commandBuffer);
 
+    // Submit pending uploads first so this command buffer sees them, as it would have if they were submitted immediately.
+    GetUploadQueue()->Flush();
+
     VkSubmitInfo submitInfo = {};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
     submitInfo.commandBufferCount = 1;
@@ -1240,6 +1217,8 @@ void CreateMaterialResource(Material* material)
         {
             DestroyMaterialResource(material);
 
+            // Shaders are named so that the pipeline cache can find them again (see PipelineCache::FindShader()).
+
             // Vertex Shaders
             for (uint32_t i = 0; i < (uint32_t)VertexType::Max; ++i)
             {
@@ -1249,7 +1228,7 @@ void CreateMaterialResource(Material* material)
 
                 if (size > 0)
                 {
-                    resource->mVertexShaders[i] = new Shader((const char*)data, size, ShaderStage::Vertex, "Material Vert Shader");
+                    resource->mVertexShaders[i] = new Shader((const char*)data, size, ShaderStage::Vertex, material->GetName() + ":vert" + std::to_string(i));
                 }
             }
 
@@ -1261,7 +1240,7 @@ void CreateMaterialResource(Material* material)
 
                 if (size > 0)
                 {
-                    resource->mFragmentShader = new Shader((const char*)data, size, ShaderStage::Fragment, "Material Frag Shader");
+                    resource->mFragmentShader = new Shader((const char*)data, size, ShaderStage::Fragment, material->GetName() + ":frag");
                 }
             }
         }
@@ -1350,6 +1329,12 @@ void BindMaterialDescriptorSet(Material* material)
     MaterialResource* resource = material->GetResource();
     std::vector<ShaderParameter>& params = material->GetParameters();
 
+    if (resource->mDescriptorSetFrame == GetFrameNumber())
+    {
+        resource->mDescriptorSet.Bind(cb, 2);
+        return;
+    }
+
     if (material->IsLite())
     {
         MaterialLite* matLite = (MaterialLite*)material;
@@ -1378,14 +1363,13 @@ void BindMaterialDescriptorSet(Material* material)
             }
         }
 
-        DescriptorSet::Begin("Lite Material DS")
+        resource->mDescriptorSet = DescriptorSet::Begin("Lite Material DS")
             .WriteUniformBuffer(MD_UNIFORM_BUFFER, uniformBlock)
             .WriteImage(MD_TEXTURE_START + 0, textures[0]->GetResource()->mImage)
             .WriteImage(MD_TEXTURE_START + 1, textures[1]->GetResource()->mImage)
             .WriteImage(MD_TEXTURE_START + 2, textures[2]->GetResource()->mImage)
             .WriteImage(MD_TEXTURE_START + 3, textures[3]->GetResource()->mImage)
-            .Build()
-            .Bind(cb, 2);
+            .Build();
     }
     else
     {
@@ -1419,8 +1403,11 @@ void BindMaterialDescriptorSet(Material* material)
         }
 
         matSet.Build();
-        matSet.Bind(cb, 2);
+        resource->mDescriptorSet = matSet;
     }
+
+    resource->mDescriptorSetFrame = GetFrameNumber();
+    resource->mDescriptorSet.Bind(cb, 2);
 }
 
 void CreateStaticMeshResource(StaticMesh* staticMesh, bool hasColor, uint32_t numVertices, void* vertices, uint32_t numIndices, IndexType* indices)
@@ -1454,10 +1441,8 @@ void BindStaticMeshResource(StaticMesh* staticMesh)
     StaticMeshResource* resource = staticMesh->GetResource();
 
     VkCommandBuffer cb = GetCommandBuffer();
-    VkBuffer vertexBuffers[] = { resource->mVertexBuffer->Get() };
-    VkDeviceSize offsets[] = { 0 };
-    vkCmdBindVertexBuffers(cb, 0, 1, vertexBuffers, offsets);
-    vkCmdBindIndexBuffer(cb, resource->mIndexBuffer->Get(), 0, VK_INDEX_TYPE_UINT32);
+    GetCommandRecorder()->BindVertexBuffer(cb, 0, resource->mVertexBuffer->Get());
+    GetCommandRecorder()->BindIndexBuffer(cb, resource->mIndexBuffer->Get(), 0, VK_INDEX_TYPE_UINT32);
 }
 
 void CreateSkeletalMeshResource(SkeletalMesh* skeletalMesh, uint32_t numVertices, VertexSkinned* vertices, uint32_t numIndices, IndexType* indices)
@@ -1489,11 +1474,9 @@ void BindSkeletalMeshResource(SkeletalMesh* skeletalMesh)
     SkeletalMeshResource* resource = skeletalMesh->GetResource();
 
     VkCommandBuffer cb = GetCommandBuffer();
-    VkBuffer vertexBuffers[] = { resource->mVertexBuffer->Get() };
-    VkDeviceSize offsets[] = { 0 };
-    vkCmdBindVertexBuffers(cb, 0, 1, vertexBuffers, offsets);
+    GetCommandRecorder()->BindVertexBuffer(cb, 0, resource->mVertexBuffer->Get());
 
-    vkCmdBindIndexBuffer(cb, resource->mIndexBuffer->Get(), 0, VK_INDEX_TYPE_UINT32);
+    GetCommandRecorder()->BindIndexBuffer(cb, resource->mIndexBuffer->Get(), 0, VK_INDEX_TYPE_UINT32);
 }
 
 void BindSkeletalMeshResourceIndices(SkeletalMesh* skeletalMesh)
@@ -1501,7 +1484,7 @@ void BindSkeletalMeshResourceIndices(SkeletalMesh* skeletalMesh)
     SkeletalMeshResource* resource = skeletalMesh->GetResource();
 
     VkCommandBuffer cb = GetCommandBuffer();
-    vkCmdBindIndexBuffer(cb, resource->mIndexBuffer->Get(), 0, VK_INDEX_TYPE_UINT32);
+    GetCommandRecorder()->BindIndexBuffer(cb, resource->mIndexBuffer->Get(), 0, VK_INDEX_TYPE_UINT32);
 }
 
 void BindGeometryDescriptorSet(StaticMesh3D* staticMeshComp)
@@ -1636,9 +1619,7 @@ void DrawStaticMeshComp(StaticMesh3D* staticMeshComp, StaticMesh* meshOverride)
             }
 
             // Bind color instance buffer at binding #1
-            VkBuffer vertexBuffers[] = { resource->mColorVertexBuffer->Get() };
-            VkDeviceSize offsets[] = { 0 };
-            vkCmdBindVertexBuffers(cb, 1, 1, vertexBuffers, offsets);
+            GetCommandRecorder()->BindVertexBuffer(cb, 1, resource->mColorVertexBuffer->Get());
         }
         else if (mesh->HasVertexColor())
         {
@@ -1660,6 +1641,7 @@ void DrawStaticMeshComp(StaticMesh3D* staticMeshComp, StaticMesh* meshOverride)
         BindGeometryDescriptorSet(staticMeshComp);
         BindMaterialDescriptorSet(material);
 
+        GetVulkanContext()->CountDrawCall();
         vkCmdDrawIndexed(cb,
             mesh->GetNumIndices(),
             1,
@@ -1669,6 +1651,164 @@ void DrawStaticMeshComp(StaticMesh3D* staticMeshComp, StaticMesh* meshOverride)
     }
 }
 
+static bool HasMaterialVertexShader(Material* material, VertexType vertType)
+{
+    MaterialResource* res = material->GetResource();
+
+    if (material->IsInstance())
+    {
+        MaterialBase* base = ((MaterialInstance*)material)->GetBaseMaterial();
+        res = base ? base->GetResource() : res;
+    }
+
+    return res != nullptr && res->mVertexShaders[(uint32_t)vertType] != nullptr;
+}
+
+static bool HasUniformScale(const glm::mat4& transform)
+{
+    // The instanced vertex shaders transform normals by the world matrix.
+    float x2 = glm::dot(glm::vec3(transform[0]), glm::vec3(transform[0]));
+    float y2 = glm::dot(glm::vec3(transform[1]), glm::vec3(transform[1]));
+    float z2 = glm::dot(glm::vec3(transform[2]), glm::vec3(transform[2]));
+    float tolerance = 0.001f * x2;
+
+    return fabs(x2 - y2) <= tolerance && fabs(x2 - z2) <= tolerance;
+}
+
+void DrawStaticMeshCompInstances(StaticMesh3D* const* staticMeshComps, uint32_t count)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    VulkanContext* context = GetVulkanContext();
+    StaticMesh* mesh = staticMeshComps[0]->GetStaticMesh();
+    Material* material = staticMeshComps[0]->GetMaterial();
+    material = material ? material : Renderer::Get()->GetDefaultMaterial();
+    VertexType vertexType = (mesh && mesh->HasVertexColor()) ? VertexType::VertexColor : VertexType::Vertex;
+
+    // Only forward pass draws are merged. Editor passes need a hit check id per node, and
+    // material vertex shaders don't have instanced variants.
+    if (count == 1 ||
+        mesh == nullptr ||
+        context->GetCurrentRenderPassId() != RenderPassId::Forward ||
+        !context->AreMaterialsEnabled() ||
+        HasMaterialVertexShader(material, vertexType))
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            DrawStaticMeshComp(staticMeshComps[i]);
+        }
+
+        return;
+    }
+
+    VkCommandBuffer cb = GetCommandBuffer();
+    bool pipelineBound = false;
+
+    uint32_t first = 0;
+    while (first < count)
+    {
+        // Draws can only share one uniform block, so split the run wherever the light list changes.
+        GeometryData ubo = {};
+        ubo.mHasBakedLighting = staticMeshComps[first]->HasBakedLighting();
+        GatherGeometryLightUniformData(ubo, staticMeshComps[first], material, true);
+
+        uint32_t last = first + 1;
+
+        if (HasUniformScale(staticMeshComps[first]->GetRenderTransform()))
+        {
+            while (last < count)
+            {
+                StaticMesh3D* comp = staticMeshComps[last];
+
+                GeometryData lightData = {};
+                GatherGeometryLightUniformData(lightData, comp, material, true);
+
+                if (comp->HasBakedLighting() != (bool)ubo.mHasBakedLighting ||
+                    lightData.mNumLights != ubo.mNumLights ||
+                    lightData.mLights0 != ubo.mLights0 ||
+                    lightData.mLights1 != ubo.mLights1 ||
+                    !HasUniformScale(comp->GetRenderTransform()))
+                {
+                    break;
+                }
+
+                ++last;
+            }
+        }
+
+        uint32_t numInstances = last - first;
+        StorageBlock instanceBlock;
+
+        if (numInstances > 1)
+        {
+            instanceBlock = context->GetFrameInstanceBuffer()->AllocBlock(numInstances * sizeof(MeshInstanceBufferData));
+        }
+
+        if (instanceBlock.mData == nullptr)
+        {
+            // Single draw, or the frame's instance buffer is full.
+            for (uint32_t i = first; i < last; ++i)
+            {
+                DrawStaticMeshComp(staticMeshComps[i]);
+            }
+
+            pipelineBound = false;
+            first = last;
+            continue;
+        }
+
+        MeshInstanceBufferData* instanceData = (MeshInstanceBufferData*)instanceBlock.mData;
+        for (uint32_t i = 0; i < numInstances; ++i)
+        {
+            instanceData[i].mTransform = staticMeshComps[first + i]->GetRenderTransform();
+        }
+
+        if (!pipelineBound)
+        {
+            BindStaticMeshResource(mesh);
+            BindForwardVertexType(vertexType, material, true);
+            BindMaterialResource(material);
+            context->CommitPipeline();
+            BindMaterialDescriptorSet(material);
+            pipelineBound = true;
+        }
+
+        // Instance transforms are applied on top of the geometry world matrix.
+        bool hasBakedLighting = ubo.mHasBakedLighting;
+        uint32_t numLights = ubo.mNumLights;
+        uint32_t lights0 = ubo.mLights0;
+        uint32_t lights1 = ubo.mLights1;
+
+        WriteGeometryUniformData(ubo, staticMeshComps[first]->GetWorld(), nullptr, glm::mat4(1.0f));
+        ubo.mHasBakedLighting = hasBakedLighting;
+        ubo.mNumLights = numLights;
+        ubo.mLights0 = lights0;
+        ubo.mLights1 = lights1;
+
+        UniformBlock uniformBlock = WriteUniformBlock(&ubo, sizeof(ubo));
+
+        DescriptorSet::Begin("StaticMesh3D Instanced DS")
+            .WriteUniformBuffer(GD_UNIFORM_BUFFER, uniformBlock)
+            .WriteStorageBuffer(GD_INSTANCE_DATA_BUFFER, instanceBlock)
+            .Build()
+            .Bind(cb, 1);
+
+        context->CountDrawCall();
+        context->CountAutoInstancedDraw(numInstances);
+        vkCmdDrawIndexed(cb,
+            mesh->GetNumIndices(),
+            numInstances,
+            0,
+            0,
+            0);
+
+        first = last;
+    }
+}
+
 void DestroySkeletalMeshCompResource(SkeletalMesh3D* skeletalMeshComp)
 {
     SkeletalMeshCompResource* resource = skeletalMeshComp->GetResource();
@@ -1770,9 +1910,7 @@ void DrawSkeletalMeshComp(SkeletalMesh3D* skeletalMeshComp)
 
         if (IsCpuSkinningRequired(skeletalMeshComp))
         {
-            VkDeviceSize offset = 0;
-            VkBuffer vertexBuffer = resource->mVertexBuffer->Get();
-            vkCmdBindVertexBuffers(cb, 0, 1, &vertexBuffer, &offset);
+            GetCommandRecorder()->BindVertexBuffer(cb, 0, resource->mVertexBuffer->Get());
 
             BindSkeletalMeshResourceIndices(mesh);
         }
@@ -1797,6 +1935,7 @@ void DrawSkeletalMeshComp(SkeletalMesh3D* skeletalMeshComp)
         BindGeometryDescriptorSet(skeletalMeshComp);
         BindMaterialDescriptorSet(material);
 
+        GetVulkanContext()->CountDrawCall();
         vkCmdDrawIndexed(cb,
             mesh->GetNumIndices(),
             1,
@@ -1847,6 +1986,7 @@ void DrawShadowMeshComp(ShadowMesh3D* shadowMeshComp)
         context->SetVertexType(shadowMeshComp->GetVertexType());
         GetVulkanContext()->CommitPipeline();
         BindGeometryDescriptorSet(shadowMeshComp);
+        GetVulkanContext()->CountDrawCall();
         vkCmdDrawIndexed(cb, mesh->GetNumIndices(), 1, 0, 0, 0);
 
         // Step 2, render front faces and blend the shadow color to the scene colors's RGB channels based on the scene color's Alpha.
@@ -1855,6 +1995,7 @@ void DrawShadowMeshComp(ShadowMesh3D* shadowMeshComp)
         context->SetVertexType(shadowMeshComp->GetVertexType());
         GetVulkanContext()->CommitPipeline();
         BindGeometryDescriptorSet(shadowMeshComp);
+        GetVulkanContext()->CountDrawCall();
         vkCmdDrawIndexed(cb, mesh->GetNumIndices(), 1, 0, 0, 0);
     }
 }
@@ -1942,9 +2083,7 @@ void DrawInstancedMeshComp(InstancedMesh3D* instancedMeshComp)
             }
 
             // Bind color instance buffer at binding #1
-            VkBuffer vertexBuffers[] = { resource->mColorVertexBuffer->Get() };
-            VkDeviceSize offsets[] = { 0 };
-            vkCmdBindVertexBuffers(cb, 1, 1, vertexBuffers, offsets);
+            GetCommandRecorder()->BindVertexBuffer(cb, 1, resource->mColorVertexBuffer->Get());
         }
         else if (mesh->HasVertexColor())
         {
@@ -1981,6 +2120,7 @@ void DrawInstancedMeshComp(InstancedMesh3D* instancedMeshComp)
         BindGeometryDescriptorSet(instancedMeshComp);
         BindMaterialDescriptorSet(material);
 
+        GetVulkanContext()->CountDrawCall();
         vkCmdDrawIndexed(cb,
             mesh->GetNumIndices(),
             numInstances,
@@ -2040,9 +2180,7 @@ void DrawTextMeshComp(TextMesh3D* textMeshComp)
 
     VkCommandBuffer cb = GetCommandBuffer();
 
-    VkDeviceSize offset = 0;
-    VkBuffer vertexBuffer = resource->mVertexBuffer->Get();
-    vkCmdBindVertexBuffers(cb, 0, 1, &vertexBuffer, &offset);
+    GetCommandRecorder()->BindVertexBuffer(cb, 0, resource->mVertexBuffer->Get());
 
     Material* material = nullptr; 
 
@@ -2059,6 +2197,7 @@ void DrawTextMeshComp(TextMesh3D* textMeshComp)
     BindGeometryDescriptorSet(textMeshComp);
     BindMaterialDescriptorSet(material);
 
+    GetVulkanContext()->CountDrawCall();
     vkCmdDraw(cb, TEXT_VERTS_PER_CHAR * textMeshComp->GetNumVisibleCharacters(), 1, 0, 0);
 }
 
@@ -2203,10 +2342,8 @@ void DrawParticleComp(Particle3D* particleComp)
             material = material ? material : Renderer::Get()->GetDefaultMaterial();
         }
 
-        VkDeviceSize offset = 0;
-        VkBuffer vertexBuffer = resource->mVertexBuffer->Get();
-        vkCmdBindVertexBuffers(cb, 0, 1, &vertexBuffer, &offset);
-        vkCmdBindIndexBuffer(cb, resource->mIndexBuffer->Get(), 0, VK_INDEX_TYPE_UINT32);
+        GetCommandRecorder()->BindVertexBuffer(cb, 0, resource->mVertexBuffer->Get());
+        GetCommandRecorder()->BindIndexBuffer(cb, resource->mIndexBuffer->Get(), 0, VK_INDEX_TYPE_UINT32);
 
         BindForwardVertexType(VertexType::VertexParticle, material);
         BindMaterialResource(material);
@@ -2220,6 +2357,7 @@ void DrawParticleComp(Particle3D* particleComp)
         // based on the number of particles, so use vertex count here to determine the number of indices.
         uint32_t numIndices = (particleComp->GetNumVertices() / 2) * 3; // 6 indices per particle (two triangles)
 
+        GetVulkanContext()->CountDrawCall();
         vkCmdDrawIndexed(
             cb,
             numIndices,
@@ -2285,14 +2423,13 @@ void DrawQuad(Quad* quad)
     // Make sure to bind the quad pipeline. Quad and text rendering will be interleaved.
     BindPipelineConfig(PipelineConfig::Quad);
 
-    VkDeviceSize offset = 0;
-    VkBuffer vertexBuffer = resource->mVertexBuffer->Get();
-    vkCmdBindVertexBuffers(cb, 0, 1, &vertexBuffer, &offset);
+    GetCommandRecorder()->BindVertexBuffer(cb, 0, resource->mVertexBuffer->Get());
 
     context->CommitPipeline();
 
     BindGeometryDescriptorSet(quad);
 
+    GetVulkanContext()->CountDrawCall();
     vkCmdDraw(cb, 4, 1, 0, 0);
 }
 
@@ -2403,14 +2540,13 @@ void DrawTextWidget(Text* text)
         VkCommandBuffer cb = GetCommandBuffer();
         BindPipelineConfig(PipelineConfig::Text);
 
-        VkDeviceSize offset = 0;
-        VkBuffer vertexBuffer = resource->mVertexBuffer->Get();
-        vkCmdBindVertexBuffers(cb, 0, 1, &vertexBuffer, &offset);
+        GetCommandRecorder()->BindVertexBuffer(cb, 0, resource->mVertexBuffer->Get());
 
         GetVulkanContext()->CommitPipeline();
 
         BindGeometryDescriptorSet(text);
 
+        GetVulkanContext()->CountDrawCall();
         vkCmdDraw(cb, 6 * text->GetNumVisibleCharacters(), 1, 0, 0);
     }
 }
@@ -2506,9 +2642,7 @@ void DrawPoly(Poly* poly)
 
         BindPipelineConfig(PipelineConfig::Poly);
 
-        VkDeviceSize offset = 0;
-        VkBuffer vertexBuffer = resource->mVertexBuffer->Get();
-        vkCmdBindVertexBuffers(cb, 0, 1, &vertexBuffer, &offset);
+        GetCommandRecorder()->BindVertexBuffer(cb, 0, resource->mVertexBuffer->Get());
 
         GetVulkanContext()->CommitPipeline();
 
@@ -2519,6 +2653,7 @@ void DrawPoly(Poly* poly)
             vkCmdSetLineWidth(cb, poly->GetLineWidth());
         }
 
+        GetVulkanContext()->CountDrawCall();
         vkCmdDraw(cb, numVerts, 1, 0, 0);
     }
 }
@@ -2559,6 +2694,7 @@ void DrawStaticMesh(StaticMesh* mesh, Material* material, const glm::mat4& trans
             .Bind(cb, 1);
         BindMaterialDescriptorSet(material);
 
+        GetVulkanContext()->CountDrawCall();
         vkCmdDrawIndexed(cb,
             mesh->GetNumIndices(),
             1,
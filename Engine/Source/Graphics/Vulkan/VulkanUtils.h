@@ -13,6 +13,8 @@
 
 class World;
 class DestroyQueue;
+class CommandRecorder;
+class UploadQueue;
 class Pipeline;
 
 class Texture;
@@ -45,7 +47,8 @@ void CreateBuffer(
     VkBufferUsageFlags usage,
     VkMemoryPropertyFlags properties,
     VkBuffer& buffer,
-    VramAllocation& bufferMemory);
+    VramAllocation& bufferMemory,
+    VramAllocType allocType = VramAllocType::Buffer);
 
 void TransitionImageLayout(
     VkImage image,
@@ -56,20 +59,11 @@ void TransitionImageLayout(
     int32_t layerCount = 1,
     VkCommandBuffer commandBuffer = VK_NULL_HANDLE);
 
-void CopyBuffer(
-    VkBuffer srcBuffer,
-    VkBuffer dstBuffer,
-    VkDeviceSize size);
-
-void CopyBufferToImage(
-    VkBuffer buffer,
-    VkImage image,
-    uint32_t width,
-    uint32_t height);
-
 uint32_t GetFrameIndex();
 uint32_t GetFrameNumber();
 DestroyQueue* GetDestroyQueue();
+CommandRecorder* GetCommandRecorder();
+UploadQueue* GetUploadQueue();
 VkDevice GetVulkanDevice();
 VkCommandBuffer GetCommandBuffer();
 
@@ -127,6 +121,7 @@ void BindGeometryDescriptorSet(StaticMesh3D* staticMeshComp);
 void UpdateStaticMeshCompResourceColors(StaticMesh3D* staticMeshComp);
 void DestroyStaticMeshCompResource(StaticMesh3D* staticMeshComp);
 void DrawStaticMeshComp(StaticMesh3D* staticMeshComp, StaticMesh* meshOverride = nullptr);
+void DrawStaticMeshCompInstances(StaticMesh3D* const* staticMeshComps, uint32_t count);
 
 // SkeletalMeshComp
 void DestroySkeletalMeshCompResource(SkeletalMesh3D* skeletalMeshComp);
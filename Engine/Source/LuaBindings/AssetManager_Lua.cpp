@@ -40,6 +40,8 @@ int AssetManager_Lua::SaveAsset(lua_State* L)
 int AssetManager_Lua::AsyncLoadAsset(lua_State* L)
 {
     const char* name = CHECK_STRING(L, 1);
+    int32_t priority = 0;
+    if (!lua_isnone(L, 2)) { priority = CHECK_INTEGER(L, 2); }
 
     // Create an Asset_Lua object with a null mAsset member.
     // The async load functionality will fill in the null member after the load as finished.
@@ -47,12 +49,22 @@ int AssetManager_Lua::AsyncLoadAsset(lua_State* L)
     Asset_Lua::Create(L, nullptr, true);
     Asset_Lua* assetLua = (Asset_Lua*) lua_touserdata(L, -1);
 
-    AssetManager::Get()->AsyncLoadAsset(name, &assetLua->mAsset);
+    AssetManager::Get()->AsyncLoadAsset(name, &assetLua->mAsset, priority);
 
     // The newly created Asset_Lua userdata should be on top of the stack.
     return 1;
 }
 
+int AssetManager_Lua::CancelAsyncLoad(lua_State* L)
+{
+    const char* name = CHECK_STRING(L, 1);
+
+    bool ret = AssetManager::Get()->CancelAsyncLoad(name);
+
+    lua_pushboolean(L, ret);
+    return 1;
+}
+
 int AssetManager_Lua::UnloadAsset(lua_State* L)
 {
     const char* name = CHECK_STRING(L, 1);
@@ -102,6 +114,8 @@ void AssetManager_Lua::Bind()
 
     REGISTER_TABLE_FUNC(L, tableIdx, AsyncLoadAsset);
 
+    REGISTER_TABLE_FUNC(L, tableIdx, CancelAsyncLoad);
+
     REGISTER_TABLE_FUNC(L, tableIdx, UnloadAsset);
 
     REGISTER_TABLE_FUNC(L, tableIdx, CreateAndRegisterAsset);
@@ -13,6 +13,7 @@ struct AssetManager_Lua
     static int LoadAsset(lua_State* L);
     static int SaveAsset(lua_State* L);
     static int AsyncLoadAsset(lua_State* L);
+    static int CancelAsyncLoad(lua_State* L);
     static int UnloadAsset(lua_State* L);
     static int CreateAndRegisterAsset(lua_State* L);
 
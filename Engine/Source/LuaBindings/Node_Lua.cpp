@@ -1,6 +1,7 @@
 #include "EngineTypes.h"
 #include "Log.h"
 #include "Engine.h"
+#include "Script.h"
 
 #include "Nodes/Node.h"
 #include "Assets/Scene.h"
@@ -56,6 +57,18 @@ int NodeWrapperNewIndex(lua_State* L)
     lua_pushvalue(L, 3);
     lua_rawset(L, uvIdx);
 
+    // Let the script know if a cached callback (Tick, BeginOverlap, etc) was overridden.
+    if (lua_type(L, 2) == LUA_TSTRING)
+    {
+        Node_Lua* nodeLua = (Node_Lua*)lua_touserdata(L, 1);
+        Script* script = nodeLua->mNode->GetScript();
+
+        if (script != nullptr)
+        {
+            script->OnFieldAssigned(lua_tostring(L, 2));
+        }
+    }
+
     return 0;
 }
 
@@ -800,21 +813,39 @@ int Node_Lua::EmitSignal(lua_State* L)
     Node* node = CHECK_NODE(L, 1);
     const char* signalName = CHECK_STRING(L, 2);
 
-    std::vector<Datum> args;
-    // How many args is this emit sending? exclude node and signalName args
-    int numArgs = lua_gettop(L) - 2;
+    SignalId signalId = FindSignal(signalName);
 
-    if (numArgs > 0)
+    if (!node->HasSignalConnections(signalId))
     {
-        args.reserve(numArgs);
+        return 0;
     }
 
-    for (int32_t i = 3; i <= 2 + numArgs; ++i)
+    // How many args is this emit sending? exclude node and signalName args
+    int numArgs = lua_gettop(L) - 2;
+
+    if (numArgs <= MAX_SIGNAL_ARGS)
     {
-        args.push_back(LuaObjectToDatum(L, i));
+        Datum args[MAX_SIGNAL_ARGS];
+
+        for (int32_t i = 0; i < numArgs; ++i)
+        {
+            LuaObjectToDatum(L, 3 + i, args[i]);
+        }
+
+        node->EmitSignal(signalId, SignalArgs(args, numArgs));
     }
+    else
+    {
+        std::vector<Datum> args;
+        args.reserve(numArgs);
 
-    node->EmitSignal(signalName, args);
+        for (int32_t i = 3; i <= 2 + numArgs; ++i)
+        {
+            args.push_back(LuaObjectToDatum(L, i));
+        }
+
+        node->EmitSignal(signalId, SignalArgs(args));
+    }
 
     return 0;
 }
@@ -1055,6 +1086,39 @@ int Node_Lua::EnableLateTick(lua_State* L)
     return 0;
 }
 
+int Node_Lua::SetScriptTickRate(lua_State* L)
+{
+    Node* node = CHECK_NODE(L, 1);
+    ScriptTickRate rate = (ScriptTickRate)CHECK_INTEGER(L, 2);
+    float value = 0.0f;
+    if (!lua_isnone(L, 3)) { value = CHECK_NUMBER(L, 3); }
+
+    if (node->GetScript() != nullptr && rate < ScriptTickRate::Count)
+    {
+        node->GetScript()->SetTickRate(rate, value);
+    }
+
+    return 0;
+}
+
+int Node_Lua::GetScriptTickRate(lua_State* L)
+{
+    Node* node = CHECK_NODE(L, 1);
+
+    ScriptTickRate rate = ScriptTickRate::EveryFrame;
+    float value = 0.0f;
+
+    if (node->GetScript() != nullptr)
+    {
+        rate = node->GetScript()->GetTickRate();
+        value = node->GetScript()->GetTickRateValue();
+    }
+
+    lua_pushinteger(L, (int)rate);
+    lua_pushnumber(L, value);
+    return 2;
+}
+
 int Node_Lua::IsAlwaysRelevant(lua_State* L)
 {
     Node* node = CHECK_NODE(L, 1);
@@ -1276,6 +1340,10 @@ void Node_Lua::Bind()
 
     REGISTER_TABLE_FUNC(L, mtIndex, EnableLateTick);
 
+    REGISTER_TABLE_FUNC(L, mtIndex, SetScriptTickRate);
+
+    REGISTER_TABLE_FUNC(L, mtIndex, GetScriptTickRate);
+
     REGISTER_TABLE_FUNC(L, mtIndex, IsAlwaysRelevant);
 
     REGISTER_TABLE_FUNC(L, mtIndex, SetAlwaysRelevant);
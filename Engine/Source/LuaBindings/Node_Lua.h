@@ -102,6 +102,8 @@ struct Node_Lua
 
     static int IsLateTickEnabled(lua_State* L);
     static int EnableLateTick(lua_State* L);
+    static int SetScriptTickRate(lua_State* L);
+    static int GetScriptTickRate(lua_State* L);
 
     static int IsAlwaysRelevant(lua_State* L);
     static int SetAlwaysRelevant(lua_State* L);
@@ -199,7 +199,7 @@ int Particle3D_Lua::GetParticleData(lua_State* L)
 
     if (index >= 0 && index < int32_t(comp->GetNumParticles()))
     {
-        const Particle& particleData = comp->GetParticles()[index];
+        Particle particleData = comp->GetParticle(index);
         Datum dataTable;
         dataTable.SetColorField("position", (glm::vec4(particleData.mPosition, 0)));
         dataTable.SetColorField("velocity", (glm::vec4(particleData.mVelocity, 0)));
@@ -225,9 +225,8 @@ int Particle3D_Lua::SetParticleData(lua_State* L)
     Datum dataTable = LuaObjectToDatum(L, 3);
 
     int32_t startIdx = (index == -1) ? 0 : index;
-    int32_t endIdx = (index == -1) ? int32_t(comp->GetNumParticles()) : index;
-    const int32_t numParticles = int32_t(comp->GetNumParticles());
-    std::vector<Particle>& particles = comp->GetParticles();
+    int32_t endIdx = (index == -1) ? int32_t(comp->GetNumParticles()) : (index + 1);
+    endIdx = glm::min(endIdx, int32_t(comp->GetNumParticles()));
 
     bool setPosition = dataTable.HasField("position");
     glm::vec3 position = setPosition ? dataTable.GetColorField("position") : glm::vec3();
@@ -250,9 +249,9 @@ int Particle3D_Lua::SetParticleData(lua_State* L)
     bool setRotation = dataTable.HasField("rotation");
     float rotation = setRotation ? dataTable.GetFloatField("rotation") : 0.0f;
 
-    for (int32_t i = 0; i < numParticles; ++i)
+    for (int32_t i = startIdx; i < endIdx; ++i)
     {
-        Particle& particleData = particles[i];
+        Particle particleData = comp->GetParticle(i);
 
         if (setPosition)
             particleData.mPosition = position;
@@ -274,6 +273,8 @@ int Particle3D_Lua::SetParticleData(lua_State* L)
 
         if (setRotation)
             particleData.mRotation = rotation;
+
+        comp->SetParticle(i, particleData);
     }
 
     return 0;
@@ -167,6 +167,55 @@ int Renderer_Lua::IsFrustumCullingEnabled(lua_State* L)
     return 1;
 }
 
+int Renderer_Lua::EnableSpatialCulling(lua_State* L)
+{
+    bool value = CHECK_BOOLEAN(L, 1);
+
+    Renderer::Get()->EnableSpatialCulling(value);
+
+    return 0;
+}
+
+int Renderer_Lua::IsSpatialCullingEnabled(lua_State* L)
+{
+    bool ret = Renderer::Get()->IsSpatialCullingEnabled();
+
+    lua_pushboolean(L, ret);
+    return 1;
+}
+
+int Renderer_Lua::EnableAutoInstancing(lua_State* L)
+{
+    bool value = CHECK_BOOLEAN(L, 1);
+
+    Renderer::Get()->EnableAutoInstancing(value);
+
+    return 0;
+}
+
+int Renderer_Lua::IsAutoInstancingEnabled(lua_State* L)
+{
+    bool ret = Renderer::Get()->IsAutoInstancingEnabled();
+
+    lua_pushboolean(L, ret);
+    return 1;
+}
+
+int Renderer_Lua::PrewarmPipelines(lua_State* L)
+{
+    uint32_t ret = Renderer::Get()->PrewarmPipelines();
+
+    lua_pushinteger(L, (int)ret);
+    return 1;
+}
+
+int Renderer_Lua::LogPipelineHitchReport(lua_State* L)
+{
+    Renderer::Get()->LogPipelineHitchReport();
+
+    return 0;
+}
+
 int Renderer_Lua::AddDebugDraw(lua_State* L)
 {
     DebugDraw draw;
@@ -361,6 +410,18 @@ void Renderer_Lua::Bind()
 
     REGISTER_TABLE_FUNC(L, tableIdx, IsFrustumCullingEnabled);
 
+    REGISTER_TABLE_FUNC(L, tableIdx, EnableSpatialCulling);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, IsSpatialCullingEnabled);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, EnableAutoInstancing);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, IsAutoInstancingEnabled);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, PrewarmPipelines);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, LogPipelineHitchReport);
+
     REGISTER_TABLE_FUNC(L, tableIdx, AddDebugDraw);
 
     REGISTER_TABLE_FUNC(L, tableIdx, AddDebugLine);
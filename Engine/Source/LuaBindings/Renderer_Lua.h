@@ -27,6 +27,12 @@ struct Renderer_Lua
     static int GetBoundsDebugMode(lua_State* L);
     static int EnableFrustumCulling(lua_State* L);
     static int IsFrustumCullingEnabled(lua_State* L);
+    static int EnableSpatialCulling(lua_State* L);
+    static int IsSpatialCullingEnabled(lua_State* L);
+    static int EnableAutoInstancing(lua_State* L);
+    static int IsAutoInstancingEnabled(lua_State* L);
+    static int PrewarmPipelines(lua_State* L);
+    static int LogPipelineHitchReport(lua_State* L);
     static int AddDebugDraw(lua_State* L);
     static int AddDebugLine(lua_State* L);
     static int Enable3dRendering(lua_State* L);
@@ -3,6 +3,7 @@
 #include "Engine.h"
 #include "Utilities.h"
 #include "ScriptUtils.h"
+#include "ScriptTickScheduler.h"
 
 #include "LuaBindings/LuaUtils.h"
 #include "LuaBindings/Script_Lua.h"
@@ -125,6 +126,23 @@ int Script_Lua::LoadDirectory(lua_State* L)
     return 0;
 }
 
+int Script_Lua::EnableBatchedTick(lua_State* L)
+{
+    bool enable = CHECK_BOOLEAN(L, 1);
+
+    ScriptTickScheduler::SetEnabled(enable);
+
+    return 0;
+}
+
+int Script_Lua::IsBatchedTickEnabled(lua_State* L)
+{
+    bool ret = ScriptTickScheduler::IsEnabled();
+
+    lua_pushboolean(L, ret);
+    return 1;
+}
+
 void Script_Lua::Bind()
 {
     lua_State* L = GetLua();
@@ -146,6 +164,10 @@ void Script_Lua::Bind()
 
     REGISTER_TABLE_FUNC(L, tableIdx, LoadDirectory);
 
+    REGISTER_TABLE_FUNC(L, tableIdx, EnableBatchedTick);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, IsBatchedTickEnabled);
+
     lua_setglobal(L, SCRIPT_LUA_NAME);
 
     OCT_ASSERT(lua_gettop(L) == 0);
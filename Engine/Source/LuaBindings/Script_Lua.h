@@ -13,6 +13,8 @@ struct Script_Lua
     static int New(lua_State* L);
     static int GarbageCollect(lua_State* L);
     static int LoadDirectory(lua_State* L);
+    static int EnableBatchedTick(lua_State* L);
+    static int IsBatchedTickEnabled(lua_State* L);
 
     static void Bind();
 };
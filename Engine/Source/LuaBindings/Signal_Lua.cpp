@@ -27,21 +27,37 @@ int Signal_Lua::Emit(lua_State* L)
 {
     Signal& signal = CHECK_SIGNAL(L, 1);
 
-    std::vector<Datum> args;
+    if (!signal.HasConnections())
+    {
+        return 0;
+    }
+
     // How many args is this emit sending? (do not include self at idx 1)
     int numArgs = lua_gettop(L) - 1;
 
-    if (numArgs > 0)
+    if (numArgs <= MAX_SIGNAL_ARGS)
     {
-        args.reserve(numArgs);
-    }
+        Datum args[MAX_SIGNAL_ARGS];
 
-    for (int32_t i = 2; i <= 1 + numArgs; ++i)
-    {
-        args.push_back(LuaObjectToDatum(L, i));
+        for (int32_t i = 0; i < numArgs; ++i)
+        {
+            LuaObjectToDatum(L, 2 + i, args[i]);
+        }
+
+        signal.Emit(SignalArgs(args, numArgs));
     }
+    else
+    {
+        std::vector<Datum> args;
+        args.reserve(numArgs);
 
-    signal.Emit(args);
+        for (int32_t i = 2; i <= 1 + numArgs; ++i)
+        {
+            args.push_back(LuaObjectToDatum(L, i));
+        }
+
+        signal.Emit(SignalArgs(args));
+    }
 
     return 0;
 }
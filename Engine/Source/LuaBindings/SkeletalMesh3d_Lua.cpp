@@ -334,6 +334,36 @@ int SkeletalMesh3D_Lua::GetBoundsRadiusOverride(lua_State* L)
     return 1;
 }
 
+int SkeletalMesh3D_Lua::SetAnimationLodEnabled(lua_State* L)
+{
+    SkeletalMesh3D* comp = CHECK_SKELETAL_MESH_3D(L, 1);
+    bool enable = CHECK_BOOLEAN(L, 2);
+
+    comp->SetAnimationLodEnabled(enable);
+
+    return 0;
+}
+
+int SkeletalMesh3D_Lua::IsAnimationLodEnabled(lua_State* L)
+{
+    SkeletalMesh3D* comp = CHECK_SKELETAL_MESH_3D(L, 1);
+
+    bool enabled = comp->IsAnimationLodEnabled();
+
+    lua_pushboolean(L, enabled);
+    return 1;
+}
+
+int SkeletalMesh3D_Lua::GetAnimationLod(lua_State* L)
+{
+    SkeletalMesh3D* comp = CHECK_SKELETAL_MESH_3D(L, 1);
+
+    uint32_t lod = comp->GetAnimationLod();
+
+    lua_pushinteger(L, (int)lod);
+    return 1;
+}
+
 void SkeletalMesh3D_Lua::Bind()
 {
     lua_State* L = GetLua();
@@ -396,6 +426,12 @@ void SkeletalMesh3D_Lua::Bind()
 
     REGISTER_TABLE_FUNC(L, mtIndex, GetBoundsRadiusOverride);
 
+    REGISTER_TABLE_FUNC(L, mtIndex, SetAnimationLodEnabled);
+
+    REGISTER_TABLE_FUNC(L, mtIndex, IsAnimationLodEnabled);
+
+    REGISTER_TABLE_FUNC(L, mtIndex, GetAnimationLod);
+
     lua_pop(L, 1);
     OCT_ASSERT(lua_gettop(L) == 0);
 }
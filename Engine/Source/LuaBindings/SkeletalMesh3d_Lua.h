@@ -43,6 +43,9 @@ struct SkeletalMesh3D_Lua
     static int SetAnimEventHandler(lua_State* L);
     static int SetBoundsRadiusOverride(lua_State* L);
     static int GetBoundsRadiusOverride(lua_State* L);
+    static int SetAnimationLodEnabled(lua_State* L);
+    static int IsAnimationLodEnabled(lua_State* L);
+    static int GetAnimationLod(lua_State* L);
 
     static void Bind();
 };
@@ -8,14 +8,38 @@
 
 #if LUA_ENABLED
 
+// Registry ref to the Vector metatable so Create() doesn't need a named lookup for every new vector.
+static int sMetatableRef = LUA_REFNIL;
+
+static void PushMetatable(lua_State* L)
+{
+    lua_rawgeti(L, LUA_REGISTRYINDEX, sMetatableRef);
+    OCT_ASSERT(lua_istable(L, -1));
+}
+
+// Functions that produce a Vector take an optional out Vector as their last argument.
+// When given, the result is written into it and it is returned instead of allocating a new Vector,
+// which lets scripts do vector math every frame without creating garbage.
+static int PushResult(lua_State* L, const glm::vec4& result, int outIdx)
+{
+    if (lua_isuserdata(L, outIdx))
+    {
+        glm::vec4& out = CHECK_VECTOR(L, outIdx);
+        out = result;
+        lua_pushvalue(L, outIdx);
+        return 1;
+    }
+
+    return Vector_Lua::Create(L, result);
+}
+
 int Vector_Lua::Create(lua_State* L)
 {
     int numArgs = lua_gettop(L);
 
     Vector_Lua* newVector = (Vector_Lua*)lua_newuserdata(L, sizeof(Vector_Lua));
     new (newVector) Vector_Lua();
-    luaL_getmetatable(L, VECTOR_LUA_NAME);
-    OCT_ASSERT(lua_istable(L, -1));
+    PushMetatable(L);
     lua_setmetatable(L, -2);
 
     // Initialize members is args were passed
@@ -44,8 +68,7 @@ int Vector_Lua::Create(lua_State* L, glm::vec4 value)
     Vector_Lua* newVector = (Vector_Lua*)lua_newuserdata(L, sizeof(Vector_Lua));
     new (newVector) Vector_Lua();
     newVector->mVector = value;
-    luaL_getmetatable(L, VECTOR_LUA_NAME);
-    OCT_ASSERT(lua_istable(L, -1));
+    PushMetatable(L);
     lua_setmetatable(L, -2);
 
     return 1;
@@ -70,6 +93,27 @@ int Vector_Lua::Destroy(lua_State* L)
     return 0;
 }
 
+Vector_Lua* Vector_Lua::Check(lua_State* L, int arg)
+{
+    // Compare against the cached metatable instead of looking it up by name like luaL_checkudata().
+    Vector_Lua* vec = (Vector_Lua*)lua_touserdata(L, arg);
+
+    if (vec != nullptr && lua_getmetatable(L, arg))
+    {
+        PushMetatable(L);
+        bool isVector = lua_rawequal(L, -1, -2);
+        lua_pop(L, 2);
+
+        if (isVector)
+        {
+            return vec;
+        }
+    }
+
+    // Raises the usual type error.
+    return CheckLuaType<Vector_Lua>(L, arg, VECTOR_LUA_NAME);
+}
+
 int Vector_Lua::Index(lua_State* L)
 {
     glm::vec4& value = CHECK_VECTOR(L, 1);
@@ -116,8 +160,9 @@ int Vector_Lua::Index(lua_State* L)
     }
     else
     {
-        lua_getglobal(L, VECTOR_LUA_NAME);
-        lua_pushstring(L, key);
+        // The Vector global table is the metatable.
+        PushMetatable(L);
+        lua_pushvalue(L, 2);
         // I think this could be a normal lua_tableget() if you wanted to follow an inheritance chain.
         // But vector doesn't need that.
         lua_rawget(L, -2);
@@ -209,9 +254,7 @@ int Vector_Lua::Clone(lua_State* L)
 {
     glm::vec4& srcVec = CHECK_VECTOR(L, 1);
 
-    Vector_Lua::Create(L, srcVec);
-
-    return 1;
+    return PushResult(L, srcVec, 2);
 }
 
 int Vector_Lua::Add(lua_State* L)
@@ -236,8 +279,7 @@ int Vector_Lua::Add(lua_State* L)
         result = left + right;
     }
 
-    Vector_Lua::Create(L, result);
-    return 1;
+    return PushResult(L, result, 3);
 }
 
 int Vector_Lua::Subtract(lua_State* L)
@@ -262,8 +304,7 @@ int Vector_Lua::Subtract(lua_State* L)
         result = left- right;
     }
 
-    Vector_Lua::Create(L, result);
-    return 1;
+    return PushResult(L, result, 3);
 }
 
 int Vector_Lua::Multiply(lua_State* L)
@@ -288,8 +329,7 @@ int Vector_Lua::Multiply(lua_State* L)
         result = left * right;
     }
 
-    Vector_Lua::Create(L, result);
-    return 1;
+    return PushResult(L, result, 3);
 }
 
 int Vector_Lua::Divide(lua_State* L)
@@ -315,8 +355,39 @@ int Vector_Lua::Divide(lua_State* L)
         result = left / right;
     }
 
-    Vector_Lua::Create(L, result);
-    return 1;
+    return PushResult(L, result, 3);
+}
+
+int Vector_Lua::AddInPlace(lua_State* L)
+{
+    CHECK_VECTOR(L, 1);
+    lua_settop(L, 2);
+    lua_pushvalue(L, 1);
+    return Add(L);
+}
+
+int Vector_Lua::SubtractInPlace(lua_State* L)
+{
+    CHECK_VECTOR(L, 1);
+    lua_settop(L, 2);
+    lua_pushvalue(L, 1);
+    return Subtract(L);
+}
+
+int Vector_Lua::MultiplyInPlace(lua_State* L)
+{
+    CHECK_VECTOR(L, 1);
+    lua_settop(L, 2);
+    lua_pushvalue(L, 1);
+    return Multiply(L);
+}
+
+int Vector_Lua::DivideInPlace(lua_State* L)
+{
+    CHECK_VECTOR(L, 1);
+    lua_settop(L, 2);
+    lua_pushvalue(L, 1);
+    return Divide(L);
 }
 
 int Vector_Lua::Equals(lua_State* L)
@@ -365,8 +436,7 @@ int Vector_Lua::Cross(lua_State* L)
 
     glm::vec3 result = glm::cross(l3, r3);
 
-    Vector_Lua::Create(L, glm::vec4(result, 0));
-    return 1;
+    return PushResult(L, glm::vec4(result, 0), 3);
 }
 
 int Vector_Lua::Lerp(lua_State* L)
@@ -377,8 +447,7 @@ int Vector_Lua::Lerp(lua_State* L)
 
     glm::vec4 result = glm::mix(a, b, alpha);
 
-    Vector_Lua::Create(L, result);
-    return 1;
+    return PushResult(L, result, 4);
 }
 
 int Vector_Lua::Max(lua_State* L)
@@ -388,8 +457,7 @@ int Vector_Lua::Max(lua_State* L)
 
     glm::vec4 result = glm::max(a, b);
 
-    Vector_Lua::Create(L, result);
-    return 1;
+    return PushResult(L, result, 3);
 }
 
 int Vector_Lua::Min(lua_State* L)
@@ -399,8 +467,7 @@ int Vector_Lua::Min(lua_State* L)
 
     glm::vec4 result = glm::min(a, b);
 
-    Vector_Lua::Create(L, result);
-    return 1;
+    return PushResult(L, result, 3);
 }
 
 int Vector_Lua::Clamp(lua_State* L)
@@ -411,8 +478,7 @@ int Vector_Lua::Clamp(lua_State* L)
 
     glm::vec4 result = glm::clamp(value, min, max);
 
-    Vector_Lua::Create(L, result);
-    return 1;
+    return PushResult(L, result, 4);
 }
 
 int Vector_Lua::Normalize(lua_State* L)
@@ -426,8 +492,7 @@ int Vector_Lua::Normalize(lua_State* L)
         result = glm::normalize(v4);
     }
 
-    Vector_Lua::Create(L, result);
-    return 1;
+    return PushResult(L, result, 2);
 }
 
 int Vector_Lua::Normalize3(lua_State* L)
@@ -441,8 +506,7 @@ int Vector_Lua::Normalize3(lua_State* L)
         result = glm::normalize(v3);
     }
 
-    Vector_Lua::Create(L, glm::vec4(result, 0));
-    return 1;
+    return PushResult(L, glm::vec4(result, 0), 2);
 }
 
 int Vector_Lua::Reflect(lua_State* L)
@@ -452,8 +516,7 @@ int Vector_Lua::Reflect(lua_State* L)
 
     glm::vec3 result = glm::reflect(inc3, nrm3);
 
-    Vector_Lua::Create(L, glm::vec4(result, 0));
-    return 1;
+    return PushResult(L, glm::vec4(result, 0), 3);
 }
 
 int Vector_Lua::Damp(lua_State* L)
@@ -465,8 +528,7 @@ int Vector_Lua::Damp(lua_State* L)
 
     glm::vec4 result = Maths::Damp(src, dst, smoothing, deltaTime);
 
-    Vector_Lua::Create(L, result);
-    return 1;
+    return PushResult(L, result, 5);
 }
 
 int Vector_Lua::Rotate(lua_State* L)
@@ -477,8 +539,7 @@ int Vector_Lua::Rotate(lua_State* L)
 
     glm::vec3 result = glm::rotate(vect3, angle * DEGREES_TO_RADIANS, axis3);
 
-    Vector_Lua::Create(L, glm::vec4(result, 0));
-    return 1;
+    return PushResult(L, glm::vec4(result, 0), 4);
 }
 
 int Vector_Lua::Length(lua_State* L)
@@ -555,8 +616,15 @@ int Vector_Lua::Negate(lua_State* L)
 
     glm::vec4 ret = vect * -1.0f;
 
-    Vector_Lua::Create(L, ret);
-    return 1;
+    return PushResult(L, ret, 2);
+}
+
+// Lua passes the operand twice to __unm, so it must not be treated as an out Vector.
+static int NegateOperator(lua_State* L)
+{
+    glm::vec4 vect = CHECK_VECTOR(L, 1);
+
+    return Vector_Lua::Create(L, vect * -1.0f);
 }
 
 void Vector_Lua::Bind()
@@ -567,6 +635,9 @@ void Vector_Lua::Bind()
     luaL_newmetatable(L, VECTOR_LUA_NAME);
     int mtIndex = lua_gettop(L);
 
+    lua_pushvalue(L, mtIndex);
+    sMetatableRef = luaL_ref(L, LUA_REGISTRYINDEX);
+
     REGISTER_TABLE_FUNC(L, mtIndex, Create);
 
     //lua_pushcfunction(L, Vector_Lua::Destroy);
@@ -588,6 +659,14 @@ void Vector_Lua::Bind()
     REGISTER_TABLE_FUNC(L, mtIndex, Divide);
     REGISTER_TABLE_FUNC_EX(L, mtIndex, Divide, "__div");
 
+    REGISTER_TABLE_FUNC(L, mtIndex, AddInPlace);
+
+    REGISTER_TABLE_FUNC(L, mtIndex, SubtractInPlace);
+
+    REGISTER_TABLE_FUNC(L, mtIndex, MultiplyInPlace);
+
+    REGISTER_TABLE_FUNC(L, mtIndex, DivideInPlace);
+
     REGISTER_TABLE_FUNC(L, mtIndex, Equals);
     REGISTER_TABLE_FUNC_EX(L, mtIndex, Equals, "__eq");
 
@@ -636,7 +715,8 @@ void Vector_Lua::Bind()
 
     REGISTER_TABLE_FUNC(L, mtIndex, SignedAngle);
 
-    REGISTER_TABLE_FUNC_EX(L, mtIndex, Negate, "__unm");
+    REGISTER_TABLE_FUNC(L, mtIndex, Negate);
+    REGISTER_TABLE_FUNC_EX(L, mtIndex, NegateOperator, "__unm");
 
     REGISTER_TABLE_FUNC_EX(L, mtIndex, Index, "__index");
 
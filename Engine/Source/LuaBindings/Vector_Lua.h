@@ -7,7 +7,7 @@
 #if LUA_ENABLED
 
 #define VECTOR_LUA_NAME "Vector"
-#define CHECK_VECTOR(L, Arg) CheckLuaType<Vector_Lua>(L, Arg, VECTOR_LUA_NAME)->mVector;
+#define CHECK_VECTOR(L, Arg) Vector_Lua::Check(L, Arg)->mVector;
 
 struct Vector_Lua
 {
@@ -21,6 +21,7 @@ struct Vector_Lua
     static int Create(lua_State* L, glm::vec3 value);
     static int Create(lua_State* L, glm::vec2 value);
     static int Destroy(lua_State* L);
+    static Vector_Lua* Check(lua_State* L, int arg);
 
     static int Index(lua_State* L);
     static int NewIndex(lua_State* L);
@@ -32,6 +33,10 @@ struct Vector_Lua
     static int Subtract(lua_State* L);
     static int Multiply(lua_State* L);
     static int Divide(lua_State* L);
+    static int AddInPlace(lua_State* L);
+    static int SubtractInPlace(lua_State* L);
+    static int MultiplyInPlace(lua_State* L);
+    static int DivideInPlace(lua_State* L);
     static int Equals(lua_State* L);
     static int Dot(lua_State* L);
     static int Dot3(lua_State* L);
@@ -495,6 +495,26 @@ int World_Lua::SpawnParticle(lua_State* L)
     return 1;
 }
 
+int World_Lua::PrewarmParticlePool(lua_State* L)
+{
+    World* world = CHECK_WORLD(L, 1);
+    ParticleSystem* particleSys = CHECK_PARTICLE_SYSTEM(L, 2);
+    int32_t count = CHECK_INTEGER(L, 3);
+
+    world->PrewarmParticlePool(particleSys, (uint32_t)glm::max(count, 0));
+
+    return 0;
+}
+
+int World_Lua::ClearParticlePool(lua_State* L)
+{
+    World* world = CHECK_WORLD(L, 1);
+
+    world->ClearParticlePool();
+
+    return 0;
+}
+
 void World_Lua::Bind()
 {
     lua_State* L = GetLua();
@@ -562,6 +582,10 @@ void World_Lua::Bind()
 
     REGISTER_TABLE_FUNC(L, mtIndex, SpawnParticle);
 
+    REGISTER_TABLE_FUNC(L, mtIndex, PrewarmParticlePool);
+
+    REGISTER_TABLE_FUNC(L, mtIndex, ClearParticlePool);
+
     // Set the __index metamethod to itself
     lua_pushvalue(L, mtIndex);
     lua_setfield(L, mtIndex, "__index");
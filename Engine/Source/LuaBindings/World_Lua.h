@@ -54,6 +54,8 @@ struct World_Lua
     static int IsInternalEdgeSmoothingEnabled(lua_State* L);
 
     static int SpawnParticle(lua_State* L);
+    static int PrewarmParticlePool(lua_State* L);
+    static int ClearParticlePool(lua_State* L);
 
     static void Bind();
 };
@@ -29,3 +29,17 @@ void Swap16(T& dst)
     charArray[0] = c1;
     charArray[1] = c0;
 }
+
+// Byte swaps an array of 32-bit values in place. Written with shifts so the compiler
+// can turn it into byte-reverse instructions and vectorize the loop.
+inline void SwapArray32(uint32_t* data, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        uint32_t v = data[i];
+        data[i] = (v >> 24) |
+            ((v >> 8) & 0x0000ff00) |
+            ((v << 8) & 0x00ff0000) |
+            (v << 24);
+    }
+}
@@ -178,6 +178,18 @@ void SYS_ReleaseFileData(char* data)
     }
 }
 
+const char* SYS_MapFile(const char* path, uint32_t& outSize)
+{
+    // Not supported. Callers fall back to reading files normally.
+    outSize = 0;
+    return nullptr;
+}
+
+void SYS_UnmapFile(const char* data, uint32_t size)
+{
+
+}
+
 std::string SYS_GetCurrentDirectoryPath()
 {
     char path[MAX_PATH_SIZE] = {};
@@ -381,6 +393,34 @@ void SYS_DestroyMutex(MutexObject* mutex)
     delete mutex;
 }
 
+SemaphoreObject* SYS_CreateSemaphore(uint32_t initialCount)
+{
+    SemaphoreObject* retSemaphore = new SemaphoreObject();
+    LightSemaphore_Init(retSemaphore, (int16_t)initialCount, INT16_MAX);
+    return retSemaphore;
+}
+
+void SYS_WaitSemaphore(SemaphoreObject* semaphore)
+{
+    LightSemaphore_Acquire(semaphore, 1);
+}
+
+void SYS_PostSemaphore(SemaphoreObject* semaphore, uint32_t count)
+{
+    LightSemaphore_Release(semaphore, (int32_t)count);
+}
+
+void SYS_DestroySemaphore(SemaphoreObject* semaphore)
+{
+    delete semaphore;
+}
+
+uint32_t SYS_GetNumProcessors()
+{
+    // Only the application core is available by default.
+    return 1;
+}
+
 void SYS_Sleep(uint32_t milliseconds)
 {
     svcSleepThread(milliseconds * 1000 * 1000);
@@ -14,6 +14,7 @@
 #include <string>
 #include <assert.h>
 #include <signal.h>
+#include <errno.h>
 
 #include <android/input.h>
 #include <android/window.h>
@@ -518,6 +519,18 @@ void SYS_ReleaseFileData(char* data)
     }
 }
 
+const char* SYS_MapFile(const char* path, uint32_t& outSize)
+{
+    // Not supported. Callers fall back to reading files normally.
+    outSize = 0;
+    return nullptr;
+}
+
+void SYS_UnmapFile(const char* data, uint32_t size)
+{
+
+}
+
 std::string SYS_GetCurrentDirectoryPath()
 {
     char path[MAX_PATH_SIZE] = {};
@@ -742,6 +755,45 @@ void SYS_DestroyMutex(MutexObject* mutex)
     delete mutex;
 }
 
+SemaphoreObject* SYS_CreateSemaphore(uint32_t initialCount)
+{
+    SemaphoreObject* retSemaphore = new SemaphoreObject();
+    int status = sem_init(retSemaphore, 0, initialCount);
+
+    if (status != 0)
+    {
+        LogError("Failed to create Semaphore");
+    }
+
+    return retSemaphore;
+}
+
+void SYS_WaitSemaphore(SemaphoreObject* semaphore)
+{
+    // Retry if a signal interrupts the wait
+    while (sem_wait(semaphore) != 0 && errno == EINTR) {}
+}
+
+void SYS_PostSemaphore(SemaphoreObject* semaphore, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        sem_post(semaphore);
+    }
+}
+
+void SYS_DestroySemaphore(SemaphoreObject* semaphore)
+{
+    sem_destroy(semaphore);
+    delete semaphore;
+}
+
+uint32_t SYS_GetNumProcessors()
+{
+    long numProcs = sysconf(_SC_NPROCESSORS_ONLN);
+    return numProcs > 0 ? (uint32_t)numProcs : 1;
+}
+
 void SYS_Sleep(uint32_t milliseconds)
 {
     usleep(milliseconds * 1000);
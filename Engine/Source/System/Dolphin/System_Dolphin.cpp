@@ -158,6 +158,18 @@ void SYS_ReleaseFileData(char* data)
     }
 }
 
+const char* SYS_MapFile(const char* path, uint32_t& outSize)
+{
+    // Not supported. Callers fall back to reading files normally.
+    outSize = 0;
+    return nullptr;
+}
+
+void SYS_UnmapFile(const char* data, uint32_t size)
+{
+
+}
+
 std::string SYS_GetCurrentDirectoryPath()
 {
     char path[MAX_PATH_SIZE] = {};
@@ -348,6 +360,43 @@ void SYS_DestroyMutex(MutexObject* mutex)
     delete mutex;
 }
 
+SemaphoreObject* SYS_CreateSemaphore(uint32_t initialCount)
+{
+    SemaphoreObject* retSemaphore = new SemaphoreObject();
+    int32_t status = LWP_SemInit(retSemaphore, initialCount, 0xffffffff);
+
+    if (status != 0)
+    {
+        LogError("Failed to create Semaphore");
+    }
+
+    return retSemaphore;
+}
+
+void SYS_WaitSemaphore(SemaphoreObject* semaphore)
+{
+    LWP_SemWait(*semaphore);
+}
+
+void SYS_PostSemaphore(SemaphoreObject* semaphore, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        LWP_SemPost(*semaphore);
+    }
+}
+
+void SYS_DestroySemaphore(SemaphoreObject* semaphore)
+{
+    LWP_SemDestroy(*semaphore);
+    delete semaphore;
+}
+
+uint32_t SYS_GetNumProcessors()
+{
+    return 1;
+}
+
 void SYS_Sleep(uint32_t milliseconds)
 {
     usleep(milliseconds * 1000);
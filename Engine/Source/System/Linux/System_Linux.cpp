@@ -17,8 +17,11 @@
 #include <vector>
 #include <assert.h>
 #include <signal.h>
+#include <errno.h>
 #include <limits.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 
 #if EDITOR
 #include "imgui.h"
@@ -582,6 +585,50 @@ void SYS_ReleaseFileData(char* data)
     }
 }
 
+const char* SYS_MapFile(const char* path, uint32_t& outSize)
+{
+    outSize = 0;
+    const char* retData = nullptr;
+
+    int fd = open(path, O_RDONLY);
+
+    if (fd >= 0)
+    {
+        struct stat fileStat;
+
+        if (fstat(fd, &fileStat) == 0 &&
+            fileStat.st_size > 0 &&
+            uint64_t(fileStat.st_size) <= UINT32_MAX)
+        {
+            void* mapping = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+            if (mapping != MAP_FAILED)
+            {
+                retData = (const char*)mapping;
+                outSize = uint32_t(fileStat.st_size);
+            }
+        }
+
+        // The mapping stays valid after the descriptor is closed.
+        close(fd);
+    }
+
+    if (retData == nullptr)
+    {
+        LogError("Failed to map file: %s", path);
+    }
+
+    return retData;
+}
+
+void SYS_UnmapFile(const char* data, uint32_t size)
+{
+    if (data != nullptr)
+    {
+        munmap((void*)data, size);
+    }
+}
+
 std::string SYS_GetOctavePath()
 {
     std::string octaveDirectory = SYS_GetCurrentDirectoryPath();
@@ -873,6 +920,45 @@ void SYS_DestroyMutex(MutexObject* mutex)
     delete mutex;
 }
 
+SemaphoreObject* SYS_CreateSemaphore(uint32_t initialCount)
+{
+    SemaphoreObject* retSemaphore = new SemaphoreObject();
+    int status = sem_init(retSemaphore, 0, initialCount);
+
+    if (status != 0)
+    {
+        LogError("Failed to create Semaphore");
+    }
+
+    return retSemaphore;
+}
+
+void SYS_WaitSemaphore(SemaphoreObject* semaphore)
+{
+    // Retry if a signal interrupts the wait
+    while (sem_wait(semaphore) != 0 && errno == EINTR) {}
+}
+
+void SYS_PostSemaphore(SemaphoreObject* semaphore, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        sem_post(semaphore);
+    }
+}
+
+void SYS_DestroySemaphore(SemaphoreObject* semaphore)
+{
+    sem_destroy(semaphore);
+    delete semaphore;
+}
+
+uint32_t SYS_GetNumProcessors()
+{
+    long numProcs = sysconf(_SC_NPROCESSORS_ONLN);
+    return numProcs > 0 ? (uint32_t)numProcs : 1;
+}
+
 void SYS_Sleep(uint32_t milliseconds)
 {
     usleep(milliseconds * 1000);
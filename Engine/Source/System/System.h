@@ -16,6 +16,8 @@ void SYS_Update();
 bool SYS_DoesFileExist(const char* path, bool isAsset);
 void SYS_AcquireFileData(const char* path, bool isAsset, int32_t maxSize, char*& outData, uint32_t& outSize);
 void SYS_ReleaseFileData(char* data);
+const char* SYS_MapFile(const char* path, uint32_t& outSize);
+void SYS_UnmapFile(const char* data, uint32_t size);
 std::string SYS_GetExecutablePath();
 std::string SYS_GetOctavePath();
 std::string SYS_GetCurrentDirectoryPath();
@@ -48,6 +50,11 @@ MutexObject* SYS_CreateMutex();
 void SYS_LockMutex(MutexObject* mutex);
 void SYS_UnlockMutex(MutexObject* mutex);
 void SYS_DestroyMutex(MutexObject* mutex);
+SemaphoreObject* SYS_CreateSemaphore(uint32_t initialCount);
+void SYS_WaitSemaphore(SemaphoreObject* semaphore);
+void SYS_PostSemaphore(SemaphoreObject* semaphore, uint32_t count = 1);
+void SYS_DestroySemaphore(SemaphoreObject* semaphore);
+uint32_t SYS_GetNumProcessors();
 void SYS_Sleep(uint32_t milliseconds);
 
 // Time
@@ -14,6 +14,7 @@
 #include <unistd.h>
 #include <xcb/xcb.h>
 #include <pthread.h>
+#include <semaphore.h>
 #elif PLATFORM_ANDROID
 #include <stdio.h>
 #include <dirent.h>
@@ -21,6 +22,7 @@
 #include <sys/stat.h>
 #include <unistd.h>
 #include <pthread.h>
+#include <semaphore.h>
 #include <android/native_window.h>
 #include <android/native_activity.h>
 #include <android_native_app_glue.h>
@@ -39,18 +41,22 @@
 #if PLATFORM_WINDOWS
 typedef HANDLE ThreadObject;
 typedef HANDLE MutexObject;
+typedef HANDLE SemaphoreObject;
 typedef DWORD ThreadFuncRet;
 #elif (PLATFORM_LINUX || PLATFORM_ANDROID)
 typedef pthread_t ThreadObject;
 typedef pthread_mutex_t MutexObject;
+typedef sem_t SemaphoreObject;
 typedef void* ThreadFuncRet;
 #elif PLATFORM_DOLPHIN
 typedef lwp_t ThreadObject;
 typedef mutex_t MutexObject;
+typedef sem_t SemaphoreObject;
 typedef void* ThreadFuncRet;
 #elif PLATFORM_3DS
 typedef Thread ThreadObject;
 typedef uint32_t MutexObject;
+typedef LightSemaphore SemaphoreObject;
 typedef void ThreadFuncRet;
 #endif
 
@@ -424,6 +424,57 @@ void SYS_ReleaseFileData(char* data)
         free(data);
     }
 }
+
+const char* SYS_MapFile(const char* path, uint32_t& outSize)
+{
+    outSize = 0;
+    const char* retData = nullptr;
+
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (file != INVALID_HANDLE_VALUE)
+    {
+        LARGE_INTEGER fileSize = {};
+
+        if (GetFileSizeEx(file, &fileSize) &&
+            fileSize.QuadPart > 0 &&
+            uint64_t(fileSize.QuadPart) <= UINT32_MAX)
+        {
+            HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+
+            if (mapping != NULL)
+            {
+                retData = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+                if (retData != nullptr)
+                {
+                    outSize = uint32_t(fileSize.QuadPart);
+                }
+
+                // The view keeps the mapping alive.
+                CloseHandle(mapping);
+            }
+        }
+
+        CloseHandle(file);
+    }
+
+    if (retData == nullptr)
+    {
+        LogError("Failed to map file: %s", path);
+    }
+
+    return retData;
+}
+
+void SYS_UnmapFile(const char* data, uint32_t size)
+{
+    if (data != nullptr)
+    {
+        UnmapViewOfFile(data);
+    }
+}
+
 std::string SYS_GetOctavePath()
 {
     std::string octaveDirectory = SYS_GetCurrentDirectoryPath();
@@ -901,6 +952,50 @@ void SYS_DestroyMutex(MutexObject* mutex)
     delete mutex;
 }
 
+SemaphoreObject* SYS_CreateSemaphore(uint32_t initialCount)
+{
+    SemaphoreObject* retSemaphore = new SemaphoreObject();
+
+    *retSemaphore = CreateSemaphore(
+        NULL,               // default security attributes
+        (LONG)initialCount, // initial count
+        LONG_MAX,           // maximum count
+        NULL);              // unnamed semaphore
+
+    if (*retSemaphore == 0)
+    {
+        LogError("Failed to create Semaphore");
+    }
+
+    return retSemaphore;
+}
+
+void SYS_WaitSemaphore(SemaphoreObject* semaphore)
+{
+    WaitForSingleObject(*semaphore, INFINITE);
+}
+
+void SYS_PostSemaphore(SemaphoreObject* semaphore, uint32_t count)
+{
+    if (!ReleaseSemaphore(*semaphore, (LONG)count, nullptr))
+    {
+        LogError("Error releasing semaphore");
+    }
+}
+
+void SYS_DestroySemaphore(SemaphoreObject* semaphore)
+{
+    CloseHandle(*semaphore);
+    delete semaphore;
+}
+
+uint32_t SYS_GetNumProcessors()
+{
+    SYSTEM_INFO sysInfo = {};
+    GetSystemInfo(&sysInfo);
+    return glm::max<uint32_t>(1, (uint32_t)sysInfo.dwNumberOfProcessors);
+}
+
 void SYS_Sleep(uint32_t milliseconds)
 {
     Sleep(milliseconds);